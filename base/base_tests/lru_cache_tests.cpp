@@ -24,6 +24,8 @@ public:
     return value;
   }
 
+  void Erase(Key const & key) { m_cache.Erase(key); }
+
   bool IsValid() const { return m_cache.IsValidForTesting(); }
 
 private:
@@ -174,3 +176,28 @@ UNIT_TEST(LruCacheLoaderCallsTest)
   cache.GetValue(1);
   TEST(cache.IsValid(), ());
 }
+
+UNIT_TEST(LruCacheEraseTest)
+{
+  using Key = int;
+  using Value = int;
+  size_t loadsCount = 0;
+  auto loader = [&loadsCount](Key k, Value & v) {
+    ++loadsCount;
+    v = k;
+  };
+
+  LruCacheTest<Key, Value> cache(2 /* maxCacheSize */, loader);
+  cache.GetValue(1);
+  cache.GetValue(2);
+  cache.Erase(1);
+  cache.Erase(3);
+  TEST(cache.IsValid(), ());
+  TEST_EQUAL(loadsCount, 2, ());
+
+  // 1 is loaded again, and 2 is kept, because there is room for it after the erase.
+  TEST_EQUAL(cache.GetValue(1), 1, ());
+  TEST_EQUAL(cache.GetValue(2), 2, ());
+  TEST(cache.IsValid(), ());
+  TEST_EQUAL(loadsCount, 3, ());
+}
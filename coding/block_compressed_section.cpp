@@ -0,0 +1,165 @@
+#include "coding/block_compressed_section.hpp"
+
+#include "coding/write_to_sink.hpp"
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace coding
+{
+using namespace std;
+
+namespace
+{
+uint64_t constexpr kHeaderSize = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t);
+}  // namespace
+
+// BlockCompressedSection --------------------------------------------------------------------------
+// static
+void BlockCompressedSection::Write(Reader const & reader, Writer & writer, uint32_t blockSize)
+{
+  CHECK_GREATER(blockSize, 0, ());
+
+  ZLib::Deflate const deflate(ZLib::Deflate::Format::ZLib, ZLib::Deflate::Level::BestCompression);
+
+  uint64_t const size = reader.Size();
+  vector<uint8_t> block;
+  vector<uint8_t> blocks;
+  vector<uint32_t> offsets = {0};
+  for (uint64_t pos = 0; pos < size; pos += blockSize)
+  {
+    block.resize(static_cast<size_t>(min<uint64_t>(blockSize, size - pos)));
+    reader.Read(pos, block.data(), block.size());
+    CHECK(deflate(block.data(), block.size(), back_inserter(blocks)), (pos, size));
+
+    CHECK_LESS_OR_EQUAL(blocks.size(), numeric_limits<uint32_t>::max(), ("Section is too big."));
+    offsets.push_back(static_cast<uint32_t>(blocks.size()));
+  }
+
+  WriteToSink(writer, static_cast<uint8_t>(Version::Latest));
+  WriteToSink(writer, blockSize);
+  WriteToSink(writer, size);
+  for (auto const offset : offsets)
+    WriteToSink(writer, offset);
+  writer.Write(blocks.data(), blocks.size());
+}
+
+// BlockCompressedReader::Section ------------------------------------------------------------------
+BlockCompressedReader::Section::Section(ModelReaderPtr const & section, size_t cacheSize)
+  : m_reader(section), m_cache(cacheSize)
+{
+  auto const version = ReadPrimitiveFromPos<uint8_t>(m_reader, 0);
+  if (version != static_cast<uint8_t>(BlockCompressedSection::Version::Latest))
+    MYTHROW(Reader::ReadException, ("Unknown compressed section version:", static_cast<int>(version)));
+
+  m_blockSize = ReadPrimitiveFromPos<uint32_t>(m_reader, sizeof(uint8_t));
+  m_size = ReadPrimitiveFromPos<uint64_t>(m_reader, sizeof(uint8_t) + sizeof(uint32_t));
+  if (m_blockSize == 0)
+    MYTHROW(Reader::ReadException, ("Zero block size."));
+
+  uint64_t const blocksCount = (m_size + m_blockSize - 1) / m_blockSize;
+  m_offsets.resize(static_cast<size_t>(blocksCount + 1));
+  m_reader.Read(kHeaderSize, m_offsets.data(), m_offsets.size() * sizeof(uint32_t));
+  for (auto & offset : m_offsets)
+    offset = SwapIfBigEndianMacroBased(offset);
+
+  if (!is_sorted(m_offsets.begin(), m_offsets.end()))
+    MYTHROW(Reader::ReadException, ("Compressed block offsets are not sorted."));
+
+  m_blocksOffset = kHeaderSize + m_offsets.size() * sizeof(uint32_t);
+  if (m_blocksOffset + m_offsets.back() > m_reader.Size())
+    MYTHROW(Reader::SizeException, ("Compressed section is truncated."));
+}
+
+void BlockCompressedReader::Section::Read(uint64_t pos, void * p, size_t size)
+{
+  ASSERT_LESS_OR_EQUAL(pos + size, m_size, ());
+
+  auto * out = static_cast<uint8_t *>(p);
+  lock_guard<mutex> lock(m_mutex);
+  while (size != 0)
+  {
+    auto const index = static_cast<size_t>(pos / m_blockSize);
+    auto const offset = static_cast<size_t>(pos % m_blockSize);
+    auto const & block = GetBlock(index);
+    ASSERT_LESS(offset, block.size(), (pos, index));
+
+    size_t const n = min(size, block.size() - offset);
+    memcpy(out, block.data() + offset, n);
+    out += n;
+    pos += n;
+    size -= n;
+  }
+}
+
+vector<uint8_t> const & BlockCompressedReader::Section::GetBlock(size_t index)
+{
+  ASSERT_LESS(index + 1, m_offsets.size(), ());
+
+  bool found = false;
+  auto & block = m_cache.Find(index, found);
+  if (found)
+    return block;
+
+  // A block which isn't decoded is removed from the cache, otherwise the next Read()
+  // would find it empty.
+  try
+  {
+    m_buffer.resize(m_offsets[index + 1] - m_offsets[index]);
+    m_reader.Read(m_blocksOffset + m_offsets[index], m_buffer.data(), m_buffer.size());
+
+    block.reserve(m_blockSize);
+    ZLib::Inflate const inflate(ZLib::Inflate::Format::ZLib);
+    if (!inflate(m_buffer.data(), m_buffer.size(), back_inserter(block)))
+      MYTHROW(Reader::ReadException, ("Can't decompress block", index, "of", m_reader.GetName()));
+
+    // All blocks but the last one are full, so Read() never goes past the end of a block.
+    uint64_t const expectedSize = min<uint64_t>(m_blockSize, m_size - index * uint64_t{m_blockSize});
+    if (block.size() != expectedSize)
+    {
+      MYTHROW(Reader::ReadException, ("Wrong size of block", index, "of", m_reader.GetName(), ":",
+                                      block.size(), "instead of", expectedSize));
+    }
+  }
+  catch (...)
+  {
+    m_cache.Erase(index);
+    throw;
+  }
+  return block;
+}
+
+// BlockCompressedReader ---------------------------------------------------------------------------
+BlockCompressedReader::BlockCompressedReader(ModelReaderPtr const & section, size_t cacheSize)
+  : ModelReader(section.GetName())
+  , m_section(make_shared<Section>(section, cacheSize))
+  , m_offset(0)
+  , m_size(m_section->GetSize())
+{
+}
+
+BlockCompressedReader::BlockCompressedReader(shared_ptr<Section> const & section,
+                                             string const & name, uint64_t offset, uint64_t size)
+  : ModelReader(name), m_section(section), m_offset(offset), m_size(size)
+{
+}
+
+void BlockCompressedReader::Read(uint64_t pos, void * p, size_t size) const
+{
+  if (pos + size > m_size)
+    MYTHROW(Reader::SizeException, (pos, size, m_size));
+  m_section->Read(m_offset + pos, p, size);
+}
+
+unique_ptr<Reader> BlockCompressedReader::CreateSubReader(uint64_t pos, uint64_t size) const
+{
+  if (pos + size > m_size)
+    MYTHROW(Reader::SizeException, (pos, size, m_size));
+  return unique_ptr<Reader>(new BlockCompressedReader(m_section, GetName(), m_offset + pos, size));
+}
+}  // namespace coding
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/lru_cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace coding
+{
+// Section data split into blocks which are compressed by zlib independently, so
+// a random access read decompresses only the blocks it touches.
+//
+// Format (all numbers are little-endian):
+//   uint8_t  version
+//   uint32_t block size, all blocks but the last one have this size when decompressed
+//   uint64_t decompressed size
+//   uint32_t offsets[blocks count + 1] of compressed blocks from the beginning of the first one
+//   compressed blocks
+class BlockCompressedSection
+{
+public:
+  enum class Version : uint8_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  static uint32_t constexpr kDefaultBlockSize = 16 * 1024;
+
+  // Writes all the data of |reader| to |writer|.
+  static void Write(Reader const & reader, Writer & writer,
+                    uint32_t blockSize = kDefaultBlockSize);
+};
+
+// Reader of the decompressed data of a section in BlockCompressedSection format.
+// Sub-readers share the section index and the cache of decompressed blocks, which
+// is protected by a mutex, so different sub-readers may be used from different threads.
+class BlockCompressedReader : public ModelReader
+{
+public:
+  // Number of decompressed blocks kept in memory for a section.
+  static size_t constexpr kDefaultCacheSize = 8;
+
+  explicit BlockCompressedReader(ModelReaderPtr const & section,
+                                 size_t cacheSize = kDefaultCacheSize);
+
+  // Reader overrides:
+  uint64_t Size() const override { return m_size; }
+  void Read(uint64_t pos, void * p, size_t size) const override;
+  std::unique_ptr<Reader> CreateSubReader(uint64_t pos, uint64_t size) const override;
+
+private:
+  class Section
+  {
+  public:
+    Section(ModelReaderPtr const & section, size_t cacheSize);
+
+    uint64_t GetSize() const { return m_size; }
+    void Read(uint64_t pos, void * p, size_t size);
+
+  private:
+    std::vector<uint8_t> const & GetBlock(size_t index);
+
+    ModelReaderPtr m_reader;
+    uint32_t m_blockSize = 0;
+    uint64_t m_size = 0;
+    uint64_t m_blocksOffset = 0;
+    std::vector<uint32_t> m_offsets;
+
+    std::mutex m_mutex;
+    LruCache<size_t, std::vector<uint8_t>> m_cache;
+    std::vector<uint8_t> m_buffer;
+  };
+
+  BlockCompressedReader(std::shared_ptr<Section> const & section, std::string const & name,
+                        uint64_t offset, uint64_t size);
+
+  std::shared_ptr<Section> m_section;
+  uint64_t m_offset;
+  uint64_t m_size;
+};
+}  // namespace coding
@@ -0,0 +1,94 @@
+#include "testing/testing.hpp"
+
+#include "coding/block_compressed_section.hpp"
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace coding;
+using namespace std;
+
+namespace
+{
+string const kFileName = "block_compressed_section.tmp";
+
+vector<uint8_t> MakeData(size_t size)
+{
+  vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(i * 7 % 251);
+  return data;
+}
+
+void WriteSection(vector<uint8_t> const & section)
+{
+  FileWriter writer(kFileName);
+  writer.Write(section.data(), section.size());
+}
+
+vector<uint8_t> BuildSection(vector<uint8_t> const & data, uint32_t blockSize)
+{
+  vector<uint8_t> section;
+  MemWriter<vector<uint8_t>> writer(section);
+  BlockCompressedSection::Write(MemReader(data.data(), data.size()), writer, blockSize);
+  return section;
+}
+
+// Offset of the decompressed size in the section header.
+size_t constexpr kSizeOffset = sizeof(uint8_t) + sizeof(uint32_t);
+}  // namespace
+
+UNIT_TEST(BlockCompressedSection_Smoke)
+{
+  SCOPE_GUARD(deleteFile, [&]() { FileWriter::DeleteFileX(kFileName); });
+
+  auto const data = MakeData(1000);
+  WriteSection(BuildSection(data, 64 /* blockSize */));
+
+  BlockCompressedReader reader(make_unique<FileReader>(kFileName), 2 /* cacheSize */);
+  TEST_EQUAL(reader.Size(), data.size(), ());
+
+  vector<uint8_t> actual(data.size());
+  reader.Read(0, actual.data(), actual.size());
+  TEST_EQUAL(actual, data, ());
+
+  // Reads across block boundaries from a sub-reader.
+  auto const subReader = reader.CreateSubReader(100, 500);
+  actual.resize(300);
+  subReader->Read(50, actual.data(), actual.size());
+  TEST_EQUAL(actual, vector<uint8_t>(data.begin() + 150, data.begin() + 450), ());
+
+  TEST_ANY_THROW(reader.Read(990, actual.data(), 20), ());
+}
+
+UNIT_TEST(BlockCompressedSection_WrongBlockSize)
+{
+  SCOPE_GUARD(deleteFile, [&]() { FileWriter::DeleteFileX(kFileName); });
+
+  // The header claims the last block is full, but it is decompressed to 36 bytes.
+  auto const data = MakeData(100);
+  auto section = BuildSection(data, 64 /* blockSize */);
+  uint64_t const wrongSize = 128;
+  for (size_t i = 0; i < sizeof(wrongSize); ++i)
+    section[kSizeOffset + i] = static_cast<uint8_t>(wrongSize >> (8 * i));
+  WriteSection(section);
+
+  BlockCompressedReader reader(make_unique<FileReader>(kFileName));
+  TEST_EQUAL(reader.Size(), wrongSize, ());
+
+  vector<uint8_t> actual(64);
+  reader.Read(0, actual.data(), actual.size());
+  TEST_EQUAL(actual, vector<uint8_t>(data.begin(), data.begin() + 64), ());
+
+  TEST_ANY_THROW(reader.Read(120, actual.data(), 8), ());
+  // The broken block isn't cached.
+  TEST_ANY_THROW(reader.Read(64, actual.data(), 8), ());
+}
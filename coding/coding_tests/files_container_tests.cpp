@@ -9,9 +9,12 @@
 
 #include "std/target_os.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 
 #ifndef OMIM_OS_WINDOWS
 #include <unistd.h>  // _SC_PAGESIZE
@@ -379,3 +382,54 @@ UNIT_TEST(FilesMappingContainer_PageSize)
 
   FileWriter::DeleteFileX(fName);
 }
+
+UNIT_TEST(FilesContainer_CompressSections)
+{
+  string const fName = "files_container.tmp";
+  SCOPE_GUARD(deleteFile, bind(&FileWriter::DeleteFileX, fName));
+
+  // Compressible data of a few blocks with the last one incomplete.
+  uint32_t const blockSize = 1024;
+  vector<uint8_t> data;
+  for (uint32_t i = 0; i < 5 * blockSize + 100; ++i)
+    data.push_back(static_cast<uint8_t>((i / 3) % 7));
+
+  {
+    FilesContainerW writer(fName);
+    writer.Write(data, "raw");
+    writer.Write(data, "packed");
+    writer.Write(vector<uint8_t>{1, 2, 3}, "small");
+  }
+
+  FilesContainerW(fName, FileWriter::OP_WRITE_EXISTING)
+      .CompressSections([](string const & tag) { return tag != "raw"; }, blockSize);
+
+  FilesContainerR reader(fName);
+  TEST(reader.IsExist("raw"), ());
+  TEST(reader.IsExist("packed"), ());
+  TEST(reader.IsExist("small"), ());
+  TEST(!reader.IsExist("none"), ());
+  TEST_LESS(reader.GetAbsoluteOffsetAndSize(FilesContainerR::GetCompressedTag("packed")).second,
+            data.size() / 2, ());
+
+  for (string const tag : {"raw", "packed"})
+  {
+    auto const r = reader.GetReader(tag);
+    TEST_EQUAL(r.Size(), data.size(), (tag));
+
+    vector<uint8_t> actual(data.size());
+    r.Read(0, actual.data(), actual.size());
+    TEST_EQUAL(actual, data, (tag));
+
+    // Reads crossing block boundaries from a sub-reader.
+    uint64_t const offset = blockSize - 10;
+    auto const sub = r.SubReader(offset, 2 * blockSize + 20);
+    actual.assign(2 * blockSize, 0);
+    sub.Read(5, actual.data(), actual.size());
+    TEST(equal(actual.begin(), actual.end(), data.begin() + offset + 5), (tag));
+  }
+
+  vector<uint8_t> small(3);
+  reader.GetReader("small").Read(0, small.data(), small.size());
+  TEST_EQUAL(small, vector<uint8_t>({1, 2, 3}), ());
+}
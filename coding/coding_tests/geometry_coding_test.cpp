@@ -1,4 +1,5 @@
 #include "testing/testing.hpp"
+#include "testing/benchmark.hpp"
 
 #include "coding/byte_stream.hpp"
 #include "coding/coding_tests/test_polylines.hpp"
@@ -16,6 +17,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <random>
 #include <vector>
 
 using namespace coding;
@@ -132,6 +134,23 @@ UNIT_TEST(PredictPointsInTriangle)
   TEST_EQUAL(PU(10, 10), PredictPointInTriangle(PD(10, 10), PU(8, 7), PU(6, 5), PU(1, 1)), ());
 }
 
+UNIT_TEST(PredictPoints_IntegerMatchesDouble)
+{
+  minstd_rand rng(0);
+  uniform_int_distribution<uint32_t> coord(0, 1 << 30);
+  for (size_t i = 0; i < 100000; ++i)
+  {
+    PU const maxPoint(coord(rng), coord(rng));
+    PU const p1(coord(rng), coord(rng));
+    PU const p2(coord(rng), coord(rng));
+    PU const p3(coord(rng), coord(rng));
+    TEST_EQUAL(PredictPointInPolyline(maxPoint, p1, p2),
+               PredictPointInPolyline(PD(maxPoint), p1, p2), (maxPoint, p1, p2));
+    TEST_EQUAL(PredictPointInTriangle(maxPoint, p1, p2, p3),
+               PredictPointInTriangle(PD(maxPoint), p1, p2, p3), (maxPoint, p1, p2, p3));
+  }
+}
+
 /*
 UNIT_TEST(PredictPointsInPolyline3_Square)
 {
@@ -190,3 +209,24 @@ UNIT_TEST(DecodeEncodePolyline_DataSet1)
 
   TestPolylineEncode("DataSet1", points, GetMaxPoint(), &EncodePolyline, &DecodePolyline);
 }
+
+BENCHMARK_TEST(DecodePolyline)
+{
+  size_t const count = ARRAY_SIZE(geometry_coding_tests::arr1);
+  vector<m2::PointU> points;
+  points.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    points.push_back(D2U(geometry_coding_tests::arr1[i]));
+
+  vector<uint64_t> deltas(count);
+  OutDeltasT deltasA(deltas);
+  EncodePolyline(make_read_adapter(points), m2::PointU::Zero(), GetMaxPoint(), deltasA);
+
+  vector<m2::PointU> decoded(count);
+  BENCHMARK_N_TIMES(IF_DEBUG_ELSE(100, 10000), 1.0)
+  {
+    OutPointsT decodedA(decoded);
+    DecodePolyline(make_read_adapter(deltas), m2::PointU::Zero(), GetMaxPoint(), decodedA);
+  }
+  TEST_EQUAL(decoded, points, ());
+}
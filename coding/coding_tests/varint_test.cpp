@@ -3,9 +3,13 @@
 
 #include "coding/byte_stream.hpp"
 
+#include "testing/benchmark.hpp"
+
 #include "base/macros.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <cstdint>
+#include <random>
 #include <vector>
 
 using namespace std;
@@ -181,3 +185,56 @@ UNIT_TEST(ReadVarInt64Array)
   }
 }
 
+UNIT_TEST(ReadVarUint64Array_MixedLengths)
+{
+  // Values of all varint lengths from 1 to 10 bytes in random order, so the word-at-a-time
+  // decoding meets every combination of varint boundaries within a word.
+  minstd_rand rng(0);
+  vector<uint64_t> values;
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    auto const bits = uniform_int_distribution<uint32_t>(0, 64)(rng);
+    auto const value = uniform_int_distribution<uint64_t>()(rng);
+    values.push_back(bits == 0 ? 0 : value >> (64 - bits));
+  }
+
+  vector<uint8_t> data;
+  {
+    PushBackByteSink<vector<uint8_t>> dst(data);
+    for (auto const v : values)
+      WriteVarUint(dst, v);
+  }
+
+  for (size_t size : {size_t{0}, size_t{1}, size_t{7}, size_t{8}, size_t{100}, values.size()})
+  {
+    vector<uint64_t> expected;
+    void const * pExpectedEnd =
+        ReadVarUint64Array(data.data(), size, base::MakeBackInsertFunctor(expected));
+
+    vector<uint64_t> result;
+    void const * pEnd =
+        ReadVarUint64Array(data.data(), pExpectedEnd, base::MakeBackInsertFunctor(result));
+    TEST_EQUAL(pEnd, pExpectedEnd, (size));
+    TEST_EQUAL(result, expected, (size));
+    TEST(equal(result.begin(), result.end(), values.begin()), (size));
+  }
+}
+
+BENCHMARK_TEST(ReadVarUint64Array)
+{
+  // Deltas of encoded geometry take 1-6 bytes, 4 bytes on average.
+  minstd_rand rng(0);
+  vector<uint8_t> data;
+  {
+    PushBackByteSink<vector<uint8_t>> dst(data);
+    for (size_t i = 0; i < 10000; ++i)
+      WriteVarUint(dst, uint64_t{1} << uniform_int_distribution<uint32_t>(0, 40)(rng));
+  }
+
+  uint64_t sum = 0;
+  BENCHMARK_N_TIMES(IF_DEBUG_ELSE(100, 10000), 1.0)
+  {
+    ReadVarUint64Array(data.data(), data.data() + data.size(), [&sum](uint64_t v) { sum += v; });
+  }
+  FORCE_USE_VALUE(sum);
+}
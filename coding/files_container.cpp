@@ -1,5 +1,6 @@
 #include "coding/files_container.hpp"
 
+#include "coding/block_compressed_section.hpp"
 #include "coding/internal/file_data.hpp"
 #include "coding/read_write_utils.hpp"
 #include "coding/varint.hpp"
@@ -86,7 +87,13 @@ FilesContainerR::TReader FilesContainerR::GetReader(Tag const & tag) const
 {
   TagInfo const * p = GetInfo(tag);
   if (!p)
-    MYTHROW(Reader::OpenException, ("Can't find section:", GetFileName(), tag));
+  {
+    p = GetInfo(GetCompressedTag(tag));
+    if (!p)
+      MYTHROW(Reader::OpenException, ("Can't find section:", GetFileName(), tag));
+    return std::make_unique<coding::BlockCompressedReader>(
+        m_source.SubReader(p->m_offset, p->m_size));
+  }
   return m_source.SubReader(p->m_offset, p->m_size);
 }
 
@@ -383,6 +390,37 @@ void FilesContainerW::DeleteSection(Tag const & tag)
   Open(FileWriter::OP_WRITE_EXISTING);
 }
 
+void FilesContainerW::CompressSections(std::function<bool(Tag const &)> const & isCompressed,
+                                       uint32_t blockSize)
+{
+  {
+    // rewrite files on disk
+    FilesContainerR contR(m_name);
+    FilesContainerW contW(m_name + ".tmp");
+
+    for (size_t i = 0; i < m_info.size(); ++i)
+    {
+      Tag const & tag = m_info[i].m_tag;
+      if (isCompressed(tag))
+      {
+        auto writer = contW.GetWriter(GetCompressedTag(tag));
+        coding::BlockCompressedSection::Write(*contR.GetReader(tag).GetPtr(), *writer, blockSize);
+      }
+      else
+      {
+        contW.Write(contR.GetReader(tag), tag);
+      }
+    }
+  }
+
+  // swap files
+  if (!base::DeleteFileX(m_name) || !base::RenameFileX(m_name + ".tmp", m_name))
+    MYTHROW(RootException, ("Can't rename file", m_name, "Sharing violation or disk error!"));
+
+  // do open to update m_info
+  Open(FileWriter::OP_WRITE_EXISTING);
+}
+
 std::unique_ptr<FilesContainerWriter> FilesContainerW::GetWriter(Tag const & tag)
 {
   ASSERT(!m_finished, ());
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,7 +39,17 @@ public:
 
   bool IsExist(Tag const & tag) const
   {
-    return GetInfo(tag) != 0;
+    return GetInfo(tag) != 0 || GetInfo(GetCompressedTag(tag)) != 0;
+  }
+
+  /// Tag of the section |tag| stored in coding::BlockCompressedSection format.
+  /// FilesContainerR::GetReader(|tag|) decompresses such sections transparently,
+  /// while they can't be mapped to memory.
+  static Tag GetCompressedTag(Tag const & tag) { return tag + ".zblk"; }
+
+  bool IsCompressed(Tag const & tag) const
+  {
+    return GetInfo(tag) == 0 && GetInfo(GetCompressedTag(tag)) != 0;
   }
 
   template <typename ToDo>
@@ -257,6 +268,11 @@ public:
   /// @precondition Container should be opened with FileWriter::OP_WRITE_EXISTING.
   void DeleteSection(Tag const & tag);
 
+  /// Rewrites sections for which |isCompressed| returns true in coding::BlockCompressedSection
+  /// format with rewriting file.
+  /// @precondition Container should be opened with FileWriter::OP_WRITE_EXISTING.
+  void CompressSections(std::function<bool(Tag const &)> const & isCompressed, uint32_t blockSize);
+
   std::string const & GetFileName() const { return m_name; }
 
 private:
@@ -64,13 +64,6 @@ uint64_t EncodePointDeltaAsUint(m2::PointU const & actual, m2::PointU const & pr
       bits::ZigZagEncode(static_cast<int32_t>(actual.y) - static_cast<int32_t>(prediction.y)));
 }
 
-m2::PointU DecodePointDeltaFromUint(uint64_t delta, m2::PointU const & prediction)
-{
-  uint32_t x, y;
-  bits::BitwiseSplit(delta, x, y);
-  return m2::PointU(prediction.x + bits::ZigZagDecode(x), prediction.y + bits::ZigZagDecode(y));
-}
-
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2, m2::PointU const & p3)
 {
@@ -138,11 +131,10 @@ void EncodePolylinePrev2(InPointsT const & points, m2::PointU const & basePoint,
     deltas.push_back(EncodePointDeltaAsUint(points[0], basePoint));
     if (count > 1)
     {
-      m2::PointD const maxPointD(maxPoint);
       deltas.push_back(EncodePointDeltaAsUint(points[1], points[0]));
       for (size_t i = 2; i < count; ++i)
         deltas.push_back(EncodePointDeltaAsUint(
-            points[i], PredictPointInPolyline(maxPointD, points[i - 1], points[i - 2])));
+            points[i], PredictPointInPolyline(maxPoint, points[i - 1], points[i - 2])));
     }
   }
 
@@ -152,22 +144,10 @@ void EncodePolylinePrev2(InPointsT const & points, m2::PointU const & basePoint,
 void DecodePolylinePrev2(InDeltasT const & deltas, m2::PointU const & basePoint,
                          m2::PointU const & maxPoint, OutPointsT & points)
 {
+  PolylineDecoder decoder(basePoint, maxPoint);
   size_t const count = deltas.size();
-  if (count > 0)
-  {
-    points.push_back(DecodePointDeltaFromUint(deltas[0], basePoint));
-    if (count > 1)
-    {
-      m2::PointD const maxPointD(maxPoint);
-      points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
-      for (size_t i = 2; i < count; ++i)
-      {
-        size_t const n = points.size();
-        points.push_back(DecodePointDeltaFromUint(
-            deltas[i], PredictPointInPolyline(maxPointD, points[n - 1], points[n - 2])));
-      }
-    }
-  }
+  for (size_t i = 0; i < count; ++i)
+    points.push_back(decoder(deltas[i]));
 }
 
 void EncodePolylinePrev3(InPointsT const & points, m2::PointU const & basePoint,
@@ -186,7 +166,7 @@ void EncodePolylinePrev3(InPointsT const & points, m2::PointU const & basePoint,
       if (count > 2)
       {
         m2::PointD const maxPointD(maxPoint);
-        m2::PointU const prediction = PredictPointInPolyline(maxPointD, points[1], points[0]);
+        m2::PointU const prediction = PredictPointInPolyline(maxPoint, points[1], points[0]);
         deltas.push_back(EncodePointDeltaAsUint(points[2], prediction));
         for (size_t i = 3; i < count; ++i)
         {
@@ -219,7 +199,7 @@ void DecodePolylinePrev3(InDeltasT const & deltas, m2::PointU const & basePoint,
       {
         m2::PointD const maxPointD(maxPoint);
         points.push_back(DecodePointDeltaFromUint(
-            deltas[2], PredictPointInPolyline(maxPointD, points.back(), pt0)));
+            deltas[2], PredictPointInPolyline(maxPoint, points.back(), pt0)));
         for (size_t i = 3; i < count; ++i)
         {
           size_t const n = points.size();
@@ -256,11 +236,10 @@ void EncodeTriangleStrip(InPointsT const & points, m2::PointU const & basePoint,
     deltas.push_back(EncodePointDeltaAsUint(points[1], points[0]));
     deltas.push_back(EncodePointDeltaAsUint(points[2], points[1]));
 
-    m2::PointD const maxPointD(maxPoint);
     for (size_t i = 3; i < count; ++i)
     {
       m2::PointU const prediction = PredictPointInTriangle(
-            maxPointD, points[i - 1], points[i - 2], points[i - 3]);
+            maxPoint, points[i - 1], points[i - 2], points[i - 3]);
       deltas.push_back(EncodePointDeltaAsUint(points[i], prediction));
     }
   }
@@ -278,12 +257,11 @@ void DecodeTriangleStrip(InDeltasT const & deltas, m2::PointU const & basePoint,
     points.push_back(DecodePointDeltaFromUint(deltas[1], points.back()));
     points.push_back(DecodePointDeltaFromUint(deltas[2], points.back()));
 
-    m2::PointD const maxPointD(maxPoint);
     for (size_t i = 3; i < count; ++i)
     {
       size_t const n = points.size();
       m2::PointU const prediction = PredictPointInTriangle(
-            maxPointD, points[n - 1], points[n - 2], points[n - 3]);
+            maxPoint, points[n - 1], points[n - 2], points[n - 3]);
       points.push_back(DecodePointDeltaFromUint(deltas[i], prediction));
     }
   }
@@ -378,6 +356,19 @@ void const * LoadInner(DecodeFunT fn, void const * pBeg, size_t count,
   return ret;
 }
 
+void const * LoadInnerPath(void const * pBeg, size_t count, GeometryCodingParams const & params,
+                           OutPointsT & points)
+{
+  // Points are decoded right from varints, see LoadInner() for the general case.
+  if (points.size() < 2)
+    points.reserve(count);
+  coding::PolylineDecoder decoder(pts::GetBasePoint(params), pts::GetMaxPoint(params));
+  uint8_t const coordBits = params.GetCoordBits();
+  return ReadVarUint64Array(pBeg, count, [&](uint64_t delta) {
+    points.push_back(pts::U2D(decoder(delta), coordBits));
+  });
+}
+
 TrianglesChainSaver::TrianglesChainSaver(GeometryCodingParams const & params)
 {
   m_base = pts::GetBasePoint(params);
@@ -456,8 +447,6 @@ void DecodeTriangles(coding::InDeltasT const & deltas, m2::PointU const & basePo
   size_t const count = deltas.size();
   ASSERT_GREATER(count, 2, ());
 
-  m2::PointD const maxPointD(maxPoint);
-
   points.push_back(coding::DecodePointDeltaFromUint(deltas[0], basePoint));
   points.push_back(coding::DecodePointDeltaFromUint(deltas[1], points.back()));
   points.push_back(coding::DecodePointDeltaFromUint(deltas[2] >> 2, points.back()));
@@ -505,7 +494,7 @@ void DecodeTriangles(coding::InDeltasT const & deltas, m2::PointU const & basePo
     points.push_back(points[trg[0]]);
     points.push_back(points[trg[1]]);
     points.push_back(coding::DecodePointDeltaFromUint(deltas[i] >> 2, coding::PredictPointInTriangle(
-            maxPointD, points[trg[0]], points[trg[1]], points[trg[2]])));
+            maxPoint, points[trg[0]], points[trg[1]], points[trg[2]])));
 
     // next step
     treeBits = deltas[i] & 3;
@@ -13,6 +13,7 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <vector>
@@ -28,7 +29,13 @@ using OutDeltasT = array_write<uint64_t>;
 // It is not recommended to use this function: consider EncodePointDelta instead.
 uint64_t EncodePointDeltaAsUint(m2::PointU const & actual, m2::PointU const & prediction);
 
-m2::PointU DecodePointDeltaFromUint(uint64_t delta, m2::PointU const & prediction);
+// Inlined since it's called for every point of every decoded geometry.
+inline m2::PointU DecodePointDeltaFromUint(uint64_t delta, m2::PointU const & prediction)
+{
+  uint32_t x, y;
+  bits::BitwiseSplit(delta, x, y);
+  return m2::PointU(prediction.x + bits::ZigZagDecode(x), prediction.y + bits::ZigZagDecode(y));
+}
 
 // Writes the difference of two 2d vectors to sink.
 template <typename Sink>
@@ -55,6 +62,18 @@ m2::PointU DecodePointDelta(Source & source, m2::PointU const & base)
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2);
 
+/// Same as above but in integer arithmetic, the result is exactly the same.
+inline m2::PointU PredictPointInPolyline(m2::PointU const & maxPoint, m2::PointU const & p1,
+                                         m2::PointU const & p2)
+{
+  // p1 + (p1 - p2) / 2 == (3 * p1 - p2) / 2, truncated and clamped to [0, maxPoint].
+  auto const predict = [](uint32_t max, uint32_t c1, uint32_t c2) -> uint32_t {
+    int64_t const t = 3 * static_cast<int64_t>(c1) - c2;
+    return t < 0 ? 0 : static_cast<uint32_t>(std::min<int64_t>(t >> 1, max));
+  };
+  return {predict(maxPoint.x, p1.x, p2.x), predict(maxPoint.y, p1.y, p2.y)};
+}
+
 /// Predict next point for polyline with given previous points (p1, p2, p3).
 m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2, m2::PointU const & p3);
@@ -64,6 +83,18 @@ m2::PointU PredictPointInPolyline(m2::PointD const & maxPoint, m2::PointU const
 m2::PointU PredictPointInTriangle(m2::PointD const & maxPoint, m2::PointU const & p1,
                                   m2::PointU const & p2, m2::PointU const & p3);
 
+/// Same as above but in integer arithmetic, the result is exactly the same.
+inline m2::PointU PredictPointInTriangle(m2::PointU const & maxPoint, m2::PointU const & p1,
+                                         m2::PointU const & p2, m2::PointU const & p3)
+{
+  // Note. The sum is computed modulo 2^32 like m2::PointU::operator+() does.
+  auto const predict = [](uint32_t max, uint32_t c1, uint32_t c2, uint32_t c3) -> uint32_t {
+    int64_t const t = static_cast<int64_t>(static_cast<uint32_t>(c1 + c2)) - c3;
+    return t < 0 ? 0 : static_cast<uint32_t>(std::min<int64_t>(t, max));
+  };
+  return {predict(maxPoint.x, p1.x, p2.x, p3.x), predict(maxPoint.y, p1.y, p2.y, p3.y)};
+}
+
 void EncodePolylinePrev1(InPointsT const & points, m2::PointU const & basePoint,
                          m2::PointU const & maxPoint, OutDeltasT & deltas);
 
@@ -93,6 +124,34 @@ void EncodeTriangleStrip(InPointsT const & points, m2::PointU const & basePoint,
 
 void DecodeTriangleStrip(InDeltasT const & deltas, m2::PointU const & basePoint,
                          m2::PointU const & maxPoint, OutPointsT & points);
+
+/// Decodes points of a polyline encoded by EncodePolyline() one by one, so deltas
+/// may be consumed right from a varint stream without intermediate arrays.
+class PolylineDecoder
+{
+public:
+  PolylineDecoder(m2::PointU const & basePoint, m2::PointU const & maxPoint)
+    : m_maxPoint(maxPoint), m_p1(basePoint), m_p2(basePoint)
+  {
+  }
+
+  m2::PointU operator()(uint64_t delta)
+  {
+    m2::PointU const prediction =
+        m_count < 2 ? m_p1 : PredictPointInPolyline(m_maxPoint, m_p1, m_p2);
+    m_p2 = m_p1;
+    m_p1 = DecodePointDeltaFromUint(delta, prediction);
+    ++m_count;
+    return m_p1;
+  }
+
+private:
+  m2::PointU m_maxPoint;
+  // Last and previous to the last decoded points.
+  m2::PointU m_p1;
+  m2::PointU m_p2;
+  size_t m_count = 0;
+};
 }  // namespace coding
 
 namespace serial
@@ -236,13 +295,17 @@ void SaveOuter(EncodeFunT fn, std::vector<m2::PointD> const & points,
 void const * LoadInner(DecodeFunT fn, void const * pBeg, size_t count,
                        GeometryCodingParams const & params, OutPointsT & points);
 
+// Encoded outer geometry of the most of features fits into this buffer, so it is read without
+// heap allocations.
+using OuterBufferT = buffer_vector<char, 512>;
+
 template <class TSource, class TPoints>
 void LoadOuter(DecodeFunT fn, TSource & src, GeometryCodingParams const & params, TPoints & points,
                size_t reserveF = 1)
 {
   uint32_t const count = ReadVarUint<uint32_t>(src);
-  std::vector<char> buffer(count);
-  char * p = &buffer[0];
+  OuterBufferT buffer(count);
+  char * p = buffer.data();
   src.Read(p, count);
 
   DeltasT deltas;
@@ -267,16 +330,25 @@ void SaveOuterPath(std::vector<m2::PointD> const & points, GeometryCodingParams
   SaveOuter(&coding::EncodePolyline, points, params, sink);
 }
 
-inline void const * LoadInnerPath(void const * pBeg, size_t count,
-                                  GeometryCodingParams const & params, OutPointsT & points)
-{
-  return LoadInner(&coding::DecodePolyline, pBeg, count, params, points);
-}
+void const * LoadInnerPath(void const * pBeg, size_t count, GeometryCodingParams const & params,
+                           OutPointsT & points);
 
 template <class TSource, class TPoints>
 void LoadOuterPath(TSource & src, GeometryCodingParams const & params, TPoints & points)
 {
-  LoadOuter(&coding::DecodePolyline, src, params, points);
+  uint32_t const count = ReadVarUint<uint32_t>(src);
+  OuterBufferT buffer(count);
+  char * p = buffer.data();
+  src.Read(p, count);
+
+  // Points are decoded right from varints, see LoadOuter() for the general case.
+  if (points.size() < 2)
+    points.reserve(count / 2);
+  coding::PolylineDecoder decoder(pts::GetBasePoint(params), pts::GetMaxPoint(params));
+  uint8_t const coordBits = params.GetCoordBits();
+  ReadVarUint64Array(p, p + count, [&](uint64_t delta) {
+    points.push_back(pts::U2D(decoder(delta), coordBits));
+  });
 }
 
 /// @name Triangles.
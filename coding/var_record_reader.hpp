@@ -24,14 +24,31 @@ public:
     return buffer;
   }
 
+  // Appends the record at |pos| to |buffer|.
+  void ReadRecord(uint64_t const pos, std::vector<uint8_t> & buffer) const
+  {
+    ReaderSource source(m_reader);
+    ASSERT_LESS(pos, source.Size(), ());
+    source.Skip(pos);
+    uint32_t const recordSize = ReadVarUint<uint32_t>(source);
+    auto const offset = buffer.size();
+    buffer.resize(offset + recordSize);
+    source.Read(buffer.data() + offset, recordSize);
+  }
+
+  // Reads |size| raw bytes at |pos|, which may span several records.
+  void Read(uint64_t const pos, void * p, size_t size) const { m_reader.Read(pos, p, size); }
+
+  // |fn| may swap the record with another buffer, which is reused for the next record.
   template <class FnT> void ForEachRecord(FnT && fn) const
   {
     ReaderSource source(m_reader);
+    std::vector<uint8_t> buffer;
     while (source.Size() > 0)
     {
       auto const pos = source.Pos();
       uint32_t const recordSize = ReadVarUint<uint32_t>(source);
-      std::vector<uint8_t> buffer(recordSize);
+      buffer.resize(recordSize);
       source.Read(buffer.data(), recordSize);
       fn(static_cast<uint32_t>(pos), std::move(buffer));
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "coding/endianness.hpp"
 #include "coding/write_to_sink.hpp"
 
 #include "base/assert.hpp"
@@ -10,6 +11,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <type_traits>
 
 // Writes any unsigned integer type using optimal bytes count, platform-independent.
@@ -252,19 +255,70 @@ void const * ReadVarInt64Array(void const * pBeg, WhileConditionT whileCondition
   return p;
 }
 
+// Decodes varints of up to 8 bytes a machine word at a time while at least 8 bytes are left
+// before |pEnd|. Returns the position of the first varint which is not decoded: either a longer
+// one or one of the last 7 bytes.
+template <typename ConverterT, typename F>
+uint8_t const * ReadVarInt64ArrayWordwise(uint8_t const * p, uint8_t const * pEnd, F & f,
+                                          ConverterT & converter)
+{
+  uint64_t constexpr kStopBits = 0x8080808080808080ULL;
+  while (pEnd - p >= 8)
+  {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    word = SwapIfBigEndianMacroBased(word);
+
+    // The last byte of a varint is the first one with the high bit cleared.
+    uint64_t const stops = ~word & kStopBits;
+    if (stops == 0)
+      break;
+    uint64_t const mask = ((stops & (0 - stops)) << 1) - 1;
+
+    // Packs 7-bit groups of |mask| bytes together: pairs of bytes, then pairs of 14-bit
+    // groups, then pairs of 28-bit groups.
+    uint64_t x = word & mask & 0x7F7F7F7F7F7F7F7FULL;
+    x = ((x & 0x7F007F007F007F00ULL) >> 1) | (x & 0x007F007F007F007FULL);
+    x = ((x & 0x3FFF00003FFF0000ULL) >> 2) | (x & 0x00003FFF00003FFFULL);
+    x = ((x & 0x0FFFFFFF00000000ULL) >> 4) | (x & 0x000000000FFFFFFFULL);
+
+    f(converter(x));
+    // Sums up the lowest bits of |mask| bytes, that is the varint size.
+    p += ((mask & 0x0101010101010101ULL) * 0x0101010101010101ULL) >> 56;
+  }
+  return p;
 }
 
+template <typename ConverterT, typename F>
+void const * ReadVarInt64ArrayUntilEnd(void const * pBeg, void const * pEnd, F f,
+                                       ConverterT converter)
+{
+  uint8_t const * p = static_cast<uint8_t const *>(pBeg);
+  uint8_t const * const end = static_cast<uint8_t const *>(pEnd);
+  while (true)
+  {
+    p = ReadVarInt64ArrayWordwise(p, end, f, converter);
+    if (end - p < 8)
+      break;
+    // A varint longer than 8 bytes.
+    p = static_cast<uint8_t const *>(
+        ReadVarInt64Array(p, ReadVarInt64ArrayGivenSize(1), std::ref(f), converter));
+  }
+  return ReadVarInt64Array(p, ReadVarInt64ArrayUntilBufferEnd(pEnd), std::ref(f), converter);
+}
+}  // namespace impl
+
 template <typename F>
 void const * ReadVarInt64Array(void const * pBeg, void const * pEnd, F f)
 {
-  return ::impl::ReadVarInt64Array<int64_t (*)(uint64_t)>(
-        pBeg, ::impl::ReadVarInt64ArrayUntilBufferEnd(pEnd), f, &bits::ZigZagDecode);
+  return ::impl::ReadVarInt64ArrayUntilEnd<int64_t (*)(uint64_t)>(pBeg, pEnd, f,
+                                                                  &bits::ZigZagDecode);
 }
 
 template <typename F>
 void const * ReadVarUint64Array(void const * pBeg, void const * pEnd, F f)
 {
-  return ::impl::ReadVarInt64Array(pBeg, ::impl::ReadVarInt64ArrayUntilBufferEnd(pEnd), f, base::IdFunctor());
+  return ::impl::ReadVarInt64ArrayUntilEnd(pBeg, pEnd, f, base::IdFunctor());
 }
 
 template <typename F>
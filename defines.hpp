@@ -46,6 +46,7 @@
 #define ROUTING_FILE_TAG "routing"
 #define CROSS_MWM_FILE_TAG "cross_mwm"
 #define FEATURE_OFFSETS_FILE_TAG "offs"
+#define FEATURE_TYPES_FILE_TAG "types"
 #define SEARCH_RANKS_FILE_TAG "ranks"
 #define POPULARITY_RANKS_FILE_TAG "popularity"
 #define REGION_INFO_FILE_TAG "rgninfo"
@@ -60,6 +61,12 @@
 #define MAXSPEEDS_FILE_TAG "maxspeeds"
 #define ROUTING_WORLD_FILE_TAG "routing_world"
 
+// Sections stored block-compressed by the generator with --compress_sections, see
+// coding/block_compressed_section.hpp. Indexed tags like "geom0" match their base tag.
+// Sections which are required to be memory-mapped must not be listed here.
+#define COMPRESSED_SECTION_TAGS \
+  {FEATURES_FILE_TAG, GEOMETRY_FILE_TAG, TRIANGLE_FILE_TAG, SEARCH_INDEX_FILE_TAG}
+
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume"
 #define DOWNLOADING_FILE_EXTENSION ".downloading"
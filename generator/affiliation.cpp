@@ -3,18 +3,21 @@
 #include "platform/platform.hpp"
 
 #include "geometry/mercator.hpp"
+#include "geometry/rect_intersect.hpp"
 
+#include "base/logging.hpp"
 #include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
-
-#include "std/boost_geometry.hpp"
-#include <boost/geometry/geometries/register/ring.hpp>
-#include <boost/geometry/geometries/register/point.hpp>
-
-BOOST_GEOMETRY_REGISTER_POINT_2D(m2::PointD, double, boost::geometry::cs::cartesian, x, y)
-BOOST_GEOMETRY_REGISTER_RING(std::vector<m2::PointD>)
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace feature
 {
@@ -100,70 +103,13 @@ std::vector<std::string> GetAffiliations(T const & t,
 }
 
 // An implementation for CountriesFilesIndexAffiliation class.
-using IndexSharedPtr = std::shared_ptr<CountriesFilesIndexAffiliation::Tree>;
-
-CountriesFilesIndexAffiliation::Box MakeBox(m2::RectD const & rect)
-{
-  return {rect.LeftBottom(), rect.RightTop()};
-}
-
-std::optional<std::string> IsOneCountryForLimitRect(m2::RectD const & limitRect,
-                                                    IndexSharedPtr const & index)
-{
-  borders::CountryPolygons const * country = nullptr;
-  std::vector<CountriesFilesIndexAffiliation::Value> values;
-  auto const bbox = MakeBox(limitRect);
-  boost::geometry::index::query(*index, boost::geometry::index::covers(bbox),
-                                std::back_inserter(values));
-  for (auto const & v : values)
-  {
-    for (borders::CountryPolygons const & c : v.second)
-    {
-      if (!country)
-        country = &c;
-      else if (country != &c)
-        return {};
-    }
-  }
-  return country ? country->GetName() : std::optional<std::string>{};
-}
+using Countries = std::vector<borders::CountryPolygons const *>;
 
-template <typename T>
-std::vector<std::string> GetHonestAffiliations(T && t, IndexSharedPtr const & index)
+void SortByNames(Countries & countries)
 {
-  std::vector<std::string> affiliations;
-  std::unordered_set<borders::CountryPolygons const *> countires;
-  ForEachPoint(t, [&](auto const & point) {
-    std::vector<CountriesFilesIndexAffiliation::Value> values;
-    boost::geometry::index::query(*index, boost::geometry::index::covers(point),
-                                  std::back_inserter(values));
-    for (auto const & v : values)
-    {
-      if (v.second.size() == 1)
-      {
-        borders::CountryPolygons const & cp = v.second.front();
-        if (countires.insert(&cp).second)
-          affiliations.emplace_back(cp.GetName());
-      }
-      else
-      {
-        for (borders::CountryPolygons const & cp : v.second)
-        {
-          if (cp.Contains(point) && countires.insert(&cp).second)
-            affiliations.emplace_back(cp.GetName());
-        }
-      }
-    }
+  std::sort(countries.begin(), countries.end(), [](auto const * lhs, auto const * rhs) {
+    return lhs->GetName() < rhs->GetName();
   });
-
-  return affiliations;
-}
-
-template <typename T>
-std::vector<std::string> GetAffiliations(T && t, IndexSharedPtr const & index)
-{
-  auto const oneCountry = IsOneCountryForLimitRect(GetLimitRect(t), index);
-  return oneCountry ? std::vector<std::string>{*oneCountry} : GetHonestAffiliations(t, index);
 }
 }  // namespace affiliation
 
@@ -189,113 +135,277 @@ bool CountriesFilesAffiliation::HasCountryByName(std::string const & name) const
   return m_countryPolygonsTree.HasRegionByName(name);
 }
 
+// CountriesFilesIndexAffiliation::Grid ------------------------------------------------------------
+class CountriesFilesIndexAffiliation::Grid
+{
+  using Countries = affiliation::Countries;
+
+public:
+  explicit Grid(borders::CountryPolygonsCollection const & countryPolygonsTree)
+    : m_width(static_cast<size_t>(std::ceil((mercator::Bounds::kMaxX - mercator::Bounds::kMinX) / kCellSize)))
+    , m_height(static_cast<size_t>(std::ceil((mercator::Bounds::kMaxY - mercator::Bounds::kMinY) / kCellSize)))
+    , m_cells(m_width * m_height)
+  {
+    Countries countries;
+    countryPolygonsTree.ForEachCountryInRect(mercator::Bounds::FullRect(),
+                                             [&](borders::CountryPolygons const & country) {
+      countries.emplace_back(&country);
+    });
+    // Countries of cells are kept in the order of names.
+    affiliation::SortByNames(countries);
+
+    std::vector<std::vector<Mark>> countriesMarks(countries.size());
+    {
+      base::thread_pool::computational::ThreadPool pool(GetPlatform().CpuCores());
+      for (size_t i = 0; i < countries.size(); ++i)
+        pool.SubmitWork([&, i]() { countriesMarks[i] = MarkCells(*countries[i]); });
+    }
+
+    std::vector<std::tuple<uint32_t, uint32_t, bool>> marks;
+    for (uint32_t i = 0; i < countriesMarks.size(); ++i)
+    {
+      for (auto const & mark : countriesMarks[i])
+        marks.emplace_back(mark.m_cell, i, mark.m_inside);
+    }
+    std::sort(marks.begin(), marks.end());
+
+    // Equal cells share an entry, the 0th entry is for cells without countries.
+    std::map<Cell, uint32_t> ids;
+    ids.emplace(Cell(), 0);
+    m_entries.emplace_back();
+    for (size_t i = 0; i < marks.size();)
+    {
+      auto const cellIndex = std::get<0>(marks[i]);
+      Cell cell;
+      for (; i < marks.size() && std::get<0>(marks[i]) == cellIndex; ++i)
+      {
+        auto const * country = countries[std::get<1>(marks[i])];
+        if (std::get<2>(marks[i]))
+          cell.m_inside.emplace_back(country);
+        else
+          cell.m_crossing.emplace_back(country);
+      }
+
+      auto const it = ids.emplace(std::move(cell), static_cast<uint32_t>(m_entries.size())).first;
+      if (it->second == m_entries.size())
+        m_entries.emplace_back(it->first);
+      m_cells[cellIndex] = it->second;
+    }
+  }
+
+  template <typename T>
+  std::vector<std::string> GetAffiliations(T const & t) const
+  {
+    // A feature within cells of the same entry without crossing countries needs no exact checks.
+    auto const rect = affiliation::GetLimitRect(t);
+    auto const minX = GetX(rect.minX());
+    auto const maxX = GetX(rect.maxX());
+    auto const minY = GetY(rect.minY());
+    auto const maxY = GetY(rect.maxY());
+    if ((maxX - minX + 1) * (maxY - minY + 1) <= kMaxCellsForRect)
+    {
+      auto const id = m_cells[minY * m_width + minX];
+      bool same = m_entries[id].m_crossing.empty();
+      for (size_t y = minY; y <= maxY && same; ++y)
+      {
+        for (size_t x = minX; x <= maxX && same; ++x)
+          same = m_cells[y * m_width + x] == id;
+      }
+
+      if (same)
+      {
+        std::vector<std::string> affiliations;
+        for (auto const * country : m_entries[id].m_inside)
+          affiliations.emplace_back(country->GetName());
+        return affiliations;
+      }
+    }
+
+    std::vector<std::string> affiliations;
+    Countries found;
+    auto const add = [&](borders::CountryPolygons const * country) {
+      if (std::find(found.cbegin(), found.cend(), country) != found.cend())
+        return;
+      found.emplace_back(country);
+      affiliations.emplace_back(country->GetName());
+    };
+    affiliation::ForEachPoint(t, [&](auto const & point) {
+      auto const & cell = m_entries[m_cells[GetY(point.y) * m_width + GetX(point.x)]];
+      for (auto const * country : cell.m_inside)
+        add(country);
+      for (auto const * country : cell.m_crossing)
+      {
+        if (country->Contains(point))
+          add(country);
+      }
+    });
+    return affiliations;
+  }
+
+private:
+  // Size of a cell in mercator units. The world is 1800x1800 cells.
+  static double constexpr kCellSize = 0.2;
+  // Limit rects of bigger features aren't checked for being inside of same cells.
+  static size_t constexpr kMaxCellsForRect = 64;
+
+  struct Cell
+  {
+    bool operator<(Cell const & rhs) const
+    {
+      return std::tie(m_inside, m_crossing) < std::tie(rhs.m_inside, rhs.m_crossing);
+    }
+
+    // Countries which cover the cell completely.
+    Countries m_inside;
+    // Countries whose borders cross the cell.
+    Countries m_crossing;
+  };
+
+  struct Mark
+  {
+    uint32_t m_cell;
+    bool m_inside;
+  };
+
+  // Returns cells crossed by borders of |country| and cells covered by it.
+  std::vector<Mark> MarkCells(borders::CountryPolygons const & country) const
+  {
+    // Points within the epsilon of borders are contained by countries, see CountryPolygons::Contains().
+    auto const eps = borders::CountryPolygons::GetContainsEpsilon();
+
+    std::unordered_map<uint32_t, bool> cells;
+    country.ForEachPolygon([&](borders::Polygon const & polygon) {
+      std::unordered_set<uint32_t> crossed;
+      auto const & points = polygon.Data();
+      for (size_t i = 0; i < points.size(); ++i)
+      {
+        auto const & p1 = points[i];
+        auto const & p2 = points[(i + 1) % points.size()];
+        m2::RectD edgeRect(p1, p2);
+        edgeRect.Inflate(eps, eps);
+        ForEachCell(edgeRect, [&](size_t x, size_t y) {
+          auto rect = GetCellRect(x, y);
+          rect.Inflate(eps, eps);
+          auto a = p1;
+          auto b = p2;
+          if (m2::Intersect(rect, a, b))
+            crossed.emplace(static_cast<uint32_t>(y * m_width + x));
+        });
+      }
+
+      // Borders don't cross cells between crossed ones in a row,
+      // so all of them are inside or all of them are outside of the polygon.
+      auto const rect = polygon.GetRect();
+      for (size_t y = GetY(rect.minY()); y <= GetY(rect.maxY()); ++y)
+      {
+        std::optional<bool> inside;
+        for (size_t x = GetX(rect.minX()); x <= GetX(rect.maxX()); ++x)
+        {
+          auto const index = static_cast<uint32_t>(y * m_width + x);
+          if (crossed.count(index) != 0)
+          {
+            inside = {};
+            continue;
+          }
+
+          if (!inside)
+            inside = polygon.Contains(GetCellRect(x, y).Center());
+          if (*inside)
+            cells[index] = true;
+        }
+      }
+
+      // A cell crossed by a polygon of a country may be covered by another polygon of it.
+      for (auto const index : crossed)
+        cells.emplace(index, false);
+    });
+
+    std::vector<Mark> marks;
+    marks.reserve(cells.size());
+    for (auto const & [index, inside] : cells)
+      marks.push_back({index, inside});
+    return marks;
+  }
+
+  template <typename Fn>
+  void ForEachCell(m2::RectD const & rect, Fn && fn) const
+  {
+    for (size_t y = GetY(rect.minY()); y <= GetY(rect.maxY()); ++y)
+    {
+      for (size_t x = GetX(rect.minX()); x <= GetX(rect.maxX()); ++x)
+        fn(x, y);
+    }
+  }
+
+  m2::RectD GetCellRect(size_t x, size_t y) const
+  {
+    auto const minX = mercator::Bounds::kMinX + x * kCellSize;
+    auto const minY = mercator::Bounds::kMinY + y * kCellSize;
+    return {minX, minY, minX + kCellSize, minY + kCellSize};
+  }
+
+  size_t GetX(double x) const { return GetIndex(x - mercator::Bounds::kMinX, m_width); }
+  size_t GetY(double y) const { return GetIndex(y - mercator::Bounds::kMinY, m_height); }
+
+  static size_t GetIndex(double offset, size_t size)
+  {
+    if (offset <= 0.0)
+      return 0;
+    return std::min(static_cast<size_t>(offset / kCellSize), size - 1);
+  }
+
+  size_t m_width;
+  size_t m_height;
+  // Ids of entries of cells by rows.
+  std::vector<uint32_t> m_cells;
+  std::vector<Cell> m_entries;
+};
+
+// CountriesFilesIndexAffiliation ------------------------------------------------------------------
 CountriesFilesIndexAffiliation::CountriesFilesIndexAffiliation(std::string const & borderPath,
                                                                bool haveBordersForWholeWorld)
   : CountriesFilesAffiliation(borderPath, haveBordersForWholeWorld)
 {
   static std::mutex cacheMutex;
-  static std::unordered_map<std::string, std::shared_ptr<Tree>> cache;
-  auto const key = borderPath + std::to_string(haveBordersForWholeWorld);
+  static std::unordered_map<std::string, std::shared_ptr<Grid const>> cache;
 
   std::lock_guard<std::mutex> lock(cacheMutex);
 
-  auto const it = cache.find(key);
+  auto const it = cache.find(borderPath);
   if (it != std::cend(cache))
   {
-    m_index = it->second;
+    m_grid = it->second;
     return;
   }
 
-  auto const net = generator::cells_merger::MakeNet(0.2 /* step */,
-                                                    mercator::Bounds::kMinX, mercator::Bounds::kMinY,
-                                                    mercator::Bounds::kMaxX, mercator::Bounds::kMaxY);
-  auto const index = BuildIndex(net);
-  m_index = index;
-  cache.emplace(key, index);
+  base::Timer timer;
+  m_grid = std::make_shared<Grid const>(m_countryPolygonsTree);
+  LOG(LINFO, ("Affiliation grid for", borderPath, "is built in", timer.ElapsedSeconds(), "seconds"));
+  cache.emplace(borderPath, m_grid);
 }
 
 std::vector<std::string> CountriesFilesIndexAffiliation::GetAffiliations(FeatureBuilder const & fb) const
 {
-  return affiliation::GetAffiliations(fb, m_index);
+  return GetAffiliationsImpl(fb);
 }
 
 std::vector<std::string> CountriesFilesIndexAffiliation::GetAffiliations(m2::PointD const & point) const
 {
-  return affiliation::GetAffiliations(point, m_index);
+  return GetAffiliationsImpl(point);
 }
 
-std::shared_ptr<CountriesFilesIndexAffiliation::Tree>
-CountriesFilesIndexAffiliation::BuildIndex(const std::vector<m2::RectD> & net)
+template <typename T>
+std::vector<std::string> CountriesFilesIndexAffiliation::GetAffiliationsImpl(T const & t) const
 {
-  std::unordered_map<borders::CountryPolygons const *, std::vector<m2::RectD>> countriesRects;
-  std::mutex countriesRectsMutex;
-  std::vector<Value> treeCells;
-  std::mutex treeCellsMutex;
-  auto const numThreads = GetPlatform().CpuCores();
-  {
-    base::thread_pool::computational::ThreadPool pool(numThreads);
-    for (auto const & rect : net)
-    {
-      pool.SubmitWork([&, rect]() {
-        std::vector<std::reference_wrapper<borders::CountryPolygons const>> countries;
-        m_countryPolygonsTree.ForEachCountryInRect(rect, [&](auto const & country) {
-          countries.emplace_back(country);
-        });
-        if (m_haveBordersForWholeWorld && countries.size() == 1)
-        {
-          borders::CountryPolygons const & country = countries.front();
-          std::lock_guard<std::mutex> lock(countriesRectsMutex);
-          countriesRects[&country].emplace_back(rect);
-        }
-        else
-        {
-          auto const box = affiliation::MakeBox(rect);
-          std::vector<std::reference_wrapper<borders::CountryPolygons const>> interCountries;
-          for (borders::CountryPolygons const & cp : countries)
-          {
-            cp.ForAnyPolygon([&](auto const & polygon) {
-              if (!boost::geometry::intersects(polygon.Data(), box))
-                return false;
-              interCountries.emplace_back(cp);
-              return true;
-            });
-          }
-          if (interCountries.empty())
-            return;
-          if (interCountries.size() == 1)
-          {
-            borders::CountryPolygons const & country = interCountries.front();
-            std::lock_guard<std::mutex> lock(countriesRectsMutex);
-            countriesRects[&country].emplace_back(rect);
-          }
-          else
-          {
-            std::lock_guard<std::mutex> lock(treeCellsMutex);
-            treeCells.emplace_back(box, std::move(interCountries));
-          }
-        }
-      });
-    }
-  }
-  {
-    base::thread_pool::computational::ThreadPool pool(numThreads);
-    for (auto & pair : countriesRects)
-    {
-      pool.SubmitWork([&, countryPtr{pair.first}, rects{std::move(pair.second)}]() mutable {
-        generator::cells_merger::CellsMerger merger(std::move(rects));
-        auto const merged = merger.Merge();
-        for (auto const & rect : merged)
-        {
-          std::vector<std::reference_wrapper<borders::CountryPolygons const>> interCountries{*countryPtr};
-          std::lock_guard<std::mutex> lock(treeCellsMutex);
-          treeCells.emplace_back(affiliation::MakeBox(rect), std::move(interCountries));
-        }
-      });
-    }
-  }
-  return std::make_shared<Tree>(treeCells);
+  auto affiliations = m_grid->GetAffiliations(t);
+  // Without countries containing a feature, the feature may belong to the only country
+  // whose bounding rects intersect it, see affiliation::GetAffiliations().
+  if (affiliations.empty() && m_haveBordersForWholeWorld)
+    return CountriesFilesAffiliation::GetAffiliations(t);
+  return affiliations;
 }
 
+// SingleAffiliation -------------------------------------------------------------------------------
 SingleAffiliation::SingleAffiliation(std::string const & filename)
   : m_filename(filename)
 {
@@ -1,15 +1,12 @@
 #pragma once
 
 #include "generator/borders.hpp"
-#include "generator/cells_merger.hpp"
 #include "generator/feature_builder.hpp"
 
-#include <optional>
+#include <memory>
 #include <string>
 #include <vector>
 
-#include <boost/geometry/index/rtree.hpp>
-
 namespace feature
 {
 class AffiliationInterface
@@ -41,12 +38,13 @@ protected:
   bool m_haveBordersForWholeWorld;
 };
 
+// Answers by a grid of cells over the mercator bounds, which is precomputed once for borders
+// and is shared by all affiliations with these borders. A cell keeps countries covering it
+// completely and countries whose borders cross it. Points are checked against the latter ones only.
 class CountriesFilesIndexAffiliation : public CountriesFilesAffiliation
 {
 public:
-  using Box = boost::geometry::model::box<m2::PointD>;
-  using Value = std::pair<Box, std::vector<std::reference_wrapper<borders::CountryPolygons const>>>;
-  using Tree = boost::geometry::index::rtree<Value, boost::geometry::index::quadratic<16>>;
+  class Grid;
 
   CountriesFilesIndexAffiliation(std::string const & borderPath, bool haveBordersForWholeWorld);
 
@@ -55,9 +53,10 @@ public:
   std::vector<std::string> GetAffiliations(m2::PointD const & point) const override;
 
 private:
-  std::shared_ptr<Tree> BuildIndex(std::vector<m2::RectD> const & net);
+  template <typename T>
+  std::vector<std::string> GetAffiliationsImpl(T const & t) const;
 
-  std::shared_ptr<Tree> m_index;
+  std::shared_ptr<Grid const> m_grid;
 };
 
 class SingleAffiliation : public AffiliationInterface
@@ -0,0 +1,155 @@
+#include "generator/affiliation.hpp"
+#include "generator/feature_builder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+
+#include "platform/platform.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
+
+#include "defines.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+DEFINE_string(data_path, "", "Path to a directory with the borders directory.");
+DEFINE_string(features_path, "",
+              "Path to a file of features in the raw format or to a directory with .mwm.tmp files.");
+DEFINE_bool(have_borders_for_whole_world, false, "Borders cover the whole world.");
+DEFINE_uint64(threads_count, 0, "Count of threads, all cores are used by default.");
+
+namespace
+{
+// Features are processed by batches to bound memory on planet-sized inputs.
+size_t constexpr kBatchSize = 1 << 16;
+
+struct Stats
+{
+  double m_seconds = 0.0;
+  std::atomic<uint64_t> m_affiliations{0};
+};
+
+std::vector<std::vector<std::string>> GetAffiliations(
+    feature::AffiliationInterface const & affiliation, std::vector<feature::FeatureBuilder> const & fbs,
+    base::thread_pool::computational::ThreadPool & pool, size_t threadsCount, Stats & stats)
+{
+  std::vector<std::vector<std::string>> affiliations(fbs.size());
+  base::Timer timer;
+  std::vector<std::future<void>> futures;
+  for (size_t t = 0; t < threadsCount; ++t)
+  {
+    futures.emplace_back(pool.Submit([&, t]() {
+      for (size_t i = t; i < fbs.size(); i += threadsCount)
+      {
+        affiliations[i] = affiliation.GetAffiliations(fbs[i]);
+        std::sort(affiliations[i].begin(), affiliations[i].end());
+        stats.m_affiliations += affiliations[i].size();
+      }
+    }));
+  }
+
+  for (auto & f : futures)
+    f.wait();
+
+  stats.m_seconds += timer.ElapsedSeconds();
+  return affiliations;
+}
+
+void Report(std::string const & name, double buildSeconds, Stats const & stats, uint64_t featuresCount)
+{
+  LOG(LINFO, (name, "is built in", buildSeconds, "seconds, features per second:",
+              stats.m_seconds > 0.0 ? featuresCount / stats.m_seconds : 0.0,
+              "affiliations:", stats.m_affiliations.load()));
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  gflags::SetUsageMessage(
+      "Compares speed and results of countries affiliations by borders and by the grid of cells.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_data_path.empty() || FLAGS_features_path.empty())
+  {
+    LOG(LERROR, ("Both --data_path and --features_path must be specified."));
+    return -1;
+  }
+
+  classificator::Load();
+
+  std::vector<std::string> paths;
+  if (Platform::IsDirectory(FLAGS_features_path))
+  {
+    Platform::FilesList files;
+    Platform::GetFilesByExt(FLAGS_features_path, DATA_FILE_EXTENSION_TMP, files);
+    for (auto const & file : files)
+      paths.emplace_back(base::JoinPath(FLAGS_features_path, file));
+  }
+  else
+  {
+    paths.emplace_back(FLAGS_features_path);
+  }
+
+  auto const threadsCount =
+      FLAGS_threads_count != 0 ? static_cast<size_t>(FLAGS_threads_count) : GetPlatform().CpuCores();
+
+  base::Timer timer;
+  feature::CountriesFilesAffiliation bordersAffiliation(FLAGS_data_path,
+                                                        FLAGS_have_borders_for_whole_world);
+  auto const bordersBuildSeconds = timer.ElapsedSeconds();
+
+  timer.Reset();
+  feature::CountriesFilesIndexAffiliation gridAffiliation(FLAGS_data_path,
+                                                          FLAGS_have_borders_for_whole_world);
+  auto const gridBuildSeconds = timer.ElapsedSeconds();
+
+  base::thread_pool::computational::ThreadPool pool(threadsCount);
+  Stats bordersStats;
+  Stats gridStats;
+  uint64_t featuresCount = 0;
+  uint64_t mismatchesCount = 0;
+  std::vector<feature::FeatureBuilder> fbs;
+  auto const processBatch = [&]() {
+    auto const expected = GetAffiliations(bordersAffiliation, fbs, pool, threadsCount, bordersStats);
+    auto const actual = GetAffiliations(gridAffiliation, fbs, pool, threadsCount, gridStats);
+    for (size_t i = 0; i < fbs.size(); ++i)
+    {
+      if (expected[i] == actual[i])
+        continue;
+
+      if (mismatchesCount++ < 10)
+      {
+        LOG(LWARNING, ("Mismatch for", fbs[i].GetMostGenericOsmId(), "by borders:", expected[i],
+                       "by grid:", actual[i]));
+      }
+    }
+    featuresCount += fbs.size();
+    fbs.clear();
+  };
+
+  for (auto const & path : paths)
+  {
+    feature::ForEachFeatureRawFormat(path, [&](feature::FeatureBuilder && fb, uint64_t) {
+      fbs.emplace_back(std::move(fb));
+      if (fbs.size() == kBatchSize)
+        processBatch();
+    });
+  }
+  processBatch();
+
+  LOG(LINFO, ("Features:", featuresCount, "from", paths.size(), "files, threads:", threadsCount));
+  Report("CountriesFilesAffiliation", bordersBuildSeconds, bordersStats, featuresCount);
+  Report("CountriesFilesIndexAffiliation", gridBuildSeconds, gridStats, featuresCount);
+  LOG(LINFO, ("Mismatches:", mismatchesCount));
+  return mismatchesCount == 0 ? 0 : 1;
+}
@@ -46,7 +46,7 @@
 #include <gflags/gflags.h>
 
 DEFINE_string(node_storage, "map",
-              "Type of storage for intermediate points representation. Available: raw, map, mem.");
+              "Type of storage for intermediate points representation. Available: raw, map, mem, packed.");
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_string(maps_build_path, "",
               "Directory of any of the previous map generations. It is assumed that it will "
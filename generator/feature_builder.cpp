@@ -2,6 +2,7 @@
 
 #include "routing/routing_helpers.hpp"
 
+#include "indexer/classificator.hpp"
 #include "indexer/feature_algo.hpp"
 #include "indexer/feature_visibility.hpp"
 #include "indexer/ftypes_matcher.hpp"
@@ -422,10 +423,15 @@ void FeatureBuilder::SerializeForIntermediate(Buffer & data) const
 }
 
 void FeatureBuilder::DeserializeFromIntermediate(Buffer & data)
+{
+  DeserializeFromIntermediate(data.data());
+}
+
+void FeatureBuilder::DeserializeFromIntermediate(void const * data)
 {
   serial::GeometryCodingParams cp;
 
-  ArrayByteSource source(&data[0]);
+  ArrayByteSource source(data);
   m_params.Read(source);
 
   m_limitRect.MakeEmpty();
@@ -491,7 +497,12 @@ void FeatureBuilder::SerializeAccuratelyForIntermediate(Buffer & data) const
 
 void FeatureBuilder::DeserializeAccuratelyFromIntermediate(Buffer & data)
 {
-  ArrayByteSource source(&data[0]);
+  DeserializeAccuratelyFromIntermediate(data.data());
+}
+
+void FeatureBuilder::DeserializeAccuratelyFromIntermediate(void const * data)
+{
+  ArrayByteSource source(data);
   m_params.Read(source);
 
   m_limitRect.MakeEmpty();
@@ -522,6 +533,27 @@ void FeatureBuilder::DeserializeAccuratelyFromIntermediate(Buffer & data)
   CHECK(IsValid(), (*this));
 }
 
+// static
+TypesHolder FeatureBuilder::ReadTypesFromIntermediate(void const * data)
+{
+  // Both intermediate formats start with FeatureBuilderParams, see FeatureParams::Write().
+  ArrayByteSource source(data);
+  auto const header = ReadPrimitiveFromSource<uint8_t>(source);
+  auto const headerGeomType = static_cast<HeaderGeomType>(header & HEADER_MASK_GEOMTYPE);
+
+  GeomType geomType = GeomType::Point;
+  if (headerGeomType == HeaderGeomType::Line)
+    geomType = GeomType::Line;
+  else if (headerGeomType == HeaderGeomType::Area)
+    geomType = GeomType::Area;
+
+  TypesHolder types(geomType);
+  size_t const count = (header & HEADER_MASK_TYPE) + 1;
+  for (size_t i = 0; i < count; ++i)
+    types.Add(classif().GetTypeForIndex(ReadVarUint<uint32_t>(source)));
+  return types;
+}
+
 void FeatureBuilder::AddOsmId(base::GeoObjectId id) { m_osmIds.push_back(id); }
 
 void FeatureBuilder::SetOsmId(base::GeoObjectId id) { m_osmIds.assign(1, id); }
@@ -762,6 +794,51 @@ std::string DebugPrint(FeatureBuilder const & fb)
   return out.str();
 }
 
+// MappedFeaturesFile ------------------------------------------------------------------------------
+MappedFeaturesFile::MappedFeaturesFile(std::string const & filename) : m_filename(filename)
+{
+  // mmap() fails for empty files, while missing files throw Reader::OpenException as before.
+  uint64_t size = 0;
+  if (base::GetFileSize(filename, size) && size == 0)
+    return;
+
+  m_reader = std::make_unique<MmapReader>(filename, MmapReader::Advice::Sequential);
+  m_data = m_reader->Data();
+  m_size = m_reader->Size();
+
+  uint64_t pos = 0;
+  while (pos < m_size)
+  {
+    m_positions.push_back(pos);
+
+    // The last byte of a varuint has no continuation bit, uint32_t takes at most 5 bytes.
+    uint64_t sizeEnd = pos;
+    while (sizeEnd < m_size && sizeEnd - pos < 5 && (m_data[sizeEnd] & 0x80) != 0)
+      ++sizeEnd;
+    if (sizeEnd == m_size || sizeEnd - pos == 5)
+      MYTHROW(Reader::ReadException, ("Broken record size at", pos, "of", m_filename));
+
+    ArrayByteSource source(m_data + pos);
+    auto const recordSize = ReadVarUint<uint32_t>(source);
+    pos = sizeEnd + 1;
+    if (recordSize > m_size - pos)
+      MYTHROW(Reader::ReadException, ("Truncated features file", m_filename, "record size",
+                                      recordSize, "at", pos, "file size", m_size));
+    pos += recordSize;
+  }
+}
+
+MappedFeaturesFile::Record MappedFeaturesFile::GetRecord(size_t i) const
+{
+  ASSERT_LESS(i, m_positions.size(), ());
+  Record record;
+  record.m_pos = m_positions[i];
+  ArrayByteSource source(m_data + record.m_pos);
+  record.m_size = ReadVarUint<uint32_t>(source);
+  record.m_data = source.PtrUint8();
+  return record;
+}
+
 namespace serialization_policy
 {
 // static
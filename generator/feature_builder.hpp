@@ -7,12 +7,14 @@
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/mmap_reader.hpp"
 
 #include "base/geo_object_id.hpp"
 #include "base/stl_helpers.hpp"
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -176,10 +178,16 @@ public:
 
   void SerializeForIntermediate(Buffer & data) const;
   void DeserializeFromIntermediate(Buffer & data);
+  void DeserializeFromIntermediate(void const * data);
 
   // These methods use geometry without loss of accuracy.
   void SerializeAccuratelyForIntermediate(Buffer & data) const;
   void DeserializeAccuratelyFromIntermediate(Buffer & data);
+  void DeserializeAccuratelyFromIntermediate(void const * data);
+
+  // Reads geometry type and types of a feature serialized by any of the methods above
+  // without deserialization of the rest of the feature.
+  static TypesHolder ReadTypesFromIntermediate(void const * data);
 
   bool PreSerializeAndRemoveUselessNamesForMwm(SupportingData const & data);
   void SerializeForMwm(SupportingData & data, serial::GeometryCodingParams const & params) const;
@@ -248,6 +256,11 @@ struct MinSize
   {
     fb.DeserializeFromIntermediate(data);
   }
+
+  static void Deserialize(FeatureBuilder & fb, void const * data)
+  {
+    fb.DeserializeFromIntermediate(data);
+  }
 };
 
 struct MaxAccuracy
@@ -264,6 +277,11 @@ struct MaxAccuracy
   {
     fb.DeserializeAccuratelyFromIntermediate(data);
   }
+
+  static void Deserialize(FeatureBuilder & fb, void const * data)
+  {
+    fb.DeserializeAccuratelyFromIntermediate(data);
+  }
 };
 }  // namespace serialization_policy
 
@@ -295,23 +313,83 @@ void ReadFromSourceRawFormat(Source & src, FeatureBuilder & fb)
   SerializationPolicy::Deserialize(fb, buffer);
 }
 
-// Process features in features file.
-template <class SerializationPolicy = serialization_policy::MaxAccuracy, class ToDo>
-void ForEachFeatureRawFormat(std::string const & filename, ToDo && toDo)
+// Memory mapped file of features in the raw format, i.e. of records of a varuint size and
+// a serialized feature. Positions of records are collected once on opening, so features may be
+// read by indexes and right from the mapped memory. Records may be filtered by types and
+// copied to other files without deserialization of features.
+class MappedFeaturesFile
 {
-  FileReader reader(filename);
-  ReaderSource<FileReader> src(reader);
-  // TryReadAndCheckVersion<SerializationPolicy>(src);
-  auto const fileSize = reader.Size();
-  auto currPos = src.Pos();
-  // read features one by one
-  while (currPos < fileSize)
+public:
+  struct Record
+  {
+    // Position of the record in the file.
+    uint64_t m_pos = 0;
+    // Serialized feature.
+    uint8_t const * m_data = nullptr;
+    uint32_t m_size = 0;
+  };
+
+  explicit MappedFeaturesFile(std::string const & filename);
+
+  // Size of the file in bytes.
+  uint64_t GetSize() const { return m_size; }
+  size_t GetCount() const { return m_positions.size(); }
+
+  Record GetRecord(size_t i) const;
+
+  template <class SerializationPolicy = serialization_policy::MaxAccuracy>
+  void Read(size_t i, FeatureBuilder & fb) const
+  {
+    SerializationPolicy::Deserialize(fb, GetRecord(i).m_data);
+  }
+
+  template <typename ToDo>
+  void ForEachRecord(ToDo && toDo) const
   {
-    FeatureBuilder fb;
-    ReadFromSourceRawFormat<SerializationPolicy>(src, fb);
-    toDo(std::move(fb), currPos);
-    currPos = src.Pos();
+    for (size_t i = 0; i < m_positions.size(); ++i)
+      toDo(GetRecord(i));
   }
+
+  template <class SerializationPolicy = serialization_policy::MaxAccuracy, typename ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    ForEachRecord([&](Record const & record) {
+      FeatureBuilder fb;
+      SerializationPolicy::Deserialize(fb, record.m_data);
+      toDo(std::move(fb), record.m_pos);
+    });
+  }
+
+  // Deserializes only features whose TypesHolder satisfies |pred|.
+  template <class SerializationPolicy = serialization_policy::MaxAccuracy, typename Pred, typename ToDo>
+  void ForEachIf(Pred && pred, ToDo && toDo) const
+  {
+    ForEachRecord([&](Record const & record) {
+      if (!pred(FeatureBuilder::ReadTypesFromIntermediate(record.m_data)))
+        return;
+
+      FeatureBuilder fb;
+      SerializationPolicy::Deserialize(fb, record.m_data);
+      toDo(std::move(fb), record.m_pos);
+    });
+  }
+
+private:
+  std::string m_filename;
+  // Empty files aren't mapped.
+  std::unique_ptr<MmapReader> m_reader;
+  uint8_t const * m_data = nullptr;
+  uint64_t m_size = 0;
+  std::vector<uint64_t> m_positions;
+};
+
+// Process features in features file. Returns size of the file.
+template <class SerializationPolicy = serialization_policy::MaxAccuracy, class ToDo>
+uint64_t ForEachFeatureRawFormat(std::string const & filename, ToDo && toDo)
+{
+  MappedFeaturesFile file(filename);
+  file.ForEach<SerializationPolicy>(std::forward<ToDo>(toDo));
+  return file.GetSize();
 }
 
 template <class SerializationPolicy = serialization_policy::MaxAccuracy>
@@ -365,9 +443,22 @@ public:
 
   void Write(FeatureBuilder const & fb)
   {
+    auto const pos = m_writer->Pos();
     Write(*m_writer, fb);
+    m_writtenSize += m_writer->Pos() - pos;
   }
 
+  // Copies a record of another features file of the same SerializationPolicy.
+  void Write(MappedFeaturesFile::Record const & record)
+  {
+    auto const pos = m_writer->Pos();
+    WriteVarUint(*m_writer, record.m_size);
+    m_writer->Write(record.m_data, record.m_size);
+    m_writtenSize += m_writer->Pos() - pos;
+  }
+
+  uint64_t GetWrittenSize() const { return m_writtenSize; }
+
   template <typename Sink>
   static void Write(Sink & writer, FeatureBuilder const & fb)
   {
@@ -381,5 +472,6 @@ private:
   std::string m_filename;
   bool m_mangleName = false;
   std::unique_ptr<Writer> m_writer;
+  uint64_t m_writtenSize = 0;
 };
 }  // namespace feature
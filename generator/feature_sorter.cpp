@@ -23,16 +23,26 @@
 #include "coding/point_coding.hpp"
 #include "coding/succinct_mapper.hpp"
 
+#include "geometry/hilbert_curve.hpp"
+
 #include "base/assert.hpp"
+#include "base/checked_cast.hpp"
 #include "base/logging.hpp"
+#include "base/macros.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
 #include "defines.hpp"
 
+#include <algorithm>
+#include <future>
 #include <limits>
 #include <list>
 #include <memory>
+#include <queue>
+#include <utility>
 #include <vector>
 
 
@@ -145,9 +155,353 @@ public:
 
   void operator()(FeatureBuilder & fb)
   {
-    GeometryHolder holder([this](int i) -> FileWriter & { return *m_geoFile[i]; },
-                          [this](int i) -> FileWriter & { return *m_trgFile[i]; }, fb, m_header);
+    GeometryHolder holder([this](int i) -> Writer & { return *m_geoFile[i]; },
+                          [this](int i) -> Writer & { return *m_trgFile[i]; }, fb, m_header);
+
+    auto const featureIndex = m_featuresCount++;
+    if (m_geometryLayout)
+      m_geometryLayout->SeekToFeature(featureIndex, m_geoFile, m_trgFile);
+
+    ProcessGeometry(fb, holder);
+
+    if (m_geometryLayout)
+      m_geometryLayout->CheckFeature(featureIndex, m_geoFile, m_trgFile);
+
+    WriteFeature(fb, holder);
+  }
+
+  // Does the same as operator() for features passed by |forEachFeature|, but geometry is
+  // simplified and tesselated on |threadsCount| threads. Geometry of a feature is written
+  // to memory and is copied to files in the order of features, so the result is the same.
+  template <typename ForEachFeature>
+  void ProcessFeatures(ForEachFeature && forEachFeature, size_t threadsCount)
+  {
+    if (threadsCount <= 1)
+    {
+      forEachFeature(*this);
+      return;
+    }
+
+    // Limits memory used by features waiting to be written.
+    size_t const maxQueueSize = threadsCount * 64;
+
+    // Features must outlive the pool which processes them.
+    std::queue<std::pair<std::unique_ptr<ProcessedFeature>, std::future<void>>> queue;
+    base::thread_pool::computational::ThreadPool pool(threadsCount);
+    auto const writeFront = [&]()
+    {
+      queue.front().second.get();
+      WriteProcessedFeature(*queue.front().first);
+      queue.pop();
+    };
+
+    forEachFeature([&](FeatureBuilder & fb)
+    {
+      auto feature = std::make_unique<ProcessedFeature>(std::move(fb), m_header);
+      auto result = pool.Submit([this, f = feature.get()]() { ProcessGeometry(f->m_fb, f->m_holder); });
+      queue.emplace(std::move(feature), std::move(result));
+      if (queue.size() > maxQueueSize)
+        writeFront();
+    });
+
+    while (!queue.empty())
+      writeFront();
+  }
+
+  // Makes operator() write outer geometry and triangles of each scale in the Hilbert curve
+  // order of features centers instead of the order of features. |forEachFeature| must pass
+  // to its argument the same features in the same order as they are passed to operator()
+  // later. Feature ids and the features section are not changed, features find their
+  // geometry by offsets as usual.
+  template <typename ForEachFeature>
+  void PlanHilbertGeometryOrder(ForEachFeature && forEachFeature)
+  {
+    size_t const scalesCount = m_header.GetScalesCount();
+
+    // Geometry is written to scratch files which are rewound after each feature,
+    // to get only sizes of the geometry.
+    TmpFiles geoScratch, trgScratch;
+    for (size_t i = 0; i < scalesCount; ++i)
+    {
+      geoScratch.push_back(std::make_unique<TmpFile>(m_geoFile[i]->GetName() + ".layout"));
+      trgScratch.push_back(std::make_unique<TmpFile>(m_trgFile[i]->GetName() + ".layout"));
+    }
+
+    auto layout = std::make_unique<GeometryLayout>(scalesCount);
+    std::vector<uint64_t> keys;
+    uint32_t featureIndex = 0;
+    forEachFeature([&](FeatureBuilder & fb)
+    {
+      GeometryHolder holder([&](int i) -> FileWriter & { return *geoScratch[i]; },
+                            [&](int i) -> FileWriter & { return *trgScratch[i]; }, fb, m_header);
+      ProcessGeometry(fb, holder);
+
+      for (size_t i = 0; i < scalesCount; ++i)
+      {
+        layout->AddFeature(i, featureIndex, *geoScratch[i], *trgScratch[i]);
+        geoScratch[i]->Seek(0);
+        trgScratch[i]->Seek(0);
+      }
+
+      auto const center = PointDToPointU(fb.GetLimitRect().Center(), kPointCoordBits);
+      keys.push_back(m2::HilbertIndex(center.x, center.y, kPointCoordBits));
+      ++featureIndex;
+    });
+
+    layout->SortByKeys(keys);
+    m_geometryLayout = std::move(layout);
+  }
+
+private:
+  using Points = std::vector<m2::PointD>;
+  using Polygons = std::list<Points>;
+
+  class TmpFile : public FileWriter
+  {
+  public:
+    explicit TmpFile(std::string const & filePath) : FileWriter(filePath) {}
+    ~TmpFile() override { DeleteFileX(GetName()); }
+  };
+
+  using TmpFiles = std::vector<std::unique_ptr<TmpFile>>;
+
+  // Planned offsets of the outer geometry and triangles of features in geometry files.
+  class GeometryLayout
+  {
+  public:
+    explicit GeometryLayout(size_t scalesCount) : m_geo(scalesCount), m_trg(scalesCount) {}
+
+    // Adds geometry of |featureIndex| written to the rewound |geo| and |trg| files of |scaleIndex|.
+    void AddFeature(size_t scaleIndex, uint32_t featureIndex, FileWriter const & geo,
+                    FileWriter const & trg)
+    {
+      m_geo[scaleIndex].Add(featureIndex, geo.Pos());
+      m_trg[scaleIndex].Add(featureIndex, trg.Pos());
+    }
+
+    void SortByKeys(std::vector<uint64_t> const & keys)
+    {
+      for (auto & file : m_geo)
+        file.SortByKeys(keys);
+      for (auto & file : m_trg)
+        file.SortByKeys(keys);
+    }
+
+    void SeekToFeature(uint32_t featureIndex, TmpFiles & geo, TmpFiles & trg)
+    {
+      for (size_t i = 0; i < m_geo.size(); ++i)
+      {
+        m_geo[i].SeekToFeature(featureIndex, *geo[i]);
+        m_trg[i].SeekToFeature(featureIndex, *trg[i]);
+      }
+    }
+
+    void CheckFeature(uint32_t featureIndex, TmpFiles const & geo, TmpFiles const & trg)
+    {
+      for (size_t i = 0; i < m_geo.size(); ++i)
+      {
+        m_geo[i].CheckFeature(featureIndex, *geo[i]);
+        m_trg[i].CheckFeature(featureIndex, *trg[i]);
+      }
+    }
 
+  private:
+    class File
+    {
+    public:
+      void Add(uint32_t featureIndex, uint64_t size)
+      {
+        if (size != 0)
+          m_entries.push_back({featureIndex, 0, base::checked_cast<uint32_t>(size)});
+      }
+
+      // Assigns offsets to the entries sorted by |keys| of features and keeps
+      // the entries sorted by feature indices.
+      void SortByKeys(std::vector<uint64_t> const & keys)
+      {
+        std::vector<Entry *> order;
+        order.reserve(m_entries.size());
+        for (auto & e : m_entries)
+          order.push_back(&e);
+        std::stable_sort(order.begin(), order.end(), [&keys](Entry const * lhs, Entry const * rhs)
+        {
+          return keys[lhs->m_featureIndex] < keys[rhs->m_featureIndex];
+        });
+
+        uint64_t offset = 0;
+        for (auto * e : order)
+        {
+          e->m_offset = base::checked_cast<uint32_t>(offset);
+          offset += e->m_size;
+        }
+      }
+
+      void SeekToFeature(uint32_t featureIndex, FileWriter & w)
+      {
+        if (m_next < m_entries.size() && m_entries[m_next].m_featureIndex == featureIndex)
+          w.Seek(m_entries[m_next].m_offset);
+        m_start = w.Pos();
+      }
+
+      // Checks that the geometry is the same as the planned one. Geometry generation must be
+      // deterministic, otherwise features would overwrite geometry of each other.
+      void CheckFeature(uint32_t featureIndex, FileWriter const & w)
+      {
+        uint64_t size = 0;
+        if (m_next < m_entries.size() && m_entries[m_next].m_featureIndex == featureIndex)
+          size = m_entries[m_next++].m_size;
+        CHECK_EQUAL(w.Pos() - m_start, size, (featureIndex));
+      }
+
+    private:
+      struct Entry
+      {
+        uint32_t m_featureIndex;
+        uint32_t m_offset;
+        uint32_t m_size;
+      };
+
+      std::vector<Entry> m_entries;
+      size_t m_next = 0;
+      uint64_t m_start = 0;
+    };
+
+    std::vector<File> m_geo, m_trg;
+  };
+
+  // A feature with geometry written to memory by ProcessGeometry() on a worker thread.
+  // Offsets of the geometry in the holder's buffer are relative to the beginning of memory.
+  struct ProcessedFeature
+  {
+    using Buffer = std::vector<char>;
+
+    struct ScaleBuffer
+    {
+      Buffer m_data;
+      MemWriter<Buffer> m_writer{m_data};
+    };
+
+    ProcessedFeature(FeatureBuilder && fb, DataHeader const & header)
+      : m_fb(std::move(fb))
+      , m_geo(header.GetScalesCount())
+      , m_trg(header.GetScalesCount())
+      , m_holder([this](int i) -> Writer & { return m_geo[i].m_writer; },
+                 [this](int i) -> Writer & { return m_trg[i].m_writer; }, m_fb, header)
+    {
+    }
+
+    FeatureBuilder m_fb;
+    // Buffers are never reallocated, writers refer to them.
+    std::vector<ScaleBuffer> m_geo, m_trg;
+    GeometryHolder m_holder;
+
+    DISALLOW_COPY_AND_MOVE(ProcessedFeature);
+  };
+
+  void WriteProcessedFeature(ProcessedFeature & feature)
+  {
+    auto const featureIndex = m_featuresCount++;
+    if (m_geometryLayout)
+      m_geometryLayout->SeekToFeature(featureIndex, m_geoFile, m_trgFile);
+
+    auto & buffer = feature.m_holder.GetBuffer();
+    WriteProcessedGeometry(buffer.m_ptsMask, feature.m_geo, m_geoFile, buffer.m_ptsOffset);
+    WriteProcessedGeometry(buffer.m_trgMask, feature.m_trg, m_trgFile, buffer.m_trgOffset);
+
+    if (m_geometryLayout)
+      m_geometryLayout->CheckFeature(featureIndex, m_geoFile, m_trgFile);
+
+    WriteFeature(feature.m_fb, feature.m_holder);
+  }
+
+  // Copies geometry of scales from memory to |files| and shifts |offsets| by positions in files.
+  // Offsets are added from the upper scale to the lower one, one per bit of |mask|.
+  void WriteProcessedGeometry(uint8_t mask, std::vector<ProcessedFeature::ScaleBuffer> const & buffers,
+                              TmpFiles & files, FeatureBuilder::Offsets & offsets)
+  {
+    size_t next = 0;
+    for (int i = static_cast<int>(buffers.size()) - 1; i >= 0; --i)
+    {
+      if ((mask & (1 << i)) == 0)
+        continue;
+
+      CHECK_LESS(next, offsets.size(), ());
+      auto & offset = offsets[next++];
+      if (offset != kGeomOffsetFallback)
+        offset += CheckedFilePosCast(*files[i]);
+    }
+    CHECK_EQUAL(next, offsets.size(), ());
+
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+      auto const & data = buffers[i].m_data;
+      if (!data.empty())
+        files[i]->Write(data.data(), data.size());
+    }
+  }
+
+  // Serializes |fb| with geometry written by |holder| and writes its data to other sections.
+  void WriteFeature(FeatureBuilder & fb, GeometryHolder & holder)
+  {
+    // Override "alt_name" with synonym for Country or State for better search matching.
+    /// @todo Probably, we should store and index OSM's short_name tag.
+    if (indexer::SynonymsHolder::CanApply(fb.GetTypes()))
+    {
+      int8_t const langs[] = {
+        StringUtf8Multilang::kDefaultCode,
+        StringUtf8Multilang::kEnglishCode,
+        StringUtf8Multilang::kInternationalCode
+      };
+
+      bool added = false;
+      for (int8_t lang : langs)
+      {
+        m_synonyms.ForEach(std::string(fb.GetName(lang)), [&fb, &added](std::string const & synonym)
+        {
+          // Assign first synonym, skip others.
+          if (added)
+            return;
+
+          auto oldName = fb.GetName(StringUtf8Multilang::kAltNameCode);
+          if (!oldName.empty())
+            LOG(LWARNING, ("Replace", oldName, "with", synonym, "for", fb.GetMostGenericOsmId()));
+
+          fb.SetName(StringUtf8Multilang::kAltNameCode, synonym);
+          added = true;
+        });
+
+        if (added)
+          break;
+      }
+    }
+
+    auto & buffer = holder.GetBuffer();
+    if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
+    {
+      fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
+
+      uint32_t const featureId = WriteFeatureBase(buffer.m_buffer, fb);
+
+      // Order is important here:
+
+      // 1. Update postcode info.
+      m_boundaryPostcodesEnricher.Enrich(fb);
+
+      // 2. Write address to a file (with possible updated postcode above).
+      fb.GetParams().SerializeAddress(*m_addrFile);
+
+      // 3. Save metadata.
+      if (!fb.GetMetadata().Empty())
+        m_metadataBuilder.Put(featureId, fb.GetMetadata());
+
+      if (fb.HasOsmIds())
+        m_osm2ft.AddIds(generator::MakeCompositeId(fb), featureId);
+    }
+  }
+
+  // Simplifies geometry of |fb| for all scales and writes it via |holder|.
+  void ProcessGeometry(FeatureBuilder & fb, GeometryHolder & holder)
+  {
     if (!fb.IsPoint())
     {
       bool const isLine = fb.IsLine();
@@ -249,76 +603,8 @@ public:
         }
       }
     }
-
-    // Override "alt_name" with synonym for Country or State for better search matching.
-    /// @todo Probably, we should store and index OSM's short_name tag.
-    if (indexer::SynonymsHolder::CanApply(fb.GetTypes()))
-    {
-      int8_t const langs[] = {
-        StringUtf8Multilang::kDefaultCode,
-        StringUtf8Multilang::kEnglishCode,
-        StringUtf8Multilang::kInternationalCode
-      };
-
-      bool added = false;
-      for (int8_t lang : langs)
-      {
-        m_synonyms.ForEach(std::string(fb.GetName(lang)), [&fb, &added](std::string const & synonym)
-        {
-          // Assign first synonym, skip others.
-          if (added)
-            return;
-
-          auto oldName = fb.GetName(StringUtf8Multilang::kAltNameCode);
-          if (!oldName.empty())
-            LOG(LWARNING, ("Replace", oldName, "with", synonym, "for", fb.GetMostGenericOsmId()));
-
-          fb.SetName(StringUtf8Multilang::kAltNameCode, synonym);
-          added = true;
-        });
-
-        if (added)
-          break;
-      }
-    }
-
-    auto & buffer = holder.GetBuffer();
-    if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
-    {
-      fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
-
-      uint32_t const featureId = WriteFeatureBase(buffer.m_buffer, fb);
-
-      // Order is important here:
-
-      // 1. Update postcode info.
-      m_boundaryPostcodesEnricher.Enrich(fb);
-
-      // 2. Write address to a file (with possible updated postcode above).
-      fb.GetParams().SerializeAddress(*m_addrFile);
-
-      // 3. Save metadata.
-      if (!fb.GetMetadata().Empty())
-        m_metadataBuilder.Put(featureId, fb.GetMetadata());
-
-      if (fb.HasOsmIds())
-        m_osm2ft.AddIds(generator::MakeCompositeId(fb), featureId);
-    }
   }
 
-private:
-  using Points = std::vector<m2::PointD>;
-  using Polygons = std::list<Points>;
-
-  class TmpFile : public FileWriter
-  {
-  public:
-    explicit TmpFile(std::string const & filePath) : FileWriter(filePath) {}
-    ~TmpFile() override { DeleteFileX(GetName()); }
-  };
-
-  using TmpFiles = std::vector<std::unique_ptr<TmpFile>>;
-
   bool IsCountry() const { return m_header.GetType() == feature::DataHeader::MapType::Country; }
 
   static void SimplifyPoints(int level, bool isCoast, m2::RectD const & rect, Points const & in, Points & out)
@@ -348,6 +634,10 @@ private:
 
   indexer::SynonymsHolder m_synonyms;
 
+  // Number of features passed to operator().
+  uint32_t m_featuresCount = 0;
+  std::unique_ptr<GeometryLayout> m_geometryLayout;
+
   DISALLOW_COPY_AND_MOVE(FeaturesCollector2);
 };
 
@@ -399,15 +689,28 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
       LOG(LINFO, ("Simplifying and filtering geometry for all geom levels"));
 
       FeaturesCollector2 collector(name, info, header, regionData, info.m_versionDate);
-      for (auto const & point : midPoints.GetVector())
+      auto const forEachFeature = [&](auto && fn)
       {
-        ReaderSource<FileReader> src(reader);
-        src.Skip(point.second);
+        for (auto const & point : midPoints.GetVector())
+        {
+          ReaderSource<FileReader> src(reader);
+          src.Skip(point.second);
 
-        FeatureBuilder fb;
-        ReadFromSourceRawFormat(src, fb);
-        collector(fb);
+          FeatureBuilder fb;
+          ReadFromSourceRawFormat(src, fb);
+          fn(fb);
+        }
+      };
+
+      if (info.m_hilbertGeometryOrder)
+      {
+        LOG(LINFO, ("Planning Hilbert curve order of geometry"));
+        collector.PlanHilbertGeometryOrder(forEachFeature);
       }
+      base::Timer timer;
+      collector.ProcessFeatures(forEachFeature, info.m_threadsCount);
+      LOG(LINFO, ("Geometry of", midPoints.GetVector().size(), "features of", name, "is processed in",
+                  timer.ElapsedSeconds(), "seconds by", info.m_threadsCount, "threads"));
 
       LOG(LINFO, ("Writing features' data to", dataFilePath));
 
@@ -112,6 +112,7 @@ void CountryFinalProcessor::ProcessRoundabouts()
   AddressesHolder addresses;
   addresses.Deserialize(m_addrInterpolFilename);
 
+  PassStats stats("ProcessRoundabouts");
   ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & name, auto const & path)
   {
     if (!IsCountry(name))
@@ -124,7 +125,8 @@ void CountryFinalProcessor::ProcessRoundabouts()
       transformer.SetLeftHandTraffic(data.Get(RegionData::Type::RD_DRIVING) == "l");
 
     FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
+    auto const readSize = ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(
+        path, [&](FeatureBuilder && fb, uint64_t)
     {
       if (roundabouts.IsRoadExists(fb))
         transformer.AddRoad(std::move(fb));
@@ -152,6 +154,9 @@ void CountryFinalProcessor::ProcessRoundabouts()
     {
       writer.Write(fb);
     });
+
+    stats.AddRead(readSize);
+    stats.AddWritten(writer.GetWrittenSize());
   }, m_threadsCount);
 }
 
@@ -231,29 +236,46 @@ void CountryFinalProcessor::ProcessBuildingParts()
   auto const & buildingPartChecker = ftypes::IsBuildingPartChecker::Instance();
   auto const & buildingHasPartsChecker = ftypes::IsBuildingHasPartsChecker::Instance();
 
+  PassStats stats("ProcessBuildingParts");
   ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & name, auto const & path)
   {
     if (!IsCountry(name))
       return;
 
+    MappedFeaturesFile file(path);
+    stats.AddRead(file.GetSize());
+
     // All "building:part" regions in MWM
     m4::Tree<m2::RegionI> buildingPartsKDTree;
 
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
+    auto const isBuildingPart = [&](TypesHolder const & types)
     {
-      if (fb.IsArea() && buildingPartChecker(fb.GetTypes()))
-      {
-        // Important trick! Add region by FeatureBuilder's native rect, to make search queries also by FB rects.
-        buildingPartsKDTree.Add(coastlines_generator::CreateRegionI(fb.GetOuterGeometry()), fb.GetLimitRect());
-      }
+      return types.GetGeomType() == GeomType::Area && buildingPartChecker(types);
+    };
+    file.ForEachIf<serialization_policy::MaxAccuracy>(isBuildingPart, [&](FeatureBuilder && fb, uint64_t)
+    {
+      // Important trick! Add region by FeatureBuilder's native rect, to make search queries also by FB rects.
+      buildingPartsKDTree.Add(coastlines_generator::CreateRegionI(fb.GetOuterGeometry()), fb.GetLimitRect());
     });
 
+    // Nothing changes without parts.
+    if (buildingPartsKDTree.IsEmpty())
+      return;
+
+    // Only buildings are deserialized, other features are copied as is.
     FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder && fb, uint64_t)
+    file.ForEachRecord([&](MappedFeaturesFile::Record const & record)
     {
-      if (fb.IsArea() &&
-          buildingChecker(fb.GetTypes()) &&
-          DoesBuildingConsistOfParts(fb, buildingPartsKDTree))
+      auto const types = FeatureBuilder::ReadTypesFromIntermediate(record.m_data);
+      if (types.GetGeomType() != GeomType::Area || !buildingChecker(types))
+      {
+        writer.Write(record);
+        return;
+      }
+
+      FeatureBuilder fb;
+      serialization_policy::MaxAccuracy::Deserialize(fb, record.m_data);
+      if (DoesBuildingConsistOfParts(fb, buildingPartsKDTree))
       {
         fb.AddType(buildingHasPartsChecker.GetType());
         fb.GetParams().FinishAddingTypes();
@@ -261,6 +283,7 @@ void CountryFinalProcessor::ProcessBuildingParts()
 
       writer.Write(fb);
     });
+    stats.AddWritten(writer.GetWrittenSize());
   }, m_threadsCount);
 }
 
@@ -269,6 +292,7 @@ void CountryFinalProcessor::AddIsolines()
   // For generated isolines must be built isolines_info section based on the same
   // binary isolines file.
   IsolineFeaturesGenerator isolineFeaturesGenerator(m_isolinesPath);
+  PassStats stats("AddIsolines");
   ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & name, auto const & path)
   {
     if (!IsCountry(name))
@@ -276,6 +300,7 @@ void CountryFinalProcessor::AddIsolines()
 
     FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, FileWriter::Op::OP_APPEND);
     isolineFeaturesGenerator.GenerateIsolines(name, [&](auto const & fb) { writer.Write(fb); });
+    stats.AddWritten(writer.GetWrittenSize());
   }, m_threadsCount);
 }
 
@@ -310,6 +335,7 @@ void CountryFinalProcessor::AddFakeNodes()
 void CountryFinalProcessor::DropProhibitedSpeedCameras()
 {
   auto const speedCameraType = classif().GetTypeByPath({"highway", "speed_camera"});
+  PassStats stats("DropProhibitedSpeedCameras");
   ForEachMwmTmp(m_temporaryMwmPath, [&](auto const & country, auto const & path)
   {
     if (!IsCountry(country))
@@ -318,15 +344,19 @@ void CountryFinalProcessor::DropProhibitedSpeedCameras()
     if (!routing::AreSpeedCamerasProhibited(platform::CountryFile(country)))
       return;
 
+    MappedFeaturesFile file(path);
     FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(path, true /* mangleName */);
-    ForEachFeatureRawFormat<serialization_policy::MaxAccuracy>(path, [&](FeatureBuilder const & fb, uint64_t)
+    file.ForEachRecord([&](MappedFeaturesFile::Record const & record)
     {
       // Removing point features with speed cameras type from geometry index for some countries.
-      if (fb.IsPoint() && fb.HasType(speedCameraType))
+      auto const types = FeatureBuilder::ReadTypesFromIntermediate(record.m_data);
+      if (types.GetGeomType() == GeomType::Point && types.Has(speedCameraType))
         return;
 
-      writer.Write(fb);
+      writer.Write(record);
     });
+    stats.AddRead(file.GetSize());
+    stats.AddWritten(writer.GetWrittenSize());
   }, m_threadsCount);
 }
 
@@ -1,5 +1,7 @@
 #include "generator/final_processor_utils.hpp"
 
+#include "base/logging.hpp"
+
 #include <algorithm>
 #include <fstream>
 #include <iterator>
@@ -9,6 +11,13 @@ namespace generator
 {
 using namespace feature;
 
+PassStats::~PassStats()
+{
+  double constexpr kMiB = 1024.0 * 1024.0;
+  LOG(LINFO, (m_name, "read", m_read / kMiB, "MiB, wrote", m_written / kMiB, "MiB in",
+              m_timer.ElapsedSeconds(), "seconds"));
+}
+
 bool Less(FeatureBuilder const & lhs, FeatureBuilder const & rhs)
 {
   auto const lGeomType = static_cast<int8_t>(lhs.GetGeomType());
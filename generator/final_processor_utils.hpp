@@ -8,9 +8,12 @@
 #include "base/file_name_utils.hpp"
 #include "base/string_utils.hpp"
 #include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
 #include "defines.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -18,6 +21,23 @@
 
 namespace generator
 {
+// Bytes of .mwm.tmp files read and written by a pass of final processing, which are logged
+// with the time of the pass on destruction. Passes are parallel by files, so counters are atomic.
+class PassStats
+{
+public:
+  explicit PassStats(std::string const & name) : m_name(name) {}
+  ~PassStats();
+
+  void AddRead(uint64_t bytes) { m_read += bytes; }
+  void AddWritten(uint64_t bytes) { m_written += bytes; }
+
+private:
+  std::string m_name;
+  base::Timer m_timer;
+  std::atomic<uint64_t> m_read{0};
+  std::atomic<uint64_t> m_written{0};
+};
 
 template <typename ToDo>
 void ForEachMwmTmp(std::string const & temporaryMwmPath, ToDo && toDo, size_t threadsCount = 1)
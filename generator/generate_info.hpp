@@ -19,13 +19,16 @@ struct GenerateInfo
   {
     Memory,
     Index,
-    File
+    File,
+    // Delta coded pages of points with a directory of pages.
+    Packed
   };
 
   enum class OsmSourceType
   {
     XML,
-    O5M
+    O5M,
+    PBF
   };
 
   // Directory for .mwm.tmp files.
@@ -70,6 +73,10 @@ struct GenerateInfo
   bool m_emitCoasts = false;
   bool m_failOnCoasts = false;
   bool m_preloadCache = false;
+  // Geometry sections are ordered along the Hilbert curve, see GenerateFinalFeatures().
+  bool m_hilbertGeometryOrder = false;
+  // Count of threads for passes which are parallel within a bucket, e.g. geometry simplification.
+  size_t m_threadsCount = 1;
   bool m_verbose = false;
 
   GenerateInfo() = default;
@@ -80,6 +87,8 @@ struct GenerateInfo
       m_osmFileType = OsmSourceType::XML;
     else if (type == "o5m")
       m_osmFileType = OsmSourceType::O5M;
+    else if (type == "pbf")
+      m_osmFileType = OsmSourceType::PBF;
     else
       LOG(LCRITICAL, ("Unknown source type:", type));
   }
@@ -92,6 +101,8 @@ struct GenerateInfo
       m_nodeStorageType = NodeStorageType::Index;
     else if (type == "mem")
       m_nodeStorageType = NodeStorageType::Memory;
+    else if (type == "packed")
+      m_nodeStorageType = NodeStorageType::Packed;
     else
       LOG(LCRITICAL, ("Incorrect node_storage type:", type));
   }
@@ -10,6 +10,10 @@
 #include "indexer/feature_visibility.hpp"
 #include "indexer/ftypes_matcher.hpp"
 
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "coding/internal/file_data.hpp"
+
 #include "base/geo_object_id.hpp"
 
 #include <limits>
@@ -381,6 +385,94 @@ UNIT_CLASS_TEST(TestWithClassificator, FBuilder_RemoveUselessAltName)
   }
 }
 
+UNIT_CLASS_TEST(TestWithClassificator, FBuilder_MappedFeaturesFile)
+{
+  std::vector<FeatureBuilder> fbs;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    FeatureBuilder fb;
+    FeatureBuilderParams params;
+    if (i % 2 == 0)
+    {
+      base::StringIL arr[] = {{"building"}};
+      AddTypes(params, arr);
+      params.FinishAddingTypes();
+      fb.SetParams(params);
+      fb.AddPolygon({{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0 + i}, {0.0, 0.0}});
+      fb.SetArea();
+    }
+    else
+    {
+      base::StringIL arr[] = {{"amenity", "cafe"}};
+      AddTypes(params, arr);
+      params.FinishAddingTypes();
+      fb.SetParams(params);
+      fb.SetCenter({1.0 * i, 2.0 * i});
+    }
+    fb.SetOsmId(base::MakeOsmWay(i + 1));
+    TEST(fb.PreSerializeAndRemoveUselessNamesForIntermediate(), ());
+    fbs.push_back(std::move(fb));
+  }
+
+  platform::tests_support::ScopedFile const file("mapped_features.mwm.tmp",
+                                                 platform::tests_support::ScopedFile::Mode::Create);
+  platform::tests_support::ScopedFile const copy("mapped_features_copy.mwm.tmp",
+                                                 platform::tests_support::ScopedFile::Mode::DoNotCreate);
+  uint64_t writtenSize = 0;
+  {
+    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(file.GetFullPath());
+    for (auto const & fb : fbs)
+      writer.Write(fb);
+    writtenSize = writer.GetWrittenSize();
+  }
+
+  MappedFeaturesFile mapped(file.GetFullPath());
+  TEST_EQUAL(mapped.GetSize(), writtenSize, ());
+  TEST_EQUAL(mapped.GetCount(), fbs.size(), ());
+  for (size_t i = 0; i < fbs.size(); ++i)
+  {
+    FeatureBuilder fb;
+    mapped.Read(i, fb);
+    TEST(fb.IsExactEq(fbs[i]), (fb, fbs[i]));
+  }
+
+  auto const buildingType = classif().GetTypeByPath({"building"});
+  size_t buildingsCount = 0;
+  mapped.ForEachIf([&](TypesHolder const & types)
+  {
+    return types.GetGeomType() == GeomType::Area && types.Has(buildingType);
+  },
+  [&](FeatureBuilder && fb, uint64_t)
+  {
+    TEST(fb.HasType(buildingType), (fb));
+    ++buildingsCount;
+  });
+  TEST_EQUAL(buildingsCount, 5, ());
+
+  {
+    FeatureBuilderWriter<serialization_policy::MaxAccuracy> writer(copy.GetFullPath());
+    mapped.ForEachRecord([&](MappedFeaturesFile::Record const & record) { writer.Write(record); });
+    TEST_EQUAL(writer.GetWrittenSize(), writtenSize, ());
+  }
+  TEST(base::IsEqualFiles(file.GetFullPath(), copy.GetFullPath()), ());
+
+  // Empty files aren't mapped.
+  platform::tests_support::ScopedFile const empty("mapped_features_empty.mwm.tmp", "");
+  TEST_EQUAL(MappedFeaturesFile(empty.GetFullPath()).GetCount(), 0, ());
+
+  // Records are checked against the file size.
+  platform::tests_support::ScopedFile const records("mapped_features_records.mwm.tmp",
+                                                    std::string("\x02" "ab" "\x81\x01") +
+                                                        std::string(129, 'c'));
+  TEST_EQUAL(MappedFeaturesFile(records.GetFullPath()).GetCount(), 2, ());
+  platform::tests_support::ScopedFile const truncated("mapped_features_truncated.mwm.tmp",
+                                                      "\x02" "ab" "\x05" "abc");
+  TEST_ANY_THROW(MappedFeaturesFile(truncated.GetFullPath()), ());
+  platform::tests_support::ScopedFile const brokenSize("mapped_features_broken_size.mwm.tmp",
+                                                       "\x02" "ab" "\x80\x80");
+  TEST_ANY_THROW(MappedFeaturesFile(brokenSize.GetFullPath()), ());
+}
+
 UNIT_CLASS_TEST(TestWithClassificator, FBuilder_RemoveInconsistentTypes)
 {
   FeatureBuilderParams params;
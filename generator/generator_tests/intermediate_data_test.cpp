@@ -8,13 +8,34 @@
 
 #include "testing/testing.hpp"
 
+#include "generator/affiliation.hpp"
+#include "generator/borders.hpp"
+#include "generator/generate_info.hpp"
+#include "generator/intermediate_data.hpp"
 #include "generator/intermediate_elements.hpp"
+#include "generator/osm_change.hpp"
+#include "generator/osm_source.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+#include "platform/platform_tests_support/writable_dir_changer.hpp"
 
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+
+#include "defines.hpp"
+
 #include <cstdint>
+#include <set>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace intermediate_data_test
@@ -109,4 +130,289 @@ UNIT_TEST(Intermediate_Data_relation_element_save_load_test)
   TEST_NOT_EQUAL(e2.m_tags["key1old"], "value1old", ());
   TEST_NOT_EQUAL(e2.m_tags["key2old"], "value2old", ());
 }
+
+UNIT_TEST(Intermediate_Data_sharded_writers_test)
+{
+  using namespace platform::tests_support;
+
+  std::string const kTestDir = "intermediate_data_test";
+  // Ids are far from each other to get elements to different shards.
+  std::string const kOsmSource = R"(<?xml version="1.0" encoding="UTF-8"?>
+<osm version="0.6">
+  <node id="1" lat="53.9" lon="27.5"/>
+  <node id="70000" lat="53.91" lon="27.51"/>
+  <node id="140000" lat="53.92" lon="27.52"/>
+  <way id="10">
+    <nd ref="1"/>
+    <nd ref="70000"/>
+  </way>
+  <way id="80000">
+    <nd ref="70000"/>
+    <nd ref="140000"/>
+  </way>
+  <relation id="5">
+    <member type="way" ref="10" role="outer"/>
+    <member type="way" ref="80000" role="outer"/>
+    <member type="node" ref="140000" role="admin_centre"/>
+    <tag k="type" v="boundary"/>
+  </relation>
+  <relation id="90000">
+    <member type="relation" ref="5" role=""/>
+    <tag k="type" v="route"/>
+  </relation>
+</osm>
+)";
+
+  for (auto const storageType : {feature::GenerateInfo::NodeStorageType::File,
+                                 feature::GenerateInfo::NodeStorageType::Index,
+                                 feature::GenerateInfo::NodeStorageType::Packed})
+  {
+    WritableDirChanger writableDirChanger(kTestDir);
+    auto const & writableDir = GetPlatform().WritableDir();
+    ScopedDir const scopedDir(kTestDir);
+    auto const osmRelativePath = base::JoinPath(kTestDir, "planet.osm");
+    ScopedFile const osmScopedFile(osmRelativePath, kOsmSource);
+
+    feature::GenerateInfo genInfo;
+    genInfo.m_cacheDir = writableDir;
+    genInfo.m_intermediateDir = writableDir;
+    genInfo.m_nodeStorageType = storageType;
+    genInfo.m_osmFileName = base::JoinPath(writableDir, osmRelativePath);
+    genInfo.m_osmFileType = feature::GenerateInfo::OsmSourceType::XML;
+    TEST(generator::GenerateIntermediateData(genInfo, 3 /* threadsCount */), ());
+
+    generator::cache::IntermediateDataObjectsCache objectsCache;
+    generator::cache::IntermediateData data(objectsCache, genInfo);
+    auto const & cache = data.GetCache();
+
+    double y = 0.0;
+    double x = 0.0;
+    for (uint64_t id : {1, 70000, 140000})
+      TEST(cache->GetNode(id, y, x), (id));
+
+    WayElement way(80000);
+    TEST(cache->GetWay(80000, way), ());
+    TEST_EQUAL(way.m_nodes, std::vector<uint64_t>({70000, 140000}), ());
+    TEST(cache->GetWay(10, way), ());
+    TEST_EQUAL(way.m_nodes, std::vector<uint64_t>({1, 70000}), ());
+
+    RelationElement relation;
+    TEST(cache->GetRelation(5, relation), ());
+    TEST_EQUAL(relation.m_ways.size(), 2, ());
+    TEST(cache->GetRelation(90000, relation), ());
+    TEST_EQUAL(relation.m_relations.size(), 1, ());
+
+    std::vector<uint64_t> relationIds;
+    generator::cache::IntermediateDataReaderInterface::ForEachRelationFn collect =
+        [&relationIds](uint64_t id, generator::cache::OSMElementCacheReaderInterface &) {
+          relationIds.push_back(id);
+          return base::ControlFlow::Continue;
+        };
+    for (uint64_t wayId : {10, 80000})
+      cache->ForEachRelationByWayCached(wayId, collect);
+    cache->ForEachRelationByNodeCached(140000, collect);
+    cache->ForEachRelationByRelationCached(5, collect);
+    TEST_EQUAL(relationIds, std::vector<uint64_t>({5, 5, 5, 90000}), ());
+  }
+}
+
+// Border of the one degree square between 53 and 54 degrees of latitude in the .poly format.
+std::string MakeSquarePoly(std::string const & name, int minLon)
+{
+  std::ostringstream poly;
+  poly << name << "\n1\n";
+  for (auto const & [lon, lat] : std::vector<std::pair<int, int>>{
+           {minLon, 53}, {minLon + 1, 53}, {minLon + 1, 54}, {minLon, 54}, {minLon, 53}})
+  {
+    poly << "  " << lon << ".0 " << lat << ".0\n";
+  }
+  poly << "END\nEND\n";
+  return poly.str();
+}
+
+UNIT_TEST(Intermediate_Data_osm_change_test)
+{
+  using namespace platform::tests_support;
+
+  std::string const kTestDir = "intermediate_data_test";
+  std::string const kOsmSource = R"(<?xml version="1.0" encoding="UTF-8"?>
+<osm version="0.6">
+  <node id="1" lat="53.9" lon="27.5"/>
+  <node id="70000" lat="53.91" lon="27.51"/>
+  <node id="140000" lat="53.92" lon="27.52"/>
+  <way id="10">
+    <nd ref="1"/>
+    <nd ref="70000"/>
+  </way>
+  <way id="80000">
+    <nd ref="70000"/>
+    <nd ref="140000"/>
+  </way>
+  <relation id="5">
+    <member type="way" ref="10" role="outer"/>
+    <member type="way" ref="80000" role="outer"/>
+    <member type="node" ref="140000" role="admin_centre"/>
+    <tag k="type" v="boundary"/>
+  </relation>
+  <relation id="90000">
+    <member type="relation" ref="5" role=""/>
+    <tag k="type" v="route"/>
+  </relation>
+</osm>
+)";
+  std::string const kOsmChange = R"(<?xml version="1.0" encoding="UTF-8"?>
+<osmChange version="0.6">
+  <modify>
+    <node id="140000" lat="53.93" lon="28.53"/>
+  </modify>
+  <create>
+    <node id="2" lat="53.95" lon="27.55"/>
+    <way id="11">
+      <nd ref="1"/>
+      <nd ref="2"/>
+    </way>
+  </create>
+  <modify>
+    <relation id="5">
+      <member type="way" ref="80000" role="outer"/>
+      <member type="way" ref="11" role="outer"/>
+      <tag k="type" v="boundary"/>
+    </relation>
+  </modify>
+  <delete>
+    <way id="10"/>
+  </delete>
+</osmChange>
+)";
+
+  for (auto const storageType : {feature::GenerateInfo::NodeStorageType::File,
+                                 feature::GenerateInfo::NodeStorageType::Index,
+                                 feature::GenerateInfo::NodeStorageType::Packed})
+  {
+    WritableDirChanger writableDirChanger(kTestDir);
+    auto const & writableDir = GetPlatform().WritableDir();
+    ScopedDir const scopedDir(kTestDir);
+    auto const osmRelativePath = base::JoinPath(kTestDir, "planet.osm");
+    ScopedFile const osmScopedFile(osmRelativePath, kOsmSource);
+
+    // Node 140000 is moved from One to Two, Three is far from all changed elements.
+    auto const bordersRelativePath = base::JoinPath(kTestDir, BORDERS_DIR);
+    ScopedDir const bordersScopedDir(bordersRelativePath);
+    ScopedFile const oneScopedFile(base::JoinPath(bordersRelativePath, "One" BORDERS_EXTENSION),
+                                   MakeSquarePoly("One", 27));
+    ScopedFile const twoScopedFile(base::JoinPath(bordersRelativePath, "Two" BORDERS_EXTENSION),
+                                   MakeSquarePoly("Two", 28));
+    ScopedFile const threeScopedFile(
+        base::JoinPath(bordersRelativePath, "Three" BORDERS_EXTENSION), MakeSquarePoly("Three", 30));
+
+    feature::GenerateInfo genInfo;
+    genInfo.m_cacheDir = writableDir;
+    genInfo.m_intermediateDir = writableDir;
+    genInfo.m_nodeStorageType = storageType;
+    genInfo.m_osmFileName = base::JoinPath(writableDir, osmRelativePath);
+    genInfo.m_osmFileType = feature::GenerateInfo::OsmSourceType::XML;
+    TEST(generator::GenerateIntermediateData(genInfo), ());
+
+    std::istringstream stream(kOsmChange);
+    generator::SourceReader reader(stream);
+    auto const change = generator::ReadOsmChange(reader);
+    TEST_EQUAL(change.m_created.size(), 2, ());
+    TEST_EQUAL(change.m_modified.size(), 2, ());
+    TEST_EQUAL(change.m_deleted.size(), 1, ());
+
+    feature::CountriesFilesAffiliation const affiliation(base::JoinPath(writableDir, kTestDir),
+                                                         false /* haveBordersForWholeWorld */);
+    TEST_EQUAL(generator::ApplyOsmChange(genInfo, change, affiliation),
+               std::set<std::string>({"One", "Two"}), ());
+
+    generator::cache::IntermediateDataObjectsCache objectsCache;
+    generator::cache::IntermediateData data(objectsCache, genInfo);
+    auto const & cache = data.GetCache();
+
+    m2::PointD point;
+    TEST(cache->GetNode(140000, point.y, point.x), ());
+    TEST(base::AlmostEqualAbs(point, mercator::FromLatLon(53.93, 28.53), 1e-6), (point));
+    TEST(cache->GetNode(2, point.y, point.x), ());
+    TEST(base::AlmostEqualAbs(point, mercator::FromLatLon(53.95, 27.55), 1e-6), (point));
+
+    WayElement way(11);
+    TEST(cache->GetWay(11, way), ());
+    TEST_EQUAL(way.m_nodes, std::vector<uint64_t>({1, 2}), ());
+    TEST(cache->GetWay(80000, way), ());
+    TEST_EQUAL(way.m_nodes, std::vector<uint64_t>({70000, 140000}), ());
+    TEST(!cache->GetWay(10, way), ());
+
+    RelationElement relation;
+    TEST(cache->GetRelation(5, relation), ());
+    TEST_EQUAL(relation.m_ways.size(), 2, ());
+    TEST(relation.m_nodes.empty(), ());
+
+    std::vector<uint64_t> relationIds;
+    generator::cache::IntermediateDataReaderInterface::ForEachRelationFn collect =
+        [&relationIds](uint64_t id, generator::cache::OSMElementCacheReaderInterface &) {
+          relationIds.push_back(id);
+          return base::ControlFlow::Continue;
+        };
+    for (uint64_t wayId : {10, 11, 80000})
+      cache->ForEachRelationByWayCached(wayId, collect);
+    cache->ForEachRelationByNodeCached(140000, collect);
+    cache->ForEachRelationByRelationCached(5, collect);
+    TEST_EQUAL(relationIds, std::vector<uint64_t>({5, 5, 90000}), ());
+
+    std::vector<std::string> countries = {"Country", "Other", WORLD_FILE_NAME};
+    generator::FilterChangedCountries({"Country"}, genInfo.GetIntermediateFileName("report.txt"),
+                                      countries);
+    TEST_EQUAL(countries, std::vector<std::string>({"Country", WORLD_FILE_NAME}), ());
+  }
+}
+
+UNIT_TEST(Intermediate_Data_packed_point_storage_test)
+{
+  using namespace generator::cache;
+  using platform::tests_support::ScopedFile;
+
+  struct Point
+  {
+    uint64_t m_id;
+    double m_lat;
+    double m_lon;
+  };
+
+  // Points of the same pages go apart in the unsorted input, the last coordinates of a point win.
+  std::vector<Point> const sorted = {{1, 53.9, 27.5},           {2, -53.9, -27.5},
+                                     {255, 0.5, 179.99},   {256, 1.0, 1.0},
+                                     {100000, 89.0, -179.0},    {100001, -89.0, 179.0},
+                                     {uint64_t{1} << 24, 10.0, 20.0}};
+  std::vector<Point> unsorted = {{100001, 1.0, 1.0}, {256, 1.0, 1.0}};
+  for (auto it = sorted.rbegin(); it != sorted.rend(); ++it)
+    unsorted.push_back(*it);
+
+  for (auto const & points : {sorted, unsorted})
+  {
+    ScopedFile const file("packed_nodes.dat", ScopedFile::Mode::DoNotCreate);
+    {
+      auto writer = CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType::Packed,
+                                             file.GetFullPath());
+      for (auto const & p : points)
+        writer->AddPoint(p.m_id, p.m_lat, p.m_lon);
+      TEST_EQUAL(writer->GetNumProcessedPoints(), points.size(), ());
+    }
+
+    auto const reader = CreatePointStorageReader(feature::GenerateInfo::NodeStorageType::Packed,
+                                                 file.GetFullPath());
+    double lat = 0.0;
+    double lon = 0.0;
+    for (auto const & p : sorted)
+    {
+      TEST(reader->GetPoint(p.m_id, lat, lon), (p.m_id));
+      TEST_ALMOST_EQUAL_ABS(lat, p.m_lat, 1e-6, (p.m_id));
+      TEST_ALMOST_EQUAL_ABS(lon, p.m_lon, 1e-6, (p.m_id));
+    }
+
+    // Missing points are logged as errors.
+    base::ScopedLogAbortLevelChanger const logAbortLevel;
+    for (uint64_t id : {0, 3, 257, 99999, 100002, 1 << 20, 1 << 30})
+      TEST(!reader->GetPoint(id, lat, lon), (id));
+  }
+}
 }  // namespace intermediate_data_test
@@ -0,0 +1,292 @@
+#include "testing/testing.hpp"
+
+#include "generator/osm_element.hpp"
+#include "generator/osm_pbf_source.hpp"
+#include "generator/osm_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/math.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace osm_pbf_source_test
+{
+using namespace generator;
+using namespace std;
+
+// Writer of messages in the protobuf wire format.
+class MessageWriter
+{
+public:
+  MessageWriter & Varint(uint32_t field, uint64_t value)
+  {
+    Key(field, 0 /* wireType */);
+    Put(value);
+    return *this;
+  }
+
+  MessageWriter & SVarint(uint32_t field, int64_t value) { return Varint(field, ZigZag(value)); }
+
+  MessageWriter & Bytes(uint32_t field, string const & bytes)
+  {
+    Key(field, 2 /* wireType */);
+    Put(bytes.size());
+    m_data += bytes;
+    return *this;
+  }
+
+  MessageWriter & Message(uint32_t field, MessageWriter const & message)
+  {
+    return Bytes(field, message.m_data);
+  }
+
+  MessageWriter & Packed(uint32_t field, vector<uint64_t> const & values)
+  {
+    MessageWriter packed;
+    for (auto const v : values)
+      packed.Put(v);
+    return Bytes(field, packed.m_data);
+  }
+
+  // Delta coded packed field of signed values.
+  MessageWriter & PackedDeltas(uint32_t field, vector<int64_t> const & values)
+  {
+    vector<uint64_t> deltas;
+    int64_t prev = 0;
+    for (auto const v : values)
+    {
+      deltas.push_back(ZigZag(v - prev));
+      prev = v;
+    }
+    return Packed(field, deltas);
+  }
+
+  string const & Data() const { return m_data; }
+
+private:
+  static uint64_t ZigZag(int64_t v)
+  {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+  }
+
+  void Key(uint32_t field, uint8_t wireType) { Put((uint64_t{field} << 3) | wireType); }
+
+  void Put(uint64_t v)
+  {
+    for (; v >= 0x80; v >>= 7)
+      m_data.push_back(static_cast<char>((v & 0x7F) | 0x80));
+    m_data.push_back(static_cast<char>(v));
+  }
+
+  string m_data;
+};
+
+void AppendBlob(string const & type, string const & block, bool compress, string & file)
+{
+  MessageWriter blob;
+  if (compress)
+  {
+    string compressed;
+    coding::ZLib::Deflate const deflate(coding::ZLib::Deflate::Format::ZLib,
+                                        coding::ZLib::Deflate::Level::BestCompression);
+    TEST(deflate(block.data(), block.size(), back_inserter(compressed)), ());
+    blob.Varint(2 /* raw_size */, block.size()).Bytes(3 /* zlib_data */, compressed);
+  }
+  else
+  {
+    blob.Bytes(1 /* raw */, block);
+  }
+
+  MessageWriter header;
+  header.Bytes(1 /* type */, type).Varint(3 /* datasize */, blob.Data().size());
+
+  auto const size = header.Data().size();
+  file.push_back(static_cast<char>(size >> 24));
+  file.push_back(static_cast<char>(size >> 16));
+  file.push_back(static_cast<char>(size >> 8));
+  file.push_back(static_cast<char>(size));
+  file += header.Data();
+  file += blob.Data();
+}
+
+void AppendHeader(string const & requiredFeature, string & file)
+{
+  MessageWriter header;
+  header.Bytes(4 /* required_features */, "OsmSchema-V0.6").Bytes(4, requiredFeature);
+  AppendBlob("OSMHeader", header.Data(), false /* compress */, file);
+}
+
+MessageWriter MakeStringTable(vector<string> const & strings)
+{
+  MessageWriter table;
+  for (auto const & s : strings)
+    table.Bytes(1 /* s */, s);
+  return table;
+}
+
+vector<OsmElement> ReadElements(string const & file, size_t threadsCount)
+{
+  istringstream ss(file);
+  SourceReader reader(ss);
+
+  vector<OsmElement> elements;
+  ProcessOsmElementsFromPbf(reader, [&elements](OsmElement && e)
+  {
+    elements.push_back(move(e));
+  }, threadsCount);
+  return elements;
+}
+
+UNIT_TEST(OSM_PBF_Source_Elements)
+{
+  string file;
+  AppendHeader("DenseNodes", file);
+
+  // Dense nodes with default granularity and a way, in a compressed block.
+  {
+    MessageWriter dense;
+    dense.PackedDeltas(1 /* id */, {100, 101, 103})
+        .PackedDeltas(8 /* lat */, {539000000, 539100000, 539200000})
+        .PackedDeltas(9 /* lon */, {275000000, 275100000, 275200000})
+        .Packed(10 /* keys_vals */, {0, 1, 2, 0, 0});
+
+    MessageWriter way;
+    way.Varint(1 /* id */, 200)
+        .Packed(2 /* keys */, {3})
+        .Packed(3 /* vals */, {4})
+        .PackedDeltas(8 /* refs */, {100, 101, 103});
+
+    MessageWriter group;
+    group.Message(2 /* dense */, dense).Message(3 /* ways */, way);
+
+    MessageWriter block;
+    block.Message(1 /* stringtable */, MakeStringTable({"", "name", "Minsk", "highway", "primary"}))
+        .Message(2 /* primitivegroup */, group);
+    AppendBlob("OSMData", block.Data(), true /* compress */, file);
+  }
+
+  // A relation and a plain node with custom granularity, in a raw block.
+  {
+    MessageWriter node;
+    node.SVarint(1 /* id */, 104)
+        .Packed(2 /* keys */, {1})
+        .Packed(3 /* vals */, {2})
+        .SVarint(8 /* lat */, 5390)
+        .SVarint(9 /* lon */, 2750);
+
+    MessageWriter relation;
+    relation.Varint(1 /* id */, 300)
+        .Packed(2 /* keys */, {3})
+        .Packed(3 /* vals */, {4})
+        .Packed(8 /* roles_sid */, {5, 0})
+        .PackedDeltas(9 /* memids */, {200, 100})
+        .Packed(10 /* types */, {1 /* WAY */, 0 /* NODE */});
+
+    MessageWriter group;
+    group.Message(1 /* nodes */, node).Message(4 /* relations */, relation);
+
+    MessageWriter block;
+    block
+        .Message(1 /* stringtable */,
+                 MakeStringTable({"", "name", "Borisov", "type", "multipolygon", "outer"}))
+        .Message(2 /* primitivegroup */, group)
+        .Varint(17 /* granularity */, 10000000);
+    AppendBlob("OSMData", block.Data(), false /* compress */, file);
+  }
+
+  auto const elements = ReadElements(file, 2 /* threadsCount */);
+  TEST_EQUAL(elements.size(), 6, (elements));
+
+  TEST(elements[0].IsNode(), ());
+  TEST_EQUAL(elements[0].m_id, 100, ());
+  TEST(base::AlmostEqualAbs(elements[0].m_lat, 53.9, 1e-7), ());
+  TEST(base::AlmostEqualAbs(elements[0].m_lon, 27.5, 1e-7), ());
+  TEST(elements[0].Tags().empty(), ());
+
+  TEST_EQUAL(elements[1].m_id, 101, ());
+  TEST_EQUAL(elements[1].GetTag("name"), "Minsk", ());
+  TEST_EQUAL(elements[2].m_id, 103, ());
+  TEST(base::AlmostEqualAbs(elements[2].m_lat, 53.92, 1e-7), ());
+
+  TEST(elements[3].IsWay(), ());
+  TEST_EQUAL(elements[3].m_id, 200, ());
+  TEST_EQUAL(elements[3].Nodes(), vector<uint64_t>({100, 101, 103}), ());
+  TEST_EQUAL(elements[3].GetTag("highway"), "primary", ());
+
+  TEST(elements[4].IsNode(), ());
+  TEST_EQUAL(elements[4].m_id, 104, ());
+  TEST(base::AlmostEqualAbs(elements[4].m_lat, 53.9, 1e-7), ());
+  TEST(base::AlmostEqualAbs(elements[4].m_lon, 27.5, 1e-7), ());
+  TEST_EQUAL(elements[4].GetTag("name"), "Borisov", ());
+
+  TEST(elements[5].IsRelation(), ());
+  TEST_EQUAL(elements[5].m_id, 300, ());
+  TEST_EQUAL(elements[5].GetTag("type"), "multipolygon", ());
+  auto const & members = elements[5].Members();
+  TEST_EQUAL(members.size(), 2, ());
+  TEST_EQUAL(members[0].m_ref, 200, ());
+  TEST_EQUAL(members[0].m_type, OsmElement::EntityType::Way, ());
+  TEST_EQUAL(members[0].m_role, "outer", ());
+  TEST_EQUAL(members[1].m_ref, 100, ());
+  TEST_EQUAL(members[1].m_type, OsmElement::EntityType::Node, ());
+}
+
+UNIT_TEST(OSM_PBF_Source_Order)
+{
+  size_t constexpr kBlocksCount = 50;
+  size_t constexpr kNodesInBlock = 100;
+
+  string file;
+  AppendHeader("DenseNodes", file);
+  for (size_t i = 0; i < kBlocksCount; ++i)
+  {
+    vector<int64_t> ids;
+    vector<int64_t> coords;
+    for (size_t j = 0; j < kNodesInBlock; ++j)
+    {
+      ids.push_back(static_cast<int64_t>(i * kNodesInBlock + j + 1));
+      coords.push_back(static_cast<int64_t>(j));
+    }
+
+    MessageWriter dense;
+    dense.PackedDeltas(1 /* id */, ids).PackedDeltas(8 /* lat */, coords).PackedDeltas(9 /* lon */, coords);
+
+    MessageWriter group;
+    group.Message(2 /* dense */, dense);
+
+    MessageWriter block;
+    block.Message(1 /* stringtable */, MakeStringTable({""})).Message(2 /* primitivegroup */, group);
+    AppendBlob("OSMData", block.Data(), i % 2 == 0 /* compress */, file);
+  }
+
+  for (size_t threadsCount : {1, 4})
+  {
+    auto const elements = ReadElements(file, threadsCount);
+    TEST_EQUAL(elements.size(), kBlocksCount * kNodesInBlock, ());
+    for (size_t i = 0; i < elements.size(); ++i)
+      TEST_EQUAL(elements[i].m_id, i + 1, (threadsCount));
+  }
+}
+
+UNIT_TEST(OSM_PBF_Source_UnsupportedFeature)
+{
+  string file;
+  AppendHeader("HistoricalInformation", file);
+
+  bool thrown = false;
+  try
+  {
+    ReadElements(file, 1 /* threadsCount */);
+  }
+  catch (osm::pbf::PbfException const &)
+  {
+    thrown = true;
+  }
+  TEST(thrown, ());
+}
+}  // namespace osm_pbf_source_test
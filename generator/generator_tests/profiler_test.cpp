@@ -0,0 +1,90 @@
+#include "testing/testing.hpp"
+
+#include "generator/profiler.hpp"
+
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace profiler_test
+{
+using generator::Profiler;
+using platform::tests_support::ScopedFile;
+
+// Touches |bytes| bytes of memory, so they are in the resident set.
+uint64_t UseMemory(size_t bytes)
+{
+  std::vector<uint8_t> buffer(bytes, 1);
+  return std::accumulate(buffer.cbegin(), buffer.cend(), uint64_t(0));
+}
+
+UNIT_TEST(Profiler_Stages)
+{
+  auto & profiler = Profiler::Instance();
+  profiler.Clear();
+
+  {
+    Profiler::Stage outer("outer", "Country");
+    profiler.AddCount("elements", 2);
+    {
+      Profiler::Stage inner("inner");
+      profiler.AddCount("elements", 3);
+      profiler.AddCount("bytes", 4);
+
+      size_t constexpr kBytes = 32 * 1024 * 1024;
+      TEST_EQUAL(UseMemory(kBytes), kBytes, ());
+    }
+    profiler.AddCount("elements", 5);
+  }
+  // There are no opened stages.
+  profiler.AddCount("elements", 7);
+
+  auto const stages = profiler.GetStages();
+  TEST_EQUAL(stages.size(), 2, ());
+
+  auto const & outer = stages[0];
+  TEST_EQUAL(outer.GetKey(), "outer/Country", ());
+  TEST_EQUAL(outer.m_counts, (std::map<std::string, uint64_t>{{"elements", 7}}), ());
+
+  auto const & inner = stages[1];
+  TEST_EQUAL(inner.GetKey(), "inner", ());
+  TEST_EQUAL(inner.m_counts, (std::map<std::string, uint64_t>{{"bytes", 4}, {"elements", 3}}),
+             ());
+
+  TEST_GREATER_OR_EQUAL(outer.m_wallSeconds, inner.m_wallSeconds, ());
+  TEST_GREATER_OR_EQUAL(outer.m_peakRssBytes, inner.m_peakRssBytes, ());
+
+  profiler.Clear();
+  TEST(profiler.GetStages().empty(), ());
+}
+
+UNIT_TEST(Profiler_CompareWithBaseline)
+{
+  auto & profiler = Profiler::Instance();
+  profiler.Clear();
+
+  {
+    Profiler::Stage stage("memory");
+    size_t constexpr kBytes = 128 * 1024 * 1024;
+    TEST_EQUAL(UseMemory(kBytes), kBytes, ());
+  }
+
+  ScopedFile const report("profiler_report.json", ScopedFile::Mode::DoNotCreate);
+  profiler.WriteReport(report.GetFullPath());
+  TEST(report.Exists(), ());
+  TEST(profiler.CompareWithBaseline(report.GetFullPath()), ());
+
+  ScopedFile const baseline("profiler_baseline.json", R"({
+    "stages": [
+      {"stage": "memory", "country": "", "wall_seconds": 0.0, "peak_rss_bytes": 1024},
+      {"stage": "other", "country": "Country", "wall_seconds": 0.0, "peak_rss_bytes": 1024}
+    ]
+  })");
+  TEST(!profiler.CompareWithBaseline(baseline.GetFullPath()), ());
+
+  profiler.Clear();
+}
+}  // namespace profiler_test
@@ -12,6 +12,9 @@
 #include "indexer/classificator.hpp"
 #include "indexer/feature_algo.hpp"
 #include "indexer/ftypes_matcher.hpp"
+#include "indexer/scales.hpp"
+
+#include "coding/internal/file_data.hpp"
 
 namespace raw_generator_tests
 {
@@ -250,6 +253,62 @@ UNIT_CLASS_TEST(TestRawGenerator, BuildingRelation)
   TEST_ALMOST_EQUAL_ABS(buildings, buildingParts, 1.0E-4, ());
 }
 
+UNIT_CLASS_TEST(TestRawGenerator, ParallelGeometry)
+{
+  std::string const mwmName = "Building";
+  BuildFB("./data/osm_test_data/building_relation.osm", mwmName);
+
+  BuildFeatures(mwmName);
+  std::string const singleThreadPath = GetMwmPath(mwmName) + ".single";
+  TEST(base::CopyFileX(GetMwmPath(mwmName), singleThreadPath), ());
+
+  // Geometry is written in the order of features, so the mwm must be the same.
+  SetThreadsCount(3);
+  BuildFeatures(mwmName);
+  TEST(base::IsEqualFiles(GetMwmPath(mwmName), singleThreadPath), ());
+}
+
+UNIT_CLASS_TEST(TestRawGenerator, HilbertGeometryOrder)
+{
+  // Decoded outer geometry and triangles of all scales of every feature.
+  using Geometry = std::vector<std::vector<m2::PointD>>;
+  auto const readGeometry = [this](std::string const & mwmName)
+  {
+    std::vector<Geometry> res;
+    ForEachFeature(mwmName, [&res](std::unique_ptr<FeatureType> ft)
+    {
+      Geometry geometry;
+      for (int scale = 0; scale <= scales::GetUpperScale(); ++scale)
+      {
+        ft->ResetGeometry();
+        auto const & points = ft->GetPoints(scale);
+        geometry.emplace_back(points.begin(), points.end());
+        auto const & triangles = ft->GetTrianglesAsPoints(scale);
+        geometry.emplace_back(triangles.begin(), triangles.end());
+      }
+      res.push_back(std::move(geometry));
+    });
+    return res;
+  };
+
+  // Areas with triangles and lines with outer geometry.
+  for (auto const & [osmFile, mwmName] : std::vector<std::pair<std::string, std::string>>{
+           {"./data/osm_test_data/building_relation.osm", "HilbertBuilding"},
+           {"./data/osm_test_data/highway_links.osm", "HilbertHighway"}})
+  {
+    BuildFB(osmFile, mwmName);
+
+    SetHilbertGeometryOrder(false);
+    BuildFeatures(mwmName);
+    auto const expected = readGeometry(mwmName);
+    TEST(!expected.empty(), (osmFile));
+
+    SetHilbertGeometryOrder(true);
+    BuildFeatures(mwmName);
+    TEST_EQUAL(readGeometry(mwmName), expected, (osmFile));
+  }
+}
+
 UNIT_CLASS_TEST(TestRawGenerator, AreaHighway)
 {
   std::string const mwmName = "AreaHighway";
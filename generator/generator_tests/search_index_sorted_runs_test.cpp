@@ -0,0 +1,111 @@
+#include "testing/testing.hpp"
+
+#include "generator/search_index_sorted_runs.hpp"
+
+#include "indexer/trie_builder.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/byte_stream.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace search_index_sorted_runs_test
+{
+using namespace indexer;
+
+using Serializer = SingleValueSerializer<IndexValue>;
+using Sink = PushBackByteSink<std::vector<uint8_t>>;
+
+// Short keys of a few letters, so there are many common prefixes and equal pairs.
+std::vector<IndexPair> MakeRandomPairs(size_t count)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> length(1, 5);
+  std::uniform_int_distribution<uint32_t> letter(0, 4);
+  std::uniform_int_distribution<uint64_t> featureId(0, 50);
+
+  std::vector<IndexPair> pairs(count);
+  for (auto & [key, value] : pairs)
+  {
+    key.resize(length(rng));
+    for (auto & c : key)
+      c = (letter(rng) == 0 ? 0x0430 : 'a') + letter(rng);
+    value.m_featureId = featureId(rng);
+  }
+  return pairs;
+}
+
+std::string GetRunsPrefix() { return base::JoinPath(GetPlatform().WritableDir(), "sorted_runs"); }
+
+UNIT_TEST(SortedRuns_MergeIsEqualToBuild)
+{
+  auto const pairs = MakeRandomPairs(5000);
+
+  // Each thread writes its own runs of 100 pairs at most, as BuildSearchIndex() does.
+  size_t constexpr kThreadsCount = 4;
+  size_t constexpr kBufferBytes = 100 * sizeof(IndexPair);
+  std::vector<std::vector<std::string>> threadRuns(kThreadsCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadsCount; ++i)
+  {
+    threads.emplace_back([&, i]()
+    {
+      SortedRunsWriter writer(GetRunsPrefix() + strings::to_string(i), kBufferBytes);
+      for (size_t j = i; j < pairs.size(); j += kThreadsCount)
+        writer.emplace_back(pairs[j]);
+      threadRuns[i] = writer.Finish();
+    });
+  }
+  for (auto & t : threads)
+    t.join();
+
+  std::vector<std::string> runs;
+  for (auto const & paths : threadRuns)
+    runs.insert(runs.end(), paths.begin(), paths.end());
+  TEST_GREATER_OR_EQUAL(runs.size(), pairs.size() / 100, ());
+
+  Serializer const serializer;
+  std::vector<uint8_t> merged;
+  {
+    Sink sink(merged);
+    trie::Builder<Sink, IndexKey, ValueList<IndexValue>, Serializer> builder(sink, serializer);
+    MergeSortedRuns(runs, [&builder](IndexPair const & pair) { builder.Add(pair.first, pair.second); });
+    builder.Finish();
+  }
+  for (auto const & path : runs)
+    FileWriter::DeleteFileX(path);
+
+  auto sorted = pairs;
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<uint8_t> expected;
+  {
+    Sink sink(expected);
+    trie::Build<Sink, IndexKey, ValueList<IndexValue>, Serializer>(sink, serializer, sorted);
+  }
+
+  TEST_EQUAL(merged, expected, ());
+}
+
+UNIT_TEST(SortedRuns_NotFinishedRunsAreDeleted)
+{
+  auto const pairs = MakeRandomPairs(10);
+  std::string firstRun;
+  {
+    SortedRunsWriter writer(GetRunsPrefix(), sizeof(IndexPair));
+    for (auto const & pair : pairs)
+      writer.emplace_back(pair);
+    firstRun = GetRunsPrefix() + ".0";
+    TEST(Platform::IsFileExistsByFullPath(firstRun), ());
+  }
+  TEST(!Platform::IsFileExistsByFullPath(firstRun), ());
+}
+}  // namespace search_index_sorted_runs_test
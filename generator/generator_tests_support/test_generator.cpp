@@ -13,6 +13,7 @@
 #include "generator/search_index_builder.hpp"
 
 #include "indexer/classificator_loader.hpp"
+#include "indexer/feature_types_table.hpp"
 #include "indexer/features_offsets_table.hpp"
 #include "indexer/index_builder.hpp"
 #include "indexer/map_style_reader.hpp"
@@ -96,6 +97,7 @@ void TestRawGenerator::BuildFeatures(std::string const & mwmName)
   std::string const mwmPath = GetMwmPath(mwmName);
 
   CHECK(BuildOffsetsTable(mwmPath), ());
+  CHECK(BuildTypesTable(mwmPath), ());
   CHECK(indexer::BuildIndexFromDataFile(mwmPath, mwmPath), ());
 }
 
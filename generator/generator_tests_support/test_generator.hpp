@@ -56,6 +56,8 @@ public:
   std::string GetCitiesBoundariesPath() const;
 
   feature::GenerateInfo const & GetGenInfo() const { return m_genInfo; }
+  void SetThreadsCount(size_t threadsCount) { m_genInfo.m_threadsCount = threadsCount; }
+  void SetHilbertGeometryOrder(bool enabled) { m_genInfo.m_hilbertGeometryOrder = enabled; }
   bool IsWorld(std::string const & mwmName) const;
 
   static char const * kWikidataFilename;
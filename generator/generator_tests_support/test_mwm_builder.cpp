@@ -14,6 +14,7 @@
 #include "indexer/data_header.hpp"
 #include "indexer/feature_data.hpp"
 #include "indexer/feature_meta.hpp"
+#include "indexer/feature_types_table.hpp"
 #include "indexer/features_offsets_table.hpp"
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/index_builder.hpp"
@@ -163,6 +164,7 @@ void TestMwmBuilder::Finish()
   UNUSED_VALUE(base::DeleteFileX(path + OSM2FEATURE_FILE_EXTENSION));
 
   CHECK(BuildOffsetsTable(path), ("Can't build feature offsets table."));
+  CHECK(BuildTypesTable(path), ("Can't build feature types table."));
 
   CHECK(indexer::BuildIndexFromDataFile(path, path), ("Can't build geometry index."));
 
@@ -14,11 +14,13 @@
 #include "generator/isolines_section_builder.hpp"
 #include "generator/maxspeeds_builder.hpp"
 #include "generator/metalines_builder.hpp"
+#include "generator/osm_change.hpp"
 #include "generator/osm_source.hpp"
 #include "generator/platform_helpers.hpp"
 #include "generator/popular_places_section_builder.hpp"
 #include "generator/postcode_points_builder.hpp"
 #include "generator/processor_factory.hpp"
+#include "generator/profiler.hpp"
 #include "generator/raw_generator.hpp"
 #include "generator/restriction_generator.hpp"
 #include "generator/road_access_generator.hpp"
@@ -41,6 +43,7 @@
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_header.hpp"
+#include "indexer/feature_types_table.hpp"
 #include "indexer/features_offsets_table.hpp"
 #include "indexer/index_builder.hpp"
 #include "indexer/map_style_reader.hpp"
@@ -49,7 +52,9 @@
 #include "platform/platform.hpp"
 
 #include "coding/endianness.hpp"
+#include "coding/files_container.hpp"
 
+#include "base/checked_cast.hpp"
 #include "base/file_name_utils.hpp"
 #include "base/timer.hpp"
 
@@ -59,7 +64,9 @@
 #include <cstdlib>
 #include <fstream>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <gflags/gflags.h>
 
@@ -74,6 +81,17 @@ char const * GetDataPathHelp()
       Platform::GetCurrentWorkingDirectory() + "/../../data'.";
   return kHelp.c_str();
 }
+
+// Adds sizes of |tags| sections of |dataFile| to counts of the current profiler stage.
+void AddSectionSizes(std::string const & dataFile, std::vector<std::string> const & tags)
+{
+  FilesContainerR container(dataFile);
+  for (auto const & tag : tags)
+  {
+    if (container.IsExist(tag))
+      generator::Profiler::Instance().AddCount(tag + "_bytes", container.GetReader(tag).Size());
+  }
+}
 }  // namespace
 
 // Coastlines.
@@ -85,7 +103,7 @@ DEFINE_bool(emit_coasts, false,
 
 // Generator settings and paths.
 DEFINE_string(osm_file_name, "", "Input osm area file.");
-DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m].");
+DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m, pbf].");
 DEFINE_string(data_path, "", GetDataPathHelp());
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_string(intermediate_data_path, "", "Path to stored intermediate data.");
@@ -95,15 +113,24 @@ DEFINE_string(cache_path, "",
 DEFINE_string(output, "", "File name for process (without 'mwm' ext).");
 DEFINE_bool(preload_cache, false, "Preload all ways and relations cache.");
 DEFINE_string(node_storage, "map",
-              "Type of storage for intermediate points representation. Available: raw, map, mem.");
+              "Type of storage for intermediate points representation. Available: raw, map, mem, packed.");
 DEFINE_uint64(planet_version, base::SecondsSinceEpoch(),
               "Version as seconds since epoch, by default - now.");
 
 // Preprocessing and feature generator.
 DEFINE_bool(preprocess, false, "1st pass - create nodes/ways/relations data.");
+DEFINE_string(osm_change, "",
+              "OsmChange file which is applied to nodes/ways/relations data of the previous "
+              "preprocessing, so it can't be used with --preprocess. --osm_file_name must be "
+              "the planet with the change already applied, the 2nd pass reads it. "
+              "Passes after the 2nd one are run for countries affected by the change only, "
+              "see osm_change_report.txt in the intermediate data path.");
 DEFINE_bool(generate_features, false, "2nd pass - generate intermediate features.");
 DEFINE_bool(generate_geometry, false,
             "3rd pass - split and simplify geometry and triangles for features.");
+DEFINE_bool(hilbert_geometry_order, false,
+            "Lay out outer geometry and triangles of each scale in the Hilbert curve order of "
+            "features. Geometry is simplified twice.");
 DEFINE_bool(generate_index, false, "4rd pass - generate index.");
 DEFINE_bool(generate_search_index, false, "5th pass - generate search index.");
 DEFINE_bool(dump_cities_boundaries, false, "Dump cities boundaries to a file");
@@ -175,6 +202,8 @@ DEFINE_uint64(stats_geom_min_diff, 5, "Consider feature's geometry scale "
 DEFINE_double(stats_geom_min_factor, 2.0f, "Consider feature's geometry scale "
               "similar to a more detailed one if it has <min_factor times less elements.");
 DEFINE_bool(stats_types, false, "Print feature stats by type.");
+DEFINE_bool(stats_compression, false,
+            "Print sizes and random read latencies of block-compressed sections.");
 DEFINE_bool(dump_types, false, "Prints all types combinations and their total count.");
 DEFINE_bool(dump_prefixes, false, "Prints statistics on feature's' name prefixes.");
 DEFINE_bool(dump_search_tokens, false, "Print statistics on search tokens.");
@@ -189,6 +218,10 @@ DEFINE_bool(unpack_mwm, false,
             "Unpack each section of mwm into a separate file with name filePath.sectionName.");
 DEFINE_bool(check_mwm, false, "Check map file to be correct.");
 DEFINE_string(delete_section, "", "Delete specified section (defines.hpp) from container.");
+DEFINE_bool(compress_sections, false,
+            "Store sections listed in COMPRESSED_SECTION_TAGS (defines.hpp) block-compressed.");
+DEFINE_uint64(compressed_section_block_size, 16 * 1024,
+              "Size of independently compressed blocks of sections, see --compress_sections.");
 DEFINE_bool(generate_traffic_keys, false,
             "Generate keys for the traffic map (road segment -> speed group).");
 
@@ -198,6 +231,12 @@ DEFINE_bool(dump_mwm_tmp, false, "Prints feature builder objects from .mwm.tmp")
 DEFINE_uint64(threads_count, 0, "Desired count of threads. If count equals zero, count of "
                                 "threads is set automatically.");
 DEFINE_bool(verbose, false, "Provide more detailed output.");
+DEFINE_string(profile_report, "",
+              "Output JSON file with wall and CPU time, peak RSS, bytes read and written and "
+              "element counts of generation stages, per country for country stages.");
+DEFINE_string(profile_baseline, "",
+              "JSON report of a previous run, see --profile_report. Stages which became slower or "
+              "use more memory than in it are logged.");
 
 MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 {
@@ -235,6 +274,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   genInfo.m_cacheDir = FLAGS_cache_path.empty() ? genInfo.m_intermediateDir
                                                 : base::AddSlashIfNeeded(FLAGS_cache_path);
   genInfo.m_targetDir = genInfo.m_tmpDir = path;
+  genInfo.m_threadsCount = threadsCount;
 
   /// @todo Probably, it's better to add separate option for .mwm.tmp files.
   if (!FLAGS_intermediate_data_path.empty())
@@ -251,6 +291,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   genInfo.m_osmFileName = FLAGS_osm_file_name;
   genInfo.m_failOnCoasts = FLAGS_fail_on_coasts;
   genInfo.m_preloadCache = FLAGS_preload_cache;
+  genInfo.m_hilbertGeometryOrder = FLAGS_hilbert_geometry_order;
   genInfo.m_popularPlacesFilename = FLAGS_popular_places_data;
   genInfo.m_brandsFilename = FLAGS_brands_data;
   genInfo.m_brandsTranslationsFilename = FLAGS_brands_translations_data;
@@ -270,14 +311,41 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 
   classificator::Load();
 
+  // Intermediate data of the new planet has the change already, it mustn't be applied twice.
+  if (FLAGS_preprocess && !FLAGS_osm_change.empty())
+  {
+    LOG(LCRITICAL, ("--preprocess can't be used with --osm_change, the change is applied to",
+                    "intermediate data of the previous run."));
+    return EXIT_FAILURE;
+  }
+
   // Generate intermediate files.
   if (FLAGS_preprocess)
   {
     LOG(LINFO, ("Generating intermediate data ...."));
-    if (!GenerateIntermediateData(genInfo))
+    Profiler::Stage stage("preprocess");
+    if (!GenerateIntermediateData(genInfo, threadsCount))
       return EXIT_FAILURE;
   }
 
+  std::set<string> changedCountries;
+  if (!FLAGS_osm_change.empty())
+  {
+    LOG(LINFO, ("Applying OsmChange", FLAGS_osm_change, "to intermediate data ...."));
+    Profiler::Stage stage("osm_change");
+    SourceReader reader(FLAGS_osm_change);
+    auto const change = ReadOsmChange(reader);
+    feature::CountriesFilesIndexAffiliation affiliation(genInfo.m_targetDir,
+                                                        genInfo.m_haveBordersForWholeWorld);
+    changedCountries = ApplyOsmChange(genInfo, change, affiliation);
+
+    auto & profiler = Profiler::Instance();
+    profiler.AddCount("created", change.m_created.size());
+    profiler.AddCount("modified", change.m_modified.size());
+    profiler.AddCount("deleted", change.m_deleted.size());
+    profiler.AddCount("changed_countries", changedCountries.size());
+  }
+
   // Generate .mwm.tmp files.
   if (FLAGS_generate_features || FLAGS_generate_world || FLAGS_make_coasts)
   {
@@ -298,6 +366,13 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   if (genInfo.m_bucketNames.empty() && !FLAGS_output.empty())
     genInfo.m_bucketNames.push_back(FLAGS_output);
 
+  if (!FLAGS_osm_change.empty())
+  {
+    FilterChangedCountries(changedCountries,
+                           genInfo.GetIntermediateFileName("osm_change_report", ".txt"),
+                           genInfo.m_bucketNames);
+  }
+
   if (FLAGS_dump_mwm_tmp)
   {
     for (auto const & fb : feature::ReadAllDatRawFormat(genInfo.GetTmpFileName(FLAGS_output)))
@@ -339,6 +414,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
     if (FLAGS_generate_geometry)
     {
       using MapType = feature::DataHeader::MapType;
+      Profiler::Stage stage("geometry", country);
 
       MapType mapType = MapType::Country;
       if (country == WORLD_FILE_NAME)
@@ -356,6 +432,10 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       if (!feature::BuildOffsetsTable(dataFile))
         continue;
 
+      LOG(LINFO, ("Generating types table for", dataFile));
+      if (!feature::BuildTypesTable(dataFile))
+        continue;
+
       if (mapType == MapType::Country)
       {
         string const metalinesFilename = genInfo.GetIntermediateFileName(METALINES_FILENAME);
@@ -364,19 +444,29 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
         if (!feature::WriteMetalinesSection(dataFile, metalinesFilename, osmToFeatureFilename))
           LOG(LCRITICAL, ("Error generating metalines section."));
       }
+
+      {
+        FilesContainerR container(dataFile);
+        Profiler::Instance().AddCount("features",
+                                      feature::FeaturesOffsetsTable::Load(container)->size());
+      }
+      AddSectionSizes(dataFile, {FEATURES_FILE_TAG, GEOMETRY_FILE_TAG, TRIANGLE_FILE_TAG});
     }
 
     if (FLAGS_generate_index)
     {
       LOG(LINFO, ("Generating index for", dataFile));
+      Profiler::Stage stage("index", country);
 
       if (!indexer::BuildIndexFromDataFile(dataFile, FLAGS_intermediate_data_path + country))
         LOG(LCRITICAL, ("Error generating index."));
+      AddSectionSizes(dataFile, {INDEX_FILE_TAG});
     }
 
     if (FLAGS_generate_search_index)
     {
       LOG(LINFO, ("Generating search index for", dataFile));
+      Profiler::Stage stage("search_index", country);
 
       /// @todo Make threads count according to environment (single mwm build or planet build).
       if (!indexer::BuildSearchIndexFromDataFile(country, genInfo, true /* forceRebuild */,
@@ -420,6 +510,10 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       LOG(LINFO, ("Generating centers table for", dataFile));
       if (!indexer::BuildCentersTableFromDataFile(dataFile, true /* forceRebuild */))
         LOG(LCRITICAL, ("Error generating centers table."));
+
+      AddSectionSizes(dataFile, {SEARCH_INDEX_FILE_TAG, FEATURE2STREET_FILE_TAG,
+                                 FEATURE2PLACE_FILE_TAG, POSTCODE_POINTS_FILE_TAG,
+                                 SEARCH_RANKS_FILE_TAG, CENTERS_FILE_TAG});
     }
 
     if (FLAGS_generate_cities_boundaries)
@@ -484,6 +578,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 
     if (FLAGS_make_routing_index)
     {
+      Profiler::Stage stage("routing", country);
       if (!countryParentGetter)
       {
         // All the mwms should use proper VehicleModels.
@@ -524,10 +619,14 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
         LOG(LINFO, ("Generating maxspeeds section for", dataFile, "using", maxspeedsFilename));
         BuildMaxspeedsSection(routingGraph.get(), dataFile, osmToFeatureFilename, maxspeedsFilename);
       }
+
+      AddSectionSizes(dataFile, {CITY_ROADS_FILE_TAG, ROUTING_FILE_TAG, RESTRICTIONS_FILE_TAG,
+                                 ROAD_ACCESS_FILE_TAG, MAXSPEEDS_FILE_TAG});
     }
 
     if (FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm || FLAGS_make_transit_cross_mwm_experimental)
     {
+      Profiler::Stage stage("cross_mwm", country);
       if (!countryParentGetter)
       {
         // All the mwms should use proper VehicleModels.
@@ -558,6 +657,8 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
                                     transitEdgeFeatureIds,
                                     false /* experimentalTransit */);
       }
+
+      AddSectionSizes(dataFile, {CROSS_MWM_FILE_TAG, TRANSIT_CROSS_MWM_FILE_TAG});
     }
 
     // Check !generate_popular_places to avoid mixing, generate_popular_places stage uses the same wiki flags.
@@ -588,7 +689,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 
   string const dataFile = base::JoinPath(path, FLAGS_output + DATA_FILE_EXTENSION);
 
-  if (FLAGS_stats_general || FLAGS_stats_geometry || FLAGS_stats_types)
+  if (FLAGS_stats_general || FLAGS_stats_geometry || FLAGS_stats_types || FLAGS_stats_compression)
   {
     LOG(LINFO, ("Calculating statistics for", dataFile));
     auto file = OfstreamWithExceptions(genInfo.GetIntermediateFileName(FLAGS_output, STATS_EXTENSION));
@@ -612,6 +713,11 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       LOG(LINFO, ("Writing types statistics"));
       stats::PrintTypeStats(file, info);
     }
+    if (FLAGS_stats_compression)
+    {
+      LOG(LINFO, ("Writing sections compression statistics"));
+      stats::PrintSectionsCompressionStats(file, dataFile);
+    }
     LOG(LINFO, ("Stats written to file", FLAGS_output + STATS_EXTENSION));
   }
 
@@ -633,6 +739,12 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   if (!FLAGS_delete_section.empty())
     DeleteSection(dataFile, FLAGS_delete_section);
 
+  if (FLAGS_compress_sections)
+  {
+    CompressSections(dataFile,
+                     base::checked_cast<uint32_t>(FLAGS_compressed_section_block_size));
+  }
+
   if (FLAGS_generate_packed_borders)
     borders::GeneratePackedBorders(path);
 
@@ -642,5 +754,11 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   if (FLAGS_check_mwm)
     check_model::ReadFeatures(dataFile);
 
+  if (!FLAGS_profile_report.empty())
+    Profiler::Instance().WriteReport(FLAGS_profile_report);
+
+  if (!FLAGS_profile_baseline.empty())
+    Profiler::Instance().CompareWithBaseline(FLAGS_profile_baseline);
+
   return EXIT_SUCCESS;
 })
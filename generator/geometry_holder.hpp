@@ -33,7 +33,8 @@ double constexpr kGeomMinFactor = 1.5f;
 class GeometryHolder
 {
 public:
-  using FileGetter = std::function<FileWriter &(int i)>;
+  // Files of geometry and triangles of scales, may be in-memory writers, see FeaturesCollector2.
+  using FileGetter = std::function<Writer &(int i)>;
   using Points = std::vector<m2::PointD>;
   using Polygons = std::list<Points>;
 
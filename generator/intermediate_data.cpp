@@ -1,8 +1,20 @@
 #include "generator/intermediate_data.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <new>
 #include <set>
 #include <string>
+#include <unordered_set>
+
+#include "coding/byte_stream.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
 
 #include "base/assert.hpp"
 #include "base/checked_cast.hpp"
@@ -19,6 +31,7 @@ namespace
 size_t const kFlushCount = 1024;
 double const kValueOrder = 1e7;
 string const kShortExtension = ".short";
+string const kFilteredExtension = ".filtered";
 
 // An estimation.
 // OSM had around 4.1 billion nodes on 2017-11-08,
@@ -65,10 +78,128 @@ public:
   // PointStorageWriterInterface overrides:
   uint64_t GetNumProcessedPoints() const override { return m_numProcessedPoints; }
 
-private:
-  uint64_t m_numProcessedPoints{0};
+protected:
+  std::atomic<uint64_t> m_numProcessedPoints{0};
 };
 
+// Layout of elements of index files written by IndexFileWriter.
+using IndexElement = std::pair<Key, uint64_t>;
+
+// Calls |toDo| with batches of elements of the index |name|.
+template <typename ToDo>
+void ForEachIndexBatch(string const & name, ToDo && toDo)
+{
+  using Element = IndexElement;
+  size_t constexpr kBatchSize = 1 << 20;
+
+  FileReader reader(name);
+  auto const size = reader.Size();
+  CHECK_EQUAL(size % sizeof(Element), 0, ("Damaged file", reader.GetName()));
+  std::vector<Element> elements;
+  for (uint64_t pos = 0; pos < size;)
+  {
+    elements.resize(static_cast<size_t>(
+        std::min<uint64_t>(kBatchSize, (size - pos) / sizeof(Element))));
+    reader.Read(pos, elements.data(), elements.size() * sizeof(Element));
+    pos += elements.size() * sizeof(Element);
+    // |toDo| may change |elements|.
+    toDo(elements);
+  }
+}
+
+// Appends offsets of the cache part |partOffsets| shifted by |dataSize| to |offsets|.
+void AppendOffsets(string const & partOffsets, uint64_t dataSize, FileWriter & offsets)
+{
+  ForEachIndexBatch(partOffsets, [&](std::vector<IndexElement> & elements) {
+    for (auto & e : elements)
+      e.second += dataSize;
+    offsets.Write(elements.data(), elements.size() * sizeof(elements.front()));
+  });
+}
+
+// Removes elements of the index |name| which satisfy |isRemoved|.
+template <typename Pred>
+void RemoveFromIndex(string const & name, Pred && isRemoved)
+{
+  auto const filteredName = name + kFilteredExtension;
+  {
+    FileWriter writer(filteredName);
+    ForEachIndexBatch(name, [&](std::vector<IndexElement> & elements) {
+      elements.erase(std::remove_if(elements.begin(), elements.end(), isRemoved), elements.end());
+      if (!elements.empty())
+        writer.Write(elements.data(), elements.size() * sizeof(elements.front()));
+    });
+  }
+  CHECK(base::RenameFileX(filteredName, name), (name));
+}
+
+// Appends parts of a cache to the cache |name|, offsets of values in parts are shifted by
+// sizes of the previous parts.
+void MergeCacheParts(string const & name, std::vector<string> const & partSuffixes)
+{
+  { FileWriter data(name); }
+  FileWriter offsets(name + OFFSET_EXT);
+  uint64_t dataSize = 0;
+  for (auto const & suffix : partSuffixes)
+  {
+    auto const part = name + suffix;
+    AppendOffsets(part + OFFSET_EXT, dataSize, offsets);
+
+    uint64_t partSize = 0;
+    CHECK(base::GetFileSize(part, partSize), (part));
+    base::AppendFileToFile(part, name);
+    dataSize += partSize;
+
+    base::DeleteFileX(part);
+    base::DeleteFileX(part + OFFSET_EXT);
+  }
+}
+
+// Concatenates parts of an index to the index |name|.
+void MergeIndexParts(string const & name, std::vector<string> const & partSuffixes)
+{
+  { FileWriter index(name); }
+  for (auto const & suffix : partSuffixes)
+  {
+    base::AppendFileToFile(name + suffix, name);
+    base::DeleteFileX(name + suffix);
+  }
+}
+
+// Replaces values of the cache |name| with |changed| ids by values of the part with |partSuffix|.
+// Values of the part are appended to the data of the cache, old values are left unreferenced.
+void ApplyCachePart(string const & name, string const & partSuffix,
+                    std::unordered_set<Key> const & changed)
+{
+  auto const part = name + partSuffix;
+  RemoveFromIndex(name + OFFSET_EXT, [&](IndexElement const & e) {
+    return changed.count(e.first) != 0;
+  });
+
+  uint64_t dataSize = 0;
+  CHECK(base::GetFileSize(name, dataSize), (name));
+  {
+    FileWriter offsets(name + OFFSET_EXT, FileWriter::OP_APPEND);
+    AppendOffsets(part + OFFSET_EXT, dataSize, offsets);
+  }
+  base::AppendFileToFile(part, name);
+
+  base::DeleteFileX(part);
+  base::DeleteFileX(part + OFFSET_EXT);
+}
+
+// Replaces entries of relations with |changedRelations| ids in the index |name| by entries of
+// the part with |partSuffix|.
+void ApplyIndexPart(string const & name, string const & partSuffix,
+                    std::unordered_set<Key> const & changedRelations)
+{
+  RemoveFromIndex(name, [&](IndexElement const & e) {
+    return changedRelations.count(e.second) != 0;
+  });
+  base::AppendFileToFile(name + partSuffix, name);
+  base::DeleteFileX(name + partSuffix);
+}
+
 // RawFilePointStorageMmapReader -------------------------------------------------------------------
 class RawFilePointStorageMmapReader : public PointStorageReaderInterface
 {
@@ -97,8 +228,9 @@ private:
 class RawFilePointStorageWriter : public PointStorageWriterBase
 {
 public:
-  explicit RawFilePointStorageWriter(string const & name) :
-    m_fileWriter(name)
+  explicit RawFilePointStorageWriter(string const & name,
+                                     FileWriter::Op op = FileWriter::OP_WRITE_TRUNCATE)
+    : m_fileWriter(name, op)
   {}
 
   // PointStorageWriterInterface overrides:
@@ -115,7 +247,6 @@ public:
 
 private:
   FileWriter m_fileWriter;
-  uint64_t m_numProcessedPoints = 0;
 };
 
 // RawMemPointStorageReader ------------------------------------------------------------------------
@@ -172,10 +303,12 @@ public:
     ++m_numProcessedPoints;
   }
 
+  // Points are stored in their own slots of the preallocated array.
+  bool AllowsConcurrentAdding() const override { return true; }
+
 private:
   FileWriter m_fileWriter;
   std::vector<LatLon> m_data;
-  uint64_t m_numProcessedPoints = 0;
 };
 
 // MapFilePointStorageReader -----------------------------------------------------------------------
@@ -199,7 +332,8 @@ public:
 
       ll.m_lat = llp.m_lat;
       ll.m_lon = llp.m_lon;
-      m_map.emplace(llp.m_pos, ll);
+      // Points appended by updates replace the previous ones.
+      m_map[llp.m_pos] = ll;
     }
 
     LOG(LINFO, ("Nodes reading is finished"));
@@ -229,8 +363,9 @@ private:
 class MapFilePointStorageWriter : public PointStorageWriterBase
 {
 public:
-  explicit MapFilePointStorageWriter(string const & name) :
-    m_fileWriter(name + kShortExtension)
+  explicit MapFilePointStorageWriter(string const & name,
+                                     FileWriter::Op op = FileWriter::OP_WRITE_TRUNCATE)
+    : m_fileWriter(name + kShortExtension, op)
   {
   }
 
@@ -252,7 +387,399 @@ public:
 
 private:
   FileWriter m_fileWriter;
-  uint64_t m_numProcessedPoints = 0;
+};
+
+// Packed storage ----------------------------------------------------------------------------------
+// Points are grouped into pages of consecutive ids. A page is the count of its points followed by
+// varint coded deltas of ids in the page and zigzag coded deltas of coordinates. The file is
+// pages in the order of ids, the directory of offsets of all pages up to the last one and
+// the count of pages. An empty page takes only its entry in the directory.
+uint8_t constexpr kPackedPageBits = 8;
+uint64_t constexpr kPackedPageSize = uint64_t{1} << kPackedPageBits;
+string const kPackedChunksExtension = ".chunks";
+
+using PackedPage = std::array<LatLon, kPackedPageSize>;
+
+// A piece of a page written by PackedPointStorageWriter.
+struct PackedChunk
+{
+  uint64_t m_offset = 0;
+  uint32_t m_page = 0;
+  uint32_t m_size = 0;
+};
+static_assert(sizeof(PackedChunk) == 16, "Invalid structure size");
+
+bool IsEmpty(LatLon const & ll) { return ll.m_lat == 0 && ll.m_lon == 0; }
+
+void EncodePackedPage(PackedPage const & page, std::vector<uint8_t> & buffer)
+{
+  buffer.clear();
+  PushBackByteSink<std::vector<uint8_t>> sink(buffer);
+  auto const count = std::count_if(page.begin(), page.end(), [](LatLon const & ll) {
+    return !IsEmpty(ll);
+  });
+  WriteVarUint(sink, static_cast<uint32_t>(count));
+
+  uint32_t prevId = 0;
+  LatLon prev;
+  for (uint32_t id = 0; id < page.size(); ++id)
+  {
+    auto const & ll = page[id];
+    if (IsEmpty(ll))
+      continue;
+
+    WriteVarUint(sink, id - prevId);
+    WriteVarInt(sink, int64_t{ll.m_lat} - prev.m_lat);
+    WriteVarInt(sink, int64_t{ll.m_lon} - prev.m_lon);
+    prevId = id;
+    prev = ll;
+  }
+}
+
+// ArrayByteSource which doesn't read past the end of a damaged page.
+class PackedPageSource
+{
+public:
+  PackedPageSource(uint8_t const * data, size_t size) : m_ptr(data), m_end(data + size) {}
+
+  void Read(void * p, size_t size)
+  {
+    CHECK(size <= static_cast<size_t>(m_end - m_ptr), ("Damaged packed page."));
+    memcpy(p, m_ptr, size);
+    m_ptr += size;
+  }
+
+private:
+  uint8_t const * m_ptr;
+  uint8_t const * const m_end;
+};
+
+// Sets points of the encoded page to |page|, other points of |page| are left as is.
+void DecodePackedPage(uint8_t const * data, size_t size, PackedPage & page)
+{
+  PackedPageSource src(data, size);
+  auto const count = ReadVarUint<uint32_t>(src);
+
+  uint32_t id = 0;
+  LatLon ll;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    id += ReadVarUint<uint32_t>(src);
+    CHECK_LESS(id, page.size(), ("Damaged packed page."));
+    ll.m_lat = static_cast<int32_t>(ll.m_lat + ReadVarInt<int64_t>(src));
+    ll.m_lon = static_cast<int32_t>(ll.m_lon + ReadVarInt<int64_t>(src));
+    page[id] = ll;
+  }
+}
+
+// Writes the directory of pages after the data of pages and the footer.
+class PackedDirectoryWriter
+{
+public:
+  explicit PackedDirectoryWriter(FileWriter & writer) : m_writer(writer) {}
+
+  // Pages must be added in the order of ids.
+  void AddPage(uint32_t page, uint64_t offset)
+  {
+    CHECK_GREATER_OR_EQUAL(page, m_pagesCount, ());
+    // Empty pages before |page| end where |page| starts.
+    for (; m_pagesCount <= page; ++m_pagesCount)
+      WriteToSink(m_writer, offset);
+  }
+
+  void Finish(uint64_t dataSize)
+  {
+    WriteToSink(m_writer, dataSize);
+    WriteToSink(m_writer, m_pagesCount);
+  }
+
+private:
+  FileWriter & m_writer;
+  uint64_t m_pagesCount = 0;
+};
+
+// PackedPointStorageReader ------------------------------------------------------------------------
+class PackedPointStorageReader : public PointStorageReaderInterface
+{
+public:
+  explicit PackedPointStorageReader(string const & name)
+    : m_mmapReader(name, MmapReader::Advice::Random), m_cache(kCacheSize)
+  {
+    auto const size = m_mmapReader.Size();
+    CHECK_GREATER_OR_EQUAL(size, 2 * sizeof(uint64_t), ("Damaged file", name));
+    m_pagesCount = ReadPrimitiveFromPos<uint64_t>(m_mmapReader, size - sizeof(uint64_t));
+    auto const directorySize = (m_pagesCount + 1) * sizeof(uint64_t);
+    CHECK_LESS_OR_EQUAL(directorySize + sizeof(uint64_t), size, ("Damaged file", name));
+    m_directory = m_mmapReader.Data() + size - sizeof(uint64_t) - directorySize;
+  }
+
+  // PointStorageReaderInterface overrides:
+  bool GetPoint(uint64_t id, double & lat, double & lon) const override
+  {
+    LatLon ll;
+    auto const pageIndex = id >> kPackedPageBits;
+    if (pageIndex < m_pagesCount)
+    {
+      auto & cached = m_cache[pageIndex % kCacheSize];
+      std::lock_guard<std::mutex> lock(cached.m_mutex);
+      if (cached.m_pageIndex != pageIndex)
+      {
+        ReadPage(pageIndex, cached.m_page);
+        cached.m_pageIndex = pageIndex;
+      }
+      ll = cached.m_page[id & (kPackedPageSize - 1)];
+    }
+
+    bool ret = FromLatLon(ll, lat, lon);
+    if (!ret)
+      LOG(LERROR, ("Node with id =", id, "not found!"));
+    return ret;
+  }
+
+  uint64_t GetPagesCount() const { return m_pagesCount; }
+
+  void ReadPage(uint64_t pageIndex, PackedPage & page) const
+  {
+    page.fill(LatLon());
+    if (pageIndex >= m_pagesCount)
+      return;
+
+    auto const begin = GetPageOffset(pageIndex);
+    auto const end = GetPageOffset(pageIndex + 1);
+    if (begin != end)
+      DecodePackedPage(m_mmapReader.Data() + begin, end - begin, page);
+  }
+
+private:
+  // A direct mapped cache of decoded pages. Ways refer to nodes with close ids mostly,
+  // so a page is decoded once for many points.
+  static size_t constexpr kCacheSize = 1 << 12;
+
+  struct CachedPage
+  {
+    std::mutex m_mutex;
+    uint64_t m_pageIndex = std::numeric_limits<uint64_t>::max();
+    PackedPage m_page;
+  };
+
+  uint64_t GetPageOffset(uint64_t pageIndex) const
+  {
+    uint64_t offset;
+    memcpy(&offset, m_directory + pageIndex * sizeof(offset), sizeof(offset));
+    return offset;
+  }
+
+  MmapReader m_mmapReader;
+  uint64_t m_pagesCount = 0;
+  uint8_t const * m_directory = nullptr;
+  mutable std::vector<CachedPage> m_cache;
+};
+
+// PackedPointStorageWriter ------------------------------------------------------------------------
+// Points are collected into a page until a point of another page comes. Then the page is written
+// as a chunk. Input sorted by ids gives a chunk per page, and chunks become the data of pages
+// as is. Otherwise chunks of a page are merged by the destructor.
+class PackedPointStorageWriter : public PointStorageWriterBase
+{
+public:
+  explicit PackedPointStorageWriter(string const & name)
+    : m_name(name)
+    , m_dataWriter(std::make_unique<FileWriter>(name + kPackedChunksExtension))
+    , m_chunksWriter(std::make_unique<FileWriter>(name + kPackedChunksExtension + OFFSET_EXT))
+  {
+  }
+
+  ~PackedPointStorageWriter() noexcept(false) override
+  {
+    FlushPage();
+    m_chunksWriter.reset();
+
+    auto const dataName = m_name + kPackedChunksExtension;
+    auto const chunksName = dataName + OFFSET_EXT;
+    if (m_isSorted)
+    {
+      {
+        PackedDirectoryWriter directory(*m_dataWriter);
+        auto const dataSize = m_dataWriter->Size();
+        FileReader reader(chunksName);
+        ReaderSource<FileReader> src(reader);
+        PackedChunk chunk;
+        while (src.Size() > 0)
+        {
+          src.Read(&chunk, sizeof(chunk));
+          directory.AddPage(chunk.m_page, chunk.m_offset);
+        }
+        directory.Finish(dataSize);
+      }
+      m_dataWriter.reset();
+      CHECK(base::RenameFileX(dataName, m_name), (m_name));
+    }
+    else
+    {
+      m_dataWriter.reset();
+      MergeChunks(dataName, chunksName);
+      base::DeleteFileX(dataName);
+    }
+    base::DeleteFileX(chunksName);
+  }
+
+  // PointStorageWriterInterface overrides:
+  void AddPoint(uint64_t id, double lat, double lon) override
+  {
+    auto const pageIndex = id >> kPackedPageBits;
+    CHECK_LESS(pageIndex, std::numeric_limits<uint32_t>::max(),
+               ("Found node with id", id, "which is bigger than the packed storage supports"));
+
+    if (pageIndex != m_pageIndex)
+    {
+      FlushPage();
+      m_pageIndex = pageIndex;
+    }
+
+    ToLatLon(lat, lon, m_page[id & (kPackedPageSize - 1)]);
+    m_isPageEmpty = false;
+    ++m_numProcessedPoints;
+  }
+
+private:
+  void FlushPage()
+  {
+    if (m_isPageEmpty)
+      return;
+
+    PackedChunk chunk;
+    chunk.m_page = static_cast<uint32_t>(m_pageIndex);
+    if (m_hasChunks && chunk.m_page <= m_lastPage)
+      m_isSorted = false;
+
+    EncodePackedPage(m_page, m_buffer);
+    chunk.m_offset = m_dataWriter->Pos();
+    chunk.m_size = static_cast<uint32_t>(m_buffer.size());
+    m_dataWriter->Write(m_buffer.data(), m_buffer.size());
+    m_chunksWriter->Write(&chunk, sizeof(chunk));
+
+    m_hasChunks = true;
+    m_lastPage = chunk.m_page;
+    m_page.fill(LatLon());
+    m_isPageEmpty = true;
+  }
+
+  void MergeChunks(string const & dataName, string const & chunksName)
+  {
+    std::vector<PackedChunk> chunks;
+    {
+      FileReader reader(chunksName);
+      CHECK_EQUAL(reader.Size() % sizeof(PackedChunk), 0, ("Damaged file", chunksName));
+      chunks.resize(static_cast<size_t>(reader.Size() / sizeof(PackedChunk)));
+      reader.Read(0, chunks.data(), chunks.size() * sizeof(PackedChunk));
+    }
+    LOG(LINFO, ("Merging", chunks.size(), "chunks of unsorted nodes"));
+
+    // Chunks of a page are applied in the order of writing, so later points replace earlier ones.
+    std::stable_sort(chunks.begin(), chunks.end(), [](PackedChunk const & lhs, PackedChunk const & rhs) {
+      return lhs.m_page < rhs.m_page;
+    });
+
+    FileReader reader(dataName);
+    FileWriter writer(m_name);
+    std::vector<std::pair<uint32_t, uint64_t>> pages;
+    std::vector<uint8_t> chunkData;
+    for (size_t i = 0; i < chunks.size();)
+    {
+      m_page.fill(LatLon());
+      size_t j = i;
+      for (; j < chunks.size() && chunks[j].m_page == chunks[i].m_page; ++j)
+      {
+        chunkData.resize(chunks[j].m_size);
+        reader.Read(chunks[j].m_offset, chunkData.data(), chunkData.size());
+        DecodePackedPage(chunkData.data(), chunkData.size(), m_page);
+      }
+
+      EncodePackedPage(m_page, m_buffer);
+      pages.emplace_back(chunks[i].m_page, writer.Pos());
+      writer.Write(m_buffer.data(), m_buffer.size());
+      i = j;
+    }
+
+    auto const dataSize = writer.Pos();
+    PackedDirectoryWriter directory(writer);
+    for (auto const & page : pages)
+      directory.AddPage(page.first, page.second);
+    directory.Finish(dataSize);
+  }
+
+  string m_name;
+  std::unique_ptr<FileWriter> m_dataWriter;
+  std::unique_ptr<FileWriter> m_chunksWriter;
+  bool m_hasChunks = false;
+  uint32_t m_lastPage = 0;
+  bool m_isSorted = true;
+
+  uint64_t m_pageIndex = 0;
+  PackedPage m_page;
+  bool m_isPageEmpty = true;
+  std::vector<uint8_t> m_buffer;
+};
+
+// PackedPointStorageUpdater -----------------------------------------------------------------------
+// Points are collected in memory, the destructor rewrites the storage page by page with
+// the collected points applied.
+class PackedPointStorageUpdater : public PointStorageWriterBase
+{
+public:
+  explicit PackedPointStorageUpdater(string const & name) : m_name(name) {}
+
+  ~PackedPointStorageUpdater() noexcept(false) override
+  {
+    if (m_points.empty())
+      return;
+
+    auto const updatedName = m_name + kFilteredExtension;
+    {
+      PackedPointStorageReader reader(m_name);
+      FileWriter writer(updatedName);
+      auto const pagesCount =
+          std::max(reader.GetPagesCount(), (m_points.rbegin()->first >> kPackedPageBits) + 1);
+      std::vector<std::pair<uint32_t, uint64_t>> pages;
+      std::vector<uint8_t> buffer;
+      PackedPage page;
+      auto it = m_points.cbegin();
+      for (uint64_t pageIndex = 0; pageIndex < pagesCount; ++pageIndex)
+      {
+        reader.ReadPage(pageIndex, page);
+        for (; it != m_points.cend() && (it->first >> kPackedPageBits) == pageIndex; ++it)
+          page[it->first & (kPackedPageSize - 1)] = it->second;
+
+        if (std::all_of(page.begin(), page.end(), IsEmpty))
+          continue;
+
+        EncodePackedPage(page, buffer);
+        pages.emplace_back(static_cast<uint32_t>(pageIndex), writer.Pos());
+        writer.Write(buffer.data(), buffer.size());
+      }
+
+      auto const dataSize = writer.Pos();
+      PackedDirectoryWriter directory(writer);
+      for (auto const & p : pages)
+        directory.AddPage(p.first, p.second);
+      directory.Finish(dataSize);
+    }
+    CHECK(base::RenameFileX(updatedName, m_name), (m_name));
+  }
+
+  // PointStorageWriterInterface overrides:
+  void AddPoint(uint64_t id, double lat, double lon) override
+  {
+    CHECK_LESS(id >> kPackedPageBits, std::numeric_limits<uint32_t>::max(),
+               ("Found node with id", id, "which is bigger than the packed storage supports"));
+
+    ToLatLon(lat, lon, m_points[id]);
+    ++m_numProcessedPoints;
+  }
+
+private:
+  string m_name;
+  std::map<uint64_t, LatLon> m_points;
 };
 }  // namespace
 
@@ -386,13 +913,14 @@ IntermediateDataReader::IntermediateDataReader(
 
 // IntermediateDataWriter
 IntermediateDataWriter::IntermediateDataWriter(PointStorageWriterInterface & nodes,
-                                               feature::GenerateInfo const & info)
+                                               feature::GenerateInfo const & info,
+                                               string const & partSuffix)
   : m_nodes(nodes)
-  , m_ways(info.GetCacheFileName(WAYS_FILE))
-  , m_relations(info.GetCacheFileName(RELATIONS_FILE))
-  , m_nodeToRelations(info.GetCacheFileName(NODES_FILE, ID2REL_EXT))
-  , m_wayToRelations(info.GetCacheFileName(WAYS_FILE, ID2REL_EXT))
-  , m_relationToRelations(info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT))
+  , m_ways(info.GetCacheFileName(WAYS_FILE) + partSuffix)
+  , m_relations(info.GetCacheFileName(RELATIONS_FILE) + partSuffix)
+  , m_nodeToRelations(info.GetCacheFileName(NODES_FILE, ID2REL_EXT) + partSuffix)
+  , m_wayToRelations(info.GetCacheFileName(WAYS_FILE, ID2REL_EXT) + partSuffix)
+  , m_relationToRelations(info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT) + partSuffix)
 {}
 
 void IntermediateDataWriter::AddRelation(Key id, RelationElement const & e)
@@ -420,6 +948,27 @@ void IntermediateDataWriter::SaveIndex()
 }
 
 // Functions
+void MergeIntermediateDataParts(feature::GenerateInfo const & info,
+                                std::vector<string> const & partSuffixes)
+{
+  MergeCacheParts(info.GetCacheFileName(WAYS_FILE), partSuffixes);
+  MergeCacheParts(info.GetCacheFileName(RELATIONS_FILE), partSuffixes);
+  MergeIndexParts(info.GetCacheFileName(NODES_FILE, ID2REL_EXT), partSuffixes);
+  MergeIndexParts(info.GetCacheFileName(WAYS_FILE, ID2REL_EXT), partSuffixes);
+  MergeIndexParts(info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT), partSuffixes);
+}
+
+void ApplyIntermediateDataPart(feature::GenerateInfo const & info, string const & partSuffix,
+                               std::unordered_set<Key> const & changedWays,
+                               std::unordered_set<Key> const & changedRelations)
+{
+  ApplyCachePart(info.GetCacheFileName(WAYS_FILE), partSuffix, changedWays);
+  ApplyCachePart(info.GetCacheFileName(RELATIONS_FILE), partSuffix, changedRelations);
+  ApplyIndexPart(info.GetCacheFileName(NODES_FILE, ID2REL_EXT), partSuffix, changedRelations);
+  ApplyIndexPart(info.GetCacheFileName(WAYS_FILE, ID2REL_EXT), partSuffix, changedRelations);
+  ApplyIndexPart(info.GetCacheFileName(RELATIONS_FILE, ID2REL_EXT), partSuffix, changedRelations);
+}
+
 std::unique_ptr<PointStorageReaderInterface>
 CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, string const & name)
 {
@@ -431,6 +980,8 @@ CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageReader>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageReader>(name);
+  case feature::GenerateInfo::NodeStorageType::Packed:
+    return std::make_unique<PackedPointStorageReader>(name);
   }
   UNREACHABLE();
 }
@@ -446,6 +997,25 @@ CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType type, string con
     return std::make_unique<MapFilePointStorageWriter>(name);
   case feature::GenerateInfo::NodeStorageType::Memory:
     return std::make_unique<RawMemPointStorageWriter>(name);
+  case feature::GenerateInfo::NodeStorageType::Packed:
+    return std::make_unique<PackedPointStorageWriter>(name);
+  }
+  UNREACHABLE();
+}
+
+std::unique_ptr<PointStorageWriterInterface>
+CreatePointStorageUpdater(feature::GenerateInfo::NodeStorageType type, string const & name)
+{
+  switch (type)
+  {
+  // Memory storage is saved in the same format as the raw file one.
+  case feature::GenerateInfo::NodeStorageType::File:
+  case feature::GenerateInfo::NodeStorageType::Memory:
+    return std::make_unique<RawFilePointStorageWriter>(name, FileWriter::OP_WRITE_EXISTING);
+  case feature::GenerateInfo::NodeStorageType::Index:
+    return std::make_unique<MapFilePointStorageWriter>(name, FileWriter::OP_APPEND);
+  case feature::GenerateInfo::NodeStorageType::Packed:
+    return std::make_unique<PackedPointStorageUpdater>(name);
   }
   UNREACHABLE();
 }
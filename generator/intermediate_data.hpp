@@ -13,6 +13,7 @@
 #include "base/logging.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -21,6 +22,7 @@
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -61,6 +63,8 @@ public:
   virtual ~PointStorageWriterInterface() noexcept(false) {};
   virtual void AddPoint(uint64_t id, double lat, double lon) = 0;
   virtual uint64_t GetNumProcessedPoints() const = 0;
+  // Returns true if points with different ids may be added from several threads at once.
+  virtual bool AllowsConcurrentAdding() const { return false; }
 };
 
 class PointStorageReaderInterface
@@ -91,6 +95,14 @@ public:
     }
   }
 
+  // Calls |toDo| with keys and values in the order of keys.
+  template <typename ToDo>
+  void ForEach(ToDo && toDo) const
+  {
+    for (auto const & e : m_elements)
+      toDo(e.first, e.second);
+  }
+
 private:
   using Element = std::pair<Key, Value>;
 
@@ -175,6 +187,17 @@ public:
   bool Read(Key id, WayElement & value) override { return Read<>(id, value); }
   bool Read(Key id, RelationElement & value) override { return Read<>(id, value); }
 
+  // Calls |toDo| with ids and ways of a cache of ways in the order of ids.
+  template <typename ToDo>
+  void ForEachWay(ToDo && toDo)
+  {
+    m_offsetsReader.ForEach([&](Key id, uint64_t pos) {
+      WayElement way(id);
+      ReadByPos(pos, way);
+      toDo(id, way);
+    });
+  }
+
 private:
   template <class Value>
   bool Read(Key id, Value & value)
@@ -186,6 +209,13 @@ private:
       return false;
     }
 
+    ReadByPos(pos, value);
+    return true;
+  }
+
+  template <class Value>
+  void ReadByPos(uint64_t pos, Value & value)
+  {
     uint32_t valueSize = m_preload ? *(reinterpret_cast<uint32_t *>(m_data.data() + pos)) : 0;
     size_t offset = pos + sizeof(uint32_t);
 
@@ -200,7 +230,6 @@ private:
 
     MemReader reader(m_data.data() + offset, valueSize);
     value.Read(reader);
-    return true;
   }
 
   FileReader m_fileReader;
@@ -274,6 +303,10 @@ public:
   bool GetWay(Key id, WayElement & e) override { return m_ways.Read(id, e); }
   bool GetRelation(Key id, RelationElement & e) override { return m_relations.Read(id, e); }
 
+  // Reads all ways of the cache, see OSMElementCacheReader::ForEachWay().
+  template <typename ToDo>
+  void ForEachWay(ToDo && toDo) { m_ways.ForEachWay(std::forward<ToDo>(toDo)); }
+
   void ForEachRelationByWayCached(Key id, ForEachRelationFn & toDo) override
   {
     CachedRelationProcessor<ForEachRelationFn> processor(m_relations, toDo);
@@ -341,7 +374,10 @@ private:
 class IntermediateDataWriter
 {
 public:
-  IntermediateDataWriter(PointStorageWriterInterface & nodes, feature::GenerateInfo const & info);
+  // When |partSuffix| is not empty, ways and relations caches and relations indices are written
+  // to parts of the files, see MergeIntermediateDataParts().
+  IntermediateDataWriter(PointStorageWriterInterface & nodes, feature::GenerateInfo const & info,
+                         std::string const & partSuffix = {});
 
   /// \a x \a y are in mercator projection coordinates. @see IntermediateDataReaderInterface::GetNode.
   void AddNode(Key id, double y, double x) { m_nodes.AddPoint(id, y, x); }
@@ -372,12 +408,30 @@ private:
   cache::IndexFileWriter m_relationToRelations;
 };
 
+// Merges parts of caches and indices written by IntermediateDataWriters with |partSuffixes|
+// into the files of a single writer, in the order of |partSuffixes|, and removes parts.
+void MergeIntermediateDataParts(feature::GenerateInfo const & info,
+                                std::vector<std::string> const & partSuffixes);
+
+// Replaces ways and relations with |changedWays| and |changedRelations| ids in caches and indices
+// by the ones of the part with |partSuffix| written by an IntermediateDataWriter, and removes
+// the part. Ways and relations which are changed but absent in the part are deleted.
+// Values of the part are appended to caches, so only offsets and indices are rewritten.
+void ApplyIntermediateDataPart(feature::GenerateInfo const & info, std::string const & partSuffix,
+                               std::unordered_set<Key> const & changedWays,
+                               std::unordered_set<Key> const & changedRelations);
+
 std::unique_ptr<PointStorageReaderInterface>
 CreatePointStorageReader(feature::GenerateInfo::NodeStorageType type, std::string const & name);
 
 std::unique_ptr<PointStorageWriterInterface>
 CreatePointStorageWriter(feature::GenerateInfo::NodeStorageType type, std::string const & name);
 
+// Creates a writer which updates points of the existing storage, a point replaces the stored
+// point with the same id.
+std::unique_ptr<PointStorageWriterInterface>
+CreatePointStorageUpdater(feature::GenerateInfo::NodeStorageType type, std::string const & name);
+
 class IntermediateData
 {
 public:
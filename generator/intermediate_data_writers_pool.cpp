@@ -0,0 +1,257 @@
+#include "generator/intermediate_data_writers_pool.hpp"
+
+#include "generator/osm_source.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace generator
+{
+using namespace std;
+
+namespace
+{
+// Nodes, ways and relations are usually numbered independently, so ranges of ids of all types
+// are spread between shards evenly.
+uint64_t constexpr kIdRangeSize = 1 << 16;
+// Chunks of elements waiting for a shard, limits memory when parsing outruns writing.
+size_t constexpr kMaxQueuedChunks = 4;
+
+// Collects points of a shard and adds them to a storage, which doesn't allow concurrent adding,
+// by batches under a lock. Batches are sorted by ids, which makes writes to files sequential.
+class LockedPointStorageWriter : public cache::PointStorageWriterInterface
+{
+public:
+  LockedPointStorageWriter(cache::PointStorageWriterInterface & storage, mutex & storageMutex)
+    : m_storage(storage), m_storageMutex(storageMutex)
+  {
+  }
+
+  // PointStorageWriterInterface overrides:
+  void AddPoint(uint64_t id, double lat, double lon) override
+  {
+    m_points.push_back({id, lat, lon});
+    if (m_points.size() == kBatchSize)
+      Flush();
+  }
+
+  uint64_t GetNumProcessedPoints() const override { return m_numProcessedPoints; }
+
+  void Flush()
+  {
+    sort(m_points.begin(), m_points.end(),
+         [](Point const & lhs, Point const & rhs) { return lhs.m_id < rhs.m_id; });
+
+    {
+      lock_guard<mutex> lock(m_storageMutex);
+      for (auto const & p : m_points)
+        m_storage.AddPoint(p.m_id, p.m_lat, p.m_lon);
+    }
+    m_numProcessedPoints += m_points.size();
+    m_points.clear();
+  }
+
+private:
+  static size_t constexpr kBatchSize = 1 << 14;
+
+  struct Point
+  {
+    uint64_t m_id;
+    double m_lat;
+    double m_lon;
+  };
+
+  cache::PointStorageWriterInterface & m_storage;
+  mutex & m_storageMutex;
+  vector<Point> m_points;
+  uint64_t m_numProcessedPoints = 0;
+};
+
+// Count of elements of a type processed by a shard and time spent on them.
+struct StageStats
+{
+  uint64_t m_count = 0;
+  double m_seconds = 0.0;
+};
+
+size_t GetStageIndex(OsmElement::EntityType type)
+{
+  switch (type)
+  {
+  case OsmElement::EntityType::Node: return 0;
+  case OsmElement::EntityType::Way: return 1;
+  case OsmElement::EntityType::Relation: return 2;
+  default: return 3;
+  }
+}
+}  // namespace
+
+// IntermediateDataWritersPool::Shard --------------------------------------------------------------
+class IntermediateDataWritersPool::Shard
+{
+public:
+  Shard(cache::PointStorageWriterInterface & nodes, mutex & nodesMutex,
+        feature::GenerateInfo const & info, string const & partSuffix)
+    : m_lockedNodes(nodes.AllowsConcurrentAdding()
+                        ? nullptr
+                        : make_unique<LockedPointStorageWriter>(nodes, nodesMutex))
+    , m_writer(m_lockedNodes ? *m_lockedNodes : nodes, info, partSuffix)
+    , m_thread([this] { Run(); })
+  {
+  }
+
+  ~Shard()
+  {
+    if (m_thread.joinable())
+      Stop();
+  }
+
+  void Push(vector<OsmElement> && elements)
+  {
+    ASSERT(!elements.empty(), ());
+    unique_lock<mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return m_queue.size() < kMaxQueuedChunks; });
+    m_queue.push(move(elements));
+    m_cond.notify_all();
+  }
+
+  // Writes all pushed elements and indices of the part.
+  void Finish()
+  {
+    Stop();
+    if (m_lockedNodes)
+      m_lockedNodes->Flush();
+    m_writer.SaveIndex();
+  }
+
+  array<StageStats, 4> const & GetStats() const { return m_stats; }
+
+private:
+  void Stop()
+  {
+    {
+      lock_guard<mutex> lock(m_mutex);
+      // An empty chunk stops the thread.
+      m_queue.emplace();
+    }
+    m_cond.notify_all();
+    m_thread.join();
+  }
+
+  void Run()
+  {
+    vector<OsmElement> elements;
+    while (true)
+    {
+      {
+        unique_lock<mutex> lock(m_mutex);
+        m_cond.wait(lock, [this] { return !m_queue.empty(); });
+        elements = move(m_queue.front());
+        m_queue.pop();
+      }
+      m_cond.notify_all();
+
+      if (elements.empty())
+        return;
+      Process(elements);
+    }
+  }
+
+  void Process(vector<OsmElement> & elements)
+  {
+    // Elements of a type go one after another in the input, so runs of them are timed at once.
+    for (size_t i = 0; i < elements.size();)
+    {
+      auto const type = elements[i].m_type;
+      base::Timer timer;
+      size_t j = i;
+      for (; j < elements.size() && elements[j].m_type == type; ++j)
+        AddElementToCache(m_writer, move(elements[j]));
+
+      auto & stats = m_stats[GetStageIndex(type)];
+      stats.m_count += j - i;
+      stats.m_seconds += timer.ElapsedSeconds();
+      i = j;
+    }
+  }
+
+  unique_ptr<LockedPointStorageWriter> m_lockedNodes;
+  cache::IntermediateDataWriter m_writer;
+  array<StageStats, 4> m_stats;
+
+  mutex m_mutex;
+  condition_variable m_cond;
+  queue<vector<OsmElement>> m_queue;
+
+  // Started after all other members are initialized.
+  thread m_thread;
+};
+
+// IntermediateDataWritersPool ---------------------------------------------------------------------
+IntermediateDataWritersPool::IntermediateDataWritersPool(
+    cache::PointStorageWriterInterface & nodes, feature::GenerateInfo const & info,
+    size_t shardsCount)
+  : m_info(info)
+{
+  CHECK_GREATER(shardsCount, 0, ());
+  for (size_t i = 0; i < shardsCount; ++i)
+  {
+    m_shards.emplace_back(
+        make_unique<Shard>(nodes, m_nodesMutex, info, ".part" + to_string(i)));
+  }
+}
+
+IntermediateDataWritersPool::~IntermediateDataWritersPool() = default;
+
+void IntermediateDataWritersPool::Emit(vector<OsmElement> && elements)
+{
+  vector<vector<OsmElement>> shardsElements(m_shards.size());
+  for (auto & e : elements)
+    shardsElements[(e.m_id / kIdRangeSize) % m_shards.size()].emplace_back(move(e));
+
+  for (size_t i = 0; i < m_shards.size(); ++i)
+  {
+    if (!shardsElements[i].empty())
+      m_shards[i]->Push(move(shardsElements[i]));
+  }
+}
+
+void IntermediateDataWritersPool::Finish()
+{
+  vector<string> partSuffixes;
+  array<StageStats, 4> stats;
+  for (size_t i = 0; i < m_shards.size(); ++i)
+  {
+    m_shards[i]->Finish();
+    partSuffixes.emplace_back(".part" + to_string(i));
+    for (size_t j = 0; j < stats.size(); ++j)
+    {
+      stats[j].m_count += m_shards[i]->GetStats()[j].m_count;
+      stats[j].m_seconds += m_shards[i]->GetStats()[j].m_seconds;
+    }
+  }
+
+  base::Timer timer;
+  cache::MergeIntermediateDataParts(m_info, partSuffixes);
+  auto const mergeSeconds = timer.ElapsedSeconds();
+
+  auto const perSecond = [](StageStats const & s) {
+    return s.m_seconds > 0.0 ? s.m_count / s.m_seconds : 0.0;
+  };
+  LOG(LINFO, ("Preprocess writing by", m_shards.size(), "shards, elements per second of a shard:",
+              "nodes:", stats[0].m_count, "at", perSecond(stats[0]),
+              "ways:", stats[1].m_count, "at", perSecond(stats[1]),
+              "relations:", stats[2].m_count, "at", perSecond(stats[2]),
+              "merge of parts:", mergeSeconds, "seconds"));
+}
+}  // namespace generator
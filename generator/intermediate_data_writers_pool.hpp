@@ -0,0 +1,38 @@
+#pragma once
+
+#include "generator/generate_info.hpp"
+#include "generator/intermediate_data.hpp"
+#include "generator/osm_element.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace generator
+{
+// Writes intermediate data of the preprocess pass on several threads while the input is parsed.
+// Elements are sharded by ranges of ids. Each shard has a thread, which writes coordinates of its
+// nodes to the point storage and its ways and relations to its own parts of caches and indices.
+// The parts are merged into the files of a single IntermediateDataWriter by Finish().
+class IntermediateDataWritersPool
+{
+public:
+  IntermediateDataWritersPool(cache::PointStorageWriterInterface & nodes,
+                              feature::GenerateInfo const & info, size_t shardsCount);
+  ~IntermediateDataWritersPool();
+
+  // Blocks while shards are busy with the previous elements.
+  void Emit(std::vector<OsmElement> && elements);
+  // Waits for all elements to be written, merges parts and logs throughput of the stages.
+  void Finish();
+
+private:
+  class Shard;
+
+  feature::GenerateInfo const & m_info;
+  // Guards the point storage, when it doesn't allow concurrent adding.
+  std::mutex m_nodesMutex;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+};
+}  // namespace generator
@@ -3,7 +3,9 @@
 #include "coding/buffered_file_writer.hpp"
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 #include "coding/zlib.hpp"
@@ -13,21 +15,227 @@
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <exception>
 #include <iterator>
+#include <map>
 #include <vector>
 
 #include "3party/bsdiff-courgette/bsdiff/bsdiff.h"
 
 namespace
 {
-enum Version
+using generator::mwm_diff::DiffApplicationResult;
+using generator::mwm_diff::DiffVersion;
+
+// Format version 1 is a sequence of chunks which make up the new mwm in order.
+enum class ChunkType : uint8_t
 {
-  // Format Version 0: bsdiff+gzip.
-  VERSION_V0 = 0,
-  VERSION_LATEST = VERSION_V0
+  // Bytes of the old mwm at an offset.
+  Copy = 0,
+  // Bytes of the new mwm compressed by zlib.
+  Raw = 1,
+  // Patch of bytes of the old mwm at an offset, bsdiff+zlib.
+  Patch = 2,
+  // The end of the diff with the size of the new mwm.
+  End = 3
 };
 
+size_t constexpr kCopyBufferSize = 64 * 1024;
+
+std::vector<uint8_t> Deflate(std::vector<uint8_t> const & data)
+{
+  using Deflate = coding::ZLib::Deflate;
+  Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+
+  std::vector<uint8_t> deflated;
+  deflate(data.data(), data.size(), back_inserter(deflated));
+  return deflated;
+}
+
+std::vector<uint8_t> ReadBytes(FileReader const & reader, uint64_t offset, uint64_t size)
+{
+  std::vector<uint8_t> bytes(base::checked_cast<size_t>(size));
+  reader.Read(offset, bytes.data(), bytes.size());
+  return bytes;
+}
+
+bool IsEqualBytes(FileReader const & lhs, uint64_t lhsOffset, FileReader const & rhs,
+                  uint64_t rhsOffset, uint64_t size)
+{
+  std::vector<uint8_t> lhsBuf(kCopyBufferSize);
+  std::vector<uint8_t> rhsBuf(kCopyBufferSize);
+  for (uint64_t pos = 0; pos < size; pos += kCopyBufferSize)
+  {
+    auto const n = static_cast<size_t>(std::min<uint64_t>(kCopyBufferSize, size - pos));
+    lhs.Read(lhsOffset + pos, lhsBuf.data(), n);
+    rhs.Read(rhsOffset + pos, rhsBuf.data(), n);
+    if (!std::equal(lhsBuf.begin(), lhsBuf.begin() + n, rhsBuf.begin()))
+      return false;
+  }
+  return true;
+}
+
+// Returns nonempty sections of the mwm read by |reader| in the order of offsets. Returns nothing
+// when the file is not a files container or its sections overlap.
+std::vector<FilesContainerBase::TagInfo> ReadSections(FileReader const & reader)
+{
+  std::vector<FilesContainerBase::TagInfo> sections;
+  try
+  {
+    FilesContainerR container(reader.GetName());
+    container.ForEachTagInfo([&](FilesContainerBase::TagInfo const & info) {
+      if (info.m_size != 0)
+        sections.push_back(info);
+    });
+  }
+  catch (std::exception const & e)
+  {
+    LOG(LWARNING, ("Could not read sections of", reader.GetName(), e.what()));
+    return {};
+  }
+
+  std::sort(sections.begin(), sections.end(),
+            [](FilesContainerBase::TagInfo const & lhs, FilesContainerBase::TagInfo const & rhs) {
+              return lhs.m_offset < rhs.m_offset;
+            });
+  uint64_t end = 0;
+  for (auto const & section : sections)
+  {
+    if (section.m_offset < end || section.m_size > reader.Size() ||
+        section.m_offset > reader.Size() - section.m_size)
+    {
+      LOG(LWARNING, ("Invalid section", section, "of", reader.GetName()));
+      return {};
+    }
+    end = section.m_offset + section.m_size;
+  }
+  return sections;
+}
+
+class ChunksWriter
+{
+public:
+  ChunksWriter(FileReader & oldReader, FileReader & newReader, FileWriter & writer)
+    : m_oldReader(oldReader), m_newReader(newReader), m_writer(writer)
+  {
+  }
+
+  void WriteCopy(uint64_t oldOffset, uint64_t size)
+  {
+    WriteToSink(m_writer, static_cast<uint8_t>(ChunkType::Copy));
+    WriteVarUint(m_writer, oldOffset);
+    WriteVarUint(m_writer, size);
+    m_copiedSize += size;
+  }
+
+  void WriteRaw(uint64_t newOffset, uint64_t size)
+  {
+    if (size == 0)
+      return;
+
+    auto const deflated = Deflate(ReadBytes(m_newReader, newOffset, size));
+    WriteToSink(m_writer, static_cast<uint8_t>(ChunkType::Raw));
+    WriteVarUint(m_writer, size);
+    WriteVarUint(m_writer, static_cast<uint64_t>(deflated.size()));
+    m_writer.Write(deflated.data(), deflated.size());
+    m_rawSize += size;
+  }
+
+  bool WritePatch(uint64_t oldOffset, uint64_t oldSize, uint64_t newOffset, uint64_t newSize)
+  {
+    auto oldSubReader = m_oldReader.SubReader(oldOffset, oldSize);
+    auto newSubReader = m_newReader.SubReader(newOffset, newSize);
+    std::vector<uint8_t> patch;
+    MemWriter<std::vector<uint8_t>> patchWriter(patch);
+    auto const status = bsdiff::CreateBinaryPatch(oldSubReader, newSubReader, patchWriter);
+    if (status != bsdiff::BSDiffStatus::OK)
+    {
+      LOG(LERROR, ("Could not create patch with bsdiff:", status));
+      return false;
+    }
+
+    auto const deflated = Deflate(patch);
+    WriteToSink(m_writer, static_cast<uint8_t>(ChunkType::Patch));
+    WriteVarUint(m_writer, oldOffset);
+    WriteVarUint(m_writer, oldSize);
+    WriteVarUint(m_writer, static_cast<uint64_t>(deflated.size()));
+    m_writer.Write(deflated.data(), deflated.size());
+    m_patchedSize += newSize;
+    return true;
+  }
+
+  void WriteEnd()
+  {
+    WriteToSink(m_writer, static_cast<uint8_t>(ChunkType::End));
+    WriteVarUint(m_writer, m_newReader.Size());
+
+    LOG(LINFO, ("Diff of", m_newReader.GetName(), "bytes copied:", m_copiedSize,
+                "patched:", m_patchedSize, "raw:", m_rawSize));
+  }
+
+private:
+  FileReader & m_oldReader;
+  FileReader & m_newReader;
+  FileWriter & m_writer;
+  uint64_t m_copiedSize = 0;
+  uint64_t m_patchedSize = 0;
+  uint64_t m_rawSize = 0;
+};
+
+bool MakeDiffVersion1(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
+{
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(DiffVersion::V1));
+  ChunksWriter chunks(oldReader, newReader, diffFileWriter);
+
+  auto const newSections = ReadSections(newReader);
+  if (newSections.empty())
+  {
+    // Not an mwm, the whole file is patched as in version 0.
+    if (newReader.Size() != 0 && !chunks.WritePatch(0, oldReader.Size(), 0, newReader.Size()))
+      return false;
+    chunks.WriteEnd();
+    return true;
+  }
+
+  std::map<FilesContainerBase::Tag, FilesContainerBase::TagInfo> oldSections;
+  for (auto const & section : ReadSections(oldReader))
+    oldSections.emplace(section.m_tag, section);
+
+  // Bytes between sections, i.e. the header, paddings and the table of sections, are stored as is.
+  uint64_t pos = 0;
+  for (auto const & section : newSections)
+  {
+    chunks.WriteRaw(pos, section.m_offset - pos);
+    pos = section.m_offset + section.m_size;
+
+    auto const it = oldSections.find(section.m_tag);
+    if (it == oldSections.cend())
+    {
+      chunks.WriteRaw(section.m_offset, section.m_size);
+      continue;
+    }
+
+    auto const & oldSection = it->second;
+    if (oldSection.m_size == section.m_size &&
+        IsEqualBytes(oldReader, oldSection.m_offset, newReader, section.m_offset, section.m_size))
+    {
+      chunks.WriteCopy(oldSection.m_offset, oldSection.m_size);
+      continue;
+    }
+
+    if (!chunks.WritePatch(oldSection.m_offset, oldSection.m_size, section.m_offset,
+                           section.m_size))
+    {
+      return false;
+    }
+  }
+  chunks.WriteRaw(pos, newReader.Size() - pos);
+  chunks.WriteEnd();
+  return true;
+}
+
 bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
 {
   std::vector<uint8_t> diffBuf;
@@ -48,18 +256,16 @@ bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter
   deflate(diffBuf.data(), diffBuf.size(), back_inserter(deflatedDiffBuf));
 
   // A basic header that holds only version.
-  WriteToSink(diffFileWriter, static_cast<uint32_t>(VERSION_V0));
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(DiffVersion::V0));
   diffFileWriter.Write(deflatedDiffBuf.data(), deflatedDiffBuf.size());
 
   return true;
 }
 
-generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
-    FileReader & oldReader, FileWriter & newWriter, ReaderSource<FileReader> & diffFileSource,
-    base::Cancellable const & cancellable)
+DiffApplicationResult ApplyDiffVersion0(FileReader & oldReader, FileWriter & newWriter,
+                                        ReaderSource<FileReader> & diffFileSource,
+                                        base::Cancellable const & cancellable)
 {
-  using generator::mwm_diff::DiffApplicationResult;
-
   std::vector<uint8_t> deflatedDiff(base::checked_cast<size_t>(diffFileSource.Size()));
   diffFileSource.Read(deflatedDiff.data(), deflatedDiff.size());
 
@@ -91,13 +297,140 @@ generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
   LOG(LERROR, ("Could not apply patch with bsdiff:", status));
   return DiffApplicationResult::Failed;
 }
+
+// Reads |size| bytes of the diff after checking that the diff has them, sizes of corrupted diffs
+// may be arbitrary.
+bool ReadDiffBytes(ReaderSource<FileReader> & diffFileSource, uint64_t size,
+                   std::vector<uint8_t> & bytes)
+{
+  if (size > diffFileSource.Size())
+    return false;
+
+  bytes.resize(static_cast<size_t>(size));
+  diffFileSource.Read(bytes.data(), bytes.size());
+  return true;
+}
+
+bool IsValidRange(FileReader const & reader, uint64_t offset, uint64_t size)
+{
+  return size <= reader.Size() && offset <= reader.Size() - size;
+}
+
+DiffApplicationResult ApplyDiffVersion1(FileReader & oldReader, FileWriter & newWriter,
+                                        ReaderSource<FileReader> & diffFileSource,
+                                        base::Cancellable const & cancellable)
+{
+  using Inflate = coding::ZLib::Inflate;
+  Inflate inflate(Inflate::Format::ZLib);
+
+  std::vector<uint8_t> deflated;
+  std::vector<uint8_t> buffer;
+  while (diffFileSource.Size() > 0)
+  {
+    if (cancellable.IsCancelled())
+    {
+      LOG(LDEBUG, ("Diff application has been cancelled"));
+      return DiffApplicationResult::Cancelled;
+    }
+
+    auto const type = static_cast<ChunkType>(ReadPrimitiveFromSource<uint8_t>(diffFileSource));
+    switch (type)
+    {
+    case ChunkType::Copy:
+    {
+      auto const offset = ReadVarUint<uint64_t>(diffFileSource);
+      auto const size = ReadVarUint<uint64_t>(diffFileSource);
+      if (!IsValidRange(oldReader, offset, size))
+        return DiffApplicationResult::Failed;
+
+      buffer.resize(kCopyBufferSize);
+      for (uint64_t pos = 0; pos < size; pos += kCopyBufferSize)
+      {
+        auto const n = static_cast<size_t>(std::min<uint64_t>(kCopyBufferSize, size - pos));
+        oldReader.Read(offset + pos, buffer.data(), n);
+        newWriter.Write(buffer.data(), n);
+      }
+      break;
+    }
+    case ChunkType::Raw:
+    {
+      auto const size = ReadVarUint<uint64_t>(diffFileSource);
+      auto const deflatedSize = ReadVarUint<uint64_t>(diffFileSource);
+      if (!ReadDiffBytes(diffFileSource, deflatedSize, deflated))
+        return DiffApplicationResult::Failed;
+
+      buffer.clear();
+      if (!inflate(deflated.data(), deflated.size(), back_inserter(buffer)) ||
+          buffer.size() != size)
+      {
+        LOG(LERROR, ("Could not inflate bytes of mwm diff"));
+        return DiffApplicationResult::Failed;
+      }
+      newWriter.Write(buffer.data(), buffer.size());
+      break;
+    }
+    case ChunkType::Patch:
+    {
+      auto const offset = ReadVarUint<uint64_t>(diffFileSource);
+      auto const size = ReadVarUint<uint64_t>(diffFileSource);
+      auto const deflatedSize = ReadVarUint<uint64_t>(diffFileSource);
+      if (!IsValidRange(oldReader, offset, size) ||
+          !ReadDiffBytes(diffFileSource, deflatedSize, deflated))
+      {
+        return DiffApplicationResult::Failed;
+      }
+
+      buffer.clear();
+      if (!inflate(deflated.data(), deflated.size(), back_inserter(buffer)))
+      {
+        LOG(LERROR, ("Could not inflate patch of mwm diff"));
+        return DiffApplicationResult::Failed;
+      }
+
+      // See ApplyDiffVersion0() about readers with exceptions.
+      auto oldSubReader = oldReader.SubReader(offset, size);
+      MemReaderWithExceptions patchReader(buffer.data(), buffer.size());
+      auto const status =
+          bsdiff::ApplyBinaryPatch(oldSubReader, newWriter, patchReader, cancellable);
+      if (status == bsdiff::BSDiffStatus::CANCELLED)
+      {
+        LOG(LDEBUG, ("Diff application has been cancelled"));
+        return DiffApplicationResult::Cancelled;
+      }
+      if (status != bsdiff::BSDiffStatus::OK)
+      {
+        LOG(LERROR, ("Could not apply patch with bsdiff:", status));
+        return DiffApplicationResult::Failed;
+      }
+      break;
+    }
+    case ChunkType::End:
+    {
+      auto const size = ReadVarUint<uint64_t>(diffFileSource);
+      if (size != newWriter.Pos() || diffFileSource.Size() != 0)
+      {
+        LOG(LERROR, ("Wrong size of mwm after applying diff:", newWriter.Pos(), "expected:", size));
+        return DiffApplicationResult::Failed;
+      }
+      return DiffApplicationResult::Ok;
+    }
+    default:
+      LOG(LERROR, ("Unknown chunk of mwm diff:", static_cast<uint32_t>(type)));
+      return DiffApplicationResult::Failed;
+    }
+  }
+
+  LOG(LERROR, ("Mwm diff is truncated"));
+  return DiffApplicationResult::Failed;
+}
 }  // namespace
 
 namespace generator
 {
 namespace mwm_diff
 {
-bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath)
+bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
+              std::string const & diffPath, DiffVersion version)
 {
   try
   {
@@ -105,13 +438,12 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
     FileReader newReader(newMwmPath);
     FileWriter diffFileWriter(diffPath);
 
-    switch (VERSION_LATEST)
+    switch (version)
     {
-    case VERSION_V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
-    default:
-      LOG(LERROR,
-          ("Making mwm diffs with diff format version", VERSION_LATEST, "is not implemented"));
+    case DiffVersion::V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
+    case DiffVersion::V1: return MakeDiffVersion1(oldReader, newReader, diffFileWriter);
     }
+    LOG(LERROR, ("Making mwm diffs with diff format version", version, "is not implemented"));
   }
   catch (Reader::Exception const & e)
   {
@@ -139,10 +471,12 @@ DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string cons
     ReaderSource<FileReader> diffFileSource(diffFileReader);
     auto const version = ReadPrimitiveFromSource<uint32_t>(diffFileSource);
 
-    switch (version)
+    switch (static_cast<DiffVersion>(version))
     {
-    case VERSION_V0:
+    case DiffVersion::V0:
       return ApplyDiffVersion0(oldReader, newWriter, diffFileSource, cancellable);
+    case DiffVersion::V1:
+      return ApplyDiffVersion1(oldReader, newWriter, diffFileSource, cancellable);
     default:
       LOG(LERROR, ("Unknown version format of mwm diff:", version));
       return DiffApplicationResult::Failed;
@@ -171,5 +505,15 @@ std::string DebugPrint(DiffApplicationResult const & result)
   }
   UNREACHABLE();
 }
+
+std::string DebugPrint(DiffVersion version)
+{
+  switch (version)
+  {
+  case DiffVersion::V0: return "V0";
+  case DiffVersion::V1: return "V1";
+  }
+  UNREACHABLE();
+}
 }  // namespace mwm_diff
 }  // namespace generator
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace base
@@ -18,12 +19,23 @@ enum class DiffApplicationResult
   Cancelled,
 };
 
+enum class DiffVersion : uint32_t
+{
+  // bsdiff of whole mwms compressed by zlib.
+  V0 = 0,
+  // Diffs of sections, unchanged sections are copied from the old mwm and changed ones
+  // are patched one by one, so the memory needed to apply a diff is bounded by the largest section.
+  V1 = 1,
+};
+
 // Makes a diff that, when applied to the mwm at |oldMwmPath|, will
 // result in the mwm at |newMwmPath|. The diff is stored at |diffPath|.
 // It is assumed that the files at |oldMwmPath| and |newMwmPath| are valid mwms.
 // Returns true on success and false on failure.
+// V0 is the default because released apps can't apply diffs of later versions. Make V1 diffs
+// only when all served clients are able to apply them.
 bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-              std::string const & diffPath);
+              std::string const & diffPath, DiffVersion version = DiffVersion::V0);
 
 // Applies the diff at |diffPath| to the mwm at |oldMwmPath|. The resulting
 // mwm is stored at |newMwmPath|.
@@ -36,5 +48,6 @@ DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string cons
                                 base::Cancellable const & cancellable);
 
 std::string DebugPrint(DiffApplicationResult const & result);
+std::string DebugPrint(DiffVersion version);
 }  // namespace mwm_diff
 }  // namespace generator
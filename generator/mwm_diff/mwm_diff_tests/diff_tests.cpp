@@ -5,12 +5,15 @@
 #include "platform/platform.hpp"
 
 #include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/internal/file_data.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace generator::diff_tests
@@ -33,58 +36,129 @@ UNIT_TEST(IncrementalUpdates_Smoke)
     FileWriter::DeleteFileX(diffPath);
   });
 
+  for (auto const version : {DiffVersion::V0, DiffVersion::V1})
   {
-    // Create an empty file.
-    FileWriter writer(newMwmPath1);
+    {
+      // Create an empty file.
+      FileWriter writer(newMwmPath1);
+    }
+
+    base::Cancellable cancellable;
+    TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, version), (version));
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+               DiffApplicationResult::Ok, ());
+
+    {
+      // Alter the old mwm slightly.
+      vector<uint8_t> oldMwmContents = base::ReadFile(oldMwmPath);
+      size_t const sz = oldMwmContents.size();
+      for (size_t i = 3 * sz / 10; i < 4 * sz / 10; i++)
+        oldMwmContents[i] += static_cast<uint8_t>(i);
+
+      FileWriter writer(newMwmPath1);
+      writer.Write(oldMwmContents.data(), oldMwmContents.size());
+    }
+
+    TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, version), (version));
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+               DiffApplicationResult::Ok, ());
+
+    TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
+
+    cancellable.Cancel();
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+               DiffApplicationResult::Cancelled, ());
+    cancellable.Reset();
+
+    {
+      // Corrupt the diff file contents.
+      vector<uint8_t> diffContents = base::ReadFile(diffPath);
+
+      // Leave the version bits intact.
+      for (size_t i = 4; i < diffContents.size(); i += 2)
+        diffContents[i] ^= 255;
+
+      FileWriter writer(diffPath);
+      writer.Write(diffContents.data(), diffContents.size());
+    }
+
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+               DiffApplicationResult::Failed, ());
+
+    {
+      // Reset the diff file contents.
+      FileWriter writer(diffPath);
+    }
+
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+               DiffApplicationResult::Failed, ());
   }
+}
 
-  base::Cancellable cancellable;
-  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath), ());
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable), DiffApplicationResult::Ok,
-             ());
+UNIT_TEST(IncrementalUpdates_Sections)
+{
+  string const oldMwmPath = base::JoinPath(GetPlatform().WritableDir(), "sections-old.mwm");
+  string const newMwmPath1 = base::JoinPath(GetPlatform().WritableDir(), "sections-new1.mwm");
+  string const newMwmPath2 = base::JoinPath(GetPlatform().WritableDir(), "sections-new2.mwm");
+  string const diffPath = base::JoinPath(GetPlatform().WritableDir(), "sections.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(oldMwmPath);
+    FileWriter::DeleteFileX(newMwmPath1);
+    FileWriter::DeleteFileX(newMwmPath2);
+    FileWriter::DeleteFileX(diffPath);
+  });
+
+  auto const makeSection = [](size_t size, uint8_t seed) {
+    vector<uint8_t> section(size);
+    for (size_t i = 0; i < size; ++i)
+      section[i] = static_cast<uint8_t>(i * seed + i / 7);
+    return section;
+  };
 
   {
-    // Alter the old mwm slightly.
-    vector<uint8_t> oldMwmContents = base::ReadFile(oldMwmPath);
-    size_t const sz = oldMwmContents.size();
-    for (size_t i = 3 * sz / 10; i < 4 * sz / 10; i++)
-      oldMwmContents[i] += static_cast<uint8_t>(i);
-
-    FileWriter writer(newMwmPath1);
-    writer.Write(oldMwmContents.data(), oldMwmContents.size());
+    FilesContainerW writer(oldMwmPath);
+    writer.Write(makeSection(100000, 3), "a");
+    writer.Write(makeSection(50001, 5), "b");
+    writer.Write(makeSection(7, 7), "c");
+  }
+
+  base::Cancellable cancellable;
+  {
+    // Same sections.
+    TEST(base::CopyFileX(oldMwmPath, newMwmPath1), ());
+    TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, DiffVersion::V1), ());
+    TEST_LESS(base::ReadFile(diffPath).size(), 1024, ());
+    TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
+               DiffApplicationResult::Ok, ());
+    TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
   }
 
-  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath), ());
+  {
+    // A changed section, a new one, a removed one and an unchanged one in another order.
+    auto b = makeSection(50001, 5);
+    for (size_t i = 1000; i < 2000; ++i)
+      b[i] = static_cast<uint8_t>(i % 13);
+    b.resize(60000, 1);
+
+    FilesContainerW writer(newMwmPath1);
+    writer.Write(b, "b");
+    writer.Write(makeSection(30000, 11), "d");
+    writer.Write(makeSection(100000, 3), "a");
+  }
+  TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath, DiffVersion::V1), ());
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable), DiffApplicationResult::Ok,
              ());
-
   TEST(base::IsEqualFiles(newMwmPath1, newMwmPath2), ());
 
-  cancellable.Cancel();
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
-             DiffApplicationResult::Cancelled, ());
-  cancellable.Reset();
-
   {
-    // Corrupt the diff file contents.
+    // Truncate the diff.
     vector<uint8_t> diffContents = base::ReadFile(diffPath);
-
-    // Leave the version bits intact.
-    for (size_t i = 4; i < diffContents.size(); i += 2)
-      diffContents[i] ^= 255;
-
+    diffContents.resize(diffContents.size() - 1);
     FileWriter writer(diffPath);
     writer.Write(diffContents.data(), diffContents.size());
   }
-
-  TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
-             DiffApplicationResult::Failed, ());
-
-  {
-    // Reset the diff file contents.
-    FileWriter writer(diffPath);
-  }
-
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
              DiffApplicationResult::Failed, ());
 }
@@ -1,20 +1,73 @@
 #include "generator/mwm_diff/diff.hpp"
 
+#include "coding/internal/file_data.hpp"
+
 #include "base/cancellable.hpp"
+#include "base/timer.hpp"
 
 #include <iostream>
 #include <cstring>
+#include <string>
+
+namespace
+{
+// Makes and applies diffs of all versions and prints their build and apply times and sizes.
+int Compare(std::string const & olderMWMDir, std::string const & newerMWMDir,
+            std::string const & diffDir)
+{
+  using namespace generator::mwm_diff;
+
+  int result = 0;
+  for (auto const version : {DiffVersion::V0, DiffVersion::V1})
+  {
+    auto const diffPath = diffDir + "." + DebugPrint(version);
+    auto const appliedPath = diffPath + ".mwm";
+
+    base::Timer timer;
+    if (!MakeDiff(olderMWMDir, newerMWMDir, diffPath, version))
+    {
+      std::cout << DebugPrint(version) << ": making failed\n";
+      result = -1;
+      continue;
+    }
+    auto const makeSeconds = timer.ElapsedSeconds();
+
+    timer.Reset();
+    base::Cancellable cancellable;
+    auto const res = ApplyDiff(olderMWMDir, appliedPath, diffPath, cancellable);
+    auto const applySeconds = timer.ElapsedSeconds();
+
+    uint64_t diffSize = 0;
+    base::GetFileSize(diffPath, diffSize);
+    auto const isEqual =
+        res == DiffApplicationResult::Ok && base::IsEqualFiles(newerMWMDir, appliedPath);
+    std::cout << DebugPrint(version) << ": size " << diffSize << " bytes, made in " << makeSeconds
+              << " s, applied in " << applySeconds << " s, result " << DebugPrint(res)
+              << (isEqual ? "" : ", DIFFERS FROM THE NEWER MWM") << "\n";
+    if (!isEqual)
+      result = -1;
+
+    base::DeleteFileX(appliedPath);
+  }
+  return result;
+}
+}  // namespace
 
 int main(int argc, char ** argv)
 {
   if (argc < 5)
   {
     std::cout <<
-        "Usage: " << argv[0] << " make|apply olderMWMDir newerMWMDir diffDir\n"
+        "Usage: " << argv[0] << " make|make_v1|apply|compare olderMWMDir newerMWMDir diffDir\n"
         "make\n"
         "  Creates the diff between newer and older MWM versions at `diffDir`\n"
+        "make_v1\n"
+        "  Same as make, but creates a diff of version 1 which released apps can't apply.\n"
         "apply\n"
         "  Applies the diff at `diffDir` to the mwm at `olderMWMDir` and stores result at `newerMWMDir`.\n"
+        "compare\n"
+        "  Creates diffs of all format versions at `diffDir`.<version>, applies them and prints\n"
+        "  sizes and times of making and applying.\n"
         "WARNING: THERE IS NO MWM VALIDITY CHECK!\n";
     return -1;
   }
@@ -22,6 +75,15 @@ int main(int argc, char ** argv)
   if (0 == std::strcmp(argv[1], "make"))
     return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir);
 
+  if (0 == std::strcmp(argv[1], "make_v1"))
+  {
+    return generator::mwm_diff::MakeDiff(olderMWMDir, newerMWMDir, diffDir,
+                                         generator::mwm_diff::DiffVersion::V1);
+  }
+
+  if (0 == std::strcmp(argv[1], "compare"))
+    return Compare(olderMWMDir, newerMWMDir, diffDir);
+
   // apply
   base::Cancellable cancellable;
   auto const res = generator::mwm_diff::ApplyDiff(olderMWMDir, newerMWMDir, diffDir, cancellable);
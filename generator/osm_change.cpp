@@ -0,0 +1,307 @@
+#include "generator/osm_change.hpp"
+
+#include "generator/intermediate_data.hpp"
+#include "generator/intermediate_elements.hpp"
+#include "generator/osm_xml_source.hpp"
+
+#include "coding/parse_xml.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/stl_helpers.hpp"
+
+#include "defines.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+
+namespace generator
+{
+namespace
+{
+std::string const kOsmChangePartSuffix = ".osc";
+
+// Ids of changed elements which are looked up in one version of intermediate data.
+struct ChangedIds
+{
+  void Add(std::vector<OsmElement> const & elements)
+  {
+    for (auto const & e : elements)
+    {
+      switch (e.m_type)
+      {
+      case OsmElement::EntityType::Node: m_nodes.insert(e.m_id); break;
+      case OsmElement::EntityType::Way: m_ways.insert(e.m_id); break;
+      case OsmElement::EntityType::Relation: m_relations.insert(e.m_id); break;
+      default: break;
+      }
+    }
+  }
+
+  std::unordered_set<cache::Key> m_nodes;
+  std::unordered_set<cache::Key> m_ways;
+  std::unordered_set<cache::Key> m_relations;
+};
+
+// Actions of an OsmChange file are roots of osm files for XMLSource.
+class OsmChangeSource
+{
+public:
+  explicit OsmChangeSource(OsmChange & change)
+    : m_change(change), m_source([this](OsmElement && e) { m_action->emplace_back(std::move(e)); })
+  {
+  }
+
+  void CharData(std::string const &) {}
+
+  void AddAttr(XMLSource::StringPtrT key, XMLSource::StringPtrT value)
+  {
+    if (m_action)
+      m_source.AddAttr(key, value);
+  }
+
+  bool Push(XMLSource::StringPtrT tagName)
+  {
+    if (++m_depth == 2)
+    {
+      if (strcmp(tagName, "create") == 0)
+        m_action = &m_change.m_created;
+      else if (strcmp(tagName, "modify") == 0)
+        m_action = &m_change.m_modified;
+      else if (strcmp(tagName, "delete") == 0)
+        m_action = &m_change.m_deleted;
+      else
+        LOG(LWARNING, ("Unknown action of OsmChange:", tagName));
+    }
+    return m_action ? m_source.Push(tagName) : true;
+  }
+
+  void Pop(XMLSource::StringPtrT tagName)
+  {
+    if (m_action)
+      m_source.Pop(tagName);
+    if (--m_depth == 1)
+      m_action = nullptr;
+  }
+
+private:
+  OsmChange & m_change;
+  std::vector<OsmElement> * m_action = nullptr;
+  size_t m_depth = 0;
+  XMLSource m_source;
+};
+
+// Collects countries of changed elements, of ways with changed nodes and of relations with
+// changed members in the current version of intermediate data.
+class ChangedCountriesCollector
+{
+public:
+  ChangedCountriesCollector(feature::GenerateInfo const & info,
+                            feature::AffiliationInterface const & affiliation,
+                            std::set<std::string> & countries)
+    : m_objects(m_objectsCache.GetOrCreatePointStorageReader(
+          info.m_nodeStorageType, info.GetCacheFileName(NODES_FILE)))
+    , m_reader(m_objects, info)
+    , m_affiliation(affiliation)
+    , m_countries(countries)
+  {
+  }
+
+  // Adds to |ways| ids of all ways which refer to any of |nodes|. Reads every way of the cache.
+  void FindWaysByNodes(std::unordered_set<cache::Key> const & nodes,
+                       std::unordered_set<cache::Key> & ways)
+  {
+    if (nodes.empty())
+      return;
+
+    m_reader.ForEachWay([&](cache::Key id, WayElement const & way) {
+      if (base::AnyOf(way.m_nodes, [&](uint64_t node) { return nodes.count(node) != 0; }))
+        ways.insert(id);
+    });
+  }
+
+  void Collect(ChangedIds const & ids)
+  {
+    for (auto const id : ids.m_nodes)
+      AddNode(id);
+    for (auto const id : ids.m_ways)
+      AddWay(id);
+
+    std::unordered_set<cache::Key> relations;
+    std::queue<cache::Key> queue;
+    cache::IntermediateDataReaderInterface::ForEachRelationFn addRelation =
+        [&](uint64_t id, cache::OSMElementCacheReaderInterface &) {
+          if (relations.insert(id).second)
+            queue.push(id);
+          return base::ControlFlow::Continue;
+        };
+    for (auto const id : ids.m_relations)
+    {
+      if (relations.insert(id).second)
+        queue.push(id);
+    }
+    for (auto const id : ids.m_nodes)
+      m_reader.ForEachRelationByNodeCached(id, addRelation);
+    for (auto const id : ids.m_ways)
+      m_reader.ForEachRelationByWayCached(id, addRelation);
+
+    // Parent relations are changed with their members.
+    for (; !queue.empty(); queue.pop())
+    {
+      AddRelation(queue.front());
+      m_reader.ForEachRelationByRelationCached(queue.front(), addRelation);
+    }
+  }
+
+private:
+  void AddNode(cache::Key id)
+  {
+    m2::PointD point;
+    if (!m_reader.GetNode(id, point.y, point.x))
+      return;
+
+    for (auto & country : m_affiliation.GetAffiliations(point))
+      m_countries.insert(std::move(country));
+  }
+
+  void AddWay(cache::Key id)
+  {
+    WayElement way(id);
+    if (!m_reader.GetWay(id, way))
+      return;
+
+    for (auto const node : way.m_nodes)
+      AddNode(node);
+  }
+
+  // Features of a relation may be built from the geometry of its member relations too,
+  // e.g. of routes of a route master, so the geometry of the nested members is added as well.
+  void AddRelation(cache::Key id)
+  {
+    if (!m_addedRelations.insert(id).second)
+      return;
+
+    RelationElement relation;
+    if (!m_reader.GetRelation(id, relation))
+      return;
+
+    for (auto const & member : relation.m_nodes)
+      AddNode(member.first);
+    for (auto const & member : relation.m_ways)
+      AddWay(member.first);
+    for (auto const & member : relation.m_relations)
+      AddRelation(member.first);
+  }
+
+  cache::IntermediateDataObjectsCache m_objectsCache;
+  cache::IntermediateDataObjectsCache::AllocatedObjects & m_objects;
+  cache::IntermediateDataReader m_reader;
+  feature::AffiliationInterface const & m_affiliation;
+  std::set<std::string> & m_countries;
+  // Relations may be nested into each other cyclically.
+  std::unordered_set<cache::Key> m_addedRelations;
+};
+}  // namespace
+
+OsmChange ReadOsmChange(SourceReader & stream)
+{
+  OsmChange change;
+  OsmChangeSource source(change);
+  XMLSequenceParser<SourceReader, OsmChangeSource> parser(stream, source);
+  while (parser.Read()) /* empty */;
+
+  for (auto * elements : {&change.m_created, &change.m_modified, &change.m_deleted})
+  {
+    for (auto & e : *elements)
+      e.Validate();
+  }
+  return change;
+}
+
+std::set<std::string> ApplyOsmChange(feature::GenerateInfo const & info, OsmChange const & change,
+                                     feature::AffiliationInterface const & affiliation)
+{
+  LOG(LINFO, ("Applying OsmChange, created:", change.m_created.size(),
+              "modified:", change.m_modified.size(), "deleted:", change.m_deleted.size()));
+
+  // Created elements are absent in the old version and deleted ones are absent in the new one.
+  ChangedIds oldIds;
+  oldIds.Add(change.m_modified);
+  oldIds.Add(change.m_deleted);
+  ChangedIds newIds;
+  newIds.Add(change.m_created);
+  newIds.Add(change.m_modified);
+
+  std::set<std::string> countries;
+  ChangedCountriesCollector(info, affiliation, countries).Collect(oldIds);
+
+  {
+    // Deleted nodes are left in storages, ways which refer to them are changed too.
+    auto nodes = cache::CreatePointStorageUpdater(info.m_nodeStorageType,
+                                                  info.GetCacheFileName(NODES_FILE));
+    cache::IntermediateDataWriter writer(*nodes, info, kOsmChangePartSuffix);
+    for (auto const * elements : {&change.m_created, &change.m_modified})
+    {
+      for (auto element : *elements)
+        AddElementToCache(writer, std::move(element));
+    }
+    writer.SaveIndex();
+  }
+
+  auto changedNodes = std::move(oldIds.m_nodes);
+  changedNodes.insert(newIds.m_nodes.cbegin(), newIds.m_nodes.cend());
+  auto changedWays = std::move(oldIds.m_ways);
+  changedWays.insert(newIds.m_ways.cbegin(), newIds.m_ways.cend());
+  auto changedRelations = std::move(oldIds.m_relations);
+  changedRelations.insert(newIds.m_relations.cbegin(), newIds.m_relations.cend());
+  cache::ApplyIntermediateDataPart(info, kOsmChangePartSuffix, changedWays, changedRelations);
+
+  // Ways are scanned once, in the new version only. A way which refers to a changed node and
+  // isn't changed itself has the same nodes and parent relations in both versions, and old
+  // positions of the changed nodes are already added from the old version.
+  ChangedCountriesCollector collector(info, affiliation, countries);
+  collector.FindWaysByNodes(changedNodes, newIds.m_ways);
+  collector.Collect(newIds);
+  return countries;
+}
+
+void FilterChangedCountries(std::set<std::string> const & changedCountries,
+                            std::string const & reportPath, std::vector<std::string> & countries)
+{
+  std::vector<std::string> regenerated;
+  std::vector<std::string> skipped;
+  for (auto & country : countries)
+  {
+    if (changedCountries.count(country) != 0 || country == WORLD_FILE_NAME ||
+        country == WORLD_COASTS_FILE_NAME)
+    {
+      regenerated.emplace_back(std::move(country));
+    }
+    else
+    {
+      skipped.emplace_back(std::move(country));
+    }
+  }
+
+  // Without known countries all changed ones are regenerated.
+  if (countries.empty())
+    regenerated.assign(changedCountries.cbegin(), changedCountries.cend());
+
+  std::ofstream stream;
+  stream.exceptions(std::fstream::failbit | std::fstream::badbit);
+  stream.open(reportPath);
+  for (auto const & country : regenerated)
+    stream << country << "\tregenerated\n";
+  for (auto const & country : skipped)
+    stream << country << "\tskipped\n";
+
+  LOG(LINFO, ("Countries regenerated:", regenerated.size(), "skipped:", skipped.size(),
+              "report:", reportPath));
+  LOG(LINFO, ("Regenerated countries:", regenerated));
+  countries = std::move(regenerated);
+}
+}  // namespace generator
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "generator/affiliation.hpp"
+#include "generator/generate_info.hpp"
+#include "generator/osm_element.hpp"
+#include "generator/osm_source.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+// Elements of an OsmChange file, see https://wiki.openstreetmap.org/wiki/OsmChange.
+struct OsmChange
+{
+  bool IsEmpty() const { return m_created.empty() && m_modified.empty() && m_deleted.empty(); }
+
+  std::vector<OsmElement> m_created;
+  std::vector<OsmElement> m_modified;
+  std::vector<OsmElement> m_deleted;
+};
+
+OsmChange ReadOsmChange(SourceReader & stream);
+
+// Applies |change| to nodes, ways and relations caches of |info| and returns names of countries
+// whose features may be changed by it. The caches must be the ones of the planet before the
+// change, while the 2nd pass reads the planet with the change already applied. Countries are
+// the ones of old and new geometry of changed elements, of ways with changed nodes and of
+// relations with changed members.
+std::set<std::string> ApplyOsmChange(feature::GenerateInfo const & info, OsmChange const & change,
+                                     feature::AffiliationInterface const & affiliation);
+
+// Leaves in |countries| the ones from |changedCountries| and World files, features of any
+// country may go to the latter ones. Regenerated and skipped countries are written
+// to |reportPath|, a country per line.
+void FilterChangedCountries(std::set<std::string> const & changedCountries,
+                            std::string const & reportPath, std::vector<std::string> & countries);
+}  // namespace generator
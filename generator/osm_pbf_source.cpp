@@ -0,0 +1,417 @@
+#include "generator/osm_pbf_source.hpp"
+
+#include "generator/osm_element.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+
+#include <iterator>
+
+namespace osm
+{
+namespace pbf
+{
+using namespace std;
+
+namespace
+{
+// Limits of the format.
+size_t constexpr kMaxBlobHeaderSize = 64 * 1024;
+size_t constexpr kMaxBlobSize = 32 * 1024 * 1024;
+
+// Features of HeaderBlock::required_features supported by the decoder.
+char const * const kSupportedFeatures[] = {"OsmSchema-V0.6", "DenseNodes"};
+
+// Fields of messages of fileformat.proto and osmformat.proto.
+namespace field
+{
+uint32_t constexpr kBlobHeaderType = 1;
+uint32_t constexpr kBlobHeaderDataSize = 3;
+
+uint32_t constexpr kBlobRaw = 1;
+uint32_t constexpr kBlobRawSize = 2;
+uint32_t constexpr kBlobZlibData = 3;
+
+uint32_t constexpr kHeaderRequiredFeatures = 4;
+
+uint32_t constexpr kBlockStringTable = 1;
+uint32_t constexpr kBlockGroup = 2;
+uint32_t constexpr kBlockGranularity = 17;
+uint32_t constexpr kBlockLatOffset = 19;
+uint32_t constexpr kBlockLonOffset = 20;
+
+uint32_t constexpr kStringTableString = 1;
+
+uint32_t constexpr kGroupNode = 1;
+uint32_t constexpr kGroupDense = 2;
+uint32_t constexpr kGroupWay = 3;
+uint32_t constexpr kGroupRelation = 4;
+
+// Common fields of Node, Way and Relation.
+uint32_t constexpr kId = 1;
+uint32_t constexpr kKeys = 2;
+uint32_t constexpr kValues = 3;
+
+uint32_t constexpr kNodeLat = 8;
+uint32_t constexpr kNodeLon = 9;
+
+uint32_t constexpr kDenseId = 1;
+uint32_t constexpr kDenseLat = 8;
+uint32_t constexpr kDenseLon = 9;
+uint32_t constexpr kDenseKeysValues = 10;
+
+uint32_t constexpr kWayRefs = 8;
+
+uint32_t constexpr kRelationRoles = 8;
+uint32_t constexpr kRelationMemberIds = 9;
+uint32_t constexpr kRelationMemberTypes = 10;
+}  // namespace field
+
+class PrimitiveBlock
+{
+public:
+  explicit PrimitiveBlock(vector<uint8_t> const & data)
+  {
+    Message block(data.data(), data.size());
+    while (block.Next())
+    {
+      switch (block.GetField())
+      {
+      case field::kBlockStringTable:
+      {
+        auto table = block.GetMessage();
+        while (table.Next())
+        {
+          if (table.GetField() == field::kStringTableString)
+            m_strings.emplace_back(table.GetString());
+          else
+            table.Skip();
+        }
+        break;
+      }
+      // Groups go before the coordinates fields, so they are decoded after the whole block is read.
+      case field::kBlockGroup: m_groups.push_back(block.GetMessage()); break;
+      case field::kBlockGranularity: m_granularity = static_cast<int64_t>(block.GetVarint()); break;
+      case field::kBlockLatOffset: m_latOffset = static_cast<int64_t>(block.GetVarint()); break;
+      case field::kBlockLonOffset: m_lonOffset = static_cast<int64_t>(block.GetVarint()); break;
+      default: block.Skip(); break;
+      }
+    }
+  }
+
+  void Decode(vector<OsmElement> & elements)
+  {
+    for (auto & group : m_groups)
+    {
+      while (group.Next())
+      {
+        switch (group.GetField())
+        {
+        case field::kGroupNode: DecodeNode(group.GetMessage(), elements); break;
+        case field::kGroupDense: DecodeDenseNodes(group.GetMessage(), elements); break;
+        case field::kGroupWay: DecodeWay(group.GetMessage(), elements); break;
+        case field::kGroupRelation: DecodeRelation(group.GetMessage(), elements); break;
+        default: group.Skip(); break;
+        }
+      }
+    }
+  }
+
+private:
+  string const & GetString(uint64_t index) const
+  {
+    if (index >= m_strings.size())
+      MYTHROW(PbfException, ("String", index, "is out of the string table of size", m_strings.size()));
+    return m_strings[index];
+  }
+
+  double GetLat(int64_t lat) const { return 1e-9 * (m_latOffset + m_granularity * lat); }
+  double GetLon(int64_t lon) const { return 1e-9 * (m_lonOffset + m_granularity * lon); }
+
+  void AddTags(Message keys, Message values, OsmElement & element) const
+  {
+    while (!keys.IsEnd())
+    {
+      if (values.IsEnd())
+        MYTHROW(PbfException, ("Less values than keys of", element.m_id));
+      auto const & key = GetString(keys.ReadVarint());
+      element.AddTag(key, GetString(values.ReadVarint()));
+    }
+  }
+
+  static OsmElement & AddElement(OsmElement::EntityType type, vector<OsmElement> & elements)
+  {
+    auto & element = elements.emplace_back();
+    element.m_type = type;
+    return element;
+  }
+
+  void DecodeNode(Message node, vector<OsmElement> & elements) const
+  {
+    auto & element = AddElement(OsmElement::EntityType::Node, elements);
+    Message keys;
+    Message values;
+    while (node.Next())
+    {
+      switch (node.GetField())
+      {
+      case field::kId: element.m_id = static_cast<uint64_t>(node.GetSVarint()); break;
+      case field::kKeys: keys = node.GetMessage(); break;
+      case field::kValues: values = node.GetMessage(); break;
+      case field::kNodeLat: element.m_lat = GetLat(node.GetSVarint()); break;
+      case field::kNodeLon: element.m_lon = GetLon(node.GetSVarint()); break;
+      default: node.Skip(); break;
+      }
+    }
+    AddTags(keys, values, element);
+    element.Validate();
+  }
+
+  void DecodeDenseNodes(Message dense, vector<OsmElement> & elements) const
+  {
+    Message ids;
+    Message lats;
+    Message lons;
+    Message keysValues;
+    while (dense.Next())
+    {
+      switch (dense.GetField())
+      {
+      case field::kDenseId: ids = dense.GetMessage(); break;
+      case field::kDenseLat: lats = dense.GetMessage(); break;
+      case field::kDenseLon: lons = dense.GetMessage(); break;
+      case field::kDenseKeysValues: keysValues = dense.GetMessage(); break;
+      default: dense.Skip(); break;
+      }
+    }
+
+    // Ids and coordinates are delta coded, tags of nodes are separated by zeroes.
+    int64_t id = 0;
+    int64_t lat = 0;
+    int64_t lon = 0;
+    while (!ids.IsEnd())
+    {
+      id += ids.ReadSVarint();
+      lat += lats.ReadSVarint();
+      lon += lons.ReadSVarint();
+
+      auto & element = AddElement(OsmElement::EntityType::Node, elements);
+      element.m_id = static_cast<uint64_t>(id);
+      element.m_lat = GetLat(lat);
+      element.m_lon = GetLon(lon);
+
+      while (!keysValues.IsEnd())
+      {
+        auto const key = keysValues.ReadVarint();
+        if (key == 0)
+          break;
+        element.AddTag(GetString(key), GetString(keysValues.ReadVarint()));
+      }
+      element.Validate();
+    }
+  }
+
+  void DecodeWay(Message way, vector<OsmElement> & elements) const
+  {
+    auto & element = AddElement(OsmElement::EntityType::Way, elements);
+    Message keys;
+    Message values;
+    Message refs;
+    while (way.Next())
+    {
+      switch (way.GetField())
+      {
+      case field::kId: element.m_id = way.GetVarint(); break;
+      case field::kKeys: keys = way.GetMessage(); break;
+      case field::kValues: values = way.GetMessage(); break;
+      case field::kWayRefs: refs = way.GetMessage(); break;
+      default: way.Skip(); break;
+      }
+    }
+
+    int64_t ref = 0;
+    while (!refs.IsEnd())
+    {
+      ref += refs.ReadSVarint();
+      element.AddNd(static_cast<uint64_t>(ref));
+    }
+    AddTags(keys, values, element);
+    element.Validate();
+  }
+
+  void DecodeRelation(Message relation, vector<OsmElement> & elements) const
+  {
+    auto & element = AddElement(OsmElement::EntityType::Relation, elements);
+    Message keys;
+    Message values;
+    Message roles;
+    Message ids;
+    Message types;
+    while (relation.Next())
+    {
+      switch (relation.GetField())
+      {
+      case field::kId: element.m_id = relation.GetVarint(); break;
+      case field::kKeys: keys = relation.GetMessage(); break;
+      case field::kValues: values = relation.GetMessage(); break;
+      case field::kRelationRoles: roles = relation.GetMessage(); break;
+      case field::kRelationMemberIds: ids = relation.GetMessage(); break;
+      case field::kRelationMemberTypes: types = relation.GetMessage(); break;
+      default: relation.Skip(); break;
+      }
+    }
+
+    int64_t id = 0;
+    while (!ids.IsEnd())
+    {
+      id += ids.ReadSVarint();
+      OsmElement::EntityType type;
+      switch (types.ReadVarint())
+      {
+      case 0: type = OsmElement::EntityType::Node; break;
+      case 1: type = OsmElement::EntityType::Way; break;
+      case 2: type = OsmElement::EntityType::Relation; break;
+      default: type = OsmElement::EntityType::Unknown; break;
+      }
+      element.AddMember(static_cast<uint64_t>(id), type, GetString(roles.ReadVarint()));
+    }
+    AddTags(keys, values, element);
+    element.Validate();
+  }
+
+  vector<string> m_strings;
+  vector<Message> m_groups;
+  int64_t m_granularity = 100;
+  int64_t m_latOffset = 0;
+  int64_t m_lonOffset = 0;
+};
+}  // namespace
+
+// Message -----------------------------------------------------------------------------------------
+void Message::Skip()
+{
+  switch (m_wireType)
+  {
+  case kVarint: ReadVarint(); break;
+  case kLengthDelimited: GetMessage(); break;
+  case kFixed64:
+  case kFixed32:
+  {
+    size_t const size = m_wireType == kFixed64 ? 8 : 4;
+    if (size > static_cast<size_t>(m_end - m_ptr))
+      MYTHROW(PbfException, ("Field", m_field, "is out of the message."));
+    m_ptr += size;
+    break;
+  }
+  default: MYTHROW(PbfException, ("Unsupported wire type", int(m_wireType), "of field", m_field));
+  }
+}
+
+// Functions ---------------------------------------------------------------------------------------
+bool ReadBlob(ReadFn const & read, Blob & blob)
+{
+  auto const readExactly = [&read](uint8_t * p, size_t size) {
+    if (read(p, size) != size)
+      MYTHROW(PbfException, ("Unexpected end of file."));
+  };
+
+  uint8_t sizeBytes[4];
+  auto const readBytes = read(sizeBytes, sizeof(sizeBytes));
+  if (readBytes == 0)
+    return false;
+  if (readBytes != sizeof(sizeBytes))
+    MYTHROW(PbfException, ("Unexpected end of file."));
+
+  // The size of the header is in network byte order.
+  size_t const headerSize = (size_t{sizeBytes[0]} << 24) | (size_t{sizeBytes[1]} << 16) |
+                            (size_t{sizeBytes[2]} << 8) | size_t{sizeBytes[3]};
+  if (headerSize > kMaxBlobHeaderSize)
+    MYTHROW(PbfException, ("Too big blob header:", headerSize));
+
+  blob.m_data.resize(headerSize);
+  readExactly(blob.m_data.data(), headerSize);
+
+  blob.m_type.clear();
+  uint64_t dataSize = 0;
+  Message header(blob.m_data.data(), blob.m_data.size());
+  while (header.Next())
+  {
+    switch (header.GetField())
+    {
+    case field::kBlobHeaderType: blob.m_type = header.GetString(); break;
+    case field::kBlobHeaderDataSize: dataSize = header.GetVarint(); break;
+    default: header.Skip(); break;
+    }
+  }
+  if (dataSize > kMaxBlobSize)
+    MYTHROW(PbfException, ("Too big blob:", dataSize));
+
+  blob.m_data.resize(static_cast<size_t>(dataSize));
+  readExactly(blob.m_data.data(), blob.m_data.size());
+  return true;
+}
+
+void Decompress(Blob const & blob, vector<uint8_t> & data)
+{
+  data.clear();
+  Message message(blob.m_data.data(), blob.m_data.size());
+  string_view zlibData;
+  bool compressed = false;
+  uint64_t rawSize = 0;
+  while (message.Next())
+  {
+    switch (message.GetField())
+    {
+    case field::kBlobRaw:
+    {
+      auto const raw = message.GetString();
+      data.assign(raw.begin(), raw.end());
+      return;
+    }
+    case field::kBlobRawSize: rawSize = message.GetVarint(); break;
+    case field::kBlobZlibData:
+      zlibData = message.GetString();
+      compressed = true;
+      break;
+    default: message.Skip(); break;
+    }
+  }
+
+  if (!compressed)
+    MYTHROW(PbfException, ("Unsupported compression of a", blob.m_type, "blob."));
+  if (rawSize > kMaxBlobSize)
+    MYTHROW(PbfException, ("Too big blob:", rawSize));
+
+  data.reserve(static_cast<size_t>(rawSize));
+  coding::ZLib::Inflate const inflate(coding::ZLib::Inflate::Format::ZLib);
+  if (!inflate(zlibData.data(), zlibData.size(), back_inserter(data)))
+    MYTHROW(PbfException, ("Can't inflate a", blob.m_type, "blob."));
+}
+
+void CheckHeaderBlock(vector<uint8_t> const & data)
+{
+  Message header(data.data(), data.size());
+  while (header.Next())
+  {
+    if (header.GetField() != field::kHeaderRequiredFeatures)
+    {
+      header.Skip();
+      continue;
+    }
+
+    auto const feature = header.GetString();
+    bool supported = false;
+    for (auto const * f : kSupportedFeatures)
+      supported = supported || feature == f;
+    if (!supported)
+      MYTHROW(PbfException, ("Unsupported required feature:", string(feature)));
+  }
+}
+
+void DecodePrimitiveBlock(vector<uint8_t> const & data, vector<OsmElement> & elements)
+{
+  PrimitiveBlock(data).Decode(elements);
+}
+}  // namespace pbf
+}  // namespace osm
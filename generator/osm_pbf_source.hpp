@@ -0,0 +1,139 @@
+// See PBF Format definition at https://wiki.openstreetmap.org/wiki/PBF_Format
+#pragma once
+
+#include "base/exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct OsmElement;
+
+namespace osm
+{
+namespace pbf
+{
+DECLARE_EXCEPTION(PbfException, RootException);
+
+// Reader of fields of a protobuf message in the wire format, see
+// https://developers.google.com/protocol-buffers/docs/encoding
+// Messages are decoded in place, without generated classes and copies of their fields.
+class Message
+{
+public:
+  Message() = default;
+  Message(uint8_t const * data, size_t size) : m_ptr(data), m_end(data + size) {}
+
+  bool IsEnd() const { return m_ptr == m_end; }
+
+  // Moves to the next field, returns false at the end of the message.
+  bool Next()
+  {
+    if (IsEnd())
+      return false;
+
+    auto const key = ReadVarint();
+    m_field = static_cast<uint32_t>(key >> 3);
+    m_wireType = static_cast<uint8_t>(key & 7);
+    return true;
+  }
+
+  uint32_t GetField() const { return m_field; }
+
+  uint64_t GetVarint()
+  {
+    CheckWireType(kVarint);
+    return ReadVarint();
+  }
+
+  int64_t GetSVarint() { return DecodeZigZag(GetVarint()); }
+
+  // Returns a length-delimited field: a string, an embedded message or a packed repeated field.
+  Message GetMessage()
+  {
+    CheckWireType(kLengthDelimited);
+    auto const size = ReadVarint();
+    if (size > static_cast<uint64_t>(m_end - m_ptr))
+      MYTHROW(PbfException, ("Field", m_field, "is out of the message."));
+
+    Message message(m_ptr, static_cast<size_t>(size));
+    m_ptr += size;
+    return message;
+  }
+
+  std::string_view GetString()
+  {
+    auto const message = GetMessage();
+    return {reinterpret_cast<char const *>(message.m_ptr),
+            static_cast<size_t>(message.m_end - message.m_ptr)};
+  }
+
+  void Skip();
+
+  // Reads the next value of a packed repeated field of varints.
+  uint64_t ReadVarint()
+  {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      if (IsEnd())
+        MYTHROW(PbfException, ("Varint is out of the message."));
+
+      uint8_t const byte = *m_ptr++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    MYTHROW(PbfException, ("Too long varint."));
+  }
+
+  int64_t ReadSVarint() { return DecodeZigZag(ReadVarint()); }
+
+private:
+  static uint8_t constexpr kVarint = 0;
+  static uint8_t constexpr kFixed64 = 1;
+  static uint8_t constexpr kLengthDelimited = 2;
+  static uint8_t constexpr kFixed32 = 5;
+
+  static int64_t DecodeZigZag(uint64_t v)
+  {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+  }
+
+  void CheckWireType(uint8_t wireType) const
+  {
+    if (m_wireType != wireType)
+      MYTHROW(PbfException, ("Wrong wire type", int(m_wireType), "of field", m_field));
+  }
+
+  uint8_t const * m_ptr = nullptr;
+  uint8_t const * m_end = nullptr;
+  uint32_t m_field = 0;
+  uint8_t m_wireType = kVarint;
+};
+
+// A block of the file as it's stored: the type from its header and the serialized Blob message.
+struct Blob
+{
+  std::string m_type;
+  std::vector<uint8_t> m_data;
+};
+
+using ReadFn = std::function<size_t(uint8_t *, size_t)>;
+
+// Reads the next blob of the file by |read|, returns false at the end of the file.
+bool ReadBlob(ReadFn const & read, Blob & blob);
+
+// Decompresses the block of |blob| to |data|.
+void Decompress(Blob const & blob, std::vector<uint8_t> & data);
+
+// Throws PbfException when the file requires features which aren't supported by the decoder.
+void CheckHeaderBlock(std::vector<uint8_t> const & data);
+
+// Appends elements of a primitive block to |elements| in the order of the block.
+void DecodePrimitiveBlock(std::vector<uint8_t> const & data, std::vector<OsmElement> & elements);
+}  // namespace pbf
+}  // namespace osm
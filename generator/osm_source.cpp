@@ -1,8 +1,10 @@
 #include "generator/osm_source.hpp"
 
 #include "generator/intermediate_data.hpp"
+#include "generator/intermediate_data_writers_pool.hpp"
 #include "generator/intermediate_elements.hpp"
 #include "generator/osm_element.hpp"
+#include "generator/profiler.hpp"
 #include "generator/towns_dumper.hpp"
 
 #include "geometry/mercator.hpp"
@@ -124,6 +126,19 @@ void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void(OsmElem
   }
 }
 
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void(OsmElement &&)> const & processor,
+                               size_t threadsCount)
+{
+  ProcessorOsmElementsFromPbf processorOsmElementsFromPbf(stream, threadsCount);
+  OsmElement element;
+  while (processorOsmElementsFromPbf.TryRead(element))
+  {
+    processor(std::move(element));
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
+  }
+}
+
 ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(SourceReader & stream)
   : m_stream(stream)
   , m_dataset([&](uint8_t * buffer, size_t size) {
@@ -190,6 +205,77 @@ bool ProcessorOsmElementsFromO5M::TryRead(OsmElement & element)
   return true;
 }
 
+ProcessorOsmElementsFromPbf::ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount)
+  : m_stream(stream)
+  // Blocks are read ahead of the decoding threads, so they are not idle while a block is read.
+  , m_maxBlocksInWork(2 * threadsCount)
+  , m_threadPool(threadsCount)
+{
+}
+
+void ProcessorOsmElementsFromPbf::SubmitBlocks()
+{
+  auto const read = [this](uint8_t * buffer, size_t size) {
+    return m_stream.Read(reinterpret_cast<char *>(buffer), size);
+  };
+
+  osm::pbf::Blob blob;
+  while (!m_isEnd && m_blocks.size() < m_maxBlocksInWork)
+  {
+    if (!osm::pbf::ReadBlob(read, blob))
+    {
+      m_isEnd = true;
+      break;
+    }
+
+    if (blob.m_type == "OSMHeader")
+    {
+      std::vector<uint8_t> data;
+      osm::pbf::Decompress(blob, data);
+      osm::pbf::CheckHeaderBlock(data);
+    }
+    else if (blob.m_type == "OSMData")
+    {
+      m_blocks.emplace(m_threadPool.Submit([blob = std::move(blob)]() {
+        std::vector<uint8_t> data;
+        osm::pbf::Decompress(blob, data);
+        std::vector<OsmElement> elements;
+        osm::pbf::DecodePrimitiveBlock(data, elements);
+        return elements;
+      }));
+    }
+    // Blobs of unknown types are skipped according to the format.
+  }
+}
+
+bool ProcessorOsmElementsFromPbf::TryRead(OsmElement & element)
+{
+  while (m_pos == m_elements.size())
+  {
+    SubmitBlocks();
+    if (m_blocks.empty())
+    {
+      if (!m_isEndLogged)
+      {
+        auto static constexpr kBytesInMiB = 1024.0 * 1024.0;
+        auto const seconds = m_timer.ElapsedSeconds();
+        LOG(LINFO, ("Decoded", m_stream.Pos() / kBytesInMiB, "MiB of PBF in", seconds, "seconds,",
+                    seconds > 0.0 ? m_stream.Pos() / kBytesInMiB / seconds : 0.0, "MiB/s"));
+        m_isEndLogged = true;
+      }
+      return false;
+    }
+
+    // Decoding exceptions are rethrown here.
+    m_elements = m_blocks.front().get();
+    m_blocks.pop();
+    m_pos = 0;
+  }
+
+  element = std::move(m_elements[m_pos++]);
+  return true;
+}
+
 ProcessorOsmElementsFromXml::ProcessorOsmElementsFromXml(SourceReader & stream)
   : m_xmlSource([&, this](OsmElement && e)
     {
@@ -226,33 +312,70 @@ bool ProcessorOsmElementsFromXml::TryRead(OsmElement & element)
 // Generate functions implementations.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool GenerateIntermediateData(feature::GenerateInfo & info)
+bool GenerateIntermediateData(feature::GenerateInfo & info, size_t threadsCount)
 {
   auto nodes =
       cache::CreatePointStorageWriter(info.m_nodeStorageType, info.GetCacheFileName(NODES_FILE));
-  cache::IntermediateDataWriter cache(*nodes, info);
   TownsDumper towns;
   SourceReader reader = info.m_osmFileName.empty() ? SourceReader() : SourceReader(info.m_osmFileName);
 
   LOG(LINFO, ("Data source:", info.m_osmFileName));
 
-  auto const processor = [&](OsmElement && element)
+  auto const process = [&](std::function<void(OsmElement &&)> const & processor)
   {
-    towns.CheckElement(element);
-    AddElementToCache(cache, std::move(element));
+    switch (info.m_osmFileType)
+    {
+    case feature::GenerateInfo::OsmSourceType::XML:
+      ProcessOsmElementsFromXML(reader, processor);
+      break;
+    case feature::GenerateInfo::OsmSourceType::O5M:
+      ProcessOsmElementsFromO5M(reader, processor);
+      break;
+    case feature::GenerateInfo::OsmSourceType::PBF:
+      ProcessOsmElementsFromPbf(reader, processor, threadsCount);
+      break;
+    }
   };
 
-  switch (info.m_osmFileType)
+  base::Timer timer;
+  if (threadsCount > 1)
   {
-  case feature::GenerateInfo::OsmSourceType::XML:
-    ProcessOsmElementsFromXML(reader, processor);
-    break;
-  case feature::GenerateInfo::OsmSourceType::O5M:
-    ProcessOsmElementsFromO5M(reader, processor);
-    break;
+    // Elements are passed to writers by chunks to keep synchronization costs low.
+    size_t constexpr kChunkSize = 1 << 14;
+    IntermediateDataWritersPool pool(*nodes, info, threadsCount);
+    std::vector<OsmElement> chunk;
+    process([&](OsmElement && element)
+    {
+      towns.CheckElement(element);
+      chunk.emplace_back(std::move(element));
+      if (chunk.size() == kChunkSize)
+      {
+        pool.Emit(std::move(chunk));
+        chunk = {};
+      }
+    });
+    if (!chunk.empty())
+      pool.Emit(std::move(chunk));
+    pool.Finish();
+  }
+  else
+  {
+    cache::IntermediateDataWriter cache(*nodes, info);
+    process([&](OsmElement && element)
+    {
+      towns.CheckElement(element);
+      AddElementToCache(cache, std::move(element));
+    });
+    cache.SaveIndex();
   }
 
-  cache.SaveIndex();
+  auto const seconds = timer.ElapsedSeconds();
+  LOG(LINFO, ("Preprocessed", reader.Pos() / (1024.0 * 1024.0), "MiB of input in", seconds,
+              "seconds, MiB/s:", seconds > 0.0 ? reader.Pos() / (1024.0 * 1024.0) / seconds : 0.0));
+
+  Profiler::Instance().AddCount("input_bytes", reader.Pos());
+  Profiler::Instance().AddCount("nodes", nodes->GetNumProcessedPoints());
+
   towns.Dump(info.GetIntermediateFileName(TOWNS_FILE));
   LOG(LINFO, ("Added points count =", nodes->GetNumProcessedPoints()));
   return true;
@@ -3,17 +3,24 @@
 #include "generator/generate_info.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/osm_o5m_source.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_xml_source.hpp"
 #include "generator/translator_interface.hpp"
 
 #include "coding/parse_xml.hpp"
 
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
+
+#include <cstddef>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <vector>
 
 struct OsmElement;
 class FeatureParams;
@@ -45,10 +52,16 @@ public:
   uint64_t Pos() const { return m_pos; }
 };
 
-bool GenerateIntermediateData(feature::GenerateInfo & info);
+void AddElementToCache(cache::IntermediateDataWriter & cache, OsmElement && element);
+
+// When |threadsCount| is greater than one, input is decoded and intermediate data is written
+// on several threads.
+bool GenerateIntermediateData(feature::GenerateInfo & info, size_t threadsCount = 1);
 
 void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
 void ProcessOsmElementsFromXML(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void (OsmElement &&)> const & processor,
+                               size_t threadsCount = 1);
 
 class ProcessorOsmElementsInterface
 {
@@ -72,6 +85,32 @@ private:
   osm::O5MSource::Iterator m_pos;
 };
 
+// Blocks of the file are decompressed and decoded on a pool of threads while the next
+// blocks are read, elements are returned in the order of the file.
+class ProcessorOsmElementsFromPbf : public ProcessorOsmElementsInterface
+{
+public:
+  ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount);
+
+  // ProcessorOsmElementsInterface overrides:
+  bool TryRead(OsmElement & element) override;
+
+private:
+  // Reads blocks until |m_maxBlocksInWork| of them are decoded or the file ends.
+  void SubmitBlocks();
+
+  SourceReader & m_stream;
+  base::Timer m_timer;
+  bool m_isEnd = false;
+  // TryRead() may be called again after the end of the file.
+  bool m_isEndLogged = false;
+  size_t const m_maxBlocksInWork;
+  base::thread_pool::computational::ThreadPool m_threadPool;
+  std::queue<std::future<std::vector<OsmElement>>> m_blocks;
+  std::vector<OsmElement> m_elements;
+  size_t m_pos = 0;
+};
+
 class ProcessorOsmElementsFromXml : public ProcessorOsmElementsInterface
 {
 public:
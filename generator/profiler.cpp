@@ -0,0 +1,271 @@
+#include "generator/profiler.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include "std/target_os.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include <sys/resource.h>
+
+#include "cppjansson/cppjansson.hpp"
+
+namespace generator
+{
+namespace
+{
+#if defined(OMIM_OS_LINUX)
+// Returns the value of |field| of a /proc file of the "name: value" or "name value" format.
+uint64_t ReadProcField(std::string const & path, std::string const & field)
+{
+  std::ifstream stream(path);
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (!strings::StartsWith(line, field))
+      continue;
+
+    std::istringstream value(line.substr(field.size()));
+    uint64_t result = 0;
+    value >> result;
+    return result;
+  }
+  return 0;
+}
+#endif
+
+// Resets the peak resident set size of the process where it's supported.
+void ResetPeakRss()
+{
+#if defined(OMIM_OS_LINUX)
+  // See "clear_refs" in the proc(5) man page, it's supported since Linux 4.0.
+  std::ofstream stream("/proc/self/clear_refs");
+  stream << "5";
+#endif
+}
+
+base::JSONPtr StageToJSON(Profiler::StageStats const & stats)
+{
+  auto obj = base::NewJSONObject();
+  ToJSONObject(*obj, "stage", stats.m_stage);
+  ToJSONObject(*obj, "country", stats.m_country);
+  ToJSONObject(*obj, "wall_seconds", stats.m_wallSeconds);
+  ToJSONObject(*obj, "cpu_seconds", stats.m_cpuSeconds);
+  ToJSONObject(*obj, "peak_rss_bytes", stats.m_peakRssBytes);
+  ToJSONObject(*obj, "bytes_read", stats.m_bytesRead);
+  ToJSONObject(*obj, "bytes_written", stats.m_bytesWritten);
+
+  auto counts = base::NewJSONObject();
+  for (auto const & [name, count] : stats.m_counts)
+    ToJSONObject(*counts, name, count);
+  ToJSONObject(*obj, "counts", counts);
+  return obj;
+}
+}  // namespace
+
+// static
+ResourceUsage ResourceUsage::Get()
+{
+  ResourceUsage usage;
+
+  rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) == 0)
+  {
+    auto const toSeconds = [](timeval const & t) { return t.tv_sec + t.tv_usec / 1e6; };
+    usage.m_cpuSeconds = toSeconds(ru.ru_utime) + toSeconds(ru.ru_stime);
+#if defined(OMIM_OS_MAC)
+    usage.m_peakRssBytes = static_cast<uint64_t>(ru.ru_maxrss);
+#else
+    usage.m_peakRssBytes = static_cast<uint64_t>(ru.ru_maxrss) * 1024;
+#endif
+  }
+
+#if defined(OMIM_OS_LINUX)
+  // Unlike ru_maxrss, VmHWM is reset by ResetPeakRss().
+  if (auto const peakKb = ReadProcField("/proc/self/status", "VmHWM:"); peakKb != 0)
+    usage.m_peakRssBytes = peakKb * 1024;
+  usage.m_bytesRead = ReadProcField("/proc/self/io", "rchar:");
+  usage.m_bytesWritten = ReadProcField("/proc/self/io", "wchar:");
+#endif
+
+  return usage;
+}
+
+Profiler::Stage::Stage(std::string const & stage, std::string const & country)
+{
+  Profiler::Instance().BeginStage(stage, country);
+  m_start = ResourceUsage::Get();
+}
+
+Profiler::Stage::~Stage()
+{
+  Profiler::Instance().EndStage(m_timer.ElapsedSeconds(), m_start);
+}
+
+// static
+Profiler & Profiler::Instance()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+void Profiler::AddCount(std::string const & name, uint64_t count)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_opened.empty())
+    m_stages[m_opened.back()].m_counts[name] += count;
+}
+
+std::vector<Profiler::StageStats> Profiler::GetStages() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<StageStats> stages;
+  for (size_t i = 0; i < m_stages.size(); ++i)
+  {
+    if (std::find(m_opened.cbegin(), m_opened.cend(), i) == m_opened.cend())
+      stages.push_back(m_stages[i]);
+  }
+  return stages;
+}
+
+void Profiler::WriteReport(std::string const & path) const
+{
+  auto const stages = GetStages();
+
+  auto const usage = ResourceUsage::Get();
+  auto total = base::NewJSONObject();
+  ToJSONObject(*total, "wall_seconds", m_timer.ElapsedSeconds());
+  ToJSONObject(*total, "cpu_seconds", usage.m_cpuSeconds);
+  uint64_t peakRssBytes = usage.m_peakRssBytes;
+  for (auto const & stats : stages)
+    peakRssBytes = std::max(peakRssBytes, stats.m_peakRssBytes);
+  ToJSONObject(*total, "peak_rss_bytes", peakRssBytes);
+  ToJSONObject(*total, "bytes_read", usage.m_bytesRead);
+  ToJSONObject(*total, "bytes_written", usage.m_bytesWritten);
+
+  auto stagesArray = base::NewJSONArray();
+  for (auto const & stats : stages)
+  {
+    auto obj = StageToJSON(stats);
+    ToJSONArray(*stagesArray, obj);
+  }
+
+  auto root = base::NewJSONObject();
+  ToJSONObject(*root, "total", total);
+  ToJSONObject(*root, "stages", stagesArray);
+
+  auto const report = base::DumpToString(root, JSON_INDENT(2));
+  FileWriter writer(path);
+  writer.Write(report.data(), report.size());
+  LOG(LINFO, ("Profiling report with", stages.size(), "stages is written to", path));
+}
+
+bool Profiler::CompareWithBaseline(std::string const & baselinePath, double factor) const
+{
+  std::string content;
+  FileReader(baselinePath).ReadAsString(content);
+  base::Json const baseline(content);
+
+  std::unordered_map<std::string, StageStats> baselineStages;
+  auto * stagesArray = base::GetJSONObligatoryField(baseline.get(), "stages");
+  for (size_t i = 0; i < json_array_size(stagesArray); ++i)
+  {
+    auto * obj = json_array_get(stagesArray, i);
+    StageStats stats;
+    FromJSONObject(obj, "stage", stats.m_stage);
+    FromJSONObject(obj, "country", stats.m_country);
+    FromJSONObject(obj, "wall_seconds", stats.m_wallSeconds);
+    FromJSONObject(obj, "peak_rss_bytes", stats.m_peakRssBytes);
+    baselineStages.emplace(stats.GetKey(), std::move(stats));
+  }
+
+  // Short stages and small peaks are too noisy to be compared.
+  double constexpr kMinWallSeconds = 1.0;
+  uint64_t constexpr kMinPeakRssBytes = 64 * 1024 * 1024;
+
+  size_t regressionsCount = 0;
+  for (auto const & stats : GetStages())
+  {
+    auto const it = baselineStages.find(stats.GetKey());
+    if (it == baselineStages.cend())
+      continue;
+
+    auto const & baselineStats = it->second;
+    if (stats.m_wallSeconds >= kMinWallSeconds &&
+        stats.m_wallSeconds > baselineStats.m_wallSeconds * factor)
+    {
+      LOG(LWARNING, ("Stage", stats.GetKey(), "wall time regressed from",
+                     baselineStats.m_wallSeconds, "to", stats.m_wallSeconds, "seconds."));
+      ++regressionsCount;
+    }
+    if (stats.m_peakRssBytes >= kMinPeakRssBytes &&
+        stats.m_peakRssBytes > baselineStats.m_peakRssBytes * factor)
+    {
+      LOG(LWARNING, ("Stage", stats.GetKey(), "peak RSS regressed from",
+                     baselineStats.m_peakRssBytes, "to", stats.m_peakRssBytes, "bytes."));
+      ++regressionsCount;
+    }
+  }
+
+  LOG(LINFO, ("Compared with", baselinePath, "stages:", baselineStages.size(),
+              "regressions:", regressionsCount));
+  return regressionsCount == 0;
+}
+
+void Profiler::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  CHECK(m_opened.empty(), ("Stages are opened."));
+  m_stages.clear();
+  m_timer.Reset();
+}
+
+void Profiler::BeginStage(std::string const & stage, std::string const & country)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // The peak of the outer stage before the inner one would be lost after the reset.
+  auto const peakRssBytes = ResourceUsage::Get().m_peakRssBytes;
+  for (auto const i : m_opened)
+    m_stages[i].m_peakRssBytes = std::max(m_stages[i].m_peakRssBytes, peakRssBytes);
+  ResetPeakRss();
+
+  StageStats stats;
+  stats.m_stage = stage;
+  stats.m_country = country;
+  m_stages.push_back(std::move(stats));
+  m_opened.push_back(m_stages.size() - 1);
+}
+
+void Profiler::EndStage(double wallSeconds, ResourceUsage const & start)
+{
+  auto const usage = ResourceUsage::Get();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  CHECK(!m_opened.empty(), ());
+  auto & stats = m_stages[m_opened.back()];
+  m_opened.pop_back();
+
+  stats.m_wallSeconds = wallSeconds;
+  stats.m_cpuSeconds = usage.m_cpuSeconds - start.m_cpuSeconds;
+  stats.m_peakRssBytes = std::max(stats.m_peakRssBytes, usage.m_peakRssBytes);
+  stats.m_bytesRead = usage.m_bytesRead - start.m_bytesRead;
+  stats.m_bytesWritten = usage.m_bytesWritten - start.m_bytesWritten;
+
+  // Peaks of inner stages are peaks of outer stages too.
+  for (auto const i : m_opened)
+    m_stages[i].m_peakRssBytes = std::max(m_stages[i].m_peakRssBytes, stats.m_peakRssBytes);
+
+  LOG(LINFO, ("Stage", stats.GetKey(), "is finished, wall seconds:", stats.m_wallSeconds,
+              "cpu seconds:", stats.m_cpuSeconds, "peak RSS MiB:", stats.m_peakRssBytes >> 20));
+}
+}  // namespace generator
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "base/macros.hpp"
+#include "base/timer.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace generator
+{
+// Resources used by the process so far. Values which aren't available on the platform are zeros.
+struct ResourceUsage
+{
+  static ResourceUsage Get();
+
+  // User and system time of all threads.
+  double m_cpuSeconds = 0.0;
+  // Peak resident set size since the start of the process. On Linux it's reset when a stage
+  // of Profiler begins, so it's the peak since the beginning of the innermost stage.
+  uint64_t m_peakRssBytes = 0;
+  // Bytes passed to read and write system calls, memory mapped files aren't counted.
+  uint64_t m_bytesRead = 0;
+  uint64_t m_bytesWritten = 0;
+};
+
+// Measures stages of the generation, per country for country stages, and writes them
+// as a JSON report. Reports of different runs are compared by stage and country names.
+// Stages are opened by one thread, counts may be added from any thread.
+class Profiler
+{
+public:
+  struct StageStats
+  {
+    std::string GetKey() const { return m_country.empty() ? m_stage : m_stage + "/" + m_country; }
+
+    std::string m_stage;
+    std::string m_country;
+    double m_wallSeconds = 0.0;
+    double m_cpuSeconds = 0.0;
+    uint64_t m_peakRssBytes = 0;
+    uint64_t m_bytesRead = 0;
+    uint64_t m_bytesWritten = 0;
+    // Counts of processed elements, sizes of written sections and so on.
+    std::map<std::string, uint64_t> m_counts;
+  };
+
+  // Measures a stage from construction to destruction. Stages may be nested, then the peak RSS
+  // of the outer stage includes peaks of the inner ones.
+  class Stage
+  {
+  public:
+    explicit Stage(std::string const & stage, std::string const & country = {});
+    ~Stage();
+
+  private:
+    base::Timer m_timer;
+    ResourceUsage m_start;
+
+    DISALLOW_COPY_AND_MOVE(Stage);
+  };
+
+  static Profiler & Instance();
+
+  // Adds |count| to the counter |name| of the innermost opened stage.
+  // It's ignored when there are no opened stages.
+  void AddCount(std::string const & name, uint64_t count);
+
+  std::vector<StageStats> GetStages() const;
+
+  // Writes closed stages and totals of the process to |path|.
+  void WriteReport(std::string const & path) const;
+
+  // Logs stages which took more than |factor| times longer or used more than |factor| times
+  // more memory than in the report at |baselinePath|. Returns false if there are such stages.
+  bool CompareWithBaseline(std::string const & baselinePath, double factor = 1.2) const;
+
+  void Clear();
+
+private:
+  Profiler() = default;
+
+  void BeginStage(std::string const & stage, std::string const & country);
+  void EndStage(double wallSeconds, ResourceUsage const & start);
+
+  mutable std::mutex m_mutex;
+  base::Timer m_timer;
+  std::vector<StageStats> m_stages;
+  // Indices of opened stages in |m_stages|, the innermost one is the last.
+  std::vector<size_t> m_opened;
+
+  DISALLOW_COPY_AND_MOVE(Profiler);
+};
+}  // namespace generator
@@ -8,6 +8,7 @@
 #include "generator/final_processor_world.hpp"
 #include "generator/osm_source.hpp"
 #include "generator/processor_factory.hpp"
+#include "generator/profiler.hpp"
 #include "generator/raw_generator_writer.hpp"
 #include "generator/translator_factory.hpp"
 #include "generator/translators_pool.hpp"
@@ -66,6 +67,8 @@ public:
     m_callCount = 0;
   }
 
+  size_t GetElementsCount() const { return m_element_counter; }
+
 private:
   base::Timer m_timer;
   size_t const m_logCallCountThreshold = 0;
@@ -154,14 +157,19 @@ void RawGenerator::GenerateCustom(
 
 bool RawGenerator::Execute()
 {
-  if (!GenerateFilteredFeatures())
-    return false;
+  {
+    Profiler::Stage stage("translators");
+    if (!GenerateFilteredFeatures())
+      return false;
+  }
 
   m_translators.reset();
   m_cache.reset();
   m_queue.reset();
   m_intermediateDataObjectsCache.Clear();
 
+  Profiler::Stage stage("final_processors");
+  Profiler::Instance().AddCount("final_processors", m_finalProcessors.size());
   while (!m_finalProcessors.empty())
   {
     auto const finalProcessor = m_finalProcessors.top();
@@ -240,6 +248,9 @@ bool RawGenerator::GenerateFilteredFeatures()
   case feature::GenerateInfo::OsmSourceType::XML:
     sourceProcessor = std::make_unique<ProcessorOsmElementsFromXml>(reader);
     break;
+  case feature::GenerateInfo::OsmSourceType::PBF:
+    sourceProcessor = std::make_unique<ProcessorOsmElementsFromPbf>(reader, m_threadsCount);
+    break;
   }
   CHECK(sourceProcessor, ());
 
@@ -267,11 +278,14 @@ bool RawGenerator::GenerateFilteredFeatures()
   } while (!isEnd);
 
   LOG(LINFO, ("Input was processed."));
+  Profiler::Instance().AddCount("elements", stats.GetElementsCount());
+  Profiler::Instance().AddCount("input_bytes", reader.Pos());
   if (!translators.Finish())
     return false;
 
   rawGeneratorWriter.ShutdownAndJoin();
   m_names = rawGeneratorWriter.GetNames();
+  Profiler::Instance().AddCount("countries", m_names.size());
   /// @todo: compare to the input list of countries loaded in borders::LoadCountriesList().
   if (m_names.empty())
     LOG(LWARNING, ("No feature data " DATA_FILE_EXTENSION_TMP " files were generated for any country!"));
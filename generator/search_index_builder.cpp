@@ -1,5 +1,7 @@
 #include "generator/search_index_builder.hpp"
 
+#include "generator/search_index_sorted_runs.hpp"
+
 #include "search/common.hpp"
 #include "search/house_to_street_table.hpp"
 #include "search/mwm_context.hpp"
@@ -24,8 +26,12 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/reader.hpp"
 #include "coding/reader_writer_ops.hpp"
 #include "coding/succinct_mapper.hpp"
+#include "coding/varint.hpp"
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
@@ -40,9 +46,13 @@
 #include "defines.hpp"
 
 #include <algorithm>
+#include <exception>
 #include <fstream>
 #include <memory>
+#include <optional>
+#include <string>
 #include <thread>
+#include <utility>
 #include <unordered_map>
 #include <vector>
 
@@ -379,20 +389,28 @@ private:
   FeatureNameInserter<ContT> m_inserter;
 };
 
+// Adds pairs of features with indices in [|beginIndex|, |endIndex|).
 template <class ContT>
-void AddFeatureNameIndexPairs(FeaturesVectorTest const & features,
-                              CategoriesHolder const & categoriesHolder,
-                              ContT & keyValuePairs)
+void AddFeatureNameIndexPairs(FeaturesVectorTest const & features, SynonymsHolder * synonyms,
+                              CategoriesHolder const & categoriesHolder, uint32_t beginIndex,
+                              uint32_t endIndex, ContT & keyValuePairs)
 {
-  feature::DataHeader const & header = features.GetHeader();
-
-  std::unique_ptr<SynonymsHolder> synonyms;
-  if (header.GetType() == feature::DataHeader::MapType::World)
-    synonyms = std::make_unique<SynonymsHolder>();
+  FeatureInserter inserter(synonyms, keyValuePairs, categoriesHolder,
+                           features.GetHeader().GetScaleRange());
 
-  features.GetVector().ForEach(FeatureInserter(synonyms.get(), keyValuePairs, categoriesHolder, header.GetScaleRange()));
+  // A single feature is reused for all records as in FeaturesVector::ForEach().
+  std::optional<FeatureType> ft;
+  for (uint32_t index = beginIndex; index < endIndex; ++index)
+  {
+    features.GetVector().GetByIndex(index, ft);
+    ft->SetID(FeatureID(MwmSet::MwmId(), index));
+    inserter(*ft, index);
+  }
 }
 
+// Memory for pairs which are sorted at once, it's shared by all threads.
+size_t constexpr kSortBufferBytes = 512 * 1024 * 1024;
+
 void ReadAddressData(std::string const & filename, std::vector<feature::AddressData> & addrs)
 {
   FileReader reader(filename);
@@ -589,7 +607,8 @@ void BuildAddressTable(FilesContainerR & container, std::string const & addressD
 }  // namespace
 
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter);
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter,
+                      std::string const & tmpPathPrefix, uint32_t threadsCount);
 
 bool BuildSearchIndexFromDataFile(std::string const & country, feature::GenerateInfo const & info,
                                   bool forceRebuild, uint32_t threadsCount)
@@ -612,7 +631,7 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   {
     {
       FileWriter writer(indexFilePath);
-      BuildSearchIndex(readContainer, writer);
+      BuildSearchIndex(readContainer, writer, indexFilePath, threadsCount);
       LOG(LINFO, ("Search index size =", writer.Size()));
     }
 
@@ -668,27 +687,88 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   return true;
 }
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter,
+                      std::string const & tmpPathPrefix, uint32_t threadsCount)
 {
-  using Key = strings::UniString;
-  using Value = Uint64IndexValue;
-
   LOG(LINFO, ("Start building search index for", container.GetFileName()));
   base::Timer timer;
 
   auto const & categoriesHolder = GetDefaultCategories();
 
-  FeaturesVectorTest features(container);
-  SingleValueSerializer<Value> serializer;
+  std::unique_ptr<SynonymsHolder> synonyms;
+  uint32_t featuresCount = 0;
+  {
+    FeaturesVectorTest features(container);
+    if (features.GetHeader().GetType() == feature::DataHeader::MapType::World)
+      synonyms = std::make_unique<SynonymsHolder>();
+    featuresCount = base::asserted_cast<uint32_t>(features.GetVector().GetNumFeatures());
+  }
+
+  threadsCount = std::max(1U, std::min(threadsCount, featuresCount));
 
-  std::vector<std::pair<Key, Value>> searchIndexKeyValuePairs;
-  AddFeatureNameIndexPairs(features, categoriesHolder, searchIndexKeyValuePairs);
+  // Each thread reads its own range of features with its own readers, because readers
+  // are not thread-safe, and writes sorted runs of its pairs.
+  std::vector<std::vector<std::string>> threadRuns(threadsCount);
+  std::vector<std::string> runs;
+  auto const deleteRuns = [&runs, &threadRuns]()
+  {
+    threadRuns.push_back(std::move(runs));
+    for (auto const & paths : threadRuns)
+    {
+      for (auto const & path : paths)
+        FileWriter::DeleteFileX(path);
+    }
+  };
+  SCOPE_GUARD(runsGuard, deleteRuns);
 
-  std::sort(searchIndexKeyValuePairs.begin(), searchIndexKeyValuePairs.end());
-  LOG(LINFO, ("End sorting strings:", timer.ElapsedSeconds()));
+  // Exceptions can't leave threads, they are rethrown after all threads are joined.
+  std::vector<std::exception_ptr> exceptions(threadsCount);
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < threadsCount; ++i)
+  {
+    threads.emplace_back([&, i]()
+    {
+      try
+      {
+        uint64_t const beginIndex = uint64_t(featuresCount) * i / threadsCount;
+        uint64_t const endIndex = uint64_t(featuresCount) * (i + 1) / threadsCount;
+
+        FeaturesVectorTest features(container.GetFileName());
+        SortedRunsWriter writer(tmpPathPrefix + ".run" + strings::to_string(i),
+                                kSortBufferBytes / threadsCount);
+        AddFeatureNameIndexPairs(features, synonyms.get(), categoriesHolder,
+                                 static_cast<uint32_t>(beginIndex),
+                                 static_cast<uint32_t>(endIndex), writer);
+        threadRuns[i] = writer.Finish();
+      }
+      catch (...)
+      {
+        exceptions[i] = std::current_exception();
+      }
+    });
+  }
+
+  for (auto & t : threads)
+    t.join();
+
+  for (auto const & e : exceptions)
+  {
+    if (e)
+      std::rethrow_exception(e);
+  }
+
+  for (auto & paths : threadRuns)
+  {
+    runs.insert(runs.end(), paths.begin(), paths.end());
+    paths.clear();
+  }
+  LOG(LINFO, ("End sorting strings:", timer.ElapsedSeconds(), "sorted runs:", runs.size()));
 
-  trie::Build<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
-      indexWriter, serializer, searchIndexKeyValuePairs);
+  SingleValueSerializer<IndexValue> serializer;
+  trie::Builder<Writer, IndexKey, ValueList<IndexValue>, SingleValueSerializer<IndexValue>>
+      builder(indexWriter, serializer);
+  MergeSortedRuns(runs, [&builder](IndexPair const & pair) { builder.Add(pair.first, pair.second); });
+  builder.Finish();
 
   LOG(LINFO, ("End building search index, elapsed seconds:", timer.ElapsedSeconds()));
 }
@@ -0,0 +1,66 @@
+#include "generator/search_index_sorted_runs.hpp"
+
+#include "coding/varint.hpp"
+
+#include "base/checked_cast.hpp"
+
+#include <algorithm>
+
+namespace indexer
+{
+void WritePair(FileWriter & writer, IndexPair const & pair)
+{
+  WriteVarUint(writer, base::asserted_cast<uint32_t>(pair.first.size()));
+  for (auto const c : pair.first)
+    WriteVarUint(writer, static_cast<uint32_t>(c));
+  WriteVarUint(writer, pair.second.m_featureId);
+}
+
+IndexPair ReadPair(ReaderSource<FileReader> & source)
+{
+  IndexPair pair;
+  pair.first.resize(ReadVarUint<uint32_t>(source));
+  for (auto & c : pair.first)
+    c = static_cast<strings::UniChar>(ReadVarUint<uint32_t>(source));
+  pair.second.m_featureId = ReadVarUint<uint64_t>(source);
+  return pair;
+}
+
+// SortedRunsWriter --------------------------------------------------------------------------------
+SortedRunsWriter::SortedRunsWriter(std::string const & pathPrefix, size_t bufferBytes)
+  : m_pathPrefix(pathPrefix), m_capacity(std::max(size_t(1), bufferBytes / sizeof(IndexPair)))
+{
+}
+
+SortedRunsWriter::~SortedRunsWriter()
+{
+  for (auto const & path : m_runs)
+    FileWriter::DeleteFileX(path);
+}
+
+std::vector<std::string> SortedRunsWriter::Finish()
+{
+  Flush();
+  m_pairs.clear();
+  m_pairs.shrink_to_fit();
+
+  std::vector<std::string> runs;
+  runs.swap(m_runs);
+  return runs;
+}
+
+void SortedRunsWriter::Flush()
+{
+  if (m_pairs.empty())
+    return;
+
+  std::sort(m_pairs.begin(), m_pairs.end());
+  m_pairs.erase(std::unique(m_pairs.begin(), m_pairs.end()), m_pairs.end());
+
+  m_runs.push_back(m_pathPrefix + "." + strings::to_string(m_runs.size()));
+  FileWriter writer(m_runs.back());
+  for (auto const & pair : m_pairs)
+    WritePair(writer, pair);
+  m_pairs.clear();
+}
+}  // namespace indexer
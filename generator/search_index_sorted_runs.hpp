@@ -0,0 +1,89 @@
+#pragma once
+
+#include "search/search_index_values.hpp"
+
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
+#include "coding/reader.hpp"
+
+#include "base/macros.hpp"
+#include "base/string_utils.hpp"
+
+#include <cstddef>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace indexer
+{
+using IndexKey = strings::UniString;
+using IndexValue = Uint64IndexValue;
+using IndexPair = std::pair<IndexKey, IndexValue>;
+
+void WritePair(FileWriter & writer, IndexPair const & pair);
+IndexPair ReadPair(ReaderSource<FileReader> & source);
+
+// Collects pairs into a buffer of a bounded size. A full buffer is sorted and written to a file
+// as a sorted run, runs are merged by MergeSortedRuns(). It's FileSorter for variable-length keys.
+class SortedRunsWriter
+{
+public:
+  SortedRunsWriter(std::string const & pathPrefix, size_t bufferBytes);
+  // Deletes runs which are not returned by Finish(), e.g. when collecting of pairs throws.
+  ~SortedRunsWriter();
+
+  // A container interface for FeatureNameInserter.
+  template <typename... Args>
+  void emplace_back(Args &&... args)
+  {
+    if (m_pairs.size() == m_capacity)
+      Flush();
+    m_pairs.emplace_back(std::forward<Args>(args)...);
+  }
+
+  // Writes the last run and returns paths of all written runs, the caller deletes them.
+  std::vector<std::string> Finish();
+
+private:
+  void Flush();
+
+  std::string const m_pathPrefix;
+  size_t const m_capacity;
+  std::vector<IndexPair> m_pairs;
+  std::vector<std::string> m_runs;
+
+  DISALLOW_COPY_AND_MOVE(SortedRunsWriter);
+};
+
+// Calls |toDo| with pairs of sorted |runs| in the sorted order.
+template <typename ToDo>
+void MergeSortedRuns(std::vector<std::string> const & runs, ToDo && toDo)
+{
+  using Item = std::pair<IndexPair, size_t>;
+  auto const greater = [](Item const & lhs, Item const & rhs) { return rhs.first < lhs.first; };
+  std::priority_queue<Item, std::vector<Item>, decltype(greater)> queue(greater);
+
+  std::vector<ReaderSource<FileReader>> sources;
+  sources.reserve(runs.size());
+  for (auto const & run : runs)
+    sources.emplace_back(FileReader(run));
+
+  auto const push = [&](size_t i)
+  {
+    if (sources[i].Size() > 0)
+      queue.emplace(ReadPair(sources[i]), i);
+  };
+
+  for (size_t i = 0; i < sources.size(); ++i)
+    push(i);
+
+  while (!queue.empty())
+  {
+    toDo(queue.top().first);
+    auto const i = queue.top().second;
+    queue.pop();
+    push(i);
+  }
+}
+}  // namespace indexer
@@ -1,15 +1,28 @@
 #include "statistics.hpp"
 
+#include "generator/unpack_mwm.hpp"
+
 #include "indexer/classificator.hpp"
 #include "indexer/data_factory.hpp"
 #include "indexer/feature_processor.hpp"
 
 #include "geometry/mercator.hpp"
 
+#include "coding/internal/file_data.hpp"
+
 #include "base/logging.hpp"
+#include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <iomanip>
 #include <iterator>
+#include <random>
+#include <vector>
+
+#include "defines.hpp"
 
 namespace stats
 {
@@ -34,6 +47,73 @@ namespace stats
     os << "\n";
   }
 
+  double MeasureRandomReads(FilesContainerR::TReader const & reader, size_t readsCount,
+                            size_t maxReadSize)
+  {
+    uint64_t const size = reader.Size();
+    if (size == 0)
+      return 0.0;
+
+    std::minstd_rand rng(0);
+    std::vector<uint8_t> buffer(maxReadSize);
+    base::Timer timer;
+    for (size_t i = 0; i < readsCount; ++i)
+    {
+      auto const pos = std::uniform_int_distribution<uint64_t>(0, size - 1)(rng);
+      auto const readSize = static_cast<size_t>(std::min<uint64_t>(maxReadSize, size - pos));
+      reader.Read(pos, buffer.data(), readSize);
+    }
+    return timer.ElapsedSeconds() * 1e6 / readsCount;
+  }
+
+  void PrintSectionsCompressionStats(std::ostream & os, std::string const & fPath)
+  {
+    // Reads at uniformly random positions mostly miss the cache of decompressed blocks,
+    // so it's the worst case latency.
+    size_t constexpr kReadsCount = 10000;
+    size_t constexpr kMaxReadSize = 256;
+    uint32_t const kBlockSizes[] = {4 * 1024, 16 * 1024, 64 * 1024};
+
+    os << "Compressed section sizes and microseconds per random read\n";
+    try
+    {
+      FilesContainerR cont(fPath);
+      std::vector<FilesContainerR::Tag> tags;
+      cont.ForEachTag([&tags](FilesContainerR::Tag const & tag)
+      {
+        if (generator::IsCompressedSection(tag))
+          tags.push_back(tag);
+      });
+
+      std::string const compressedPath = fPath + EXTENSION_TMP;
+      SCOPE_GUARD(deleteCompressed, std::bind(&base::DeleteFileX, compressedPath));
+      for (auto const blockSize : kBlockSizes)
+      {
+        CHECK(base::CopyFileX(fPath, compressedPath), (fPath, compressedPath));
+        generator::CompressSections(compressedPath, blockSize);
+        FilesContainerR compressed(compressedPath);
+
+        os << "Block size " << blockSize << "\n";
+        for (auto const & tag : tags)
+        {
+          auto const compressedSize =
+              compressed.GetAbsoluteOffsetAndSize(FilesContainerR::GetCompressedTag(tag)).second;
+          auto const raw = cont.GetReader(tag);
+          os << std::setw(18) << tag << " : " << std::setw(10) << raw.Size() << " -> "
+             << std::setw(10) << compressedSize << ", " << std::setprecision(2) << std::fixed
+             << MeasureRandomReads(raw, kReadsCount, kMaxReadSize) << "us -> "
+             << MeasureRandomReads(compressed.GetReader(tag), kReadsCount, kMaxReadSize)
+             << "us\n";
+        }
+      }
+    }
+    catch (Reader::Exception const & ex)
+    {
+      LOG(LWARNING, ("Error reading file:", fPath, ex.Msg()));
+    }
+    os << "\n";
+  }
+
   // 0.001 deg² ≈ 12.392 km² * cos(lat)
   static constexpr double kAreas[] = { 10, 20, 50, 100, 200, 500, 1000, 5000, 360*360*12400 };
 
@@ -87,6 +87,10 @@ namespace stats
 
   void PrintFileContainerStats(std::ostream & os, std::string const & fPath);
 
+  // Prints sizes of sections listed in COMPRESSED_SECTION_TAGS and latencies of random
+  // reads from them, both raw and compressed with a few block sizes.
+  void PrintSectionsCompressionStats(std::ostream & os, std::string const & fPath);
+
   void CalcStats(std::string const & fPath, MapInfo & info);
   void PrintStats(std::ostream & os, MapInfo & info);
   void PrintTypeStats(std::ostream & os, MapInfo & info);
@@ -8,8 +8,11 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cctype>
 #include <vector>
 
+#include "defines.hpp"
+
 namespace generator
 {
 void UnpackMwm(std::string const & filePath)
@@ -37,4 +40,28 @@ void DeleteSection(std::string const & filePath, std::string const & tag)
 {
   FilesContainerW(filePath, FileWriter::OP_WRITE_EXISTING).DeleteSection(tag);
 }
+
+bool IsCompressedSection(std::string const & tag)
+{
+  for (std::string const compressed : COMPRESSED_SECTION_TAGS)
+  {
+    if (tag == compressed)
+      return true;
+
+    // Indexed sections like geom0, trg3.
+    if (tag.size() == compressed.size() + 1 && tag.compare(0, compressed.size(), compressed) == 0 &&
+        std::isdigit(static_cast<unsigned char>(tag.back())))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CompressSections(std::string const & filePath, uint32_t blockSize)
+{
+  LOG(LINFO, ("Compressing sections of", filePath, "with block size", blockSize));
+  FilesContainerW(filePath, FileWriter::OP_WRITE_EXISTING)
+      .CompressSections(&IsCompressedSection, blockSize);
+}
 }  // namespace generator
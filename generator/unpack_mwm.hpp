@@ -2,6 +2,7 @@
 
 #include "base/base.hpp"
 
+#include <cstdint>
 #include <string>
 
 
@@ -11,4 +12,10 @@ namespace generator
 void UnpackMwm(std::string const & filePath);
 
 void DeleteSection(std::string const & filePath, std::string const & tag);
+
+// Returns true for sections listed in COMPRESSED_SECTION_TAGS.
+bool IsCompressedSection(std::string const & tag);
+
+// Rewrites sections listed in COMPRESSED_SECTION_TAGS in the block-compressed format.
+void CompressSections(std::string const & filePath, uint32_t blockSize);
 }  // namespace generator
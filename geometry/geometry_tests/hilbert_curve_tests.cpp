@@ -0,0 +1,56 @@
+#include "testing/testing.hpp"
+
+#include "geometry/hilbert_curve.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace hilbert_curve_tests
+{
+UNIT_TEST(HilbertIndex_Order1)
+{
+  TEST_EQUAL(m2::HilbertIndex(0, 0, 1), 0, ());
+  TEST_EQUAL(m2::HilbertIndex(0, 1, 1), 1, ());
+  TEST_EQUAL(m2::HilbertIndex(1, 1, 1), 2, ());
+  TEST_EQUAL(m2::HilbertIndex(1, 0, 1), 3, ());
+}
+
+UNIT_TEST(HilbertIndex_Continuity)
+{
+  uint8_t constexpr kOrder = 5;
+  uint32_t constexpr kSize = 1 << kOrder;
+
+  std::vector<std::pair<uint64_t, std::pair<uint32_t, uint32_t>>> cells;
+  for (uint32_t x = 0; x < kSize; ++x)
+  {
+    for (uint32_t y = 0; y < kSize; ++y)
+      cells.push_back({m2::HilbertIndex(x, y, kOrder), {x, y}});
+  }
+  std::sort(cells.begin(), cells.end());
+
+  for (size_t i = 0; i < cells.size(); ++i)
+  {
+    // The curve visits every cell exactly once.
+    TEST_EQUAL(cells[i].first, i, ());
+    if (i == 0)
+      continue;
+
+    // Consecutive cells are neighbours.
+    auto const & p = cells[i - 1].second;
+    auto const & q = cells[i].second;
+    auto const dx = std::abs(static_cast<int64_t>(p.first) - static_cast<int64_t>(q.first));
+    auto const dy = std::abs(static_cast<int64_t>(p.second) - static_cast<int64_t>(q.second));
+    TEST_EQUAL(dx + dy, 1, (p, q));
+  }
+}
+
+UNIT_TEST(HilbertIndex_MaxOrder)
+{
+  uint32_t constexpr kMax = 0xFFFFFFFF;
+  TEST_EQUAL(m2::HilbertIndex(0, 0, 32), 0, ());
+  TEST_EQUAL(m2::HilbertIndex(kMax, 0, 32), 0xFFFFFFFFFFFFFFFFULL, ());
+}
+}  // namespace hilbert_curve_tests
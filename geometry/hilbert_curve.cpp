@@ -0,0 +1,40 @@
+#include "geometry/hilbert_curve.hpp"
+
+#include "base/assert.hpp"
+
+#include <utility>
+
+namespace m2
+{
+uint64_t HilbertIndex(uint32_t x, uint32_t y, uint8_t order)
+{
+  ASSERT_GREATER(order, 0, ());
+  ASSERT_LESS_OR_EQUAL(order, 32, ());
+
+  uint64_t const n = uint64_t{1} << order;
+  ASSERT_LESS(x, n, ());
+  ASSERT_LESS(y, n, ());
+
+  uint64_t rx = x;
+  uint64_t ry = y;
+  uint64_t index = 0;
+  for (uint64_t s = n / 2; s > 0; s /= 2)
+  {
+    uint64_t const bx = (rx & s) != 0 ? 1 : 0;
+    uint64_t const by = (ry & s) != 0 ? 1 : 0;
+    index += s * s * ((3 * bx) ^ by);
+
+    // Rotates the quadrant so that the curve in it has the canonical orientation.
+    if (by == 0)
+    {
+      if (bx == 1)
+      {
+        rx = n - 1 - rx;
+        ry = n - 1 - ry;
+      }
+      std::swap(rx, ry);
+    }
+  }
+  return index;
+}
+}  // namespace m2
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+namespace m2
+{
+// Returns the position of the cell (x, y) on the Hilbert curve that fills
+// the 2^order x 2^order grid. Cells that are close on the curve are close
+// on the plane, so sorting by this index gives a good spatial locality.
+// |x| and |y| must be less than 2^order, |order| must be in [1, 32].
+uint64_t HilbertIndex(uint32_t x, uint32_t y, uint8_t order);
+}  // namespace m2
@@ -34,14 +34,19 @@ bool CentersTable::Get(uint32_t id, m2::PointD & center)
   if (!m_map->Get(id, pointu))
     return false;
 
+  center = Decode(pointu);
+  return true;
+}
+
+m2::PointD CentersTable::Decode(m2::PointU const & pointu) const
+{
   if (m_version == Version::V0)
-    center = PointUToPointD(pointu, m_codingParams.GetCoordBits());
-  else if (m_version == Version::V1)
-    center = PointUToPointD(pointu, m_codingParams.GetCoordBits(), m_limitRect);
-  else
-    CHECK(false, ("Unknown CentersTable format."));
+    return PointUToPointD(pointu, m_codingParams.GetCoordBits());
+  if (m_version == Version::V1)
+    return PointUToPointD(pointu, m_codingParams.GetCoordBits(), m_limitRect);
 
-  return true;
+  CHECK(false, ("Unknown CentersTable format."));
+  return {};
 }
 
 // CentersTable ------------------------------------------------------------------------------------
@@ -56,6 +56,13 @@ public:
 
   uint64_t Count() const { return m_map->Count(); };
 
+  // Calls |fn| for (id, center) of all features in the table, in increasing order of ids.
+  template <typename Fn>
+  void ForEach(Fn && fn)
+  {
+    m_map->ForEach([&](uint32_t id, m2::PointU const & pointu) { fn(id, Decode(pointu)); });
+  }
+
   // Loads CentersTable instance. Note that |reader| must be alive
   // until the destruction of loaded table. Returns nullptr if
   // CentersTable can't be loaded.
@@ -70,6 +77,8 @@ private:
   bool Init(Reader & reader, serial::GeometryCodingParams const & codingParams,
             m2::RectD const & limitRect);
 
+  m2::PointD Decode(m2::PointU const & pointu) const;
+
   serial::GeometryCodingParams m_codingParams;
   std::unique_ptr<Map> m_map;
   std::unique_ptr<Reader> m_centersSubreader;
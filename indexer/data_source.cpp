@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <optional>
 
 using platform::CountryFile;
 using platform::LocalCountryFile;
@@ -19,7 +20,6 @@ public:
 
   ReadMWMFunctor(FeatureSourceFactory const & factory, Fn const & fn) : m_factory(factory), m_fn(fn)
   {
-    m_stop = []() { return false; };
   }
 
   ReadMWMFunctor(FeatureSourceFactory const & factory, Fn const & fn,
@@ -35,7 +35,7 @@ public:
   {
     auto src = m_factory(handle);
 
-    MwmValue const * mwmValue = handle.GetValue();
+    MwmValue * mwmValue = handle.GetValue();
     if (mwmValue)
     {
       // Untouched (original) features reading. Applies covering |cov| to geometry index, gets
@@ -51,18 +51,28 @@ public:
 
       // Use last coding scale for covering (see index_builder.cpp).
       covering::Intervals const & intervals = cov.Get<RectId::DEPTH_LEVELS>(lastScale);
-      ScaleIndex<ModelReaderPtr> index(mwmValue->m_cont.GetReader(INDEX_FILE_TAG), mwmValue->m_factory);
+      auto const & index = mwmValue->GetScaleIndex();
+      auto const processValue = [&](uint64_t /* key */, uint32_t value)
+      {
+        if (checkUnique(value))
+          m_fn(value, *src);
+      };
 
-      // iterate through intervals
-      for (auto const & i : intervals)
+      if (!m_stop)
+      {
+        // All intervals are read in a single traversal of the index.
+        index.ForEachInIntervalsAndScale(intervals, scale, processValue);
+      }
+      else
       {
-        index.ForEachInIntervalAndScale(i.first, i.second, scale, [&](uint64_t /* key */, uint32_t value)
+        // Intervals are ordered by the caller (e.g. spirally from the center), so they are
+        // read one by one to stop as soon as the caller has enough features.
+        for (auto const & i : intervals)
         {
-          if (checkUnique(value))
-            m_fn(value, *src);
-        });
-        if (m_stop())
-          break;
+          index.ForEachInIntervalAndScale(i.first, i.second, scale, processValue);
+          if (m_stop())
+            break;
+        }
       }
     }
 
@@ -79,9 +89,10 @@ private:
   DataSource::StopSearchCallback m_stop;
 };
 
-void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src, uint32_t index)
+// |original| is reused for all original features read by a functor.
+void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSource & src,
+                     uint32_t index, std::optional<FeatureType> & original)
 {
-  std::unique_ptr<FeatureType> ft;
   switch (src.GetFeatureStatus(index))
   {
   case FeatureStatus::Deleted:
@@ -89,17 +100,17 @@ void ReadFeatureType(std::function<void(FeatureType &)> const & fn, FeatureSourc
   case FeatureStatus::Created:
   case FeatureStatus::Modified:
   {
-    ft = src.GetModifiedFeature(index);
-    break;
+    auto ft = src.GetModifiedFeature(index);
+    CHECK(ft, ());
+    fn(*ft);
+    return;
   }
   case FeatureStatus::Untouched:
   {
-    ft = src.GetOriginalFeature(index);
-    break;
+    fn(src.GetOriginalFeature(index, original));
+    return;
   }
   }
-  CHECK(ft, ());
-  fn(*ft);
 }
 }  //  namespace
 
@@ -147,6 +158,13 @@ std::unique_ptr<FeatureType> FeaturesLoaderGuard::GetOriginalFeatureByIndex(uint
   return m_handle.IsAlive() ? m_source->GetOriginalFeature(index) : nullptr;
 }
 
+void FeaturesLoaderGuard::LoadFeatures(std::vector<uint32_t> indices,
+                                       DataSource::FeatureCallback const & fn) const
+{
+  if (m_handle.IsAlive())
+    m_source->LoadFeatures(std::move(indices), fn);
+}
+
 // DataSource ----------------------------------------------------------------------------------
 std::unique_ptr<MwmInfo> DataSource::CreateInfo(platform::LocalCountryFile const & localFile) const
 {
@@ -172,6 +190,8 @@ std::unique_ptr<MwmValue> DataSource::CreateValue(MwmInfo & info) const
   auto p = std::make_unique<MwmValue>(localFile);
 
   p->SetTable(dynamic_cast<MwmInfoEx &>(info));
+  if (m_mapFeatures)
+    p->SetMappedFeatures(dynamic_cast<MwmInfoEx &>(info));
 
   p->m_metaDeserializer = indexer::MetadataDeserializer::Load(p->m_cont);
   CHECK(p->m_metaDeserializer, ());
@@ -232,8 +252,9 @@ void DataSource::ForEachFeatureIDInRect(FeatureIdCallback const & f, m2::RectD c
 
 void DataSource::ForEachInRect(FeatureCallback const & f, m2::RectD const & rect, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  std::optional<FeatureType> original;
+  auto readFeatureType = [&f, &original](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, original);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -245,8 +266,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 {
   auto const rect = mercator::RectByCenterXYAndSizeInMeters(center, sizeM);
 
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  std::optional<FeatureType> original;
+  auto readFeatureType = [&f, &original](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, original);
   };
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType, stop);
   ForEachInIntervals(readFunctor, covering::CoveringMode::Spiral, rect, scale);
@@ -254,8 +276,9 @@ void DataSource::ForClosestToPoint(FeatureCallback const & f, StopSearchCallback
 
 void DataSource::ForEachInScale(FeatureCallback const & f, int scale) const
 {
-  auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-    ReadFeatureType(f, src, index);
+  std::optional<FeatureType> original;
+  auto readFeatureType = [&f, &original](uint32_t index, FeatureSource & src) {
+    ReadFeatureType(f, src, index, original);
   };
 
   ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -269,8 +292,9 @@ void DataSource::ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const
   if (handle.IsAlive())
   {
     covering::CoveringGetter cov(rect, covering::ViewportWithLowLevels);
-    auto readFeatureType = [&f](uint32_t index, FeatureSource & src) {
-      ReadFeatureType(f, src, index);
+    std::optional<FeatureType> original;
+    auto readFeatureType = [&f, &original](uint32_t index, FeatureSource & src) {
+      ReadFeatureType(f, src, index, original);
     };
 
     ReadMWMFunctor readFunctor(*m_factory, readFeatureType);
@@ -282,6 +306,7 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
 {
   ASSERT(is_sorted(features.begin(), features.end()), ());
 
+  std::vector<uint32_t> indices;
   auto fidIter = features.begin();
   auto const endIter = features.end();
   while (fidIter != endIter)
@@ -292,21 +317,40 @@ void DataSource::ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID>
     {
       // Prepare features reading.
       auto src = (*m_factory)(handle);
+      auto const flush = [&]()
+      {
+        if (!indices.empty())
+          src->LoadFeatures(indices, fn);
+        indices.clear();
+      };
+
+      // Untouched features are read in batches. LoadFeatures() skips other features,
+      // so they are read one by one between the batches to keep the order.
       do
       {
-        auto const fts = src->GetFeatureStatus(fidIter->m_index);
+        auto const index = fidIter->m_index;
+        auto const fts = src->GetFeatureStatus(index);
         ASSERT_NOT_EQUAL(
             FeatureStatus::Deleted, fts,
             ("Deleted feature was cached. It should not be here. Please review your code."));
+        if (fts == FeatureStatus::Untouched)
+        {
+          indices.push_back(index);
+          continue;
+        }
+
+        flush();
         std::unique_ptr<FeatureType> ft;
         if (fts == FeatureStatus::Modified || fts == FeatureStatus::Created)
-          ft = src->GetModifiedFeature(fidIter->m_index);
+          ft = src->GetModifiedFeature(index);
         else
-          ft = src->GetOriginalFeature(fidIter->m_index);
+          ft = src->GetOriginalFeature(index);
 
         CHECK(ft, ());
         fn(*ft);
       } while (++fidIter != endIter && id == fidIter->m_mwmId);
+
+      flush();
     }
     else
     {
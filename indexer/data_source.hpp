@@ -39,6 +39,8 @@ public:
   void ForEachInRectForMWM(FeatureCallback const & f, m2::RectD const & rect, int scale,
                            MwmId const & id) const;
   // "features" must be sorted using FeatureID::operator< as predicate.
+  // |fn| is called once for each feature of alive mwms, in the order of |features|.
+  // Obsolete features are passed as original ones.
   void ReadFeatures(FeatureCallback const & fn, std::vector<FeatureID> const & features) const;
 
   void ReadFeature(FeatureCallback const & fn, FeatureID const & feature) const
@@ -51,6 +53,11 @@ public:
     return (*m_factory)(handle);
   }
 
+  /// When enabled, features are read directly from the memory-mapped features section
+  /// instead of being copied. Affects mwm values created after the call, so it should be
+  /// called before any mwm is registered.
+  void SetFeaturesMapping(bool enabled) { m_mapFeatures = enabled; }
+
 protected:
   using ReaderCallback = std::function<void(MwmSet::MwmHandle const & handle,
                                             covering::CoveringGetter & cov, int scale)>;
@@ -68,6 +75,7 @@ protected:
 
 private:
   std::unique_ptr<FeatureSourceFactory> m_factory;
+  bool m_mapFeatures = false;
 };
 
 // DataSource which operates with features from mwm file and does not support features creation
@@ -103,7 +111,11 @@ public:
   std::unique_ptr<FeatureType> GetOriginalFeatureByIndex(uint32_t index) const;
   std::unique_ptr<FeatureType> GetOriginalOrEditedFeatureByIndex(uint32_t index) const;
   /// Everyone, except Editor core, should use this method.
+  /// Features are loaded lazily by the guard's FeatureSource, so they must not outlive the guard.
   std::unique_ptr<FeatureType> GetFeatureByIndex(uint32_t index) const;
+  /// Calls |fn| for features with |indices| sorted by index. Much faster than
+  /// GetFeatureByIndex() calls for many features, see FeatureSource::LoadFeatures().
+  void LoadFeatures(std::vector<uint32_t> indices, DataSource::FeatureCallback const & fn) const;
   size_t GetNumFeatures() const { return m_source->GetNumFeatures(); }
 
 private:
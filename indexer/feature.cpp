@@ -117,9 +117,9 @@ uint32_t CalcOffset(ArrayByteSource const & source, uint8_t const * start)
   return static_cast<uint32_t>(distance(start, source.PtrUint8()));
 }
 
-uint8_t Header(vector<uint8_t> const & data)
+uint8_t Header(uint8_t const * data, size_t size)
 {
- CHECK(!data.empty(), ());
+ CHECK(data && size != 0, ());
  return data[0];
 }
 
@@ -190,12 +190,76 @@ uint8_t ReadByte(TSource & src)
 FeatureType::FeatureType(SharedLoadInfo const * loadInfo, vector<uint8_t> && buffer,
                          indexer::MetadataDeserializer * metadataDeserializer)
   : m_loadInfo(loadInfo)
-  , m_data(std::move(buffer))
+  , m_data(buffer.data())
+  , m_dataSize(buffer.size())
+  , m_buffer(std::move(buffer))
   , m_metadataDeserializer(metadataDeserializer)
 {
   CHECK(m_loadInfo, ());
 
-  m_header = Header(m_data); // Parse the header and optional name/layer/addinfo.
+  m_header = Header(m_data, m_dataSize); // Parse the header and optional name/layer/addinfo.
+}
+
+FeatureType::FeatureType(SharedLoadInfo const * loadInfo, uint8_t const * data, size_t size,
+                         shared_ptr<MappedFeatures const> const & mapping,
+                         indexer::MetadataDeserializer * metadataDeserializer)
+  : m_loadInfo(loadInfo)
+  , m_data(data)
+  , m_dataSize(size)
+  , m_mapping(mapping)
+  , m_metadataDeserializer(metadataDeserializer)
+{
+  CHECK(m_loadInfo, ());
+
+  m_header = Header(m_data, m_dataSize); // Parse the header and optional name/layer/addinfo.
+}
+
+void FeatureType::Reset(SharedLoadInfo const * loadInfo, vector<uint8_t> && buffer,
+                        indexer::MetadataDeserializer * metadataDeserializer)
+{
+  m_buffer.swap(buffer);
+  Reset(loadInfo, m_buffer.data(), m_buffer.size(), {} /* mapping */, metadataDeserializer);
+}
+
+void FeatureType::Reset(SharedLoadInfo const * loadInfo, uint8_t const * data, size_t size,
+                        shared_ptr<MappedFeatures const> const & mapping,
+                        indexer::MetadataDeserializer * metadataDeserializer)
+{
+  CHECK(loadInfo, ());
+
+  m_loadInfo = loadInfo;
+  m_data = data;
+  m_dataSize = size;
+  // Features of a batch share the same mapping, so the reference count isn't touched for them.
+  if (m_mapping != mapping)
+    m_mapping = mapping;
+  m_metadataDeserializer = metadataDeserializer;
+  m_header = Header(m_data, m_dataSize);
+
+  // Containers are cleared, not reassigned, to keep their memory.
+  m_id = FeatureID();
+  m_params.MakeZero();
+  m_center = m2::PointD();
+  m_limitRect = m2::RectD();
+  m_points.clear();
+  m_triangles.clear();
+  m_metadata.Clear();
+  m_metaIds.clear();
+
+  m_parsed.Reset();
+  m_offsets.Reset();
+  m_ptsSimpMask = 0;
+  m_innerStats = InnerGeomStat();
+}
+
+void FeatureType::ReleaseRecord()
+{
+  m_id = FeatureID();
+  m_loadInfo = nullptr;
+  m_data = nullptr;
+  m_dataSize = 0;
+  m_mapping.reset();
+  m_metadataDeserializer = nullptr;
 }
 
 std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject const & emo)
@@ -274,7 +338,7 @@ void FeatureType::ParseTypes()
 
   auto const typesOffset = sizeof(m_header);
   Classificator & c = classif();
-  ArrayByteSource source(m_data.data() + typesOffset);
+  ArrayByteSource source(m_data + typesOffset);
 
   size_t const count = GetTypesCount();
   for (size_t i = 0; i < count; ++i)
@@ -293,7 +357,7 @@ void FeatureType::ParseTypes()
     }
   }
 
-  m_offsets.m_common = CalcOffset(source, m_data.data());
+  m_offsets.m_common = CalcOffset(source, m_data);
   m_parsed.m_types = true;
 }
 
@@ -305,8 +369,8 @@ void FeatureType::ParseCommon()
   CHECK(m_loadInfo, ());
   ParseTypes();
 
-  ArrayByteSource source(m_data.data() + m_offsets.m_common);
-  uint8_t const h = Header(m_data);
+  ArrayByteSource source(m_data + m_offsets.m_common);
+  uint8_t const h = Header(m_data, m_dataSize);
   m_params.Read(source, h);
 
   if (GetGeomType() == GeomType::Point)
@@ -315,7 +379,7 @@ void FeatureType::ParseCommon()
     m_limitRect.Add(m_center);
   }
 
-  m_offsets.m_header2 = CalcOffset(source, m_data.data());
+  m_offsets.m_header2 = CalcOffset(source, m_data);
   m_parsed.m_common = true;
 }
 
@@ -351,8 +415,8 @@ void FeatureType::ParseHeader2()
   ParseCommon();
 
   uint8_t elemsCount = 0, geomScalesMask = 0;
-  BitSource bitSource(m_data.data() + m_offsets.m_header2);
-  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+  BitSource bitSource(m_data + m_offsets.m_header2);
+  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
 
   if (headerGeomType == HeaderGeomType::Line || headerGeomType == HeaderGeomType::Area)
   {
@@ -420,7 +484,7 @@ void FeatureType::ParseHeader2()
     }
   }
   // Size of the whole header incl. inner geometry / triangles.
-  m_innerStats.m_size = CalcOffset(src, m_data.data());
+  m_innerStats.m_size = CalcOffset(src, m_data);
   m_parsed.m_header2 = true;
 }
 
@@ -449,7 +513,7 @@ void FeatureType::ParseGeometry(int scale)
     CHECK(m_loadInfo, ());
     ParseHeader2();
 
-    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
     if (headerGeomType == HeaderGeomType::Line)
     {
       size_t const pointsCount = m_points.size();
@@ -501,7 +565,7 @@ FeatureType::GeomStat FeatureType::GetOuterGeometryStats()
   ASSERT_LESS_OR_EQUAL(scalesCount, DataHeader::kMaxScalesCount, ("MWM has too many geometry scales!"));
   FeatureType::GeomStat res;
 
-  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
   if (headerGeomType == HeaderGeomType::Line)
   {
     size_t const pointsCount = m_points.size();
@@ -529,6 +593,7 @@ FeatureType::GeomStat FeatureType::GetOuterGeometryStats()
 
           res.m_sizes[ind] = static_cast<uint32_t>(src.Pos() - scaleOffset);
           res.m_elements[ind] = static_cast<uint32_t>(points.size());
+          res.m_offsets[ind] = scaleOffset;
         }
       }
       // Retain best geometry.
@@ -550,7 +615,7 @@ void FeatureType::ParseTriangles(int scale)
     CHECK(m_loadInfo, ());
     ParseHeader2();
 
-    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
     if (headerGeomType == HeaderGeomType::Area)
     {
       if (m_triangles.empty())
@@ -577,7 +642,7 @@ FeatureType::GeomStat FeatureType::GetOuterTrianglesStats()
   ASSERT_LESS_OR_EQUAL(scalesCount, static_cast<int>(DataHeader::kMaxScalesCount), ("MWM has too many geometry scales!"));
   FeatureType::GeomStat res;
 
-  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
   if (headerGeomType == HeaderGeomType::Area)
   {
     if (m_triangles.empty())
@@ -595,6 +660,7 @@ FeatureType::GeomStat FeatureType::GetOuterTrianglesStats()
 
           res.m_sizes[ind] = static_cast<uint32_t>(src.Pos() - scaleOffset);
           res.m_elements[ind] = static_cast<uint32_t>(m_triangles.size() / 3);
+          res.m_offsets[ind] = scaleOffset;
         }
       }
       // The best geometry is retained in m_triangles.
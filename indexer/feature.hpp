@@ -8,11 +8,13 @@
 #include "base/macros.hpp"
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace feature
 {
+class MappedFeatures;
 class SharedLoadInfo;
 struct NameParamsOut; // Include feature_utils.hpp when using
 
@@ -36,6 +38,24 @@ public:
 
   FeatureType(feature::SharedLoadInfo const * loadInfo, std::vector<uint8_t> && buffer,
               indexer::MetadataDeserializer * metadataDeserializer);
+  // Doesn't copy the feature record, |data| points into |mapping| or into memory owned
+  // by the caller when |mapping| is empty. The feature keeps |mapping| alive, so its record
+  // stays valid when the mwm is closed, but |loadInfo| must still outlive the feature.
+  FeatureType(feature::SharedLoadInfo const * loadInfo, uint8_t const * data, size_t size,
+              std::shared_ptr<feature::MappedFeatures const> const & mapping,
+              indexer::MetadataDeserializer * metadataDeserializer);
+
+  // Reuses the feature for another record instead of constructing a new one, memory allocated
+  // for the geometry, names and the record buffer of the previous record is kept.
+  // |buffer| gets the previous record buffer of the feature, so it may be reused by the caller.
+  void Reset(feature::SharedLoadInfo const * loadInfo, std::vector<uint8_t> && buffer,
+             indexer::MetadataDeserializer * metadataDeserializer);
+  void Reset(feature::SharedLoadInfo const * loadInfo, uint8_t const * data, size_t size,
+             std::shared_ptr<feature::MappedFeatures const> const & mapping,
+             indexer::MetadataDeserializer * metadataDeserializer);
+  // Drops the record, the mapping and pointers into the mwm, so a feature kept for reuse
+  // doesn't keep the mwm alive. Reset() must be called before the feature is used again.
+  void ReleaseRecord();
 
   static std::unique_ptr<FeatureType> CreateFromMapObject(osm::MapObject const & emo);
 
@@ -184,6 +204,8 @@ public:
   struct GeomStat
   {
     GeomArr m_sizes = {}, m_elements = {};
+    // Offsets of the geometry in the sections of its scales, valid when the size is not 0.
+    GeomArr m_offsets = {};
   };
 
   // Returns outer points/triangles stats for all geo levels and loads the best geometry.
@@ -245,7 +267,12 @@ private:
 
   // Non-owning pointer to shared load info. SharedLoadInfo created once per FeaturesVector.
   feature::SharedLoadInfo const * m_loadInfo = nullptr;
-  std::vector<uint8_t> m_data;
+  // Feature record, points either to |m_buffer| or to the memory-mapped features section.
+  uint8_t const * m_data = nullptr;
+  size_t m_dataSize = 0;
+  std::vector<uint8_t> m_buffer;
+  // Keeps the memory-mapped features section alive, empty when the record is in |m_buffer|.
+  std::shared_ptr<feature::MappedFeatures const> m_mapping;
 
   // Pointer to shared metedata deserializer. Must be set for mwm format >= Format::v11
   indexer::MetadataDeserializer * m_metadataDeserializer = nullptr;
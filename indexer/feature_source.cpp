@@ -1,5 +1,40 @@
 #include "indexer/feature_source.hpp"
 
+#include "base/scope_guard.hpp"
+
+#include <algorithm>
+
+namespace
+{
+// Limits memory used by FeatureSource::LoadFeatures().
+size_t constexpr kMaxBatchSize = 256;
+// Callbacks of LoadFeatures() rarely load features themselves, so a couple of arenas is enough.
+size_t constexpr kMaxPooledArenas = 2;
+
+// Arenas of finished LoadFeatures() calls of the current thread. Features of an arena and
+// their memory are reused by the next calls, e.g. for the next tile, instead of being
+// allocated again. Nested calls take different arenas. Pooled arenas are cleared, so they
+// don't keep mwms of previous calls alive.
+thread_local std::vector<std::unique_ptr<FeaturesArena>> g_arenas;
+
+std::unique_ptr<FeaturesArena> TakeArena()
+{
+  if (g_arenas.empty())
+    return std::make_unique<FeaturesArena>();
+
+  auto arena = std::move(g_arenas.back());
+  g_arenas.pop_back();
+  return arena;
+}
+
+void ReturnArena(std::unique_ptr<FeaturesArena> arena)
+{
+  arena->Clear();
+  if (g_arenas.size() < kMaxPooledArenas)
+    g_arenas.push_back(std::move(arena));
+}
+}  // namespace
+
 std::string ToString(FeatureStatus fs)
 {
   switch (fs)
@@ -20,7 +55,8 @@ FeatureSource::FeatureSource(MwmSet::MwmHandle const & handle) : m_handle(handle
 
   auto const & value = *m_handle.GetValue();
   m_vector = std::make_unique<FeaturesVector>(value.m_cont, value.GetHeader(), value.m_table.get(),
-                                              value.m_metaDeserializer.get());
+                                              value.m_metaDeserializer.get(),
+                                              value.m_mappedFeatures);
 }
 
 size_t FeatureSource::GetNumFeatures() const
@@ -41,6 +77,75 @@ std::unique_ptr<FeatureType> FeatureSource::GetOriginalFeature(uint32_t index) c
   return ft;
 }
 
+FeatureType & FeatureSource::GetOriginalFeature(uint32_t index, std::optional<FeatureType> & ft) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+  ASSERT(m_vector, ());
+  m_vector->GetByIndex(index, ft);
+  ft->SetID({ GetMwmId(), index });
+  return *ft;
+}
+
+void FeatureSource::GetOriginalFeatures(std::vector<uint32_t> const & indices,
+                                        FeaturesArena & arena) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+  ASSERT(m_vector, ());
+  m_vector->GetByIndices(indices, arena);
+  for (size_t i = 0; i < indices.size(); ++i)
+    arena[i].SetID({ GetMwmId(), indices[i] });
+}
+
+void FeatureSource::LoadFeatures(std::vector<uint32_t> indices,
+                                 std::function<void(FeatureType &)> const & fn) const
+{
+  ASSERT(m_handle.IsAlive(), ());
+
+  if (!std::is_sorted(indices.begin(), indices.end()))
+    std::sort(indices.begin(), indices.end());
+
+  auto arena = TakeArena();
+  SCOPE_GUARD(returnArena, [&arena]() { ReturnArena(std::move(arena)); });
+
+  std::vector<uint32_t> batch;
+  auto const flush = [&]()
+  {
+    if (batch.empty())
+      return;
+    GetOriginalFeatures(batch, *arena);
+    for (size_t i = 0; i < arena->Size(); ++i)
+      fn((*arena)[i]);
+    batch.clear();
+  };
+
+  for (auto const index : indices)
+  {
+    switch (GetFeatureStatus(index))
+    {
+    case FeatureStatus::Deleted:
+    case FeatureStatus::Obsolete: break;
+    case FeatureStatus::Created:
+    case FeatureStatus::Modified:
+    {
+      // Original features before the edited one go first to keep the order.
+      flush();
+      auto ft = GetModifiedFeature(index);
+      CHECK(ft, ());
+      fn(*ft);
+      break;
+    }
+    case FeatureStatus::Untouched:
+    {
+      batch.push_back(index);
+      if (batch.size() == kMaxBatchSize)
+        flush();
+      break;
+    }
+    }
+  }
+  flush();
+}
+
 FeatureStatus FeatureSource::GetFeatureStatus(uint32_t index) const
 {
   return FeatureStatus::Untouched;
@@ -9,7 +9,9 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 enum class FeatureStatus
 {
@@ -34,6 +36,16 @@ public:
   size_t GetNumFeatures() const;
 
   std::unique_ptr<FeatureType> GetOriginalFeature(uint32_t index) const;
+  // Same as above, but reuses |ft| and its memory when it's not empty.
+  FeatureType & GetOriginalFeature(uint32_t index, std::optional<FeatureType> & ft) const;
+  // Replaces features in |arena| with original features with |indices|.
+  void GetOriginalFeatures(std::vector<uint32_t> const & indices, FeaturesArena & arena) const;
+
+  // Calls |fn| for features with |indices| in the order of increasing indices, which is the order
+  // of their offsets in the mwm. Original features are read in batches, see
+  // FeaturesVector::GetByIndices(). Deleted and obsolete features are skipped.
+  void LoadFeatures(std::vector<uint32_t> indices,
+                    std::function<void(FeatureType &)> const & fn) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_handle.GetId(); }
 
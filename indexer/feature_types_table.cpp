@@ -0,0 +1,236 @@
+#include "indexer/feature_types_table.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/features_vector.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+#include "base/stl_helpers.hpp"
+
+#include "defines.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace feature
+{
+using namespace std;
+
+namespace
+{
+uint32_t GetBlocksCount(uint32_t featuresCount)
+{
+  return (featuresCount + FeatureTypesTable::kBlockSize - 1) / FeatureTypesTable::kBlockSize;
+}
+
+template <typename T>
+T ReadFromPtr(uint8_t const * p)
+{
+  T t;
+  memcpy(&t, p, sizeof(t));
+  return SwapIfBigEndianMacroBased(t);
+}
+}  // namespace
+
+// FeatureTypesTable::Header -----------------------------------------------------------------------
+void FeatureTypesTable::Header::Serialize(Writer & writer) const
+{
+  auto const start = writer.Pos();
+  WriteToSink(writer, static_cast<uint8_t>(m_version));
+  WriteToSink(writer, m_featuresCount);
+  WriteToSink(writer, m_typesCount);
+  WriteZeroesToSink(writer, kSize - (writer.Pos() - start));
+}
+
+void FeatureTypesTable::Header::Read(Reader & reader)
+{
+  NonOwningReaderSource source(reader);
+  m_version = static_cast<Version>(ReadPrimitiveFromSource<uint8_t>(source));
+  m_featuresCount = ReadPrimitiveFromSource<uint32_t>(source);
+  m_typesCount = ReadPrimitiveFromSource<uint32_t>(source);
+}
+
+// FeatureTypesTable::TypesSet ---------------------------------------------------------------------
+void FeatureTypesTable::TypesSet::Add(uint32_t type, bool withSubtree)
+{
+  auto const & c = classif();
+  if (withSubtree)
+    c.ForEachInSubtree([&](uint32_t descendant) { AddIndex(c.GetIndexForType(descendant)); }, type);
+  else
+    AddIndex(c.GetIndexForType(type));
+}
+
+void FeatureTypesTable::TypesSet::AddIndex(uint32_t index)
+{
+  if (index / 64 >= m_bits.size())
+    m_bits.resize(index / 64 + 1);
+  m_bits[index / 64] |= uint64_t{1} << (index % 64);
+}
+
+// FeatureTypesTable -------------------------------------------------------------------------------
+// static
+unique_ptr<FeatureTypesTable> FeatureTypesTable::Load(FilesContainerR const & cont)
+{
+  if (!cont.IsExist(FEATURE_TYPES_FILE_TAG))
+    return {};
+
+  unique_ptr<FeatureTypesTable> table(new FeatureTypesTable());
+  try
+  {
+    table->m_file.Open(cont.GetFileName());
+    auto const p = cont.GetAbsoluteOffsetAndSize(FEATURE_TYPES_FILE_TAG);
+    table->m_handle.Assign(table->m_file.Map(p.first, p.second, FEATURE_TYPES_FILE_TAG));
+  }
+  catch (Reader::Exception const & e)
+  {
+    // E.g. the section is compressed, read it into memory.
+    LOG(LDEBUG, ("Can't map types table of", cont.GetFileName(), ":", e.Msg()));
+    return Load(*cont.GetReader(FEATURE_TYPES_FILE_TAG).GetPtr());
+  }
+
+  if (!table->Init(table->m_handle.GetData<uint8_t>(), table->m_handle.GetSize()))
+    return {};
+  return table;
+}
+
+// static
+unique_ptr<FeatureTypesTable> FeatureTypesTable::Load(Reader const & reader)
+{
+  unique_ptr<FeatureTypesTable> table(new FeatureTypesTable());
+  table->m_buffer.resize(base::checked_cast<size_t>(reader.Size()));
+  reader.Read(0, table->m_buffer.data(), table->m_buffer.size());
+  if (!table->Init(table->m_buffer.data(), table->m_buffer.size()))
+    return {};
+  return table;
+}
+
+bool FeatureTypesTable::Init(uint8_t const * data, uint64_t size)
+{
+  MemReader reader(data, static_cast<size_t>(size));
+  if (size < Header::kSize)
+  {
+    LOG(LERROR, ("Types table is truncated."));
+    return false;
+  }
+  m_header.Read(reader);
+  // A table of a newer version is not used, as if the mwm had no table.
+  if (m_header.m_version > Version::Latest)
+  {
+    LOG(LWARNING, ("Unknown types table version:", base::Underlying(m_header.m_version)));
+    return false;
+  }
+
+  uint64_t const featuresCount = m_header.m_featuresCount;
+  uint64_t const blocksSize = uint64_t{GetBlocksCount(m_header.m_featuresCount)} * sizeof(uint32_t);
+  uint64_t const typesSize = uint64_t{m_header.m_typesCount} * sizeof(uint16_t);
+  if (Header::kSize + blocksSize + typesSize + 2 * featuresCount != size)
+  {
+    LOG(LERROR, ("Wrong types table size:", size, m_header.m_featuresCount, m_header.m_typesCount));
+    return false;
+  }
+
+  m_blocks = data + Header::kSize;
+  m_types = m_blocks + blocksSize;
+  m_infos = m_types + typesSize;
+  m_ranks = m_infos + featuresCount;
+  return true;
+}
+
+TypesHolder FeatureTypesTable::GetTypes(uint32_t id) const
+{
+  ASSERT_LESS(id, GetFeaturesCount(), ());
+
+  uint32_t const block = id / kBlockSize;
+  uint32_t pos = GetBlockStart(block);
+  for (uint32_t i = block * kBlockSize; i < id; ++i)
+    pos += GetTypesCount(i);
+
+  auto const & c = classif();
+  TypesHolder types(GetGeomType(id));
+  for (uint32_t i = pos; i < pos + GetTypesCount(id); ++i)
+    types.Add(c.GetTypeForIndex(GetTypeIndex(i)));
+  return types;
+}
+
+uint16_t FeatureTypesTable::GetTypeIndex(uint32_t pos) const
+{
+  ASSERT_LESS(pos, m_header.m_typesCount, ());
+  return ReadFromPtr<uint16_t>(m_types + pos * sizeof(uint16_t));
+}
+
+uint32_t FeatureTypesTable::GetBlockStart(uint32_t block) const
+{
+  return ReadFromPtr<uint32_t>(m_blocks + block * sizeof(uint32_t));
+}
+
+// FeatureTypesTableBuilder ------------------------------------------------------------------------
+void FeatureTypesTableBuilder::Put(FeatureType & ft)
+{
+  TypesHolder const types(ft);
+  CHECK_GREATER(types.Size(), 0, ());
+  CHECK_LESS_OR_EQUAL(types.Size(), kMaxTypesCount, ());
+
+  auto const & c = classif();
+  for (auto const type : types)
+  {
+    auto const index = c.GetIndexForType(type);
+    CHECK_LESS_OR_EQUAL(index, numeric_limits<uint16_t>::max(), (type));
+    m_types.push_back(static_cast<uint16_t>(index));
+  }
+
+  auto const geomType = static_cast<uint8_t>(types.GetGeomType());
+  CHECK_LESS(geomType, 4, ());
+  m_infos.push_back(static_cast<uint8_t>((types.Size() - 1) | (geomType << 3)));
+  m_ranks.push_back(ft.GetRank());
+}
+
+void FeatureTypesTableBuilder::Freeze(Writer & writer) const
+{
+  FeatureTypesTable::Header header;
+  header.m_featuresCount = base::checked_cast<uint32_t>(m_infos.size());
+  header.m_typesCount = base::checked_cast<uint32_t>(m_types.size());
+  header.Serialize(writer);
+
+  uint32_t pos = 0;
+  for (size_t i = 0; i < m_infos.size(); ++i)
+  {
+    if (i % FeatureTypesTable::kBlockSize == 0)
+      WriteToSink(writer, pos);
+    pos += (m_infos[i] & 7) + 1;
+  }
+  ASSERT_EQUAL(pos, m_types.size(), ());
+
+  for (auto const index : m_types)
+    WriteToSink(writer, index);
+  writer.Write(m_infos.data(), m_infos.size());
+  writer.Write(m_ranks.data(), m_ranks.size());
+}
+
+bool BuildTypesTable(string const & filePath)
+{
+  try
+  {
+    FeatureTypesTableBuilder builder;
+    {
+      FeaturesVectorTest features(filePath);
+      features.GetVector().ForEach([&builder](FeatureType & ft, uint32_t) { builder.Put(ft); });
+    }
+
+    FilesContainerW cont(filePath, FileWriter::OP_WRITE_EXISTING);
+    auto writer = cont.GetWriter(FEATURE_TYPES_FILE_TAG);
+    builder.Freeze(*writer);
+    return true;
+  }
+  catch (RootException const & ex)
+  {
+    LOG(LERROR, ("Generating types table failed for", filePath, "reason", ex.Msg()));
+    return false;
+  }
+}
+}  // namespace feature
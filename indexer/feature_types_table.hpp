@@ -0,0 +1,154 @@
+#pragma once
+
+#include "indexer/feature_data.hpp"
+
+#include "coding/files_container.hpp"
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class FeatureType;
+class Reader;
+class Writer;
+
+namespace feature
+{
+// Types, geometry types and ranks of all features of an mwm, stored apart from the features
+// records as a struct of arrays, so predicates on types don't read and parse the features section.
+//
+// Format (all numbers are little-endian):
+//   Header
+//   uint32_t blocks[(features count + kBlockSize - 1) / kBlockSize]
+//            positions in |types| of the first type of each block of kBlockSize features
+//   uint16_t types[types count]  classificator indices of types of all features
+//   uint8_t  infos[features count]  number of types minus one (3 bits), geometry type (2 bits)
+//   uint8_t  ranks[features count]
+class FeatureTypesTable
+{
+public:
+  enum class Version : uint8_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  struct Header
+  {
+    void Serialize(Writer & writer) const;
+    void Read(Reader & reader);
+
+    static uint32_t constexpr kSize = 16;
+
+    Version m_version = Version::Latest;
+    uint32_t m_featuresCount = 0;
+    uint32_t m_typesCount = 0;
+  };
+
+  static uint32_t constexpr kBlockSize = 64;
+
+  // Set of classificator types, which is checked by a single lookup of a bit per type.
+  class TypesSet
+  {
+  public:
+    // Adds |type| and, when |withSubtree| is true, all its descendants.
+    void Add(uint32_t type, bool withSubtree = false);
+
+    bool Has(uint16_t index) const
+    {
+      return index < m_bits.size() * 64 && ((m_bits[index / 64] >> (index % 64)) & 1) != 0;
+    }
+
+  private:
+    void AddIndex(uint32_t index);
+
+    std::vector<uint64_t> m_bits;
+  };
+
+  // Returns nullptr if the mwm has no types table, or the table is damaged or has an unknown
+  // version, so callers fall back to features.
+  static std::unique_ptr<FeatureTypesTable> Load(FilesContainerR const & cont);
+  // Reads the table of |reader| into memory.
+  static std::unique_ptr<FeatureTypesTable> Load(Reader const & reader);
+
+  uint32_t GetFeaturesCount() const { return m_header.m_featuresCount; }
+
+  GeomType GetGeomType(uint32_t id) const
+  {
+    ASSERT_LESS(id, GetFeaturesCount(), ());
+    return static_cast<GeomType>((m_infos[id] >> 3) & 3);
+  }
+
+  uint8_t GetRank(uint32_t id) const
+  {
+    ASSERT_LESS(id, GetFeaturesCount(), ());
+    return m_ranks[id];
+  }
+
+  TypesHolder GetTypes(uint32_t id) const;
+
+  // Calls |fn| for ids of all features which have any type of |types|, in increasing order.
+  // Only the packed arrays of types and infos are scanned, one after another.
+  template <typename Fn>
+  void ForEachFeatureWithTypes(TypesSet const & types, Fn && fn) const
+  {
+    uint32_t pos = 0;
+    for (uint32_t id = 0; id < m_header.m_featuresCount; ++id)
+    {
+      uint32_t const end = pos + GetTypesCount(id);
+      for (uint32_t i = pos; i < end; ++i)
+      {
+        if (types.Has(GetTypeIndex(i)))
+        {
+          fn(id);
+          break;
+        }
+      }
+      pos = end;
+    }
+  }
+
+private:
+  FeatureTypesTable() = default;
+
+  bool Init(uint8_t const * data, uint64_t size);
+
+  uint32_t GetTypesCount(uint32_t id) const { return (m_infos[id] & 7) + 1; }
+  uint16_t GetTypeIndex(uint32_t pos) const;
+  uint32_t GetBlockStart(uint32_t block) const;
+
+  Header m_header;
+  uint8_t const * m_blocks = nullptr;
+  uint8_t const * m_types = nullptr;
+  uint8_t const * m_infos = nullptr;
+  uint8_t const * m_ranks = nullptr;
+
+  // The table is either mapped or read into |m_buffer|.
+  ::detail::MappedFile m_file;
+  ::detail::MappedFile::Handle m_handle;
+  std::vector<uint8_t> m_buffer;
+
+  DISALLOW_COPY_AND_MOVE(FeatureTypesTable);
+};
+
+class FeatureTypesTableBuilder
+{
+public:
+  // Features must be put in the order of their ids.
+  void Put(FeatureType & ft);
+  void Freeze(Writer & writer) const;
+
+private:
+  std::vector<uint16_t> m_types;
+  std::vector<uint8_t> m_infos;
+  std::vector<uint8_t> m_ranks;
+};
+
+// Builds the types table section of the mwm at |filePath|.
+bool BuildTypesTable(std::string const & filePath);
+}  // namespace feature
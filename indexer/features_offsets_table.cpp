@@ -14,11 +14,20 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 
+#include <algorithm>
+#include <optional>
+
 using namespace platform;
 using namespace std;
 
 namespace feature
 {
+  namespace
+  {
+  // Skipping of a few offsets by the enumerator is cheaper than a select.
+  uint32_t constexpr kMaxEnumeratorSkip = 16;
+  }  // namespace
+
   void FeaturesOffsetsTable::Builder::PushOffset(uint32_t const offset)
   {
     ASSERT(m_offsets.empty() || m_offsets.back() < offset, ());
@@ -109,17 +118,47 @@ namespace feature
                                                      m_table.select(size() - 1)));
     ASSERT_GREATER_OR_EQUAL(offset, m_table.select(0), ("Offset out of bounds", offset,
                                                         m_table.select(size() - 1)));
-    //Binary search in elias_fano list
-    size_t leftBound = 0, rightBound = size();
-    while (leftBound + 1 < rightBound) {
-      size_t middle = leftBound + (rightBound - leftBound) / 2;
-      if (m_table.select(middle) <= offset)
-        leftBound = middle;
-      else
-        rightBound = middle;
+    // Offsets strictly increase, so the index is the number of smaller offsets, which is
+    // found by the rank index of the table instead of a binary search of selects.
+    // The universe of the table ends at the last offset, which has no rank.
+    size_t const index =
+        offset >= m_table.size() ? size() - 1 : static_cast<size_t>(m_table.rank(offset));
+    ASSERT_EQUAL(offset, m_table.select(index), ("Can't find offset", offset, "in the table"));
+    return index;
+  }
+
+  void FeaturesOffsetsTable::GetFeatureRanges(vector<uint32_t> const & sortedIndices,
+                                              vector<pair<uint32_t, uint32_t>> & ranges) const
+  {
+    ASSERT(is_sorted(sortedIndices.begin(), sortedIndices.end()), ());
+    ranges.resize(sortedIndices.size());
+
+    optional<succinct::elias_fano::select_enumerator> enumerator;
+    // Index of the offset returned by the next call of |enumerator| and the last returned offset.
+    uint64_t next = 0;
+    uint32_t last = 0;
+    auto const getOffset = [&](uint64_t index) {
+      if (enumerator && index + 1 == next)
+        return last;
+      if (!enumerator || index < next || index - next > kMaxEnumeratorSkip)
+      {
+        enumerator.emplace(m_table, index);
+        next = index;
+      }
+      for (; next < index; ++next)
+        enumerator->next();
+      ++next;
+      last = static_cast<uint32_t>(enumerator->next());
+      return last;
+    };
+
+    for (size_t i = 0; i < sortedIndices.size(); ++i)
+    {
+      auto const index = sortedIndices[i];
+      ASSERT_LESS(index, size(), ());
+      ranges[i].first = getOffset(index);
+      ranges[i].second = index + 1 < size() ? getOffset(index + 1) : kNoOffset;
     }
-    ASSERT_EQUAL(offset, m_table.select(leftBound), ("Can't find offset", offset, "in the table"));
-    return leftBound;
   }
 
   bool BuildOffsetsTable(string const & filePath)
@@ -6,8 +6,10 @@
 #include "defines.hpp"
 
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if defined(__clang__)
@@ -85,6 +87,18 @@ namespace feature
     /// \return index of a feature
     size_t GetFeatureIndexbyOffset(uint32_t offset) const;
 
+    /// End of the last feature, which is unknown to the table.
+    static uint32_t constexpr kNoOffset = std::numeric_limits<uint32_t>::max();
+
+    /// Batched version of GetFeatureOffset() for indices in non-decreasing order.
+    /// Close indices are walked by a sequential enumerator instead of a select per index.
+    ///
+    /// \param sortedIndices indices of features in non-decreasing order
+    /// \param ranges offsets of features and offsets of the next features, in the
+    ///               order of |sortedIndices|, the next offset of the last feature is kNoOffset
+    void GetFeatureRanges(std::vector<uint32_t> const & sortedIndices,
+                          std::vector<std::pair<uint32_t, uint32_t>> & ranges) const;
+
     /// \return number of features offsets in a table.
     size_t size() const { return static_cast<size_t>(m_table.num_ones()); }
 
@@ -5,11 +5,55 @@
 
 #include "platform/constants.hpp"
 
+#include "coding/byte_stream.hpp"
+#include "coding/varint.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+// Records separated by less bytes are read at once, reading of a few
+// unneeded bytes is cheaper than a separate read.
+uint32_t constexpr kMaxReadGap = 4 * 1024;
+}  // namespace
+
+void FeaturesArena::Clear()
+{
+  // Features are kept to be reused, but they must not keep the mwm alive. Some of them
+  // may be not constructed when reading of the batch has failed.
+  for (size_t i = 0; i < m_size; ++i)
+  {
+    if (m_features[i])
+      m_features[i]->ReleaseRecord();
+  }
+  m_size = 0;
+  m_records.clear();
+  m_order.clear();
+  m_sortedIndices.clear();
+  m_ranges.clear();
+  m_buffer.clear();
+}
+
+void FeaturesArena::Reset(size_t size)
+{
+  Clear();
+  if (size > m_capacity)
+  {
+    m_features = std::make_unique<std::optional<FeatureType>[]>(size);
+    m_capacity = size;
+  }
+  m_size = size;
+}
 
 FeaturesVector::FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header,
                                feature::FeaturesOffsetsTable const * table,
-                               indexer::MetadataDeserializer * metaDeserializer)
-: m_loadInfo(cont, header), m_table(table), m_metaDeserializer(metaDeserializer)
+                               indexer::MetadataDeserializer * metaDeserializer,
+                               std::shared_ptr<feature::MappedFeatures const> mapped)
+: m_loadInfo(cont, header)
+, m_table(table)
+, m_metaDeserializer(metaDeserializer)
+, m_mapped(std::move(mapped))
 {
   InitRecordsReader();
 }
@@ -24,14 +68,158 @@ void FeaturesVector::InitRecordsReader()
           (base::Underlying(header.m_version)));
   m_recordReader = std::make_unique<RecordReader>(
         reader.SubReader(header.m_featuresOffset, header.m_featuresSize));
+  m_featuresSize = header.m_featuresSize;
+}
+
+uint32_t FeaturesVector::GetOffset(uint32_t index) const
+{
+  return m_table ? m_table->GetFeatureOffset(index) : index;
+}
+
+void FeaturesVector::GetRecordRanges(std::vector<uint32_t> const & sortedIndices,
+                                     std::vector<std::pair<uint32_t, uint32_t>> & ranges) const
+{
+  if (!m_table)
+  {
+    ranges.resize(sortedIndices.size());
+    for (size_t i = 0; i < sortedIndices.size(); ++i)
+      ranges[i] = {sortedIndices[i], sortedIndices[i]};
+    return;
+  }
+
+  m_table->GetFeatureRanges(sortedIndices, ranges);
+  if (!ranges.empty() && ranges.back().second == feature::FeaturesOffsetsTable::kNoOffset)
+    ranges.back().second = m_featuresSize;
 }
 
 std::unique_ptr<FeatureType> FeaturesVector::GetByIndex(uint32_t index) const
 {
-  auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
+  auto const ftOffset = GetOffset(index);
+  if (m_mapped)
+  {
+    auto const record = m_mapped->GetRecord(ftOffset);
+    return std::make_unique<FeatureType>(&m_loadInfo, record.m_data, record.m_size, m_mapped,
+                                         m_metaDeserializer);
+  }
   return std::make_unique<FeatureType>(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
 }
 
+void FeaturesVector::GetByIndex(uint32_t index, std::optional<FeatureType> & ft) const
+{
+  auto const ftOffset = GetOffset(index);
+  if (m_mapped)
+  {
+    auto const record = m_mapped->GetRecord(ftOffset);
+    if (ft)
+      ft->Reset(&m_loadInfo, record.m_data, record.m_size, m_mapped, m_metaDeserializer);
+    else
+      ft.emplace(&m_loadInfo, record.m_data, record.m_size, m_mapped, m_metaDeserializer);
+    return;
+  }
+
+  if (!ft)
+  {
+    ft.emplace(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
+    return;
+  }
+
+  // The record is read into the buffer of the previous record of |ft|.
+  m_recordBuffer.clear();
+  m_recordReader->ReadRecord(ftOffset, m_recordBuffer);
+  ft->Reset(&m_loadInfo, std::move(m_recordBuffer), m_metaDeserializer);
+}
+
+void FeaturesVector::GetByIndices(std::vector<uint32_t> const & indices, FeaturesArena & arena) const
+{
+  arena.Reset(indices.size());
+
+  // Offsets grow with indices.
+  auto & order = arena.m_order;
+  order.resize(indices.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&indices](size_t lhs, size_t rhs) { return indices[lhs] < indices[rhs]; });
+
+  // Offsets are looked up once for all the sorted indices.
+  auto & sortedIndices = arena.m_sortedIndices;
+  sortedIndices.resize(order.size());
+  for (size_t j = 0; j < order.size(); ++j)
+    sortedIndices[j] = indices[order[j]];
+  auto & ranges = arena.m_ranges;
+  GetRecordRanges(sortedIndices, ranges);
+
+  // Splits records into groups of nearby records, as [first, last) ranges of |order|.
+  // Without offsets table ends of records are unknown, so each group has a single record.
+  std::vector<std::pair<size_t, size_t>> groups;
+  for (size_t first = 0; first < order.size();)
+  {
+    auto end = ranges[first].second;
+    size_t last = first + 1;
+    for (; m_table && last < order.size(); ++last)
+    {
+      if (ranges[last].first > uint64_t{end} + kMaxReadGap)
+        break;
+      end = std::max(end, ranges[last].second);
+    }
+    groups.emplace_back(first, last);
+    first = last;
+  }
+
+  if (m_mapped)
+  {
+    // Let the OS read all groups in parallel before the records are touched.
+    if (m_table)
+    {
+      for (auto const & g : groups)
+        m_mapped->Prefetch(ranges[g.first].first, ranges[g.second - 1].second);
+    }
+
+    for (size_t j = 0; j < order.size(); ++j)
+    {
+      auto const record = m_mapped->GetRecord(ranges[j].first);
+      arena.Emplace(order[j], &m_loadInfo, record.m_data, record.m_size, m_mapped,
+                    m_metaDeserializer);
+    }
+    return;
+  }
+
+  // Read all records first, because the buffer may be reallocated while growing.
+  auto & buffer = arena.m_buffer;
+  auto & records = arena.m_records;
+  records.resize(indices.size());
+  for (auto const & g : groups)
+  {
+    auto const groupBegin = ranges[g.first].first;
+    auto const bufferBegin = buffer.size();
+
+    if (!m_table)
+    {
+      ASSERT_EQUAL(g.second, g.first + 1, ());
+      m_recordReader->ReadRecord(groupBegin, buffer);
+      records[order[g.first]] = {bufferBegin, buffer.size() - bufferBegin};
+      continue;
+    }
+
+    auto const groupEnd = ranges[g.second - 1].second;
+    buffer.resize(bufferBegin + groupEnd - groupBegin);
+    m_recordReader->Read(groupBegin, buffer.data() + bufferBegin, groupEnd - groupBegin);
+
+    for (size_t j = g.first; j < g.second; ++j)
+    {
+      auto const pos = bufferBegin + ranges[j].first - groupBegin;
+      ArrayByteSource source(buffer.data() + pos);
+      auto const size = ReadVarUint<uint32_t>(source);
+      records[order[j]] = {static_cast<size_t>(source.PtrUint8() - buffer.data()), size};
+    }
+  }
+
+  for (size_t i = 0; i < records.size(); ++i)
+  {
+    arena.Emplace(i, &m_loadInfo, buffer.data() + records[i].first, records[i].second,
+                  nullptr /* mapping */, m_metaDeserializer);
+  }
+}
+
 size_t FeaturesVector::GetNumFeatures() const
 {
   return m_table ? m_table->size() : 0;
@@ -1,17 +1,75 @@
 #pragma once
 
 #include "indexer/feature.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/metadata_serdes.hpp"
 #include "indexer/shared_load_info.hpp"
 
 #include "coding/var_record_reader.hpp"
 
+#include "base/assert.hpp"
+
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace feature { class FeaturesOffsetsTable; }
 
+/// Storage of a batch of features loaded by FeaturesVector::GetByIndices().
+/// Records of not mapped features are copied into a single buffer, and features
+/// are kept between batches and reused by FeatureType::Reset(), so loading of a batch
+/// doesn't allocate memory per feature once the arena is warmed up.
+/// Features are valid until the arena is cleared or reused for the next batch.
+class FeaturesArena
+{
+  DISALLOW_COPY_AND_MOVE(FeaturesArena);
+
+public:
+  FeaturesArena() = default;
+
+  // Releases records and mwms of features, but keeps their memory for the next batch.
+  void Clear();
+
+  size_t Size() const { return m_size; }
+  FeatureType & operator[](size_t i)
+  {
+    ASSERT_LESS(i, m_size, ());
+    ASSERT(m_features[i], ());
+    return *m_features[i];
+  }
+
+private:
+  friend class FeaturesVector;
+
+  // Clears the arena and makes room for |size| features.
+  void Reset(size_t size);
+
+  template <typename... Args>
+  void Emplace(size_t i, Args &&... args)
+  {
+    ASSERT_LESS(i, m_size, ());
+    if (m_features[i])
+      m_features[i]->Reset(std::forward<Args>(args)...);
+    else
+      m_features[i].emplace(std::forward<Args>(args)...);
+  }
+
+  std::vector<uint8_t> m_buffer;
+  // Positions of records in |m_buffer|.
+  std::vector<std::pair<size_t, size_t>> m_records;
+  // Order of features by offsets.
+  std::vector<size_t> m_order;
+  // Indices of features in |m_order| and ranges of their records.
+  std::vector<uint32_t> m_sortedIndices;
+  std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
+  // FeatureType is neither copyable nor movable, so features are constructed in place.
+  std::unique_ptr<std::optional<FeatureType>[]> m_features;
+  size_t m_size = 0;
+  size_t m_capacity = 0;
+};
+
 /// Note! This class is NOT Thread-Safe.
 /// You should have separate instance of Vector for every thread.
 class FeaturesVector
@@ -19,27 +77,62 @@ class FeaturesVector
   DISALLOW_COPY(FeaturesVector);
 
 public:
+  /// When |mapped| is not nullptr, features reference records in the mapped memory
+  /// instead of copying them, and keep |mapped| alive while they reference it.
   FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header,
                  feature::FeaturesOffsetsTable const * table,
-                 indexer::MetadataDeserializer * metaDeserializer);
+                 indexer::MetadataDeserializer * metaDeserializer,
+                 std::shared_ptr<feature::MappedFeatures const> mapped = {});
 
   std::unique_ptr<FeatureType> GetByIndex(uint32_t index) const;
+  /// Same as above, but reuses |ft| and its memory when it's not empty.
+  void GetByIndex(uint32_t index, std::optional<FeatureType> & ft) const;
+  /// Replaces features in |arena| with features with |indices|, in the same order.
+  /// Records are read in the order of their offsets, nearby records are read at once,
+  /// and mapped records are prefetched, which is much faster than GetByIndex() calls
+  /// on cold mwms.
+  void GetByIndices(std::vector<uint32_t> const & indices, FeaturesArena & arena) const;
 
   size_t GetNumFeatures() const;
 
   template <class ToDo> void ForEach(ToDo && toDo) const
   {
     uint32_t index = 0;
-    m_recordReader->ForEachRecord([&](uint32_t pos, std::vector<uint8_t> && data)
+    // A single feature is reused for all records.
+    std::optional<FeatureType> ft;
+    auto const process = [&](uint32_t pos, auto && record, auto &&... sizeAndMapping)
     {
-      FeatureType ft(&m_loadInfo, std::move(data), m_metaDeserializer);
+      if (ft)
+      {
+        ft->Reset(&m_loadInfo, std::forward<decltype(record)>(record), sizeAndMapping...,
+                  m_metaDeserializer);
+      }
+      else
+      {
+        ft.emplace(&m_loadInfo, std::forward<decltype(record)>(record), sizeAndMapping...,
+                   m_metaDeserializer);
+      }
 
       // We can't properly set MwmId here, because FeaturesVector
       // works with FileContainerR, not with MwmId/MwmHandle/MwmValue.
       // But it's OK to set at least feature's index, because it can
       // be used later for Metadata loading.
-      ft.SetID(FeatureID(MwmSet::MwmId(), index));
-      toDo(ft, m_table ? index++ : pos);
+      ft->SetID(FeatureID(MwmSet::MwmId(), index));
+      toDo(*ft, m_table ? index++ : pos);
+    };
+
+    if (m_mapped)
+    {
+      m_mapped->ForEachRecord([&](uint32_t pos, feature::MappedFeatures::Record const & record)
+      {
+        process(pos, record.m_data, record.m_size, m_mapped);
+      });
+      return;
+    }
+
+    m_recordReader->ForEachRecord([&](uint32_t pos, std::vector<uint8_t> && data)
+    {
+      process(pos, std::move(data));
     });
   }
 
@@ -62,13 +155,23 @@ private:
 
   void InitRecordsReader();
 
+  uint32_t GetOffset(uint32_t index) const;
+  // Fills |ranges| with offsets and ends of records with |sortedIndices|.
+  // Without offsets table ends of records are unknown, and they are equal to offsets.
+  void GetRecordRanges(std::vector<uint32_t> const & sortedIndices,
+                       std::vector<std::pair<uint32_t, uint32_t>> & ranges) const;
+
   friend class FeaturesVectorTest;
   using RecordReader = VarRecordReader<FilesContainerR::TReader>;
 
   feature::SharedLoadInfo m_loadInfo;
   std::unique_ptr<RecordReader> m_recordReader;
+  uint32_t m_featuresSize = 0;
   feature::FeaturesOffsetsTable const * m_table;
   indexer::MetadataDeserializer * m_metaDeserializer;
+  std::shared_ptr<feature::MappedFeatures const> m_mapped;
+  // Buffer swapped with record buffers of reused features, see GetByIndex().
+  mutable std::vector<uint8_t> m_recordBuffer;
 };
 
 /// Test features vector (reader) that combines all the needed data for stand-alone work.
@@ -0,0 +1,97 @@
+#include "testing/testing.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/classificator_loader.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_types_table.hpp"
+#include "indexer/features_vector.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace feature_types_table_test
+{
+using namespace feature;
+using namespace std;
+
+UNIT_TEST(FeatureTypesTable_Smoke)
+{
+  classificator::Load();
+
+  string const kMap = base::JoinPath(GetPlatform().WritableDir(), "minsk-pass.mwm");
+  FeaturesVectorTest fv(kMap);
+
+  vector<uint8_t> buffer;
+  {
+    FeatureTypesTableBuilder builder;
+    fv.GetVector().ForEach([&](FeatureType & ft, uint32_t) { builder.Put(ft); });
+
+    MemWriter<vector<uint8_t>> writer(buffer);
+    builder.Freeze(writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+  auto const table = FeatureTypesTable::Load(reader);
+  TEST(table, ());
+  TEST_EQUAL(table->GetFeaturesCount(), fv.GetVector().GetNumFeatures(), ());
+
+  uint32_t const buildingType = classif().GetTypeByPath({"building"});
+  uint32_t const highwayType = classif().GetTypeByPath({"highway"});
+
+  FeatureTypesTable::TypesSet set;
+  set.Add(buildingType);
+  set.Add(highwayType, true /* withSubtree */);
+
+  vector<uint32_t> expected;
+  fv.GetVector().ForEach([&](FeatureType & ft, uint32_t id)
+  {
+    TypesHolder const types(ft);
+    TEST_EQUAL(table->GetTypes(id).ToObjectNames(), types.ToObjectNames(), (id));
+    TEST_EQUAL(table->GetGeomType(id), types.GetGeomType(), (id));
+    TEST_EQUAL(table->GetRank(id), ft.GetRank(), (id));
+
+    for (auto type : types)
+    {
+      auto truncated = type;
+      ftype::TruncValue(truncated, 1);
+      if (type == buildingType || truncated == highwayType)
+      {
+        expected.push_back(id);
+        break;
+      }
+    }
+  });
+
+  vector<uint32_t> actual;
+  table->ForEachFeatureWithTypes(set, [&](uint32_t id) { actual.push_back(id); });
+  TEST(!actual.empty(), ());
+  TEST_EQUAL(actual, expected, ());
+}
+
+UNIT_TEST(FeatureTypesTable_UnknownVersion)
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    FeatureTypesTableBuilder().Freeze(writer);
+  }
+
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    TEST(FeatureTypesTable::Load(reader), ());
+  }
+
+  // The version is the first byte of the header.
+  buffer[0] = static_cast<uint8_t>(FeatureTypesTable::Version::Latest) + 1;
+  MemReader reader(buffer.data(), buffer.size());
+  TEST(!FeatureTypesTable::Load(reader), ());
+}
+}  // namespace feature_types_table_test
@@ -13,9 +13,14 @@
 
 #include "defines.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace platform;
 using namespace std;
@@ -65,6 +70,46 @@ namespace feature
     TEST_EQUAL(static_cast<size_t>(7), table->GetFeatureIndexbyOffset(1024), ());
   }
 
+  UNIT_TEST(FeaturesOffsetsTable_Ranges)
+  {
+    mt19937 rng(0);
+    uniform_int_distribution<uint32_t> gap(1, 300);
+
+    FeaturesOffsetsTable::Builder builder;
+    vector<uint32_t> offsets;
+    uint32_t offset = 0;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+      offset += gap(rng);
+      offsets.push_back(offset);
+      builder.PushOffset(offset);
+    }
+
+    unique_ptr<FeaturesOffsetsTable> table(FeaturesOffsetsTable::Build(builder));
+    TEST_EQUAL(table->size(), offsets.size(), ());
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+      TEST_EQUAL(table->GetFeatureIndexbyOffset(offsets[i]), i, ());
+
+    // Dense, sparse and repeated indices, and the last feature.
+    vector<uint32_t> indices = {0, 0, 1, 2, 5, 20, 21, 21, 40, 41, 42, 1000, 1017, 9998, 9999};
+    uniform_int_distribution<uint32_t> index(0, static_cast<uint32_t>(offsets.size() - 1));
+    for (size_t i = 0; i < 500; ++i)
+      indices.push_back(index(rng));
+    sort(indices.begin(), indices.end());
+
+    vector<pair<uint32_t, uint32_t>> ranges;
+    table->GetFeatureRanges(indices, ranges);
+    TEST_EQUAL(ranges.size(), indices.size(), ());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      auto const id = indices[i];
+      TEST_EQUAL(ranges[i].first, offsets[id], (id));
+      TEST_EQUAL(ranges[i].second,
+                 id + 1 < offsets.size() ? offsets[id + 1] : FeaturesOffsetsTable::kNoOffset, (id));
+    }
+  }
+
   UNIT_TEST(FeaturesOffsetsTable_ReadWrite)
   {
     string const testFileName = "test_file";
@@ -1,12 +1,25 @@
 #include "testing/testing.hpp"
 
+#include "indexer/dat_section_header.hpp"
 #include "indexer/data_source.hpp"
+#include "indexer/features_offsets_table.hpp"
 #include "indexer/features_vector.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/mwm_set.hpp"
+#include "indexer/scales.hpp"
 
 #include "platform/local_country_file.hpp"
+#include "platform/platform.hpp"
 
+#include "coding/files_container.hpp"
+#include "coding/writer.hpp"
+
+#include "defines.hpp"
+
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -76,4 +89,205 @@ UNIT_TEST(FeaturesVectorTest_ParseMetadata)
   });
   TEST_EQUAL(expected, actual, ());
 }
+
+UNIT_TEST(FeaturesVectorTest_Mapped)
+{
+  LocalCountryFile localFile = LocalCountryFile::MakeForTesting("minsk-pass");
+
+  FrozenDataSource dataSource;
+  dataSource.SetFeaturesMapping(true);
+  auto result = dataSource.RegisterMap(localFile);
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  MwmSet::MwmHandle handle = dataSource.GetMwmHandleById(result.first);
+  TEST(handle.IsAlive(), ());
+
+  auto const * value = handle.GetValue();
+  TEST(value->m_mappedFeatures, ());
+
+  FeaturesVector copying(value->m_cont, value->GetHeader(), value->m_table.get(),
+                         value->m_metaDeserializer.get());
+  FeaturesVector mapped(value->m_cont, value->GetHeader(), value->m_table.get(),
+                        value->m_metaDeserializer.get(), value->m_mappedFeatures);
+  TEST_EQUAL(copying.GetNumFeatures(), mapped.GetNumFeatures(), ());
+
+  vector<uint32_t> indices;
+  for (uint32_t i = 0; i < mapped.GetNumFeatures(); i += 7)
+    indices.push_back(i);
+
+  FeaturesArena copyingArena;
+  FeaturesArena mappedArena;
+  copying.GetByIndices(indices, copyingArena);
+  mapped.GetByIndices(indices, mappedArena);
+  TEST_EQUAL(copyingArena.Size(), indices.size(), ());
+  TEST_EQUAL(mappedArena.Size(), indices.size(), ());
+
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    auto const ft = copying.GetByIndex(indices[i]);
+    auto const rect = ft->GetLimitRect(scales::GetUpperScale());
+    TEST_EQUAL(ft->GetGeomType(), mapped.GetByIndex(indices[i])->GetGeomType(), (indices[i]));
+    TEST_EQUAL(rect, mappedArena[i].GetLimitRect(scales::GetUpperScale()), (indices[i]));
+    TEST_EQUAL(rect, copyingArena[i].GetLimitRect(scales::GetUpperScale()), (indices[i]));
+    TEST_EQUAL(ft->GetReadableName(), mappedArena[i].GetReadableName(), (indices[i]));
+  }
+}
+
+UNIT_TEST(FeaturesVectorTest_ReuseFeature)
+{
+  FrozenDataSource dataSource;
+  auto result = dataSource.RegisterMap(LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  MwmSet::MwmHandle handle = dataSource.GetMwmHandleById(result.first);
+  TEST(handle.IsAlive(), ());
+
+  auto const * value = handle.GetValue();
+  FeaturesVector fv(value->m_cont, value->GetHeader(), value->m_table.get(),
+                    value->m_metaDeserializer.get());
+
+  // Points, lines and areas go in turn, so each parsed part of the reused feature is replaced.
+  optional<FeatureType> reused;
+  for (uint32_t i = 0; i < fv.GetNumFeatures(); i += 5)
+  {
+    auto const expected = fv.GetByIndex(i);
+    fv.GetByIndex(i, reused);
+    TEST(reused, ());
+
+    expected->SetID(FeatureID(MwmSet::MwmId(), i));
+    reused->SetID(FeatureID(MwmSet::MwmId(), i));
+
+    TEST_EQUAL(reused->GetGeomType(), expected->GetGeomType(), (i));
+    TEST_EQUAL(reused->GetReadableName(), expected->GetReadableName(), (i));
+    TEST_EQUAL(reused->GetHouseNumber(), expected->GetHouseNumber(), (i));
+    TEST_EQUAL(reused->GetLayer(), expected->GetLayer(), (i));
+    TEST_EQUAL(reused->GetMetadata(feature::Metadata::FMD_POSTCODE),
+               expected->GetMetadata(feature::Metadata::FMD_POSTCODE), (i));
+    TEST_EQUAL(reused->GetLimitRect(FeatureType::BEST_GEOMETRY),
+               expected->GetLimitRect(FeatureType::BEST_GEOMETRY), (i));
+    TEST_EQUAL(reused->GetPoints(FeatureType::BEST_GEOMETRY).size(),
+               expected->GetPoints(FeatureType::BEST_GEOMETRY).size(), (i));
+    TEST_EQUAL(reused->GetTrianglesAsPoints(FeatureType::BEST_GEOMETRY).size(),
+               expected->GetTrianglesAsPoints(FeatureType::BEST_GEOMETRY).size(), (i));
+  }
+}
+
+UNIT_TEST(FeaturesLoaderGuard_LoadFeatures)
+{
+  FrozenDataSource dataSource;
+  auto result = dataSource.RegisterMap(LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  FeaturesLoaderGuard guard(dataSource, result.first);
+  vector<uint32_t> indices;
+  for (uint32_t i = 0; i < guard.GetNumFeatures(); i += 3)
+    indices.push_back(i);
+  // Both nearby and distant records, some of them twice.
+  for (uint32_t i = 1; i < guard.GetNumFeatures(); i += 1000)
+    indices.push_back(i);
+
+  vector<uint32_t> expected = indices;
+  sort(expected.begin(), expected.end());
+  reverse(indices.begin(), indices.end());
+
+  vector<uint32_t> actual;
+  guard.LoadFeatures(indices, [&](FeatureType & ft)
+  {
+    actual.push_back(ft.GetID().m_index);
+    auto const expectedFt = guard.GetFeatureByIndex(ft.GetID().m_index);
+    TEST_EQUAL(ft.GetLimitRect(scales::GetUpperScale()),
+               expectedFt->GetLimitRect(scales::GetUpperScale()), (ft.GetID()));
+  });
+  TEST_EQUAL(actual, expected, ());
+}
+
+UNIT_TEST(FeaturesVectorTest_ReadFailure)
+{
+  Platform & platform = GetPlatform();
+  FilesContainerR const original(platform.GetReader("minsk-pass" DATA_FILE_EXTENSION));
+  auto const table = feature::FeaturesOffsetsTable::Load(original);
+  TEST(table, ());
+  uint32_t const lastOffset = table->GetFeatureOffset(table->size() - 1);
+
+  // The last byte of the last record is cut off, so the record can't be read.
+  vector<uint8_t> features;
+  {
+    auto const reader = original.GetReader(FEATURES_FILE_TAG);
+    feature::DatSectionHeader header;
+    header.Read(*reader.GetPtr());
+    features.resize(header.m_featuresOffset + header.m_featuresSize - 1);
+    reader.Read(0, features.data(), features.size());
+
+    --header.m_featuresSize;
+    vector<uint8_t> serializedHeader;
+    MemWriter<vector<uint8_t>> writer(serializedHeader);
+    header.Serialize(writer);
+    copy(serializedHeader.begin(), serializedHeader.end(), features.begin());
+  }
+
+  string const filePath = platform.WritablePathForFile("features_read_failure" DATA_FILE_EXTENSION);
+  {
+    FilesContainerW writer(filePath);
+    original.ForEachTag([&](string const & tag)
+    {
+      if (tag != FEATURES_FILE_TAG)
+        writer.Write(original.GetReader(tag), tag);
+    });
+    writer.Write(features, FEATURES_FILE_TAG);
+  }
+
+  {
+    FilesContainerR const cont(filePath);
+    feature::DataHeader const header(cont);
+    // Without the offsets table indices are offsets of records.
+    FeaturesVector fv(cont, header, nullptr /* table */, nullptr /* metaDeserializer */);
+
+    FeaturesArena arena;
+    fv.GetByIndices({0}, arena);
+    TEST_EQUAL(arena.Size(), 1, ());
+
+    // Features of the arena are not constructed when the reading throws.
+    TEST_ANY_THROW(fv.GetByIndices({0, lastOffset, 0}, arena), ());
+    arena.Clear();
+    TEST_EQUAL(arena.Size(), 0, ());
+
+    TEST_ANY_THROW(fv.GetByIndices({lastOffset, 0}, arena), ());
+    fv.GetByIndices({0, 0}, arena);
+    TEST_EQUAL(arena.Size(), 2, ());
+    auto const expected = fv.GetByIndex(0);
+    for (size_t i = 0; i < arena.Size(); ++i)
+    {
+      TEST_EQUAL(arena[i].GetLimitRect(scales::GetUpperScale()),
+                 expected->GetLimitRect(scales::GetUpperScale()), (i));
+    }
+  }
+
+  FileWriter::DeleteFileX(filePath);
+}
+
+UNIT_TEST(FeaturesLoaderGuard_PooledFeaturesReleaseMwm)
+{
+  FrozenDataSource dataSource;
+  dataSource.SetFeaturesMapping(true);
+  auto result = dataSource.RegisterMap(LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  weak_ptr<feature::MappedFeatures const> mapping;
+  {
+    FeaturesLoaderGuard guard(dataSource, result.first);
+    mapping = guard.GetHandle().GetValue()->m_mappedFeatures;
+    TEST(!mapping.expired(), ());
+
+    vector<uint32_t> indices;
+    for (uint32_t i = 0; i < guard.GetNumFeatures(); i += 10)
+      indices.push_back(i);
+    size_t count = 0;
+    guard.LoadFeatures(indices, [&count](FeatureType &) { ++count; });
+    TEST_EQUAL(count, indices.size(), ());
+  }
+
+  // Features pooled for the next LoadFeatures() calls of the thread don't keep the mapping.
+  dataSource.ClearCache();
+  TEST(mapping.expired(), ());
+}
 } // namespace features_vector_test
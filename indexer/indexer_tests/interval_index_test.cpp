@@ -1,14 +1,23 @@
+#include "testing/benchmark.hpp"
 #include "testing/testing.hpp"
 
+#include "indexer/cell_id.hpp"
+#include "indexer/feature_covering.hpp"
 #include "indexer/interval_index.hpp"
 #include "indexer/interval_index_builder.hpp"
+#include "indexer/scales.hpp"
 
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
+#include "geometry/mercator.hpp"
+#include "geometry/rect2d.hpp"
+
 #include "base/macros.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <algorithm>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -291,3 +300,143 @@ UNIT_TEST(IntervalIndex_Simple5)
     TEST_EQUAL(values, vector<uint32_t>(expected, expected + ARRAY_SIZE(expected)), ());
   }
 }
+
+namespace
+{
+using CellIdFeaturePairs = vector<CellIdFeaturePairForTest>;
+
+// Points of |count| features spread over a [-10, 10] x [-10, 10] square, indexed like
+// in the scale index of mwms.
+CellIdFeaturePairs MakeFeatureCells(uint32_t count)
+{
+  mt19937 rng(0);
+  uniform_real_distribution<double> coord(-10.0, 10.0);
+
+  CellIdFeaturePairs data;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    auto const cell = CellIdConverter<mercator::Bounds, RectId>::ToCellId(coord(rng), coord(rng));
+    data.emplace_back(cell.ToInt64(RectId::DEPTH_LEVELS), i);
+  }
+  sort(data.begin(), data.end(), [](auto const & lhs, auto const & rhs) {
+    return make_pair(lhs.GetCell(), lhs.GetValue()) < make_pair(rhs.GetCell(), rhs.GetValue());
+  });
+  return data;
+}
+
+vector<char> BuildFeatureCellsIndex(CellIdFeaturePairs const & data)
+{
+  vector<char> serialIndex;
+  MemWriter<vector<char>> writer(serialIndex);
+  BuildIntervalIndex(data.begin(), data.end(), writer, RectId::DEPTH_LEVELS * 2 + 1);
+  return serialIndex;
+}
+
+vector<m2::RectD> MakeViewports(size_t count)
+{
+  mt19937 rng(1);
+  uniform_real_distribution<double> coord(-10.0, 10.0);
+  uniform_real_distribution<double> size(0.01, 2.0);
+
+  vector<m2::RectD> viewports;
+  for (size_t i = 0; i < count; ++i)
+  {
+    m2::PointD const center(coord(rng), coord(rng));
+    m2::RectD viewport(center, center);
+    viewport.Inflate(size(rng), size(rng));
+    viewports.push_back(viewport);
+  }
+  return viewports;
+}
+
+covering::Intervals GetViewportIntervals(m2::RectD const & rect)
+{
+  covering::CoveringGetter covering(rect, covering::ViewportWithLowLevels);
+  return covering.Get<RectId::DEPTH_LEVELS>(scales::GetUpperScale());
+}
+}  // namespace
+
+UNIT_TEST(IntervalIndex_MultipleIntervals)
+{
+  auto const data = MakeFeatureCells(10000);
+  auto const serialIndex = BuildFeatureCellsIndex(data);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  IntervalIndex<MemReader, uint32_t> index(reader);
+
+  for (auto const & viewport : MakeViewports(100))
+  {
+    auto const intervals = GetViewportIntervals(viewport);
+
+    vector<uint32_t> expected;
+    for (auto const & d : data)
+    {
+      for (auto const & interval : intervals)
+      {
+        if (static_cast<int64_t>(d.GetCell()) >= interval.first &&
+            static_cast<int64_t>(d.GetCell()) < interval.second)
+        {
+          expected.push_back(d.GetValue());
+          break;
+        }
+      }
+    }
+    sort(expected.begin(), expected.end());
+
+    vector<uint32_t> byInterval;
+    for (auto const & interval : intervals)
+      index.ForEach(IndexValueInserter(byInterval), interval.first, interval.second);
+    base::SortUnique(byInterval);
+
+    vector<uint32_t> values;
+    vector<uint64_t> keys;
+    index.ForEach([&](uint64_t key, uint32_t value) {
+      keys.push_back(key);
+      values.push_back(value);
+    }, intervals);
+    TEST(is_sorted(keys.begin(), keys.end()), ());
+    sort(values.begin(), values.end());
+
+    TEST_EQUAL(values, expected, (viewport));
+    TEST_EQUAL(byInterval, expected, (viewport));
+  }
+
+  // Overlapping and unsorted intervals.
+  vector<pair<uint64_t, uint64_t>> const intervals = {
+      {data[20].GetCell(), data[40].GetCell() + 1},
+      {data[0].GetCell(), data[30].GetCell()},
+      {data[35].GetCell(), data[35].GetCell()},
+      {data[50].GetCell(), data[60].GetCell()}};
+  vector<uint32_t> values;
+  index.ForEach(IndexValueInserter(values), intervals);
+  sort(values.begin(), values.end());
+
+  vector<uint32_t> expected;
+  for (size_t i = 0; i < data.size() && data[i].GetCell() < data[60].GetCell(); ++i)
+  {
+    if (data[i].GetCell() <= data[40].GetCell() || data[i].GetCell() >= data[50].GetCell())
+      expected.push_back(data[i].GetValue());
+  }
+  sort(expected.begin(), expected.end());
+  TEST_EQUAL(values, expected, ());
+}
+
+BENCHMARK_TEST(IntervalIndex_Viewports)
+{
+  auto const data = MakeFeatureCells(IF_DEBUG_ELSE(20000, 200000));
+  auto const serialIndex = BuildFeatureCellsIndex(data);
+  MemReader reader(serialIndex.data(), serialIndex.size());
+  IntervalIndex<MemReader, uint32_t> index(reader);
+
+  vector<covering::Intervals> viewports;
+  for (auto const & viewport : MakeViewports(100))
+    viewports.push_back(GetViewportIntervals(viewport));
+
+  uint64_t sum = 0;
+  auto const accumulate = [&sum](uint64_t, uint32_t value) { sum += value; };
+  BENCHMARK_N_TIMES(IF_DEBUG_ELSE(10, 100), 10.0)
+  {
+    for (auto const & intervals : viewports)
+      index.ForEach(accumulate, intervals);
+  }
+  TEST_GREATER(sum, 0, ());
+}
@@ -1,3 +1,4 @@
+#include "testing/benchmark.hpp"
 #include "testing/testing.hpp"
 
 #include "platform/platform_tests_support/scoped_mwm.hpp"
@@ -7,8 +8,13 @@
 
 #include "base/macros.hpp"
 
+#include <atomic>
 #include <initializer_list>
+#include <memory>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace mwm_set_test
 {
@@ -30,6 +36,32 @@ void GetMwmsInfo(MwmSet const & mwmSet, MwmsInfo & mwmsInfo)
     mwmsInfo[info->GetCountryName()] = info;
 }
 
+// Acquires and releases |iterations| handles of |mwms| from each of |threadsCount| threads.
+// Returns the number of alive handles.
+size_t HammerHandles(MwmSet & mwmSet, vector<MwmSet::MwmId> const & mwms, size_t threadsCount,
+                     size_t iterations)
+{
+  atomic<size_t> alive(0);
+  vector<thread> threads;
+  for (size_t i = 0; i < threadsCount; ++i)
+  {
+    threads.emplace_back([&, i]()
+    {
+      size_t count = 0;
+      for (size_t j = 0; j < iterations; ++j)
+      {
+        auto const handle = mwmSet.GetMwmHandleById(mwms[(i + j) % mwms.size()]);
+        if (handle.IsAlive())
+          ++count;
+      }
+      alive += count;
+    });
+  }
+  for (auto & t : threads)
+    t.join();
+  return alive;
+}
+
 void TestFilesPresence(MwmsInfo const & mwmsInfo, initializer_list<string> const & expectedNames)
 {
   TEST_EQUAL(expectedNames.size(), mwmsInfo.size(), ());
@@ -169,4 +201,59 @@ UNIT_TEST(MwmSetLockAndIdTest)
   TEST(!handle.GetId().IsAlive(), ());
   TEST(!handle.GetId().GetInfo().get(), ());
 }
+
+UNIT_TEST(MwmSetConcurrentHandles)
+{
+  TestMwmSet mwmSet;
+  vector<unique_ptr<ScopedMwm>> files;
+  vector<MwmSet::MwmId> mwms;
+  for (auto const & name : {"0", "1", "2", "3"})
+  {
+    files.push_back(make_unique<ScopedMwm>(string(name) + ".mwm"));
+    mwms.push_back(mwmSet.Register(LocalCountryFile::MakeForTesting(name)).first);
+  }
+
+  size_t const kThreads = 8;
+  size_t const kIterations = 1000;
+  TEST_EQUAL(HammerHandles(mwmSet, mwms, kThreads, kIterations), kThreads * kIterations, ());
+  for (auto const & id : mwms)
+    TEST_EQUAL(id.GetInfo()->GetNumRefs(), 0, (id));
+
+  // An mwm is deregistered when the last handle is released.
+  atomic<bool> stop(false);
+  thread hammer([&]()
+  {
+    while (!stop)
+      HammerHandles(mwmSet, {mwms[1]}, 4 /* threadsCount */, 10 /* iterations */);
+  });
+  TEST(mwmSet.Deregister(CountryFile("0")), ());
+  while (mwms[1].IsAlive())
+    mwmSet.Deregister(CountryFile("1"));
+  stop = true;
+  hammer.join();
+
+  TEST_EQUAL(mwms[1].GetInfo()->GetStatus(), MwmInfo::STATUS_DEREGISTERED, ());
+  TEST_EQUAL(mwms[1].GetInfo()->GetNumRefs(), 0, ());
+  TEST(!mwmSet.GetMwmHandleById(mwms[1]).IsAlive(), ());
+  TEST(mwmSet.GetMwmHandleById(mwms[2]).IsAlive(), ());
+}
+
+BENCHMARK_TEST(MwmSetHandlesContention)
+{
+  TestMwmSet mwmSet;
+  vector<unique_ptr<ScopedMwm>> files;
+  vector<MwmSet::MwmId> mwms;
+  for (auto const & name : {"0", "1", "2", "3", "4", "5", "6", "7"})
+  {
+    files.push_back(make_unique<ScopedMwm>(string(name) + ".mwm"));
+    mwms.push_back(mwmSet.Register(LocalCountryFile::MakeForTesting(name)).first);
+  }
+
+  size_t const kThreads = 16;
+  size_t const kIterations = IF_DEBUG_ELSE(1000, 10000);
+  BENCHMARK_N_TIMES(10, 10.0)
+  {
+    TEST_EQUAL(HammerHandles(mwmSet, mwms, kThreads, kIterations), kThreads * kIterations, ());
+  }
+}
 }  // namespace mwm_set_test
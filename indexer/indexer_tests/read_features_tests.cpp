@@ -2,6 +2,7 @@
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_source.hpp"
+#include "indexer/feature_source.hpp"
 
 #include "platform/local_country_file.hpp"
 
@@ -11,6 +12,53 @@
 
 using namespace std;
 
+namespace
+{
+// Every third feature is obsolete and every third one is modified.
+class TestFeatureSource : public FeatureSource
+{
+public:
+  explicit TestFeatureSource(MwmSet::MwmHandle const & handle) : FeatureSource(handle) {}
+
+  // FeatureSource overrides:
+  FeatureStatus GetFeatureStatus(uint32_t index) const override
+  {
+    switch (index % 3)
+    {
+    case 1: return FeatureStatus::Obsolete;
+    case 2: return FeatureStatus::Modified;
+    default: return FeatureStatus::Untouched;
+    }
+  }
+
+  unique_ptr<FeatureType> GetModifiedFeature(uint32_t index) const override
+  {
+    ++m_numModified;
+    return GetOriginalFeature(index);
+  }
+
+  static size_t m_numModified;
+};
+
+size_t TestFeatureSource::m_numModified = 0;
+
+class TestFeatureSourceFactory : public FeatureSourceFactory
+{
+public:
+  // FeatureSourceFactory overrides:
+  unique_ptr<FeatureSource> operator()(MwmSet::MwmHandle const & handle) const override
+  {
+    return make_unique<TestFeatureSource>(handle);
+  }
+};
+
+class TestDataSource : public DataSource
+{
+public:
+  TestDataSource() : DataSource(make_unique<TestFeatureSourceFactory>()) {}
+};
+}  // namespace
+
 UNIT_TEST(ReadFeatures_Smoke)
 {
   classificator::Load();
@@ -35,3 +83,31 @@ UNIT_TEST(ReadFeatures_Smoke)
     ft1->ForEachType([](auto const /* t */) {});
   }
 }
+
+UNIT_TEST(ReadFeatures_OnePerId)
+{
+  classificator::Load();
+
+  TestDataSource dataSource;
+  auto const result =
+      dataSource.RegisterMap(platform::LocalCountryFile::MakeForTesting("minsk-pass"));
+  TEST_EQUAL(result.second, MwmSet::RegResult::Success, ());
+
+  vector<FeatureID> ids;
+  size_t numModified = 0;
+  {
+    FeaturesLoaderGuard const guard(dataSource, result.first);
+    for (uint32_t i = 0; i < guard.GetNumFeatures(); i += 2)
+    {
+      ids.emplace_back(result.first, i);
+      if (i % 3 == 2)
+        ++numModified;
+    }
+  }
+
+  TestFeatureSource::m_numModified = 0;
+  vector<FeatureID> actual;
+  dataSource.ReadFeatures([&actual](FeatureType & ft) { actual.push_back(ft.GetID()); }, ids);
+  TEST_EQUAL(actual, ids, ());
+  TEST_EQUAL(TestFeatureSource::m_numModified, numModified, ());
+}
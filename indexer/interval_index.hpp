@@ -7,7 +7,11 @@
 #include "base/assert.hpp"
 #include "base/buffer_vector.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 class IntervalIndexBase
 {
@@ -32,11 +36,18 @@ public:
   enum { kVersion = 1 };
 };
 
+// Reading nodes of the index is allocation-free after the first query: the top levels
+// of the tree are kept in memory and the other nodes are read to per-level buffers.
+// Because of the buffers, which are mutable, even const queries of an instance must not
+// run from different threads simultaneously. An index of MwmValue::GetScaleIndex() is safe,
+// because MwmSet::LockValue() gives a value to a single MwmHandle at a time.
 template <class ReaderT, typename Value>
 class IntervalIndex : public IntervalIndexBase
 {
   typedef IntervalIndexBase base_t;
 public:
+  // Levels are kept in memory starting from the root while their total size fits in it.
+  static uint32_t constexpr kMaxPinnedBytes = 8 * 1024;
 
   explicit IntervalIndex(ReaderT const & reader) : m_Reader(reader)
   {
@@ -44,8 +55,11 @@ public:
     src.Read(&m_Header, sizeof(Header));
     CHECK_EQUAL(m_Header.m_Version, static_cast<uint8_t>(kVersion), ());
     if (m_Header.m_Levels != 0)
+    {
       for (int i = 0; i <= m_Header.m_Levels + 1; ++i)
         m_LevelOffsets.push_back(ReadPrimitiveFromSource<uint32_t>(src));
+      PinTopLevels();
+    }
   }
 
   uint64_t KeyEnd() const
@@ -56,76 +70,150 @@ public:
   template <typename F>
   void ForEach(F const & f, uint64_t beg, uint64_t end) const
   {
-    if (m_Header.m_Levels != 0 && beg != end)
+    Interval const interval(beg, end);
+    ForEachImpl(f, &interval, &interval + 1);
+  }
+
+  // Calls |f| for all keys in the [beg, end) |intervals|. Intervals may go in any order
+  // and overlap, each node of the index is read at most once, and keys are passed to |f|
+  // in the ascending order, once even for overlapping intervals.
+  template <typename F, typename Intervals>
+  void ForEach(F const & f, Intervals const & intervals) const
+  {
+    ForEachImpl(f, std::begin(intervals), std::end(intervals));
+  }
+
+private:
+  using Interval = std::pair<uint64_t, uint64_t>;
+
+  template <typename F, typename It>
+  void ForEachImpl(F const & f, It first, It last) const
+  {
+    if (m_Header.m_Levels == 0)
+      return;
+
+    // Inclusive [beg, end] intervals clamped to the key space.
+    buffer_vector<Interval, 64> intervals;
+    for (; first != last; ++first)
+    {
+      uint64_t const beg = std::min(static_cast<uint64_t>(first->first), KeyEnd());
+      uint64_t const end = std::min(static_cast<uint64_t>(first->second), KeyEnd());
+      if (beg < end)
+        intervals.emplace_back(beg, end - 1);
+    }
+    if (intervals.empty())
+      return;
+
+    std::sort(intervals.begin(), intervals.end());
+    size_t n = 0;
+    for (size_t i = 1; i < intervals.size(); ++i)
     {
-      // ASSERT_LESS_OR_EQUAL(beg, KeyEnd(), (end));
-      // ASSERT_LESS_OR_EQUAL(end, KeyEnd(), (beg));
-      if (beg > KeyEnd())
-        beg = KeyEnd();
-      if (end > KeyEnd())
-        end = KeyEnd();
-      --end;  // end is inclusive in ForEachImpl().
-      ForEachNode(f, beg, end, m_Header.m_Levels, 0,
-                  m_LevelOffsets[m_Header.m_Levels + 1] - m_LevelOffsets[m_Header.m_Levels],
-                  0 /* started keyBase */);
+      if (intervals[i].first <= intervals[n].second + 1)
+        intervals[n].second = std::max(intervals[n].second, intervals[i].second);
+      else
+        intervals[++n] = intervals[i];
     }
+    intervals.resize(n + 1);
+
+    ForEachNode(f, intervals.data(), intervals.data() + intervals.size(), m_Header.m_Levels, 0,
+                m_LevelOffsets[m_Header.m_Levels + 1] - m_LevelOffsets[m_Header.m_Levels],
+                0 /* started keyBase */);
   }
 
-private:
-  template <typename F>
-  void ForEachLeaf(F const & f, uint64_t const beg, uint64_t const end,
-      uint32_t const offset, uint32_t const size,
-      uint64_t keyBase /* discarded part of object key value in the parent nodes*/) const
+  void PinTopLevels()
+  {
+    uint32_t const end = m_LevelOffsets[m_Header.m_Levels + 1];
+    m_PinnedLevel = m_Header.m_Levels + 1;
+    while (m_PinnedLevel > 0 && end - m_LevelOffsets[m_PinnedLevel - 1] <= kMaxPinnedBytes)
+      --m_PinnedLevel;
+
+    m_Pinned.resize(end - m_LevelOffsets[m_PinnedLevel]);
+    if (!m_Pinned.empty())
+      m_Reader.Read(m_LevelOffsets[m_PinnedLevel], m_Pinned.data(), m_Pinned.size());
+    m_Buffers.resize(m_PinnedLevel);
+  }
+
+  uint8_t const * ReadNode(int level, uint32_t offset, uint32_t size) const
   {
-    buffer_vector<uint8_t, 1024> data;
-    data.resize(size);
+    if (level >= m_PinnedLevel)
+      return m_Pinned.data() + (offset - m_LevelOffsets[m_PinnedLevel]);
 
-    m_Reader.Read(offset, &data[0], size);
-    ArrayByteSource src(&data[0]);
+    auto & buffer = m_Buffers[level];
+    if (buffer.size() < size)
+      buffer.resize(size);
+    m_Reader.Read(offset, buffer.data(), size);
+    return buffer.data();
+  }
 
-    void const * pEnd = &data[0] + size;
+  // [it, itEnd) are sorted disjoint inclusive intervals of absolute keys which intersect
+  // the keys of the node.
+  template <typename F>
+  void ForEachLeaf(F const & f, Interval const * it, Interval const * itEnd,
+      uint8_t const * data, uint32_t const size,
+      uint64_t keyBase /* discarded part of object key value in the parent nodes*/) const
+  {
+    ArrayByteSource src(data);
+    void const * pEnd = data + size;
+    uint64_t const last = (itEnd - 1)->second;
     Value value = 0;
     while (src.Ptr() < pEnd)
     {
       uint32_t key = 0;
       src.Read(&key, m_Header.m_LeafBytes);
-      key = SwapIfBigEndianMacroBased(key);
-      if (key > end)
+      uint64_t const fullKey = keyBase + SwapIfBigEndianMacroBased(key);
+      if (fullKey > last)
         break;
       value += ReadVarInt<int64_t>(src);
-      if (key >= beg)
-        f(keyBase + key, value);
+      while (it->second < fullKey)
+        ++it;
+      if (fullKey >= it->first)
+        f(fullKey, value);
     }
   }
 
   template <typename F>
-  void ForEachNode(F const & f, uint64_t beg, uint64_t end, int level,
+  void ForEachNode(F const & f, Interval const * it, Interval const * itEnd, int level,
       uint32_t offset, uint32_t size,
       uint64_t keyBase /* discarded part of object key value in the parent nodes */) const
   {
     ASSERT(size > 0, ());
+    ASSERT(it != itEnd, ());
     offset += m_LevelOffsets[level];
+    uint8_t const * data = ReadNode(level, offset, size);
 
     if (level == 0)
     {
-      ForEachLeaf(f, beg, end, offset, size, keyBase);
+      ForEachLeaf(f, it, itEnd, data, size, keyBase);
       return;
     }
 
     uint8_t const skipBits = (m_Header.m_LeafBytes << 3) + (level - 1) * m_Header.m_BitsPerLevel;
-    ASSERT_LESS_OR_EQUAL(beg, end, (skipBits));
-
     uint64_t const levelBytesFF = (1ULL << skipBits) - 1;
-    uint32_t const beg0 = static_cast<uint32_t>(beg >> skipBits);
-    uint32_t const end0 = static_cast<uint32_t>(end >> skipBits);
-    ASSERT_LESS(end0, (1U << m_Header.m_BitsPerLevel), (beg, end, skipBits));
+    uint64_t const nodeLast = keyBase + (levelBytesFF << m_Header.m_BitsPerLevel) +
+                              ((1ULL << m_Header.m_BitsPerLevel) - 1);
+    ASSERT_LESS_OR_EQUAL(keyBase, (itEnd - 1)->second, (skipBits));
+    ASSERT_LESS_OR_EQUAL(it->first, nodeLast, (skipBits));
 
-    buffer_vector<uint8_t, 576> data;
-    data.resize(size);
+    uint32_t const beg0 = static_cast<uint32_t>((std::max(it->first, keyBase) - keyBase) >> skipBits);
+    uint32_t const end0 =
+        static_cast<uint32_t>((std::min((itEnd - 1)->second, nodeLast) - keyBase) >> skipBits);
+    ASSERT_LESS(end0, (1U << m_Header.m_BitsPerLevel), (keyBase, skipBits));
 
-    m_Reader.Read(offset, &data[0], size);
-    ArrayByteSource src(&data[0]);
+    // Passes to the child |i| the intervals which intersect its keys.
+    auto const forEachChild = [&](uint32_t i, uint32_t childOffset, uint32_t childSize)
+    {
+      uint64_t const childBeg = keyBase + (uint64_t{i} << skipBits);
+      uint64_t const childLast = childBeg + levelBytesFF;
+      while (it != itEnd && it->second < childBeg)
+        ++it;
+      auto childEnd = it;
+      while (childEnd != itEnd && childEnd->first <= childLast)
+        ++childEnd;
+      if (childEnd != it)
+        ForEachNode(f, it, childEnd, level - 1, childOffset, childSize, childBeg);
+    };
 
+    ArrayByteSource src(data);
     uint32_t const offsetAndFlag = ReadVarUint<uint32_t>(src);
     uint32_t childOffset = offsetAndFlag >> 1;
     if (offsetAndFlag & 1)
@@ -139,21 +227,17 @@ private:
         {
           uint32_t childSize = ReadVarUint<uint32_t>(src);
           if (i >= beg0)
-          {
-            uint64_t const beg1 = (i == beg0) ? (beg & levelBytesFF) : 0;
-            uint64_t const end1 = (i == end0) ? (end & levelBytesFF) : levelBytesFF;
-            ForEachNode(f, beg1, end1, level - 1, childOffset, childSize, keyBase + (uint64_t{i} << skipBits));
-          }
+            forEachChild(i, childOffset, childSize);
           childOffset += childSize;
         }
       }
       ASSERT(end0 != (static_cast<uint32_t>(1) << m_Header.m_BitsPerLevel) - 1 ||
-             src.Ptr() == data.data() + size,
-             (beg, end, beg0, end0, offset, size, src.Ptr(), data.data()));
+             src.Ptr() == data + size,
+             (keyBase, beg0, end0, offset, size, src.Ptr(), data));
     }
     else
     {
-      void const * pEnd = &data[0] + size;
+      void const * pEnd = data + size;
       while (src.Ptr() < pEnd)
       {
         uint8_t const i = src.ReadByte();
@@ -161,11 +245,7 @@ private:
           break;
         uint32_t childSize = ReadVarUint<uint32_t>(src);
         if (i >= beg0)
-        {
-          uint64_t const beg1 = (i == beg0) ? (beg & levelBytesFF) : 0;
-          uint64_t const end1 = (i == end0) ? (end & levelBytesFF) : levelBytesFF;
-          ForEachNode(f, beg1, end1, level - 1, childOffset, childSize, keyBase + (uint64_t{i} << skipBits));
-        }
+          forEachChild(i, childOffset, childSize);
         childOffset += childSize;
       }
     }
@@ -174,4 +254,11 @@ private:
   ReaderT m_Reader;
   Header m_Header;
   buffer_vector<uint32_t, 7> m_LevelOffsets;
+
+  // Levels starting from |m_PinnedLevel| up to the root, read to memory.
+  int m_PinnedLevel = 0;
+  std::vector<uint8_t> m_Pinned;
+  // Buffers for nodes of the levels which are not pinned, one per level, as a parent node
+  // must stay valid while its children are visited.
+  mutable std::vector<std::vector<uint8_t>> m_Buffers;
 };
@@ -0,0 +1,90 @@
+#include "indexer/mapped_features.hpp"
+
+#include "indexer/dat_section_header.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/varint.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+
+#include "std/target_os.hpp"
+
+#include "defines.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef OMIM_OS_WINDOWS
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+namespace feature
+{
+using namespace std;
+
+// static
+unique_ptr<MappedFeatures> MappedFeatures::Load(FilesContainerR const & cont)
+{
+  // Compressed features are always read by the reader, it's not an error.
+  if (cont.IsCompressed(FEATURES_FILE_TAG))
+    return {};
+
+  try
+  {
+    DatSectionHeader header;
+    header.Read(*cont.GetReader(FEATURES_FILE_TAG).GetPtr());
+
+    auto features = make_unique<MappedFeatures>();
+    features->m_file.Open(cont.GetFileName());
+
+    auto const p = cont.GetAbsoluteOffsetAndSize(FEATURES_FILE_TAG);
+    if (uint64_t{header.m_featuresOffset} + header.m_featuresSize > p.second)
+      MYTHROW(Reader::SizeException, ("Features records are out of the section."));
+    features->m_handle.Assign(features->m_file.Map(p.first + header.m_featuresOffset,
+                                                   header.m_featuresSize, FEATURES_FILE_TAG));
+    features->m_data = features->m_handle.GetData<uint8_t>();
+    features->m_size = header.m_featuresSize;
+    return features;
+  }
+  catch (RootException const & e)
+  {
+    // Features are read by the reader then, e.g. when mmap() fails or the section is damaged.
+    LOG(LWARNING, ("Can't map features of", cont.GetFileName(), ":", e.Msg()));
+    return {};
+  }
+}
+
+MappedFeatures::Record MappedFeatures::GetRecord(uint32_t offset) const
+{
+  ASSERT_LESS(offset, m_size, ());
+
+  ArrayByteSource source(m_data + offset);
+  Record record;
+  record.m_size = ReadVarUint<uint32_t>(source);
+  record.m_data = source.PtrUint8();
+  ASSERT_LESS_OR_EQUAL(record.m_data + record.m_size, m_data + m_size, ());
+  return record;
+}
+
+void MappedFeatures::Prefetch(uint32_t begin, uint32_t end) const
+{
+  ASSERT_LESS_OR_EQUAL(begin, end, ());
+  ASSERT_LESS_OR_EQUAL(end, m_size, ());
+
+#ifndef OMIM_OS_WINDOWS
+  static uintptr_t const kPageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+
+  // madvise() requires a page-aligned address.
+  auto const address = reinterpret_cast<uintptr_t>(m_data + begin);
+  auto const aligned = address - address % kPageSize;
+  if (madvise(reinterpret_cast<void *>(aligned), address - aligned + (end - begin), MADV_WILLNEED) != 0)
+    LOG(LDEBUG, ("madvise error:", strerror(errno)));
+#else
+  UNUSED_VALUE(begin);
+  UNUSED_VALUE(end);
+#endif
+}
+}  // namespace feature
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "coding/files_container.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace feature
+{
+// Features records of the mwm's features section mapped into memory, so
+// FeatureType-s may be created on top of the records without copying them.
+class MappedFeatures
+{
+public:
+  struct Record
+  {
+    uint8_t const * m_data = nullptr;
+    size_t m_size = 0;
+  };
+
+  // Returns nullptr when the section can't be mapped, e.g. when the mwm
+  // is not a plain file or the section is compressed.
+  static std::unique_ptr<MappedFeatures> Load(FilesContainerR const & cont);
+
+  // |offset| is relative to the beginning of the features records,
+  // the same as offsets stored in FeaturesOffsetsTable.
+  Record GetRecord(uint32_t offset) const;
+
+  // Asks the OS to read records in [begin, end) ahead of the access to them.
+  void Prefetch(uint32_t begin, uint32_t end) const;
+
+  template <typename Fn>
+  void ForEachRecord(Fn && fn) const
+  {
+    uint32_t offset = 0;
+    while (offset < m_size)
+    {
+      auto const record = GetRecord(offset);
+      fn(offset, record);
+      offset = static_cast<uint32_t>(record.m_data + record.m_size - m_data);
+    }
+  }
+
+  uint64_t GetSize() const { return m_size; }
+
+private:
+  ::detail::MappedFile m_file;
+  ::detail::MappedFile::Handle m_handle;
+  uint8_t const * m_data = nullptr;
+  uint64_t m_size = 0;
+};
+}  // namespace feature
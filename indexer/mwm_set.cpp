@@ -1,6 +1,8 @@
 #include "indexer/mwm_set.hpp"
 
+#include "indexer/feature_types_table.hpp"
 #include "indexer/features_offsets_table.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/scales.hpp"
 
 #include "coding/reader.hpp"
@@ -13,7 +15,9 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <exception>
+#include <iterator>
 #include <sstream>
 
 
@@ -165,14 +169,7 @@ bool MwmSet::DeregisterImpl(MwmId const & id, EventList & events)
     SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
     vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
     infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
-    for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
-    {
-      if (it->first == id)
-      {
-        m_cache.erase(it);
-        break;
-      }
-    }
+    ClearCache(id);
     return true;
   }
 
@@ -202,7 +199,7 @@ bool MwmSet::DeregisterImpl(CountryFile const & countryFile, EventList & events)
 
 bool MwmSet::IsLoaded(CountryFile const & countryFile) const
 {
-  lock_guard<mutex> lock(m_lock);
+  shared_lock<shared_mutex> lock(m_lock);
 
   MwmId const id = GetMwmIdByCountryFileImpl(countryFile);
   return id.IsAlive() && id.GetInfo()->IsRegistered();
@@ -210,7 +207,7 @@ bool MwmSet::IsLoaded(CountryFile const & countryFile) const
 
 void MwmSet::GetMwmsInfo(vector<shared_ptr<MwmInfo>> & info) const
 {
-  lock_guard<mutex> lock(m_lock);
+  shared_lock<shared_mutex> lock(m_lock);
   info.clear();
   info.reserve(m_info.size());
   for (auto const & p : m_info)
@@ -257,35 +254,33 @@ void MwmSet::ProcessEventList(EventList & events)
 
 unique_ptr<MwmValue> MwmSet::LockValue(MwmId const & id)
 {
-  unique_ptr<MwmValue> result;
-  WithEventLog([&](EventList & events)
-               {
-                 result = LockValueImpl(id, events);
-               });
-  return result;
-}
-
-unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
-{
-  if (!id.IsAlive())
-    return nullptr;
-  shared_ptr<MwmInfo> info = id.GetInfo();
+  shared_ptr<MwmInfo> const & info = id.GetInfo();
+  {
+    shared_lock<shared_mutex> lock(m_lock);
+    // Statuses are changed under the exclusive lock only, so the mwm can't be
+    // deregistered while it has references.
+    if (!id.IsAlive())
+      return nullptr;
 
-  // It's better to return valid "value pointer" even for "out-of-date" files,
-  // because they can be locked for a long time by other algos.
-  //if (!info->IsUpToDate())
-  //  return TMwmValuePtr();
+    // It's better to return valid "value pointer" even for "out-of-date" files,
+    // because they can be locked for a long time by other algos.
+    //if (!info->IsUpToDate())
+    //  return TMwmValuePtr();
 
-  ++info->m_numRefs;
+    ++info->m_numRefs;
 
-  // Search in cache.
-  for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
-  {
-    if (it->first == id)
+    // Search in cache.
+    auto & shard = GetCacheShard(id);
+    lock_guard<mutex> shardLock(shard.m_lock);
+    for (auto it = shard.m_cache.begin(); it != shard.m_cache.end(); ++it)
     {
-      unique_ptr<MwmValue> result = std::move(it->second);
-      m_cache.erase(it);
-      return result;
+      if (it->first == id)
+      {
+        unique_ptr<MwmValue> result = std::move(it->second);
+        shard.m_cache.erase(it);
+        --m_cacheCount;
+        return result;
+      }
     }
   }
 
@@ -303,21 +298,16 @@ unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
   {
     LOG(LERROR, ("Can't create MWMValue for", info->GetCountryName(), "Reason", ex.what()));
 
-    --info->m_numRefs;
-    DeregisterImpl(id, events);
+    WithEventLog([&](EventList & events)
+                 {
+                   --info->m_numRefs;
+                   DeregisterImpl(id, events);
+                 });
     return nullptr;
   }
 }
 
 void MwmSet::UnlockValue(MwmId const & id, unique_ptr<MwmValue> p)
-{
-  WithEventLog([&](EventList & events)
-               {
-                 UnlockValueImpl(id, std::move(p), events);
-               });
-}
-
-void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList & events)
 {
   ASSERT(id.IsAlive(), (id));
   ASSERT(p.get() != nullptr, ());
@@ -325,74 +315,100 @@ void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList
     return;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
-  ASSERT_GREATER(info->m_numRefs, 0, ());
-  --info->m_numRefs;
-  if (info->m_numRefs == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
-    VERIFY(DeregisterImpl(id, events), ());
-
-  if (info->IsUpToDate())
+  unique_ptr<MwmValue> evicted;
+  bool deregister = false;
   {
-    /// @todo Probably, it's better to store only "unique by id" free caches here.
-    /// But it's no obvious if we have many threads working with the single mwm.
+    shared_lock<shared_mutex> lock(m_lock);
+    ASSERT_GREATER(info->m_numRefs, 0, ());
+    deregister = --info->m_numRefs == 0 &&
+                 info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER;
 
-    m_cache.push_back(make_pair(id, std::move(p)));
-    if (m_cache.size() > m_cacheSize)
+    if (info->IsUpToDate())
     {
-      LOG(LDEBUG, ("MwmValue max cache size reached! Added", id, "removed", m_cache.front().first));
-      ASSERT_EQUAL(m_cache.size(), m_cacheSize + 1, ());
-      m_cache.pop_front();
+      /// @todo Probably, it's better to store only "unique by id" free caches here.
+      /// But it's no obvious if we have many threads working with the single mwm.
+
+      auto & shard = GetCacheShard(id);
+      lock_guard<mutex> shardLock(shard.m_lock);
+      shard.m_cache.push_back(make_pair(id, std::move(p)));
+      // The oldest value of the shard is evicted, so an mwm used by many threads
+      // may take the whole cache.
+      if (++m_cacheCount > m_cacheSize)
+      {
+        LOG(LDEBUG, ("MwmValue max cache size reached! Added", id, "removed",
+                     shard.m_cache.front().first));
+        evicted = std::move(shard.m_cache.front().second);
+        shard.m_cache.pop_front();
+        --m_cacheCount;
+      }
     }
   }
+
+  if (deregister)
+  {
+    // The mwm might be locked again after the shared lock was released.
+    WithEventLog([&](EventList & events)
+                 {
+                   if (info->m_numRefs == 0 &&
+                       info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
+                   {
+                     VERIFY(DeregisterImpl(id, events), ());
+                   }
+                 });
+  }
 }
 
 void MwmSet::Clear()
 {
-  lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  lock_guard<shared_mutex> lock(m_lock);
+  ClearCacheImpl();
   m_info.clear();
 }
 
 void MwmSet::ClearCache()
 {
-  lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  ClearCacheImpl();
 }
 
 MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) const
 {
-  lock_guard<mutex> lock(m_lock);
+  shared_lock<shared_mutex> lock(m_lock);
   return GetMwmIdByCountryFileImpl(countryFile);
 }
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleByCountryFile(CountryFile const & countryFile)
 {
-  MwmSet::MwmHandle handle;
-  WithEventLog([&](EventList & events)
-               {
-                 handle = GetMwmHandleByIdImpl(GetMwmIdByCountryFileImpl(countryFile), events);
-               });
-  return handle;
+  return GetMwmHandleById(GetMwmIdByCountryFile(countryFile));
 }
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleById(MwmId const & id)
-{
-  MwmSet::MwmHandle handle;
-  WithEventLog([&](EventList & events)
-               {
-                 handle = GetMwmHandleByIdImpl(id, events);
-               });
-  return handle;
-}
-
-MwmSet::MwmHandle MwmSet::GetMwmHandleByIdImpl(MwmId const & id, EventList & events)
 {
   unique_ptr<MwmValue> value;
   if (id.IsAlive())
-    value = LockValueImpl(id, events);
+    value = LockValue(id);
   return MwmHandle(*this, id, std::move(value));
 }
 
-void MwmSet::ClearCacheImpl(Cache::iterator beg, Cache::iterator end) { m_cache.erase(beg, end); }
+MwmSet::CacheShard & MwmSet::GetCacheShard(MwmId const & id)
+{
+  static_assert(kCacheShardsCount == 16, "");
+  // Fibonacci hashing of the info address, as its lower bits are the same for all infos.
+  auto const key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(id.GetInfo().get()));
+  return m_cacheShards[(key * 0x9E3779B97F4A7C15ULL) >> 60];
+}
+
+void MwmSet::ClearCacheImpl()
+{
+  for (auto & shard : m_cacheShards)
+  {
+    Cache values;
+    {
+      lock_guard<mutex> shardLock(shard.m_lock);
+      m_cacheCount -= shard.m_cache.size();
+      values.swap(shard.m_cache);
+    }
+  }
+}
 
 void MwmSet::ClearCache(MwmId const & id)
 {
@@ -400,7 +416,12 @@ void MwmSet::ClearCache(MwmId const & id)
   {
     return (p.first == id);
   };
-  ClearCacheImpl(base::RemoveIfKeepValid(m_cache.begin(), m_cache.end(), sameId), m_cache.end());
+
+  auto & shard = GetCacheShard(id);
+  lock_guard<mutex> shardLock(shard.m_lock);
+  auto const it = base::RemoveIfKeepValid(shard.m_cache.begin(), shard.m_cache.end(), sameId);
+  m_cacheCount -= static_cast<size_t>(distance(it, shard.m_cache.end()));
+  shard.m_cache.erase(it, shard.m_cache.end());
 }
 
 // MwmValue ----------------------------------------------------------------------------------------
@@ -413,6 +434,7 @@ MwmValue::MwmValue(LocalCountryFile const & localFile)
 
 void MwmValue::SetTable(MwmInfoEx & info)
 {
+  lock_guard<mutex> lock(info.m_lock);
   m_table = info.m_table.lock();
   if (m_table)
     return;
@@ -421,6 +443,38 @@ void MwmValue::SetTable(MwmInfoEx & info)
   info.m_table = m_table;
 }
 
+void MwmValue::SetMappedFeatures(MwmInfoEx & info)
+{
+  lock_guard<mutex> lock(info.m_lock);
+  m_mappedFeatures = info.m_mappedFeatures.lock();
+  if (m_mappedFeatures)
+    return;
+
+  m_mappedFeatures = feature::MappedFeatures::Load(m_cont);
+  info.m_mappedFeatures = m_mappedFeatures;
+}
+
+ScaleIndex<ModelReaderPtr> const & MwmValue::GetScaleIndex()
+{
+  // No lock: the value is used through one MwmHandle, i.e. by one thread, at a time.
+  if (!m_scaleIndex)
+  {
+    m_scaleIndex =
+        make_unique<ScaleIndex<ModelReaderPtr>>(m_cont.GetReader(INDEX_FILE_TAG), m_factory);
+  }
+  return *m_scaleIndex;
+}
+
+feature::FeatureTypesTable const * MwmValue::GetTypesTable()
+{
+  if (!m_typesTableLoaded)
+  {
+    m_typesTable = feature::FeatureTypesTable::Load(m_cont);
+    m_typesTableLoaded = true;
+  }
+  return m_typesTable.get();
+}
+
 string DebugPrint(MwmSet::RegResult result)
 {
   switch (result)
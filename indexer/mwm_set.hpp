@@ -1,6 +1,7 @@
 #pragma once
 #include "indexer/data_factory.hpp"
 #include "indexer/house_to_street_iface.hpp"
+#include "indexer/scale_index.hpp"
 
 #include "platform/local_country_file.hpp"
 #include "platform/mwm_version.hpp"
@@ -12,16 +13,23 @@
 
 #include "defines.hpp"
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
-namespace feature { class FeaturesOffsetsTable; }
+namespace feature
+{
+class FeaturesOffsetsTable;
+class FeatureTypesTable;
+class MappedFeatures;
+}  // namespace feature
 
 /// Information about stored mwm.
 class MwmInfo
@@ -88,7 +96,7 @@ protected:
 
   platform::LocalCountryFile m_file;  ///< Path to the mwm file.
   std::atomic<Status> m_status;       ///< Current country status.
-  uint32_t m_numRefs;                 ///< Number of active handles.
+  std::atomic<uint32_t> m_numRefs;    ///< Number of active handles.
 };
 
 class MwmInfoEx : public MwmInfo
@@ -102,10 +110,12 @@ private:
   // MwmSet's cache. We can't use shared_ptr because of offsets table
   // must be removed as soon as the last corresponding MwmValue is
   // destroyed. Also, note that this value must be used and modified
-  // only in MwmValue::SetTable() method, which, in turn, is called
-  // only in the MwmSet critical section, protected by a lock.  So,
-  // there's an implicit synchronization on this field.
+  // only in MwmValue::SetTable() method under |m_lock|, because
+  // values of the same mwm may be created by different threads.
+  std::mutex m_lock;
   std::weak_ptr<feature::FeaturesOffsetsTable> m_table;
+  // The same as |m_table|, used only in MwmValue::SetMappedFeatures().
+  std::weak_ptr<feature::MappedFeatures> m_mappedFeatures;
 };
 
 class MwmValue;
@@ -316,7 +326,17 @@ protected:
 private:
   using Cache = std::deque<std::pair<MwmId, std::unique_ptr<MwmValue>>>;
 
-  // This is the only valid way to take |m_lock| and use *Impl()
+  // Free values are kept in shards selected by MwmId, so handles of different mwms
+  // are acquired and released under different mutexes.
+  struct CacheShard
+  {
+    std::mutex m_lock;
+    Cache m_cache;
+  };
+
+  static size_t constexpr kCacheShardsCount = 16;
+
+  // This is the only valid way to take |m_lock| exclusively and use *Impl()
   // functions. The reason is that event processing requires
   // triggering of observers, but it's generally unsafe to call
   // user-provided functions while |m_lock| is taken, as it may lead
@@ -328,7 +348,7 @@ private:
   {
     EventList events;
     {
-      std::lock_guard<std::mutex> lock(m_lock);
+      std::lock_guard<std::shared_mutex> lock(m_lock);
       fn(events);
     }
     ProcessEventList(events);
@@ -340,23 +360,23 @@ private:
   // Triggers observers on each event in |events|.
   void ProcessEventList(EventList & events);
 
-  /// @precondition This function is always called under mutex m_lock.
-  MwmHandle GetMwmHandleByIdImpl(MwmId const & id, EventList & events);
-
+  // Values are locked and unlocked under the shared |m_lock|, so handles may be
+  // acquired by many threads simultaneously. A new value is created without any lock.
   std::unique_ptr<MwmValue> LockValue(MwmId const & id);
-  std::unique_ptr<MwmValue> LockValueImpl(MwmId const & id, EventList & events);
   void UnlockValue(MwmId const & id, std::unique_ptr<MwmValue> p);
-  void UnlockValueImpl(MwmId const & id, std::unique_ptr<MwmValue> p, EventList & events);
 
-  /// Do the cleaning for [beg, end) without acquiring the mutex.
-  /// @precondition This function is always called under mutex m_lock.
-  void ClearCacheImpl(Cache::iterator beg, Cache::iterator end);
+  CacheShard & GetCacheShard(MwmId const & id);
 
-  Cache m_cache;
+  /// Removes all the values from the cache.
+  void ClearCacheImpl();
+
+  std::array<CacheShard, kCacheShardsCount> m_cacheShards;
+  // Number of values in all shards.
+  std::atomic<size_t> m_cacheCount{0};
   size_t const m_cacheSize;
 
 protected:
-  /// @precondition This function is always called under mutex m_lock.
+  /// Removes values of |id| from the cache.
   void ClearCache(MwmId const & id);
 
   /// Find mwm with a given name.
@@ -365,7 +385,9 @@ protected:
 
   std::map<std::string, std::vector<std::shared_ptr<MwmInfo>>> m_info;
 
-  mutable std::mutex m_lock;
+  // Protects |m_info| and statuses of mwms. It's taken exclusively to register and
+  // deregister mwms, and shared to acquire and release handles.
+  mutable std::shared_mutex m_lock;
 
 private:
   base::ObserverListSafe<Observer> m_observers;
@@ -379,11 +401,26 @@ public:
   platform::LocalCountryFile const m_file;
 
   std::shared_ptr<feature::FeaturesOffsetsTable> m_table;
+  // Memory-mapped features records, may be empty. See DataSource::SetFeaturesMapping().
+  std::shared_ptr<feature::MappedFeatures> m_mappedFeatures;
   std::unique_ptr<indexer::MetadataDeserializer> m_metaDeserializer;
   std::unique_ptr<HouseToStreetTable> m_house2street, m_house2place;
+  std::unique_ptr<ScaleIndex<ModelReaderPtr>> m_scaleIndex;
+  std::shared_ptr<feature::FeatureTypesTable> m_typesTable;
+  bool m_typesTableLoaded = false;
 
   explicit MwmValue(platform::LocalCountryFile const & localFile);
   void SetTable(MwmInfoEx & info);
+  void SetMappedFeatures(MwmInfoEx & info);
+
+  // Geometry index which is created on the first call and kept with the value, so the
+  // top levels of its trees are read from the file once. Neither the creation nor queries
+  // of the index are synchronized. It's fine because a value is owned by a single MwmHandle
+  // at a time, see MwmSet::LockValue(), so the index must not be shared between threads
+  // apart from the handle.
+  ScaleIndex<ModelReaderPtr> const & GetScaleIndex();
+  // Types table which is loaded on the first call, nullptr if the mwm has no such section.
+  feature::FeatureTypesTable const * GetTypesTable();
 
   feature::DataHeader const & GetHeader() const  { return m_factory.GetHeader(); }
   feature::RegionData const & GetRegionData() const { return m_factory.GetRegionData(); }
@@ -6,6 +6,7 @@
 #include "coding/var_serial_vector.hpp"
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -63,6 +64,20 @@ public:
     }
   }
 
+  // Same as ForEachInIntervalAndScale() for all |intervals| at once, but each node of the
+  // index trees is read only once. Values are passed to |fn| bucket by bucket.
+  template <typename Intervals>
+  void ForEachInIntervalsAndScale(Intervals const & intervals, int scale,
+                                  std::function<void(uint64_t, uint32_t)> const & fn) const
+  {
+    auto const scaleBucket = BucketByScale(scale);
+    if (scaleBucket < m_IndexForScale.size())
+    {
+      for (size_t i = 0; i <= scaleBucket; ++i)
+        m_IndexForScale[i]->ForEach(fn, intervals);
+    }
+  }
+
 private:
   std::vector<std::unique_ptr<IntervalIndex<Reader, uint32_t>>> m_IndexForScale;
 };
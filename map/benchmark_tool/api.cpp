@@ -1,15 +1,37 @@
 #include "map/benchmark_tool/api.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <new>
 #include <numeric>
 
 using namespace std;
 
+namespace
+{
+atomic<uint64_t> g_allocations{0};
+}  // namespace
+
+// Counts allocations of the whole tool, see AllResult::m_allocations.
+void * operator new(size_t size)
+{
+  g_allocations.fetch_add(1, memory_order_relaxed);
+  if (void * p = malloc(size == 0 ? 1 : size))
+    return p;
+  throw bad_alloc();
+}
+
+void operator delete(void * p) noexcept { free(p); }
+void operator delete(void * p, size_t) noexcept { free(p); }
+
 namespace bench
 {
+uint64_t GetAllocationsCount() { return g_allocations.load(memory_order_relaxed); }
+
 void Result::PrintAllTimes()
 {
   sort(m_time.begin(), m_time.end());
@@ -51,6 +73,34 @@ void AllResult::Print()
     cout << "TOTAL[ idx:" << m_all - m_reading.m_all <<
             " decoding:" << m_reading.m_all <<
             " summ:" << m_all << " ]" << endl;
+    cout << setprecision(2);
+    cout << "FEATURES[ count:" << m_features <<
+            " per second:" << (m_all > 0.0 ? m_features / m_all : 0.0) <<
+            " allocations per 1000 features:" <<
+            (m_features != 0 ? 1000.0 * m_allocations / m_features : 0.0) << " ]" << endl;
   }
 }
+
+void ReadAmplificationResult::Print()
+{
+  auto const print = [](string const & name, ReadAmplification const & r)
+  {
+    cout << name << "[ needed:" << r.m_bytes << " pages:" << r.m_pagesBytes <<
+            " amplification:" << r.Get() << " ]" << endl;
+  };
+
+  cout << fixed << setprecision(2);
+  print("DAT", m_dat);
+  print("GEOM", m_geom);
+  print("TRG", m_trg);
+}
+
+void OffsetsTableResult::Print()
+{
+  cout << fixed << setprecision(2);
+  cout << "OFFSETS[ features:" << m_features << " ] ";
+  cout << "NS PER LOOKUP[ sequential:" << m_sequential << " random:" << m_random <<
+          " sorted:" << m_sortedSingle << " sorted batch:" << m_sortedBatch <<
+          " by offset:" << m_byOffset << " ]" << endl;
+}
 }  // namespace bench
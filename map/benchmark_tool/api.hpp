@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -41,8 +42,58 @@ namespace bench
 
     Result m_reading;
     double m_all = 0.0;
+    uint64_t m_features = 0;
+    uint64_t m_allocations = 0;
   };
 
-  /// @param[in] count number of times to run benchmark
-  void RunFeaturesLoadingBenchmark(std::string filePath, std::pair<int, int> scaleR, AllResult & res);
+  // Bytes of a section needed to draw viewports and bytes of the 4K pages read to get them.
+  struct ReadAmplification
+  {
+    double Get() const { return m_bytes == 0 ? 0.0 : static_cast<double>(m_pagesBytes) / m_bytes; }
+
+    uint64_t m_bytes = 0;
+    uint64_t m_pagesBytes = 0;
+  };
+
+  class ReadAmplificationResult
+  {
+  public:
+    void Print();
+
+    ReadAmplification m_dat;
+    ReadAmplification m_geom;
+    ReadAmplification m_trg;
+  };
+
+  // Nanoseconds per lookup of the features offsets table.
+  class OffsetsTableResult
+  {
+  public:
+    void Print();
+
+    uint64_t m_features = 0;
+    double m_sequential = 0.0;
+    double m_random = 0.0;
+    double m_sortedSingle = 0.0;
+    double m_sortedBatch = 0.0;
+    double m_byOffset = 0.0;
+  };
+
+  /// @return number of heap allocations made by the process so far.
+  uint64_t GetAllocationsCount();
+
+  /// @param[in] mapFeatures read features directly from the memory-mapped mwm
+  /// @param[in] readByIds collect ids of features of a viewport first and read features
+  ///                      by ids, as the renderer does, instead of reading them from the index
+  void RunFeaturesLoadingBenchmark(std::string filePath, std::pair<int, int> scaleR,
+                                   bool mapFeatures, bool readByIds, AllResult & res);
+
+  /// Counts pages of the features and the best geometry sections touched by each viewport
+  /// of the features loading benchmark. Pages are counted from the beginning of a section.
+  void RunReadAmplificationReport(std::string filePath, std::pair<int, int> scaleRange,
+                                  ReadAmplificationResult & res);
+
+  /// Measures lookups of offsets by sequential and random feature ids, lookups of sorted
+  /// batches of random ids one by one and at once, and lookups of ids by offsets.
+  void RunOffsetsTableBenchmark(std::string filePath, OffsetsTableResult & res);
 }  // namespace bench
@@ -3,6 +3,7 @@
 #include "map/features_fetcher.hpp"
 
 #include "indexer/feature_visibility.hpp"
+#include "indexer/features_offsets_table.hpp"
 #include "indexer/scales.hpp"
 
 #include "platform/platform.hpp"
@@ -11,6 +12,10 @@
 #include "base/macros.hpp"
 #include "base/timer.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -32,6 +37,7 @@ namespace
     }
 
     bool IsEmpty() const { return m_count == 0; }
+    size_t GetCount() const { return m_count; }
 
     void operator()(FeatureType & ft)
     {
@@ -60,16 +66,16 @@ namespace
     int m_scale = 0;
   };
 
-  void RunBenchmark(FeaturesFetcher const & src, m2::RectD const & rect,
-                    pair<int, int> const & scaleRange, AllResult & res)
+  // Calls |fn| for the viewports of the recursive subdivision of |rect| for scales from
+  // |scaleRange|. A viewport is divided while |fn| finds features in it.
+  template <typename Fn>
+  void ForEachViewport(m2::RectD const & rect, pair<int, int> const & scaleRange, Fn && fn)
   {
     ASSERT_LESS_OR_EQUAL(scaleRange.first, scaleRange.second, ());
 
     vector<m2::RectD> rects;
     rects.push_back(rect);
 
-    Accumulator acc(res.m_reading);
-
     while (!rects.empty())
     {
       m2::RectD const r = rects.back();
@@ -78,15 +84,7 @@ namespace
       bool doDivide = true;
       int const scale = scales::GetScaleLevel(r);
       if (scale >= scaleRange.first)
-      {
-        acc.Reset(scale);
-
-        base::Timer timer;
-        src.ForEachFeature(r, acc, scale);
-        res.Add(timer.ElapsedSeconds());
-
-        doDivide = !acc.IsEmpty();
-      }
+        doDivide = fn(r, scale);
 
       if (doDivide && scale < scaleRange.second)
       {
@@ -97,28 +95,235 @@ namespace
       }
     }
   }
+
+  void RunBenchmark(FeaturesFetcher const & src, m2::RectD const & rect,
+                    pair<int, int> const & scaleRange, bool readByIds, AllResult & res)
+  {
+    Accumulator acc(res.m_reading);
+    vector<FeatureID> ids;
+
+    ForEachViewport(rect, scaleRange, [&](m2::RectD const & r, int scale)
+    {
+      acc.Reset(scale);
+
+      auto const allocations = GetAllocationsCount();
+      base::Timer timer;
+      if (readByIds)
+      {
+        ids.clear();
+        src.ForEachFeatureID(r, [&ids](FeatureID const & id) { ids.push_back(id); }, scale);
+        sort(ids.begin(), ids.end());
+        auto readFn = ref(acc);
+        src.ReadFeatures(readFn, ids);
+      }
+      else
+      {
+        src.ForEachFeature(r, ref(acc), scale);
+      }
+      res.Add(timer.ElapsedSeconds());
+      res.m_allocations += GetAllocationsCount() - allocations;
+      res.m_features += acc.GetCount();
+
+      return !acc.IsEmpty();
+    });
+  }
+
+  // Bytes of a section needed for a viewport and bytes of the pages containing them.
+  class SectionPages
+  {
+  public:
+    void Add(uint64_t offset, uint64_t size)
+    {
+      if (size == 0)
+        return;
+
+      m_bytes += size;
+      for (uint64_t page = offset / kPageSize; page <= (offset + size - 1) / kPageSize; ++page)
+        m_pages.insert(page);
+    }
+
+    // Accumulates the viewport stats to |res| and starts a new viewport.
+    void Flush(ReadAmplification & res)
+    {
+      res.m_bytes += m_bytes;
+      res.m_pagesBytes += m_pages.size() * kPageSize;
+      m_bytes = 0;
+      m_pages.clear();
+    }
+
+  private:
+    static uint64_t constexpr kPageSize = 4096;
+
+    uint64_t m_bytes = 0;
+    set<uint64_t> m_pages;
+  };
+
+  bool RegisterForBenchmark(FeaturesFetcher & src, string fileName, bool mapFeatures,
+                            pair<int, int> & scaleRange, MwmSet::MwmId & id)
+  {
+    base::GetNameFromFullPath(fileName);
+    base::GetNameWithoutExt(fileName);
+
+    src.GetDataSource().SetFeaturesMapping(mapFeatures);
+    auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
+    if (r.second != MwmSet::RegResult::Success)
+      return false;
+
+    uint8_t const minScale = r.first.GetInfo()->m_minScale;
+    uint8_t const maxScale = r.first.GetInfo()->m_maxScale;
+    if (minScale > scaleRange.first)
+      scaleRange.first = minScale;
+    if (maxScale < scaleRange.second)
+      scaleRange.second = maxScale;
+
+    id = r.first;
+    return scaleRange.first <= scaleRange.second;
+  }
 }
 
-void RunFeaturesLoadingBenchmark(string fileName, pair<int, int> scaleRange, AllResult & res)
+void RunFeaturesLoadingBenchmark(string fileName, pair<int, int> scaleRange, bool mapFeatures,
+                                 bool readByIds, AllResult & res)
 {
-  base::GetNameFromFullPath(fileName);
-  base::GetNameWithoutExt(fileName);
+  FeaturesFetcher src;
+  MwmSet::MwmId id;
+  if (!RegisterForBenchmark(src, std::move(fileName), mapFeatures, scaleRange, id))
+    return;
+
+  RunBenchmark(src, id.GetInfo()->m_bordersRect, scaleRange, readByIds, res);
+}
 
+void RunReadAmplificationReport(string fileName, pair<int, int> scaleRange,
+                                ReadAmplificationResult & res)
+{
   FeaturesFetcher src;
-  auto const r = src.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
-  if (r.second != MwmSet::RegResult::Success)
+  MwmSet::MwmId id;
+  if (!RegisterForBenchmark(src, std::move(fileName), false /* mapFeatures */, scaleRange, id))
     return;
 
-  uint8_t const minScale = r.first.GetInfo()->m_minScale;
-  uint8_t const maxScale = r.first.GetInfo()->m_maxScale;
-  if (minScale > scaleRange.first)
-    scaleRange.first = minScale;
-  if (maxScale < scaleRange.second)
-    scaleRange.second = maxScale;
+  auto const handle = src.GetDataSource().GetMwmHandleById(id);
+  auto const & value = *handle.GetValue();
+  auto const & header = value.GetHeader();
+  auto const table = feature::FeaturesOffsetsTable::Load(value.m_cont);
+
+  SectionPages dat, geom, trg;
+  ForEachViewport(id.GetInfo()->m_bordersRect, scaleRange, [&](m2::RectD const & r, int scale)
+  {
+    // Geometry of the first scale not less than the viewport's one is read for the viewport.
+    size_t scaleIndex = 0;
+    while (scaleIndex + 1 < header.GetScalesCount() && header.GetScale(scaleIndex) < scale)
+      ++scaleIndex;
+
+    bool found = false;
+    src.ForEachFeature(r, [&](FeatureType & ft)
+    {
+      found = true;
+
+      auto const index = ft.GetID().m_index;
+      auto const offset = table->GetFeatureOffset(index);
+      // The size of the last record is unknown, count only its first byte.
+      dat.Add(offset, index + 1 < table->size() ? table->GetFeatureOffset(index + 1) - offset : 1);
+
+      ft.ParseHeader2();
+      auto const geomStat = ft.GetOuterGeometryStats();
+      auto const trgStat = ft.GetOuterTrianglesStats();
+      for (size_t i = scaleIndex; i < header.GetScalesCount(); ++i)
+      {
+        if (geomStat.m_sizes[i] != 0)
+        {
+          geom.Add(geomStat.m_offsets[i], geomStat.m_sizes[i]);
+          break;
+        }
+      }
+      for (size_t i = scaleIndex; i < header.GetScalesCount(); ++i)
+      {
+        if (trgStat.m_sizes[i] != 0)
+        {
+          trg.Add(trgStat.m_offsets[i], trgStat.m_sizes[i]);
+          break;
+        }
+      }
+    }, scale);
+
+    dat.Flush(res.m_dat);
+    geom.Flush(res.m_geom);
+    trg.Flush(res.m_trg);
+    return found;
+  });
+}
 
-  if (scaleRange.first > scaleRange.second)
+void RunOffsetsTableBenchmark(string fileName, OffsetsTableResult & res)
+{
+  FeaturesFetcher src;
+  MwmSet::MwmId id;
+  pair<int, int> scaleRange(0, scales::GetUpperScale());
+  if (!RegisterForBenchmark(src, std::move(fileName), false /* mapFeatures */, scaleRange, id))
     return;
 
-  RunBenchmark(src, r.first.GetInfo()->m_bordersRect, scaleRange, res);
+  auto const handle = src.GetDataSource().GetMwmHandleById(id);
+  auto const table = feature::FeaturesOffsetsTable::Load(handle.GetValue()->m_cont);
+  auto const count = static_cast<uint32_t>(table->size());
+  if (count == 0)
+    return;
+
+  // Ids of features of a viewport are sorted before reading, batches imitate viewports.
+  size_t constexpr kBatchSize = 1000;
+  size_t const lookupsCount = max<size_t>(count, 100 * kBatchSize);
+  mt19937 rng(0);
+  uniform_int_distribution<uint32_t> distribution(0, count - 1);
+  vector<uint32_t> indices(lookupsCount);
+  for (auto & index : indices)
+    index = distribution(rng);
+
+  auto const nsPerLookup = [](base::Timer const & timer, size_t lookups) {
+    return timer.ElapsedNanoseconds() / static_cast<double>(lookups);
+  };
+
+  // Results are accumulated, so lookups aren't optimized out.
+  volatile uint64_t sum = 0;
+  res.m_features = count;
+
+  base::Timer timer;
+  for (uint32_t i = 0; i < count; ++i)
+    sum += table->GetFeatureOffset(i);
+  res.m_sequential = nsPerLookup(timer, count);
+
+  timer.Reset();
+  for (auto const index : indices)
+    sum += table->GetFeatureOffset(index);
+  res.m_random = nsPerLookup(timer, lookupsCount);
+
+  vector<uint32_t> offsets(lookupsCount);
+  for (size_t i = 0; i < lookupsCount; ++i)
+    offsets[i] = table->GetFeatureOffset(indices[i]);
+
+  for (size_t i = 0; i < lookupsCount; i += kBatchSize)
+    sort(indices.begin() + i, indices.begin() + min(i + kBatchSize, lookupsCount));
+
+  // A record is read with its end, so both the offset and the next offset are looked up.
+  timer.Reset();
+  for (auto const index : indices)
+  {
+    sum += table->GetFeatureOffset(index);
+    if (index + 1 < count)
+      sum += table->GetFeatureOffset(index + 1);
+  }
+  res.m_sortedSingle = nsPerLookup(timer, lookupsCount);
+
+  vector<uint32_t> batch;
+  vector<pair<uint32_t, uint32_t>> ranges;
+  timer.Reset();
+  for (size_t i = 0; i < lookupsCount; i += kBatchSize)
+  {
+    batch.assign(indices.begin() + i, indices.begin() + min(i + kBatchSize, lookupsCount));
+    table->GetFeatureRanges(batch, ranges);
+    for (auto const & r : ranges)
+      sum += r.first + r.second;
+  }
+  res.m_sortedBatch = nsPerLookup(timer, lookupsCount);
+
+  timer.Reset();
+  for (auto const offset : offsets)
+    sum += table->GetFeatureIndexbyOffset(offset);
+  res.m_byOffset = nsPerLookup(timer, lookupsCount);
 }
 }  // namespace bench
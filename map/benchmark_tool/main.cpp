@@ -13,6 +13,11 @@ DEFINE_string(input, "", "MWM file name in the data directory");
 DEFINE_int32(lowS, 10, "Low processing scale");
 DEFINE_int32(highS, 17, "High processing scale");
 DEFINE_bool(print_scales, false, "Print geometry scales for MWM and exit");
+DEFINE_bool(map_features, false, "Read features directly from the memory-mapped MWM");
+DEFINE_bool(read_by_ids, false, "Read features of a viewport by their ids, as the renderer does");
+DEFINE_bool(read_amplification, false,
+            "Print the ratio of bytes of touched 4K pages to needed bytes of features and geometry sections");
+DEFINE_bool(offsets_table, false, "Measure lookups of feature offsets by feature ids and back");
 
 int main(int argc, char ** argv)
 {
@@ -41,8 +46,25 @@ int main(int argc, char ** argv)
   {
     using namespace bench;
 
+    if (FLAGS_read_amplification)
+    {
+      ReadAmplificationResult res;
+      RunReadAmplificationReport(FLAGS_input, make_pair(FLAGS_lowS, FLAGS_highS), res);
+      res.Print();
+      return 0;
+    }
+
+    if (FLAGS_offsets_table)
+    {
+      OffsetsTableResult res;
+      RunOffsetsTableBenchmark(FLAGS_input, res);
+      res.Print();
+      return 0;
+    }
+
     AllResult res;
-    RunFeaturesLoadingBenchmark(FLAGS_input, make_pair(FLAGS_lowS, FLAGS_highS), res);
+    RunFeaturesLoadingBenchmark(FLAGS_input, make_pair(FLAGS_lowS, FLAGS_highS),
+                                FLAGS_map_features, FLAGS_read_by_ids, res);
 
     res.Print();
   }
@@ -326,7 +326,7 @@ Framework::Framework(FrameworkParams const & params, bool loadMaps)
   InitCountryInfoGetter();
   LOG(LDEBUG, ("Country info getter initialized"));
 
-  InitSearchAPI(params.m_numSearchAPIThreads);
+  InitSearchAPI(params.m_numSearchAPIThreads, params.m_shareSearchDecodedCenters);
   LOG(LDEBUG, ("Search API initialized, part 1"));
 
   m_bmManager = make_unique<BookmarkManager>(BookmarkManager::Callbacks(
@@ -1193,7 +1193,7 @@ void Framework::InitCountryInfoGetter()
   m_infoGetter->SetAffiliations(m_storage.GetAffiliations());
 }
 
-void Framework::InitSearchAPI(size_t numThreads)
+void Framework::InitSearchAPI(size_t numThreads, bool shareDecodedCenters)
 {
   ASSERT(!m_searchAPI.get(), ("InitSearchAPI() must be called only once."));
   ASSERT(m_infoGetter.get(), ());
@@ -1201,7 +1201,8 @@ void Framework::InitSearchAPI(size_t numThreads)
   {
     m_searchAPI =
         make_unique<SearchAPI>(m_featuresFetcher.GetDataSource(), m_storage, *m_infoGetter,
-                               numThreads, static_cast<SearchAPI::Delegate &>(*this));
+                               numThreads, shareDecodedCenters,
+                               static_cast<SearchAPI::Delegate &>(*this));
   }
   catch (RootException const & e)
   {
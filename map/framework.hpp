@@ -101,6 +101,8 @@ struct FrameworkParams
 {
   bool m_enableDiffs = true;
   size_t m_numSearchAPIThreads = 1;
+  // See search::Engine::Params::m_shareDecodedCenters.
+  bool m_shareSearchDecodedCenters = false;
 
   FrameworkParams() = default;
   FrameworkParams(bool enableDiffs)
@@ -442,7 +444,7 @@ public:
 
 private:
   void InitCountryInfoGetter();
-  void InitSearchAPI(size_t numThreads);
+  void InitSearchAPI(size_t numThreads, bool shareDecodedCenters);
 
   bool m_connectToGpsTrack; // need to connect to tracker when Drape is being constructed
 
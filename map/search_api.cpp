@@ -68,6 +68,13 @@ bookmarks::GroupId KmlGroupIdToSearchGroupId(kml::MarkGroupId id)
   return base::asserted_cast<bookmarks::GroupId>(id);
 }
 
+Engine::Params MakeEngineParams(size_t numThreads, bool shareDecodedCenters)
+{
+  Engine::Params params(languages::GetCurrentTwine() /* locale */, numThreads);
+  params.m_shareDecodedCenters = shareDecodedCenters;
+  return params;
+}
+
 kml::MarkId SearchBookmarkIdToKmlMarkId(bookmarks::Id id) { return static_cast<kml::MarkId>(id); }
 
 void AppendBookmarkIdDocs(vector<BookmarkInfo> const & marks, vector<BookmarkIdDoc> & result)
@@ -140,13 +147,13 @@ private:
 
 SearchAPI::SearchAPI(DataSource & dataSource, storage::Storage const & storage,
                      storage::CountryInfoGetter const & infoGetter, size_t numThreads,
-                     Delegate & delegate)
+                     bool shareDecodedCenters, Delegate & delegate)
   : m_dataSource(dataSource)
   , m_storage(storage)
   , m_infoGetter(infoGetter)
   , m_delegate(delegate)
   , m_engine(m_dataSource, GetDefaultCategories(), m_infoGetter,
-             Engine::Params(languages::GetCurrentTwine() /* locale */, numThreads))
+             MakeEngineParams(numThreads, shareDecodedCenters))
 {
 }
 
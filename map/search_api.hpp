@@ -64,7 +64,8 @@ public:
   };
 
   SearchAPI(DataSource & dataSource, storage::Storage const & storage,
-            storage::CountryInfoGetter const & infoGetter, size_t numThreads, Delegate & delegate);
+            storage::CountryInfoGetter const & infoGetter, size_t numThreads,
+            bool shareDecodedCenters, Delegate & delegate);
   virtual ~SearchAPI() = default;
 
   void OnViewportChanged(m2::RectD const & viewport);
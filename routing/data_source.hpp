@@ -4,6 +4,7 @@
 #include "routing_common/num_mwm_id.hpp"
 
 #include "indexer/data_source.hpp"
+#include "indexer/feature_types_table.hpp"
 
 #include "base/lru_cache.hpp"
 
@@ -135,5 +136,21 @@ public:
     /// @todo Should we also retrieve "modified" features here?
     return ptr->GetOriginalFeature(id.m_index);
   }
+
+  /// Reads types from the types table of the mwm without reading the feature, if the table exists.
+  bool GetFeatureTypes(FeatureID const & id, feature::TypesHolder & types)
+  {
+    if (auto const * table = GetHandle(id.m_mwmId).GetValue()->GetTypesTable())
+    {
+      types = table->GetTypes(id.m_index);
+      return true;
+    }
+
+    auto ft = GetFeature(id);
+    if (!ft)
+      return false;
+    types = feature::TypesHolder(*ft);
+    return true;
+  }
 };
 } // namespace routing
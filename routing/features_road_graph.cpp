@@ -183,12 +183,8 @@ FeaturesRoadGraphBase::FindRoads(m2::RectD const & rect, IsGoodFeatureFn const &
 
 void FeaturesRoadGraphBase::GetFeatureTypes(FeatureID const & featureId, feature::TypesHolder & types) const
 {
-  auto ft = m_dataSource.GetFeature(featureId);
-  if (!ft)
-    return;
-
-  ASSERT_EQUAL(ft->GetGeomType(), feature::GeomType::Line, ());
-  types = feature::TypesHolder(*ft);
+  if (m_dataSource.GetFeatureTypes(featureId, types))
+    ASSERT_EQUAL(types.GetGeomType(), feature::GeomType::Line, ());
 }
 
 void FeaturesRoadGraphBase::GetJunctionTypes(geometry::PointWithAltitude const & junction,
@@ -58,15 +58,13 @@ void IndexRoadGraph::GetEdgeTypes(Edge const & edge, feature::TypesHolder & type
     return;
   }
 
-  auto ft = m_dataSource.GetFeature(featureId);
-  if (!ft)
+  if (!m_dataSource.GetFeatureTypes(featureId, types))
   {
     LOG(LERROR, ("Can't load types for feature", featureId));
     return;
   }
 
-  ASSERT_EQUAL(ft->GetGeomType(), feature::GeomType::Line, ());
-  types = feature::TypesHolder(*ft);
+  ASSERT_EQUAL(types.GetGeomType(), feature::GeomType::Line, ());
 }
 
 void IndexRoadGraph::GetJunctionTypes(geometry::PointWithAltitude const & junction,
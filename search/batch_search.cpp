@@ -0,0 +1,156 @@
+#include "search/batch_search.hpp"
+
+#include "search/engine.hpp"
+#include "search/result.hpp"
+
+#include "base/assert.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+namespace search
+{
+using namespace std;
+
+namespace
+{
+pair<int64_t, int64_t> GetCell(m2::PointD const & p, double cellSize)
+{
+  return {static_cast<int64_t>(floor(p.x / cellSize)), static_cast<int64_t>(floor(p.y / cellSize))};
+}
+}  // namespace
+
+// BatchSearch::Stats ------------------------------------------------------------------------------
+double BatchSearch::Stats::GetQueriesPerSecond() const
+{
+  if (m_elapsedSeconds <= 0.0)
+    return 0.0;
+  return static_cast<double>(m_numQueries) / m_elapsedSeconds;
+}
+
+// BatchSearch -------------------------------------------------------------------------------------
+BatchSearch::BatchSearch(Engine & engine, Params const & params)
+  : m_engine(engine), m_params(params)
+{
+  CHECK_GREATER(m_params.m_cellSize, 0.0, ());
+  CHECK_GREATER(m_params.m_maxGroupSize, 0, ());
+  if (m_params.m_maxGroupsInFlight == 0)
+    m_params.m_maxGroupsInFlight = 2 * max<size_t>(m_engine.GetNumThreads(), 1);
+}
+
+BatchSearch::Stats BatchSearch::Run(vector<Query> const & queries, OnResults const & onResults)
+{
+  base::Timer timer;
+
+  Stats stats;
+  stats.m_numQueries = queries.size();
+
+  mutex mu;
+  condition_variable cv;
+  size_t groupsInFlight = 0;
+  size_t numCancelled = 0;
+
+  auto const groups = MakeGroups(queries, m_params.m_cellSize, m_params.m_maxGroupSize);
+  stats.m_numGroups = groups.size();
+
+  for (auto const & group : groups)
+  {
+    vector<SearchParams> batch;
+    batch.reserve(group.size());
+    for (size_t const i : group)
+    {
+      auto const & query = queries[i];
+
+      SearchParams params;
+      params.m_query = query.m_query;
+      params.m_inputLocale = m_params.m_locale;
+      params.m_viewport = query.m_viewport;
+      params.m_position = query.m_position;
+      params.m_mode = Mode::Everywhere;
+      params.m_maxNumResults = m_params.m_maxNumResults;
+      // Intermediate results are useless here, emit everything at once.
+      params.m_batchSize = m_params.m_maxNumResults;
+      params.m_timeout = m_params.m_timeout;
+      params.m_useDebugInfo = false;
+      params.m_onResults = [i, &onResults, &mu, &numCancelled](Results const & results)
+      {
+        if (!results.IsEndMarker())
+          return;
+        if (results.IsEndedCancelled())
+        {
+          lock_guard<mutex> lock(mu);
+          ++numCancelled;
+        }
+        onResults(i, results);
+      };
+      batch.push_back(std::move(params));
+    }
+
+    {
+      unique_lock<mutex> lock(mu);
+      cv.wait(lock, [&]() { return groupsInFlight < m_params.m_maxGroupsInFlight; });
+      ++groupsInFlight;
+    }
+
+    m_engine.SearchBatch(std::move(batch), [&mu, &cv, &groupsInFlight]()
+    {
+      lock_guard<mutex> lock(mu);
+      CHECK_GREATER(groupsInFlight, 0, ());
+      --groupsInFlight;
+      cv.notify_one();
+    });
+  }
+
+  {
+    unique_lock<mutex> lock(mu);
+    cv.wait(lock, [&]() { return groupsInFlight == 0; });
+    stats.m_numCancelled = numCancelled;
+  }
+
+  stats.m_elapsedSeconds = timer.ElapsedSeconds();
+  return stats;
+}
+
+// static
+vector<vector<size_t>> BatchSearch::MakeGroups(vector<Query> const & queries, double cellSize,
+                                               size_t maxGroupSize)
+{
+  CHECK_GREATER(cellSize, 0.0, ());
+  CHECK_GREATER(maxGroupSize, 0, ());
+
+  vector<pair<pair<int64_t, int64_t>, size_t>> cells;
+  cells.reserve(queries.size());
+  for (size_t i = 0; i < queries.size(); ++i)
+    cells.emplace_back(GetCell(queries[i].m_viewport.Center(), cellSize), i);
+  sort(cells.begin(), cells.end());
+
+  vector<vector<size_t>> groups;
+  for (size_t i = 0; i < cells.size(); ++i)
+  {
+    if (i == 0 || cells[i].first != cells[i - 1].first || groups.back().size() == maxGroupSize)
+      groups.emplace_back();
+    groups.back().push_back(cells[i].second);
+  }
+  return groups;
+}
+
+string DebugPrint(BatchSearch::Stats const & stats)
+{
+  ostringstream os;
+  os << "BatchSearch::Stats [";
+  os << "queries: " << stats.m_numQueries << ", ";
+  os << "groups: " << stats.m_numGroups << ", ";
+  os << "cancelled: " << stats.m_numCancelled << ", ";
+  os << "elapsed: " << stats.m_elapsedSeconds << "s, ";
+  os << "queries/s: " << stats.GetQueriesPerSecond();
+  os << "]";
+  return os.str();
+}
+}  // namespace search
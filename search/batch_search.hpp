@@ -0,0 +1,94 @@
+#pragma once
+
+#include "search/search_params.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace search
+{
+class Engine;
+class Results;
+
+// Runs a large number of independent queries (e.g. rows of an address file
+// to be geocoded) through the search engine.
+//
+// Queries are grouped by the cell of the center of their viewport and every
+// group is posted to the engine as a single batch, so all queries of a group
+// are processed by the same processor and share its per-mwm caches. The number
+// of groups in flight is bounded, so the memory used by pending requests does
+// not depend on the number of queries.
+//
+// NOTE: this class is NOT thread-safe, but Run() may be called many times.
+class BatchSearch
+{
+public:
+  struct Query
+  {
+    Query() = default;
+    Query(std::string const & query, m2::RectD const & viewport)
+      : m_query(query), m_viewport(viewport)
+    {
+    }
+
+    std::string m_query;
+    m2::RectD m_viewport;
+    std::optional<m2::PointD> m_position;
+  };
+
+  struct Params
+  {
+    std::string m_locale = "en";
+    size_t m_maxNumResults = SearchParams::kDefaultNumResultsEverywhere;
+    SearchParams::TimeDurationT m_timeout = SearchParams::kDefaultTimeout;
+
+    // Size of the grid cell (in mercator units) used to group queries by viewport.
+    double m_cellSize = 0.5;
+
+    // Max number of queries processed by a single engine task.
+    size_t m_maxGroupSize = 64;
+
+    // Max number of groups posted to the engine but not processed yet.
+    // Zero means twice the number of engine threads.
+    size_t m_maxGroupsInFlight = 0;
+  };
+
+  struct Stats
+  {
+    double GetQueriesPerSecond() const;
+
+    size_t m_numQueries = 0;
+    size_t m_numGroups = 0;
+    size_t m_numCancelled = 0;
+    double m_elapsedSeconds = 0.0;
+  };
+
+  // Called exactly once per query with its final results. |queryIndex| is the
+  // index of the query in the vector passed to Run(). May be called concurrently
+  // from different engine threads.
+  using OnResults = std::function<void(size_t queryIndex, Results const & results)>;
+
+  BatchSearch(Engine & engine, Params const & params);
+
+  // Blocks until all |queries| are processed.
+  Stats Run(std::vector<Query> const & queries, OnResults const & onResults);
+
+  // Splits indices of |queries| into groups of at most |maxGroupSize| queries
+  // whose viewport centers lie in the same grid cell of size |cellSize|.
+  // Groups are ordered by cells, queries within a group keep their input order.
+  static std::vector<std::vector<size_t>> MakeGroups(std::vector<Query> const & queries,
+                                                     double cellSize, size_t maxGroupSize);
+
+private:
+  Engine & m_engine;
+  Params m_params;
+};
+
+std::string DebugPrint(BatchSearch::Stats const & stats);
+}  // namespace search
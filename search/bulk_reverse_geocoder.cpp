@@ -0,0 +1,451 @@
+#include "search/bulk_reverse_geocoder.hpp"
+
+#include "search/house_to_street_table.hpp"
+
+#include "editor/osm_editor.hpp"
+
+#include "indexer/data_source.hpp"
+#include "indexer/fake_feature_ids.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_algo.hpp"
+#include "indexer/scales.hpp"
+
+#include "coding/point_coding.hpp"
+
+#include "geometry/hilbert_curve.hpp"
+#include "geometry/mercator.hpp"
+#include "geometry/parametrized_segment.hpp"
+#include "geometry/rect2d.hpp"
+#include "geometry/tree4d.hpp"
+#include "geometry/triangle2d.hpp"
+
+#include "base/assert.hpp"
+#include "base/stl_helpers.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+namespace search
+{
+using namespace std;
+
+namespace
+{
+int constexpr kQueryScale = scales::GetUpperScale();
+
+// Feature geometry kept in memory to compute distances to many points
+// without reading the feature again.
+class CachedGeometry
+{
+public:
+  explicit CachedGeometry(FeatureType & ft) : m_type(ft.GetGeomType())
+  {
+    switch (m_type)
+    {
+    case feature::GeomType::Point: m_points.push_back(ft.GetCenter()); break;
+    case feature::GeomType::Line:
+    {
+      auto const & points = ft.GetPoints(FeatureType::BEST_GEOMETRY);
+      m_points.assign(points.begin(), points.end());
+      break;
+    }
+    default:
+    {
+      ASSERT_EQUAL(m_type, feature::GeomType::Area, ());
+      auto const & triangles = ft.GetTrianglesAsPoints(FeatureType::BEST_GEOMETRY);
+      m_points.assign(triangles.begin(), triangles.end());
+      break;
+    }
+    }
+  }
+
+  // Same as feature::GetMinDistanceMeters() for the best geometry.
+  double GetMinDistanceMeters(m2::PointD const & pt) const
+  {
+    double res = numeric_limits<double>::max();
+    auto const update = [&](m2::PointD const & p)
+    {
+      res = min(res, mercator::DistanceOnEarth(p, pt));
+    };
+    auto const updateBySegment = [&](m2::PointD const & p1, m2::PointD const & p2)
+    {
+      m2::ParametrizedSegment<m2::PointD> const segment(p1, p2);
+      update(segment.ClosestPointTo(pt));
+    };
+
+    switch (m_type)
+    {
+    case feature::GeomType::Point: update(m_points.front()); break;
+    case feature::GeomType::Line:
+    {
+      for (size_t i = 1; i < m_points.size(); ++i)
+        updateBySegment(m_points[i - 1], m_points[i]);
+      break;
+    }
+    default:
+    {
+      for (size_t i = 0; i + 2 < m_points.size(); i += 3)
+      {
+        auto const & p1 = m_points[i];
+        auto const & p2 = m_points[i + 1];
+        auto const & p3 = m_points[i + 2];
+        if (m2::IsPointInsideTriangle(pt, p1, p2, p3))
+          return 0.0;
+
+        updateBySegment(p1, p2);
+        updateBySegment(p2, p3);
+        updateBySegment(p3, p1);
+      }
+      break;
+    }
+    }
+    return res;
+  }
+
+private:
+  feature::GeomType m_type;
+  vector<m2::PointD> m_points;
+};
+
+struct CachedBuilding
+{
+  CachedBuilding(FeatureType & ft, string const & hn)
+    : m_building(ft.GetID(), 0.0 /* distMeters */, hn, feature::GetCenter(ft)), m_geometry(ft)
+  {
+  }
+
+  ReverseGeocoder::Building m_building;
+  CachedGeometry m_geometry;
+};
+
+struct CachedStreet
+{
+  explicit CachedStreet(FeatureType & ft)
+    : m_street(ft.GetID(), 0.0 /* distMeters */, ft.GetReadableName(), ft.GetNames())
+    , m_geometry(ft)
+  {
+  }
+
+  ReverseGeocoder::Street m_street;
+  CachedGeometry m_geometry;
+};
+
+// Per-thread house-to-street tables. MwmValue's own tables are lazily created
+// and must not be touched from several threads at once.
+class HouseTables
+{
+public:
+  HouseTables(DataSource const & dataSource, bool placeAsStreet)
+    : m_dataSource(dataSource), m_placeAsStreet(placeAsStreet)
+  {
+  }
+
+  optional<HouseToStreetTable::Result> Get(FeatureID const & fid)
+  {
+    if (feature::FakeFeatureIds::IsEditorCreatedFeature(fid.m_index))
+      return {};
+
+    auto it = m_tables.find(fid.m_mwmId);
+    if (it == m_tables.end())
+    {
+      Tables tables;
+      tables.m_handle = m_dataSource.GetMwmHandleById(fid.m_mwmId);
+      if (tables.m_handle.IsAlive())
+      {
+        auto const & value = *tables.m_handle.GetValue();
+        tables.m_streets = LoadHouseToStreetTable(value);
+        if (m_placeAsStreet)
+          tables.m_places = LoadHouseToPlaceTable(value);
+      }
+      it = m_tables.emplace(fid.m_mwmId, std::move(tables)).first;
+    }
+
+    auto const & tables = it->second;
+    if (!tables.m_streets)
+      return {};
+
+    auto res = tables.m_streets->Get(fid.m_index);
+    if (!res && tables.m_places)
+      res = tables.m_places->Get(fid.m_index);
+    return res;
+  }
+
+private:
+  struct Tables
+  {
+    MwmSet::MwmHandle m_handle;
+    unique_ptr<HouseToStreetTable> m_streets;
+    unique_ptr<HouseToStreetTable> m_places;
+  };
+
+  DataSource const & m_dataSource;
+  bool m_placeAsStreet;
+  map<MwmSet::MwmId, Tables> m_tables;
+};
+
+class BatchProcessor
+{
+public:
+  BatchProcessor(DataSource const & dataSource, BulkReverseGeocoder::Params const & params)
+    : m_dataSource(dataSource), m_params(params), m_tables(dataSource, params.m_placeAsStreet)
+  {
+  }
+
+  size_t GetNumFeatureReads() const { return m_numFeatureReads; }
+
+  void Process(vector<m2::PointD> const & points, vector<size_t> const & order, size_t beg,
+               size_t end, vector<ReverseGeocoder::Address> & addresses)
+  {
+    LoadBuildings(points, order, beg, end);
+
+    vector<ReverseGeocoder::Building> nearest;
+    for (size_t i = beg; i < end; ++i)
+    {
+      auto const & pt = points[order[i]];
+      GetNearestBuildings(pt, nearest);
+
+      auto & addr = addresses[order[i]];
+      size_t triesCount = 0;
+      for (auto const & b : nearest)
+      {
+        if (GetAddress(b, addr) ||
+            ++triesCount == ReverseGeocoder::kMaxNumTriesToApproxAddress)
+        {
+          break;
+        }
+      }
+    }
+
+    m_buildings.clear();
+    m_buildingsTree.Clear();
+    m_streets.clear();
+  }
+
+private:
+  m2::RectD GetLookupRect(m2::PointD const & pt) const
+  {
+    return mercator::RectByCenterXYAndSizeInMeters(pt, m_params.m_maxDistanceM);
+  }
+
+  void LoadBuildings(vector<m2::PointD> const & points, vector<size_t> const & order, size_t beg,
+                     size_t end)
+  {
+    m2::RectD rect;
+    for (size_t i = beg; i < end; ++i)
+      rect.Add(GetLookupRect(points[order[i]]));
+
+    m_dataSource.ForEachInRect([&](FeatureType & ft)
+    {
+      ++m_numFeatureReads;
+      auto const & hn = ReverseGeocoder::GetHouseNumber(ft);
+      if (hn.empty())
+        return;
+
+      m_buildingsTree.Add(m_buildings.size(), ft.GetLimitRect(FeatureType::BEST_GEOMETRY));
+      m_buildings.emplace_back(ft, hn);
+    }, rect, kQueryScale);
+  }
+
+  // Returns up to kMaxNumTriesToApproxAddress nearest buildings, sorted by distance.
+  void GetNearestBuildings(m2::PointD const & pt, vector<ReverseGeocoder::Building> & nearest) const
+  {
+    nearest.clear();
+    m_buildingsTree.ForEachInRect(GetLookupRect(pt), [&](size_t i)
+    {
+      auto const & b = m_buildings[i];
+      auto const distance = b.m_geometry.GetMinDistanceMeters(pt);
+      if (distance > m_params.m_maxDistanceM)
+        return;
+
+      nearest.push_back(b.m_building);
+      nearest.back().m_distanceMeters = distance;
+    });
+
+    auto const n = min(nearest.size(), ReverseGeocoder::kMaxNumTriesToApproxAddress);
+    partial_sort(nearest.begin(), nearest.begin() + n, nearest.end(),
+                 base::LessBy(&ReverseGeocoder::Building::m_distanceMeters));
+    nearest.resize(n);
+  }
+
+  // Same as ReverseGeocoder::GetNearbyAddress(), but streets are read once per batch.
+  bool GetAddress(ReverseGeocoder::Building const & bld, ReverseGeocoder::Address & addr)
+  {
+    string street;
+    if (osm::Editor::Instance().GetEditedFeatureStreet(bld.m_id, street))
+    {
+      addr.m_building = bld;
+      addr.m_street.m_name = street;
+      return true;
+    }
+
+    auto const res = m_tables.Get(bld.m_id);
+    if (!res)
+      return false;
+
+    CHECK_EQUAL(res->m_type, HouseToStreetTable::StreetIdType::FeatureId, ());
+    FeatureID const streetId(bld.m_id.m_mwmId, res->m_streetId);
+    auto it = m_streets.find(streetId);
+    if (it == m_streets.end())
+    {
+      unique_ptr<CachedStreet> cached;
+      m_dataSource.ReadFeature([&cached](FeatureType & ft)
+      {
+        cached = make_unique<CachedStreet>(ft);
+      }, streetId);
+      ++m_numFeatureReads;
+      it = m_streets.emplace(streetId, std::move(cached)).first;
+    }
+
+    if (!it->second)
+      return false;
+
+    addr.m_street = it->second->m_street;
+    addr.m_street.m_distanceMeters = it->second->m_geometry.GetMinDistanceMeters(bld.m_center);
+    addr.m_building = bld;
+    return true;
+  }
+
+  DataSource const & m_dataSource;
+  BulkReverseGeocoder::Params const & m_params;
+  HouseTables m_tables;
+
+  vector<CachedBuilding> m_buildings;
+  m4::Tree<size_t> m_buildingsTree;
+  map<FeatureID, unique_ptr<CachedStreet>> m_streets;
+
+  size_t m_numFeatureReads = 0;
+};
+}  // namespace
+
+// BulkReverseGeocoder::Stats ----------------------------------------------------------------------
+double BulkReverseGeocoder::Stats::GetPointsPerSecond() const
+{
+  if (m_elapsedSeconds <= 0.0)
+    return 0.0;
+  return static_cast<double>(m_numPoints) / m_elapsedSeconds;
+}
+
+// BulkReverseGeocoder -----------------------------------------------------------------------------
+BulkReverseGeocoder::BulkReverseGeocoder(DataSource const & dataSource, Params const & params)
+  : m_dataSource(dataSource), m_params(params)
+{
+  CHECK_GREATER(m_params.m_numThreads, 0, ());
+  CHECK_GREATER(m_params.m_maxBatchSize, 0, ());
+}
+
+BulkReverseGeocoder::Stats BulkReverseGeocoder::GetNearbyAddresses(
+    vector<m2::PointD> const & points, vector<ReverseGeocoder::Address> & addresses) const
+{
+  base::Timer timer;
+
+  addresses.assign(points.size(), {});
+
+  auto const order = OrderByHilbertCurve(points);
+  auto const batches = MakeBatches(points, order, m_params.m_maxBatchSize, m_params.m_maxBatchSpanM);
+
+  atomic<size_t> nextBatch = 0;
+  atomic<size_t> numFeatureReads = 0;
+  auto const fn = [&]()
+  {
+    BatchProcessor processor(m_dataSource, m_params);
+    for (size_t i = nextBatch++; i < batches.size(); i = nextBatch++)
+      processor.Process(points, order, batches[i].first, batches[i].second, addresses);
+    numFeatureReads += processor.GetNumFeatureReads();
+  };
+
+  auto const numThreads = min(m_params.m_numThreads, max<size_t>(batches.size(), 1));
+  vector<thread> threads;
+  threads.reserve(numThreads - 1);
+  for (size_t i = 1; i < numThreads; ++i)
+    threads.emplace_back(fn);
+  fn();
+  for (auto & t : threads)
+    t.join();
+
+  Stats stats;
+  stats.m_numPoints = points.size();
+  stats.m_numBatches = batches.size();
+  stats.m_numFeatureReads = numFeatureReads;
+  stats.m_numAddressesFound = static_cast<size_t>(
+      count_if(addresses.begin(), addresses.end(), [](auto const & a) { return a.IsValid(); }));
+  stats.m_elapsedSeconds = timer.ElapsedSeconds();
+  return stats;
+}
+
+// static
+vector<size_t> BulkReverseGeocoder::OrderByHilbertCurve(vector<m2::PointD> const & points)
+{
+  vector<pair<uint64_t, size_t>> keys;
+  keys.reserve(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    auto const p = PointDToPointU(points[i], kPointCoordBits);
+    keys.emplace_back(m2::HilbertIndex(p.x, p.y, kPointCoordBits), i);
+  }
+  sort(keys.begin(), keys.end());
+
+  vector<size_t> order;
+  order.reserve(keys.size());
+  for (auto const & key : keys)
+    order.push_back(key.second);
+  return order;
+}
+
+// static
+vector<pair<size_t, size_t>> BulkReverseGeocoder::MakeBatches(vector<m2::PointD> const & points,
+                                                              vector<size_t> const & order,
+                                                              size_t maxBatchSize, double maxSpanM)
+{
+  CHECK_GREATER(maxBatchSize, 0, ());
+
+  vector<pair<size_t, size_t>> batches;
+  size_t beg = 0;
+  m2::RectD rect;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    auto extended = rect;
+    extended.Add(points[order[i]]);
+
+    auto const tooWide = [&]()
+    {
+      auto const ll = extended.LeftBottom();
+      return mercator::DistanceOnEarth(ll, extended.LeftTop()) > maxSpanM ||
+             mercator::DistanceOnEarth(ll, extended.RightBottom()) > maxSpanM;
+    };
+
+    if (i != beg && (i - beg == maxBatchSize || tooWide()))
+    {
+      batches.emplace_back(beg, i);
+      beg = i;
+      extended.MakeEmpty();
+      extended.Add(points[order[i]]);
+    }
+    rect = extended;
+  }
+
+  if (beg != order.size())
+    batches.emplace_back(beg, order.size());
+  return batches;
+}
+
+string DebugPrint(BulkReverseGeocoder::Stats const & stats)
+{
+  ostringstream os;
+  os << "BulkReverseGeocoder::Stats [";
+  os << "points: " << stats.m_numPoints << ", ";
+  os << "batches: " << stats.m_numBatches << ", ";
+  os << "feature reads: " << stats.m_numFeatureReads << ", ";
+  os << "addresses found: " << stats.m_numAddressesFound << ", ";
+  os << "elapsed: " << stats.m_elapsedSeconds << "s, ";
+  os << "points/s: " << stats.GetPointsPerSecond();
+  os << "]";
+  return os.str();
+}
+}  // namespace search
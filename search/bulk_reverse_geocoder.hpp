@@ -0,0 +1,73 @@
+#pragma once
+
+#include "search/reverse_geocoder.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class DataSource;
+
+namespace search
+{
+// Reverse geocoder for large sets of points.
+//
+// Points are sorted along the Hilbert curve and split into spatially compact
+// batches. Buildings and streets around a batch are loaded from the data source
+// once, together with their geometry, and are reused for all points of the batch.
+// Batches are processed in parallel.
+//
+// Unlike ReverseGeocoder::GetNearbyAddress(), which checks the first houses found
+// by a spiral covering, the nearest houses within the lookup radius are checked
+// for every point.
+class BulkReverseGeocoder
+{
+public:
+  struct Params
+  {
+    size_t m_numThreads = 1;
+    // Max number of points in a batch.
+    size_t m_maxBatchSize = 256;
+    // Max size of the bounding box of batch points, in meters.
+    double m_maxBatchSpanM = 2000.0;
+    double m_maxDistanceM = ReverseGeocoder::kLookupRadiusM;
+    bool m_placeAsStreet = false;
+  };
+
+  struct Stats
+  {
+    double GetPointsPerSecond() const;
+
+    size_t m_numPoints = 0;
+    size_t m_numBatches = 0;
+    // Number of features read from the data source.
+    size_t m_numFeatureReads = 0;
+    size_t m_numAddressesFound = 0;
+    double m_elapsedSeconds = 0.0;
+  };
+
+  BulkReverseGeocoder(DataSource const & dataSource, Params const & params);
+
+  // Fills |addresses| with the nearest addresses of |points|, in the same order.
+  // Invalid address is set for points without a house nearby.
+  Stats GetNearbyAddresses(std::vector<m2::PointD> const & points,
+                           std::vector<ReverseGeocoder::Address> & addresses) const;
+
+  // Returns indices of |points| sorted along the Hilbert curve.
+  static std::vector<size_t> OrderByHilbertCurve(std::vector<m2::PointD> const & points);
+
+  // Splits |order| into consecutive [begin, end) ranges of at most |maxBatchSize| points
+  // whose bounding box is at most |maxSpanM| meters wide and high.
+  static std::vector<std::pair<size_t, size_t>> MakeBatches(std::vector<m2::PointD> const & points,
+                                                            std::vector<size_t> const & order,
+                                                            size_t maxBatchSize, double maxSpanM);
+
+private:
+  DataSource const & m_dataSource;
+  Params m_params;
+};
+
+std::string DebugPrint(BulkReverseGeocoder::Stats const & stats);
+}  // namespace search
@@ -0,0 +1,170 @@
+#include "search/decoded_centers_table.hpp"
+
+#include "search/lazy_centers_table.hpp"
+
+#include "indexer/centers_table.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/point_coding.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+namespace search
+{
+using namespace std;
+
+// DecodedCentersTable -----------------------------------------------------------------------------
+// static
+unique_ptr<DecodedCentersTable> DecodedCentersTable::Load(MwmValue const & value)
+{
+  FilesContainerR::TReader reader(unique_ptr<ModelReader>{});
+  auto table = LazyCentersTable::Load(value, reader);
+  if (!table)
+    return {};
+
+  vector<pair<uint32_t, m2::PointD>> centers;
+  centers.reserve(table->Count());
+  table->ForEach([&centers](uint32_t id, m2::PointD const & center) { centers.emplace_back(id, center); });
+  return Build(centers);
+}
+
+// static
+unique_ptr<DecodedCentersTable> DecodedCentersTable::Build(
+    vector<pair<uint32_t, m2::PointD>> const & centers)
+{
+  auto table = make_unique<DecodedCentersTable>();
+
+  uint32_t size = 0;
+  for (auto const & c : centers)
+    size = max(size, c.first + 1);
+
+  table->m_xs.assign(size, kMissing);
+  table->m_ys.assign(size, kMissing);
+  for (auto const & c : centers)
+  {
+    auto const pointu = PointDToPointU(c.second, kPointCoordBits);
+    table->m_xs[c.first] = pointu.x;
+    table->m_ys[c.first] = pointu.y;
+  }
+  table->m_count = centers.size();
+  return table;
+}
+
+bool DecodedCentersTable::Get(uint32_t id, m2::PointD & center) const
+{
+  if (id >= m_xs.size() || m_xs[id] == kMissing)
+    return false;
+
+  center = PointUToPointD(m2::PointU(m_xs[id], m_ys[id]), kPointCoordBits);
+  return true;
+}
+
+void DecodedCentersTable::MarkInsideRect(vector<uint32_t> const & ids, m2::RectD const & rect,
+                                         vector<bool> & inside) const
+{
+  ASSERT_EQUAL(ids.size(), inside.size(), ());
+
+  auto const r = ToFixedPoint(rect);
+  uint32_t const size = static_cast<uint32_t>(m_xs.size());
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    auto const id = ids[i];
+    if (id < size && IsInside(r, m_xs[id], m_ys[id]))
+      inside[i] = true;
+  }
+}
+
+size_t DecodedCentersTable::GetMemoryUsage() const
+{
+  return (m_xs.capacity() + m_ys.capacity()) * sizeof(uint32_t);
+}
+
+// static
+DecodedCentersTable::FixedRect DecodedCentersTable::ToFixedPoint(m2::RectD const & rect)
+{
+  FixedRect r;
+  if (!rect.IsValid())
+  {
+    // Matches no points, including missing ones.
+    r.m_minX = r.m_minY = kMissing - 1;
+    return r;
+  }
+
+  auto const minPoint = PointDToPointU(rect.LeftBottom(), kPointCoordBits);
+  auto const maxPoint = PointDToPointU(rect.RightTop(), kPointCoordBits);
+  r.m_minX = minPoint.x;
+  r.m_minY = minPoint.y;
+  r.m_sizeX = maxPoint.x - minPoint.x;
+  r.m_sizeY = maxPoint.y - minPoint.y;
+  return r;
+}
+
+// DecodedCentersCache -----------------------------------------------------------------------------
+shared_ptr<DecodedCentersTable const> DecodedCentersCache::Get(MwmSet::MwmHandle const & handle)
+{
+  ASSERT(handle.IsAlive(), ());
+
+  shared_ptr<Entry> entry;
+  {
+    lock_guard<mutex> lock(m_mu);
+
+    // Drop tables of deregistered mwms.
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+      if (it->first.IsAlive())
+        ++it;
+      else
+        it = m_entries.erase(it);
+    }
+
+    auto & e = m_entries[handle.GetId()];
+    if (!e)
+      e = make_shared<Entry>();
+    entry = e;
+  }
+
+  // Tables of different mwms are decoded in parallel, while threads requesting
+  // the same table wait for the first one to decode it.
+  lock_guard<mutex> lock(entry->m_mu);
+  if (!entry->m_loaded)
+  {
+    base::Timer timer;
+    entry->m_table = DecodedCentersTable::Load(*handle.GetValue());
+    entry->m_loaded = true;
+
+    if (entry->m_table)
+    {
+      LOG(LINFO, ("Decoded centers of", handle.GetInfo()->GetCountryName(), ":",
+                  entry->m_table->Count(), "features,", entry->m_table->GetMemoryUsage(),
+                  "bytes,", timer.ElapsedSeconds(), "seconds."));
+    }
+  }
+  return entry->m_table;
+}
+
+void DecodedCentersCache::Clear()
+{
+  lock_guard<mutex> lock(m_mu);
+  m_entries.clear();
+}
+
+vector<pair<string, size_t>> DecodedCentersCache::GetMemoryUsage() const
+{
+  vector<pair<MwmSet::MwmId, shared_ptr<Entry>>> entries;
+  {
+    lock_guard<mutex> lock(m_mu);
+    entries.assign(m_entries.begin(), m_entries.end());
+  }
+
+  vector<pair<string, size_t>> usage;
+  for (auto const & e : entries)
+  {
+    lock_guard<mutex> lock(e.second->m_mu);
+    if (e.second->m_table && e.first.IsAlive())
+      usage.emplace_back(e.first.GetInfo()->GetCountryName(), e.second->m_table->GetMemoryUsage());
+  }
+  return usage;
+}
+}  // namespace search
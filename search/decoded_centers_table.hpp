@@ -0,0 +1,105 @@
+#pragma once
+
+#include "indexer/mwm_set.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MwmValue;
+
+namespace search
+{
+// Centers of all features of an mwm, decoded at once into fixed-point
+// coordinates. Unlike CentersTable, which decodes blocks on demand and caches
+// them per instance, the table is immutable after loading, so a single instance
+// may be used by all search threads.
+//
+// Coordinates are stored as two separate arrays indexed by feature id, which
+// allows compilers to vectorize rect filtering.
+class DecodedCentersTable
+{
+public:
+  // Decodes the centers table of |value|. Returns nullptr if the mwm
+  // doesn't have a centers table.
+  static std::unique_ptr<DecodedCentersTable> Load(MwmValue const & value);
+
+  static std::unique_ptr<DecodedCentersTable> Build(
+      std::vector<std::pair<uint32_t, m2::PointD>> const & centers);
+
+  // Tries to get |center| of the feature identified by |id|. Returns
+  // false if table does not have entry for the feature.
+  [[nodiscard]] bool Get(uint32_t id, m2::PointD & center) const;
+
+  // Sets |inside[i]| to true for all |ids[i]| whose centers are inside |rect|.
+  // Points are compared with the fixed-point accuracy. Features without centers
+  // are never inside.
+  void MarkInsideRect(std::vector<uint32_t> const & ids, m2::RectD const & rect,
+                      std::vector<bool> & inside) const;
+
+  size_t Count() const { return m_count; }
+  size_t GetMemoryUsage() const;
+
+private:
+  // Fixed-point rect in the form suitable for the single unsigned comparison
+  // per coordinate: x is inside iff (x - m_minX) <= m_sizeX.
+  struct FixedRect
+  {
+    uint32_t m_minX = 0;
+    uint32_t m_minY = 0;
+    uint32_t m_sizeX = 0;
+    uint32_t m_sizeY = 0;
+  };
+
+  // Fixed-point coordinate of a missing center. It's greater than any valid
+  // coordinate, so missing centers never pass the rect check.
+  static uint32_t constexpr kMissing = std::numeric_limits<uint32_t>::max();
+
+  static FixedRect ToFixedPoint(m2::RectD const & rect);
+
+  static bool IsInside(FixedRect const & r, uint32_t x, uint32_t y)
+  {
+    return (x - r.m_minX <= r.m_sizeX) & (y - r.m_minY <= r.m_sizeY);
+  }
+
+  std::vector<uint32_t> m_xs;
+  std::vector<uint32_t> m_ys;
+  size_t m_count = 0;
+};
+
+// Decoded centers tables shared by all search threads. Each table is
+// decoded once, on the first request, and is released when the cache
+// is cleared or when the mwm is deregistered.
+class DecodedCentersCache
+{
+public:
+  // Returns the decoded centers table of the mwm of |handle|, or nullptr
+  // if the mwm doesn't have a centers table.
+  std::shared_ptr<DecodedCentersTable const> Get(MwmSet::MwmHandle const & handle);
+
+  void Clear();
+
+  // Returns memory used by decoded tables, per mwm name.
+  std::vector<std::pair<std::string, size_t>> GetMemoryUsage() const;
+
+private:
+  struct Entry
+  {
+    std::mutex m_mu;
+    bool m_loaded = false;
+    std::shared_ptr<DecodedCentersTable const> m_table;
+  };
+
+  mutable std::mutex m_mu;
+  std::map<MwmSet::MwmId, std::shared_ptr<Entry>> m_entries;
+};
+}  // namespace search
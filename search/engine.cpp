@@ -1,5 +1,6 @@
 #include "search/engine.hpp"
 
+#include "search/decoded_centers_table.hpp"
 #include "search/processor.hpp"
 
 #include "storage/country_info_getter.hpp"
@@ -88,11 +89,15 @@ Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
   categories.ForEachName(doInit);
   doInit.GetSuggests(m_suggests);
 
+  if (params.m_shareDecodedCenters)
+    m_decodedCentersCache = make_unique<DecodedCentersCache>();
+
   m_contexts.resize(params.m_numThreads);
   for (size_t i = 0; i < params.m_numThreads; ++i)
   {
     auto processor = make_unique<Processor>(dataSource, categories, m_suggests, infoGetter);
     processor->SetPreferredLocale(params.m_locale);
+    processor->SetDecodedCentersCache(m_decodedCentersCache.get());
     m_contexts[i].m_processor = std::move(processor);
   }
 
@@ -127,6 +132,24 @@ weak_ptr<ProcessorHandle> Engine::Search(SearchParams params)
   return handle;
 }
 
+weak_ptr<ProcessorHandle> Engine::SearchBatch(vector<SearchParams> batch,
+                                              function<void()> onFinished)
+{
+  shared_ptr<ProcessorHandle> handle(new ProcessorHandle());
+  PostMessage(Message::TYPE_TASK,
+              [this, batch = std::move(batch), onFinished = std::move(onFinished),
+               handle](Processor & processor) mutable
+              {
+                SCOPE_GUARD(finish, [&onFinished] {
+                  if (onFinished)
+                    onFinished();
+                });
+                for (auto & params : batch)
+                  DoSearch(std::move(params), handle, processor, LDEBUG);
+              });
+  return handle;
+}
+
 void Engine::SetLocale(string const & locale)
 {
   PostMessage(Message::TYPE_BROADCAST,
@@ -138,6 +161,27 @@ size_t Engine::GetNumThreads() const { return m_threads.size(); }
 void Engine::ClearCaches()
 {
   PostMessage(Message::TYPE_BROADCAST, [](Processor & processor) { processor.ClearCaches(); });
+  if (m_decodedCentersCache)
+    m_decodedCentersCache->Clear();
+}
+
+vector<pair<string, size_t>> Engine::GetDecodedCentersMemoryUsage() const
+{
+  if (!m_decodedCentersCache)
+    return {};
+  return m_decodedCentersCache->GetMemoryUsage();
+}
+
+StageLatencies Engine::GetStageLatencies() const
+{
+  lock_guard<mutex> lock(m_stageLatenciesMu);
+  return m_stageLatencies;
+}
+
+void Engine::ResetStageLatencies()
+{
+  lock_guard<mutex> lock(m_stageLatenciesMu);
+  m_stageLatencies = {};
 }
 
 void Engine::CacheWorldLocalities()
@@ -279,13 +323,14 @@ void Engine::PostMessage(Args &&... args)
   m_cv.notify_one();
 }
 
-void Engine::DoSearch(SearchParams params, shared_ptr<ProcessorHandle> handle, Processor & processor)
+void Engine::DoSearch(SearchParams params, shared_ptr<ProcessorHandle> handle, Processor & processor,
+                      base::LogLevel logLevel)
 {
-  LOG(LINFO, ("Search started:", params.m_mode, params.m_viewport));
+  LOG(logLevel, ("Search started:", params.m_mode, params.m_viewport));
   base::Timer timer;
-  SCOPE_GUARD(printDuration, [&timer]()
+  SCOPE_GUARD(printDuration, [&]()
   {
-    LOG(LINFO, ("Search ended in", timer.ElapsedMilliseconds(), "ms."));
+    LOG(logLevel, ("Search ended in", timer.ElapsedMilliseconds(), "ms."));
   });
 
   processor.Reset();
@@ -293,5 +338,11 @@ void Engine::DoSearch(SearchParams params, shared_ptr<ProcessorHandle> handle, P
   SCOPE_GUARD(detach, [&handle] { handle->Detach(); });
 
   processor.Search(std::move(params));
+
+  if (auto const * timings = processor.GetStageTimings())
+  {
+    lock_guard<mutex> lock(m_stageLatenciesMu);
+    m_stageLatencies.Add(*timings);
+  }
 }
 }  // namespace search
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "search/search_params.hpp"
+#include "search/stage_timings.hpp"
 #include "search/suggest.hpp"
 
 #include "indexer/categories_holder.hpp"
 
+#include "base/logging.hpp"
 #include "base/macros.hpp"
 #include "base/thread.hpp"
 
@@ -14,6 +16,7 @@
 #include <mutex>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 class DataSource;
@@ -25,6 +28,7 @@ class CountryInfoGetter;
 
 namespace search
 {
+class DecodedCentersCache;
 class EngineData;
 class Processor;
 
@@ -80,6 +84,11 @@ public:
     // to process queries. Use this field wisely as large values may
     // negatively affect performance due to false sharing.
     size_t m_numThreads;
+
+    // When true, centers tables of mwms are decoded completely on the first
+    // request and are shared by all threads, instead of being decoded block
+    // by block in each thread. Trades memory for speed, see DecodedCentersCache.
+    bool m_shareDecodedCenters = false;
   };
 
   // Doesn't take ownership of dataSource and categories.
@@ -90,6 +99,15 @@ public:
   // Posts search request to the queue and returns its handle.
   std::weak_ptr<ProcessorHandle> Search(SearchParams params);
 
+  // Posts a batch of search requests to the queue as a single task and
+  // returns its handle. All requests of the batch are processed one by one
+  // by the same processor, so caches built for the first request
+  // (categories, streets, localities, matchers) are reused by the rest of
+  // the batch. |onFinished| is called on the processor's thread after the
+  // last request of the batch is processed.
+  std::weak_ptr<ProcessorHandle> SearchBatch(std::vector<SearchParams> batch,
+                                             std::function<void()> onFinished);
+
   // Sets default locale on all query processors.
   void SetLocale(std::string const & locale);
 
@@ -99,6 +117,15 @@ public:
   // Posts request to clear caches to the queue.
   void ClearCaches();
 
+  // Returns memory used by shared decoded centers tables, per mwm name.
+  // Empty if Params::m_shareDecodedCenters is false.
+  std::vector<std::pair<std::string, size_t>> GetDecodedCentersMemoryUsage() const;
+
+  // Returns per-stage latency histograms of all requests processed since
+  // the start or the last call of ResetStageLatencies().
+  StageLatencies GetStageLatencies() const;
+  void ResetStageLatencies();
+
   // Posts requests to load and cache localities from World.mwm.
   void CacheWorldLocalities();
 
@@ -166,10 +193,18 @@ private:
   template <typename... Args>
   void PostMessage(Args &&... args);
 
-  void DoSearch(SearchParams params, std::shared_ptr<ProcessorHandle> handle, Processor & processor);
+  // Batch requests are logged with |logLevel| LDEBUG, there may be millions of them.
+  void DoSearch(SearchParams params, std::shared_ptr<ProcessorHandle> handle, Processor & processor,
+                base::LogLevel logLevel = LINFO);
 
   std::vector<Suggest> m_suggests;
 
+  // Shared by all processors, may be nullptr.
+  std::unique_ptr<DecodedCentersCache> m_decodedCentersCache;
+
+  mutable std::mutex m_stageLatenciesMu;
+  StageLatencies m_stageLatencies;
+
   bool m_shutdown;
   std::mutex m_mu;
   std::condition_variable m_cv;
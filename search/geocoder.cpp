@@ -652,6 +652,7 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
 {
+  ScopedStageTimer timer(*m_stageTimings, SearchStage::Retrieval);
   Retrieval retrieval(*m_context, m_cancellable);
 
   size_t const numTokens = m_params.GetNumTokens();
@@ -739,6 +740,8 @@ void Geocoder::CacheWorldLocalities()
 
 void Geocoder::FillLocalitiesTable(BaseContext const & ctx)
 {
+  ScopedStageTimer timer(*m_stageTimings, SearchStage::Localities);
+
   auto addRegionMaps = [this](FeatureType & ft, Locality && l, Region::Type type)
   {
     if (ft.GetGeomType() != feature::GeomType::Point)
@@ -840,6 +843,8 @@ void Geocoder::FillLocalitiesTable(BaseContext const & ctx)
 
 void Geocoder::FillVillageLocalities(BaseContext const & ctx)
 {
+  ScopedStageTimer timer(*m_stageTimings, SearchStage::Localities);
+
   vector<Locality> preLocalities;
   FillLocalityCandidates(ctx, ctx.m_villages, kMaxNumVillages, preLocalities);
 
@@ -910,11 +915,11 @@ void Geocoder::ForEachCountry(ExtendedMwmInfos const & extendedInfos, Fn && fn)
       continue;
     bool const updatePreranker = i + 1 >= extendedInfos.m_firstBatchSize;
     auto const & mwmType = extendedInfos.m_infos[i].m_type;
-    if (fn(make_unique<MwmContext>(std::move(handle), mwmType), updatePreranker) ==
-        base::ControlFlow::Break)
-    {
+    auto context = make_unique<MwmContext>(std::move(handle), mwmType);
+    if (m_decodedCentersCache)
+      context->SetDecodedCenters(m_decodedCentersCache->Get(context->m_handle));
+    if (fn(std::move(context), updatePreranker) == base::ControlFlow::Break)
       break;
-    }
   }
 }
 
@@ -1284,19 +1289,44 @@ template <class FnT>
 void Geocoder::CentersFilter::ClusterizeStreets(std::vector<uint32_t> & streets,
                                                 Geocoder const & geocoder, FnT && fn) const
 {
-  std::vector<std::tuple<double, m2::PointD, uint32_t>> loadedStreets;
+  buffer_vector<m2::RectD, 2> rects(m_centers.size());
+  for (size_t i = 0; i < rects.size(); ++i)
+  {
+    rects[i] = mercator::RectByCenterXYAndSizeInMeters(
+          m_centers[i], geocoder.m_params.m_filteringParams.m_streetSearchRadiusM);
+  }
+
+  // Decoded centers are checked against the rects for all streets at once.
+  std::vector<bool> inside(streets.size(), false);
+  auto const * decodedCenters = geocoder.m_context->GetDecodedCenters();
+  if (decodedCenters)
+  {
+    for (auto const & rect : rects)
+      decodedCenters->MarkInsideRect(streets, rect, inside);
+  }
+
+  std::vector<std::tuple<double, bool, uint32_t>> loadedStreets;
   loadedStreets.reserve(streets.size());
 
-  // Calculate {distance, center, feature id}.
-  for (uint32_t fid : streets)
+  // Calculate {distance, is inside any rect, feature id}.
+  for (size_t i = 0; i < streets.size(); ++i)
   {
+    uint32_t const fid = streets[i];
     m2::PointD ftCenter;
     if (geocoder.m_context->GetCenter(fid, ftCenter))
     {
       double minDist = std::numeric_limits<double>::max();
       for (auto const & c : m_centers)
         minDist = std::min(minDist, ftCenter.Length(c));
-      loadedStreets.emplace_back(minDist, ftCenter, fid);
+
+      if (!decodedCenters)
+      {
+        inside[i] = std::any_of(rects.begin(), rects.end(), [&ftCenter](m2::RectD const & rect)
+        {
+          return rect.IsPointInside(ftCenter);
+        });
+      }
+      loadedStreets.emplace_back(minDist, inside[i], fid);
     }
     else
     {
@@ -1311,23 +1341,11 @@ void Geocoder::CentersFilter::ClusterizeStreets(std::vector<uint32_t> & streets,
     return std::get<0>(t1) < std::get<0>(t2);
   });
 
-  buffer_vector<m2::RectD, 2> rects(m_centers.size());
-  for (size_t i = 0; i < rects.size(); ++i)
-  {
-    rects[i] = mercator::RectByCenterXYAndSizeInMeters(
-          m_centers[i], geocoder.m_params.m_filteringParams.m_streetSearchRadiusM);
-  }
-
   // Find the first (after m_maxStreetsCount) street that is out of the rect's bounds
   size_t count = std::min(loadedStreets.size(), geocoder.m_params.m_filteringParams.m_maxStreetsCount);
   for (; count < loadedStreets.size(); ++count)
   {
-    bool const outside = std::all_of(rects.begin(), rects.end(),
-                                     [pt = std::get<1>(loadedStreets[count])](m2::RectD const & rect)
-                                     {
-                                       return !rect.IsPointInside(pt);
-                                     });
-    if (outside)
+    if (!std::get<1>(loadedStreets[count]))
       break;
   }
 
@@ -1776,6 +1794,7 @@ void Geocoder::FindPaths(BaseContext & ctx)
     return true;
   };
 
+  ScopedStageTimer timer(*m_stageTimings, SearchStage::PathFinder);
   m_finder.ForEachReachableVertex(*m_matcher, sortedLayers, [&](IntersectionResult const & result)
   {
     ASSERT(result.IsValid(), ());
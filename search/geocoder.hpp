@@ -17,6 +17,7 @@
 #include "search/mwm_context.hpp"
 #include "search/postcode_points.hpp"
 #include "search/query_params.hpp"
+#include "search/stage_timings.hpp"
 #include "search/streets_matcher.hpp"
 #include "search/token_range.hpp"
 #include "search/tracer.hpp"
@@ -127,6 +128,13 @@ public:
   void CacheWorldLocalities();
   void ClearCaches();
 
+  // Makes geocoder use shared decoded centers tables from |cache|.
+  // |cache| may be nullptr, then centers are decoded on demand.
+  void SetDecodedCentersCache(DecodedCentersCache * cache) { m_decodedCentersCache = cache; }
+
+  // Makes geocoder add durations of its stages to |timings|, must be called before the search.
+  void SetStageTimings(StageTimings & timings) { m_stageTimings = &timings; }
+
 private:
   enum class RectId
   {
@@ -375,5 +383,8 @@ private:
   ResultTracer m_resultTracer;
 
   PreRanker & m_preRanker;
+
+  DecodedCentersCache * m_decodedCentersCache = nullptr;
+  StageTimings * m_stageTimings = nullptr;
 };
 }  // namespace search
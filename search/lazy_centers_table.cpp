@@ -18,37 +18,37 @@ void LazyCentersTable::EnsureTableLoaded()
   if (m_state != STATE_NOT_LOADED)
     return;
 
+  m_table = Load(m_value, m_reader);
+  if (m_table)
+    m_state = STATE_LOADED;
+  else
+    m_state = STATE_FAILED;
+}
+
+// static
+std::unique_ptr<CentersTable> LazyCentersTable::Load(MwmValue const & value,
+                                                     FilesContainerR::TReader & reader)
+{
   try
   {
-    m_reader = m_value.m_cont.GetReader(CENTERS_FILE_TAG);
+    reader = value.m_cont.GetReader(CENTERS_FILE_TAG);
   }
   catch (RootException const & ex)
   {
     LOG(LERROR, ("Unable to load", CENTERS_FILE_TAG, ex.Msg()));
-    m_state = STATE_FAILED;
-    return;
+    return {};
   }
 
-  version::MwmTraits traits(m_value.GetMwmVersion());
+  version::MwmTraits traits(value.GetMwmVersion());
   auto const format = traits.GetCentersTableFormat();
 
   if (format == version::MwmTraits::CentersTableFormat::PlainEliasFanoMap)
-  {
-    m_table = CentersTable::LoadV0(*m_reader.GetPtr(), m_value.GetHeader().GetDefGeometryCodingParams());
-  }
-  else if (format == version::MwmTraits::CentersTableFormat::EliasFanoMapWithHeader)
-  {
-    m_table = CentersTable::LoadV1(*m_reader.GetPtr());
-  }
-  else
-  {
-    CHECK(false, ("Unknown centers table format."));
-  }
+    return CentersTable::LoadV0(*reader.GetPtr(), value.GetHeader().GetDefGeometryCodingParams());
+  if (format == version::MwmTraits::CentersTableFormat::EliasFanoMapWithHeader)
+    return CentersTable::LoadV1(*reader.GetPtr());
 
-  if (m_table)
-    m_state = STATE_LOADED;
-  else
-    m_state = STATE_FAILED;
+  CHECK(false, ("Unknown centers table format."));
+  return {};
 }
 
 bool LazyCentersTable::Get(uint32_t id, m2::PointD & center)
@@ -31,6 +31,11 @@ public:
 
   [[nodiscard]] bool Get(uint32_t id, m2::PointD & center);
 
+  // Loads centers table of |value|. Note that |reader| must be alive until
+  // the destruction of loaded table. Returns nullptr if the table can't be loaded.
+  static std::unique_ptr<CentersTable> Load(MwmValue const & value,
+                                            FilesContainerR::TReader & reader);
+
 private:
   MwmValue const & m_value;
   State m_state;
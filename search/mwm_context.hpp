@@ -1,5 +1,6 @@
 #pragma once
 
+#include "search/decoded_centers_table.hpp"
 #include "search/lazy_centers_table.hpp"
 
 #include "editor/editable_feature_source.hpp"
@@ -103,9 +104,20 @@ public:
 
   [[nodiscard]] inline bool GetCenter(uint32_t index, m2::PointD & center)
   {
+    if (m_decodedCenters)
+      return m_decodedCenters->Get(index, center);
     return m_centers.Get(index, center);
   }
 
+  // Makes the context use the shared decoded centers table instead of
+  // decoding centers on demand.
+  void SetDecodedCenters(std::shared_ptr<DecodedCentersTable const> centers)
+  {
+    m_decodedCenters = std::move(centers);
+  }
+
+  DecodedCentersTable const * GetDecodedCenters() const { return m_decodedCenters.get(); }
+
   std::optional<uint32_t> GetStreet(uint32_t index) const;
 
   MwmSet::MwmHandle m_handle;
@@ -121,18 +133,17 @@ private:
   void ForEachIndexImpl(covering::Intervals const & intervals, uint32_t scale, Fn && fn) const
   {
     CheckUniqueIndexes checkUnique;
-    for (auto const & i : intervals)
-      m_index.ForEachInIntervalAndScale(i.first, i.second, scale,
-          [&](uint64_t /* key */, uint32_t value)
-          {
-            if (checkUnique(value))
-              fn(value);
-          });
+    m_index.ForEachInIntervalsAndScale(intervals, scale, [&](uint64_t /* key */, uint32_t value)
+    {
+      if (checkUnique(value))
+        fn(value);
+    });
   }
 
   FeaturesVector m_vector;
-  ScaleIndex<ModelReaderPtr> m_index;
+  ScaleIndex<ModelReaderPtr> const & m_index;
   LazyCentersTable m_centers;
+  std::shared_ptr<DecodedCentersTable const> m_decodedCenters;
   EditableFeatureSource m_editableSource;
   std::optional<MwmType> m_type;
 
@@ -1,8 +1,10 @@
 #include "search/pre_ranker.hpp"
 
+#include "search/decoded_centers_table.hpp"
 #include "search/dummy_rank_table.hpp"
 #include "search/lazy_centers_table.hpp"
 #include "search/pre_ranking_info.hpp"
+#include "search/stage_timings.hpp"
 
 #include "editor/osm_editor.hpp"
 
@@ -98,6 +100,7 @@ void PreRanker::FillMissingFieldsInPreResults()
   unique_ptr<RankTable> ranks = make_unique<DummyRankTable>();
   unique_ptr<RankTable> popularityRanks = make_unique<DummyRankTable>();
   unique_ptr<LazyCentersTable> centers;
+  shared_ptr<DecodedCentersTable const> decodedCenters;
   bool pivotFeaturesInitialized = false;
 
   ForEachMwmOrder(m_results, [&](PreRankerResult & r)
@@ -110,13 +113,17 @@ void PreRanker::FillMissingFieldsInPreResults()
 
       ranks.reset();
       centers.reset();
+      decodedCenters.reset();
       if (mwmHandle.IsAlive())
       {
         auto const * value = mwmHandle.GetValue();
 
         ranks = RankTable::Load(value->m_cont, SEARCH_RANKS_FILE_TAG);
         popularityRanks = RankTable::Load(value->m_cont, POPULARITY_RANKS_FILE_TAG);
-        centers = make_unique<LazyCentersTable>(*value);
+        if (m_decodedCentersCache)
+          decodedCenters = m_decodedCentersCache->Get(mwmHandle);
+        else
+          centers = make_unique<LazyCentersTable>(*value);
       }
       if (!ranks)
         ranks = make_unique<DummyRankTable>();
@@ -128,7 +135,8 @@ void PreRanker::FillMissingFieldsInPreResults()
     r.SetPopularity(popularityRanks->Get(id.m_index));
 
     m2::PointD center;
-    if (centers && centers->Get(id.m_index, center))
+    if ((decodedCenters && decodedCenters->Get(id.m_index, center)) ||
+        (centers && centers->Get(id.m_index, center)))
     {
       r.SetDistanceToPivot(mercator::DistanceOnEarth(m_params.m_accuratePivotCenter, center));
       r.SetCenter(center);
@@ -253,9 +261,12 @@ void PreRanker::Filter()
 
 void PreRanker::UpdateResults(bool lastUpdate)
 {
-  FilterRelaxedResults(lastUpdate);
-  FillMissingFieldsInPreResults();
-  Filter();
+  {
+    ScopedStageTimer timer(*m_stageTimings, SearchStage::PreRanker);
+    FilterRelaxedResults(lastUpdate);
+    FillMissingFieldsInPreResults();
+    Filter();
+  }
   m_numSentResults += m_results.size();
   m_ranker.AddPreRankerResults(std::move(m_results));
   m_results.clear();
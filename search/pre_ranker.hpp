@@ -21,6 +21,9 @@ class DataSource;
 
 namespace search
 {
+class DecodedCentersCache;
+class StageTimings;
+
 // Fast and simple pre-ranker for search results.
 class PreRanker
 {
@@ -92,6 +95,13 @@ public:
   bool HaveFullyMatchedResult() const { return m_haveFullyMatchedResult; }
   size_t Limit() const { return m_params.m_limit; }
 
+  // Makes pre-ranker use shared decoded centers tables from |cache|.
+  // |cache| may be nullptr, then centers are decoded on demand.
+  void SetDecodedCentersCache(DecodedCentersCache * cache) { m_decodedCentersCache = cache; }
+
+  // Makes pre-ranker add its duration to |timings|, must be called before the search.
+  void SetStageTimings(StageTimings & timings) { m_stageTimings = &timings; }
+
   // Iterate results per-MWM clusters.
   // Made it "static template" for easy unit tests implementing.
   template <class T, class FnT>
@@ -169,6 +179,9 @@ private:
 
   unsigned m_rndSeed;
 
+  DecodedCentersCache * m_decodedCentersCache = nullptr;
+  StageTimings * m_stageTimings = nullptr;
+
   DISALLOW_COPY_AND_MOVE(PreRanker);
 };
 }  // namespace search
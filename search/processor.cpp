@@ -41,6 +41,7 @@
 #include "base/logging.hpp"
 #include "base/stl_helpers.hpp"
 #include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
 #include <algorithm>
 #include <sstream>
@@ -174,6 +175,10 @@ Processor::Processor(DataSource const & dataSource, CategoriesHolder const & cat
                m_localitiesCaches, static_cast<base::Cancellable const &>(*this))
   , m_bookmarksProcessor(m_emitter, static_cast<base::Cancellable const &>(*this))
 {
+  m_geocoder.SetStageTimings(m_stageTimings);
+  m_preRanker.SetStageTimings(m_stageTimings);
+  m_ranker.SetStageTimings(m_stageTimings);
+
   // Current and input langs are to be set later.
   m_keywordsScorer.SetLanguages(
       LanguageTier::LANGUAGE_TIER_EN_AND_INTERNATIONAL,
@@ -231,6 +236,12 @@ void Processor::SetInputLocale(string const & locale)
   m_inputLocaleCode = CategoriesHolder::MapLocaleToInteger(locale);
 }
 
+void Processor::SetDecodedCentersCache(DecodedCentersCache * cache)
+{
+  m_geocoder.SetDecodedCentersCache(cache);
+  m_preRanker.SetDecodedCentersCache(cache);
+}
+
 void Processor::SetQuery(string const & query, bool categorialRequest /* = false */)
 {
   LOG(LDEBUG, ("query:", query, "isCategorial:", categorialRequest));
@@ -551,6 +562,10 @@ void Processor::Search(SearchParams params)
   // Comment this line to run search in a debugger.
   SetDeadline(chrono::steady_clock::now() + params.m_timeout);
 
+  base::Timer timer;
+  m_stageTimings.Clear();
+  m_stageTimingsReady = false;
+
   if (params.m_onStarted)
     params.m_onStarted();
 
@@ -626,6 +641,14 @@ void Processor::Search(SearchParams params)
       m_preRanker.UpdateResults(true /* lastUpdate */);
     }
 
+    if (cancellationStatus != base::Cancellable::Status::CancelCalled)
+    {
+      m_stageTimings.Add(SearchStage::Total, timer.ElapsedSeconds());
+      m_stageTimingsReady = true;
+      if (params.m_onStageTimings)
+        params.m_onStageTimings(m_stageTimings);
+    }
+
     // Emit finish marker to client.
     m_geocoder.Finish(cancellationStatus == Cancellable::Status::CancelCalled);
     break;
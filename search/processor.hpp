@@ -9,6 +9,7 @@
 #include "search/pre_ranker.hpp"
 #include "search/ranker.hpp"
 #include "search/search_params.hpp"
+#include "search/stage_timings.hpp"
 #include "search/suggest.hpp"
 
 #include "ge0/geo_url_parser.hpp"
@@ -62,6 +63,15 @@ public:
   void SetViewport(m2::RectD const & viewport);
   void SetPreferredLocale(std::string const & locale);
   void SetInputLocale(std::string const & locale);
+  // Makes processor use shared decoded centers tables from |cache|, see DecodedCentersCache.
+  void SetDecodedCentersCache(DecodedCentersCache * cache);
+
+  // Returns stage durations of the last search request, or nullptr if
+  // it was cancelled. Durations are measured for every request.
+  StageTimings const * GetStageTimings() const
+  {
+    return m_stageTimingsReady ? &m_stageTimings : nullptr;
+  }
   void SetQuery(std::string const & query, bool categorialRequest = false);
 
   inline bool IsEmptyQuery() const { return m_query.IsEmpty(); }
@@ -158,6 +168,9 @@ protected:
 
   bool m_lastUpdate = false;
 
+  StageTimings m_stageTimings;
+  bool m_stageTimingsReady = false;
+
   // Suggestions language code, not the same as we use in mwm data
   int8_t m_inputLocaleCode = StringUtf8Multilang::kUnsupportedLanguageCode;
   int8_t m_currentLocaleCode = StringUtf8Multilang::kUnsupportedLanguageCode;
@@ -5,6 +5,7 @@
 #include "search/highlighting.hpp"
 #include "search/model.hpp"
 #include "search/pre_ranking_info.hpp"
+#include "search/stage_timings.hpp"
 #include "search/ranking_utils.hpp"
 #include "search/token_slice.hpp"
 
@@ -19,11 +20,16 @@
 #include "coding/string_utf8_multilang.hpp"
 
 #include "base/logging.hpp"
+#include "base/stl_helpers.hpp"
 #include "base/string_utils.hpp"
 
 #include <algorithm>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
+#include <utility>
 
 namespace search
 {
@@ -213,6 +219,49 @@ NameScores GetNameScores(FeatureType & ft, Geocoder::Params const & params,
   return bestScores;
 }
 
+// Number of extra results kept when pruning candidates in case some of the best ones
+// are filtered out later.
+size_t constexpr kPruningReserveResults = 10;
+
+// Keeps the best linear model ranks of ranker results. Results with the same type and name
+// may be merged by duplicates filters, so such results are counted only once.
+class BestRanksTracker
+{
+public:
+  explicit BestRanksTracker(size_t count) : m_count(count) {}
+
+  void Add(RankerResult const & r)
+  {
+    auto const rank = r.GetLinearModelRank();
+    auto const res = m_best.emplace(Key(r.GetRankingInfo().m_type, r.GetName()), rank);
+    if (!res.second)
+    {
+      if (res.first->second >= rank)
+        return;
+      m_ranks.erase(m_ranks.find(res.first->second));
+      res.first->second = rank;
+    }
+    m_ranks.insert(rank);
+  }
+
+  // Returns true if there are at least |m_count| distinct results ranked higher than |rank|.
+  bool IsDominated(double rank) const
+  {
+    if (m_count == 0)
+      return true;
+    if (m_ranks.size() < m_count)
+      return false;
+    return *next(m_ranks.rbegin(), m_count - 1) > rank;
+  }
+
+private:
+  using Key = pair<Model::Type, string>;
+
+  size_t const m_count;
+  map<Key, double> m_best;
+  multiset<double> m_ranks;
+};
+
 void RemoveDuplicatingLinear(vector<RankerResult> & results)
 {
   // "Молодечно первомайская ул"; "Тюрли первомайская ул" should remain both :)
@@ -341,19 +390,63 @@ public:
   }
 
   optional<RankerResult> operator()(PreRankerResult const & preResult)
+  {
+    auto ft = LoadFeature(preResult.GetId());
+    if (!ft)
+      return {};
+    // |m_loader| may be replaced while making the result, e.g. by the World loader for the city,
+    // but |ft| needs the guard it's loaded by.
+    auto const loader = m_loader;
+    return MakeResult(preResult, *ft);
+  }
+
+  // Makes results for |preResults| of a single mwm sorted by feature index, their features
+  // are loaded in a batch. Calls |fn| with positions in |preResults| and made results.
+  template <typename Fn>
+  void operator()(vector<PreRankerResult const *> const & preResults, Fn && fn)
+  {
+    if (preResults.empty())
+      return;
+
+    auto const & mwmId = preResults.front()->GetId().m_mwmId;
+    vector<uint32_t> indices;
+    indices.reserve(preResults.size());
+    for (auto const * r : preResults)
+    {
+      ASSERT_EQUAL(r->GetId().m_mwmId, mwmId, ());
+      indices.push_back(r->GetId().m_index);
+    }
+
+    // A separate guard, because |m_loader| may be changed while making results.
+    FeaturesLoaderGuard loader(m_dataSource, mwmId);
+    size_t i = 0;
+    loader.LoadFeatures(std::move(indices), [&](FeatureType & ft)
+    {
+      // Deleted features are skipped.
+      auto const index = ft.GetID().m_index;
+      while (i < preResults.size() && preResults[i]->GetId().m_index < index)
+        ++i;
+      ASSERT_LESS(i, preResults.size(), ());
+      ASSERT_EQUAL(preResults[i]->GetId().m_index, index, ());
+
+      if (auto res = MakeResult(*preResults[i], ft))
+        fn(i, std::move(*res));
+      ++i;
+    });
+  }
+
+private:
+  optional<RankerResult> MakeResult(PreRankerResult const & preResult, FeatureType & ft)
   {
     m2::PointD center;
     string name;
     string country;
+    FillFeatureInfo(ft, center, name, country);
 
-    auto ft = LoadFeature(preResult.GetId(), center, name, country);
-    if (!ft)
-      return {};
-
-    RankerResult res(*ft, center, std::move(name), country);
+    RankerResult res(ft, center, std::move(name), country);
 
     RankingInfo info;
-    InitRankingInfo(*ft, center, preResult, info);
+    InitRankingInfo(ft, center, preResult, info);
 
     if (info.m_type == Model::TYPE_STREET)
     {
@@ -391,7 +484,7 @@ public:
     }
 
     info.m_rank = NormalizeRank(info.m_rank, info.m_type, center, country,
-                                m_capitalChecker(*ft), !info.m_allTokensUsed);
+                                m_capitalChecker(ft), !info.m_allTokensUsed);
 
     if (preResult.GetInfo().m_isCommonMatchOnly)
     {
@@ -420,7 +513,6 @@ public:
     return res;
   }
 
-private:
   bool IsSameLoader(FeatureID const & id) const
   {
     return (m_loader && m_loader->GetId() == id.m_mwmId);
@@ -429,7 +521,7 @@ private:
   unique_ptr<FeatureType> LoadFeature(FeatureID const & id)
   {
     if (!IsSameLoader(id))
-      m_loader = make_unique<FeaturesLoaderGuard>(m_dataSource, id.m_mwmId);
+      m_loader = make_shared<FeaturesLoaderGuard>(m_dataSource, id.m_mwmId);
     return LoadFeatureImpl(id, *m_loader);
   }
 
@@ -453,29 +545,27 @@ private:
     return addr.IsValid();
   }
 
-  // For the best performance, incoming ids should be sorted by id.first (mwm file id).
-  unique_ptr<FeatureType> LoadFeature(FeatureID const & id, m2::PointD & center, string & name,
-                                      string & country)
+  // For the best performance, incoming features should be sorted by mwm id.
+  void FillFeatureInfo(FeatureType & ft, m2::PointD & center, string & name, string & country)
   {
-    auto ft = LoadFeature(id);
-    if (!ft)
-      return ft;
+    auto const & id = ft.GetID();
+    if (!IsSameLoader(id))
+      m_loader = make_shared<FeaturesLoaderGuard>(m_dataSource, id.m_mwmId);
 
     // Country (region) name is a file name if feature isn't from World.mwm.
-    ASSERT(m_loader && m_loader->GetId() == id.m_mwmId, ());
     if (m_loader->IsWorld())
       country.clear();
     else
       country = m_loader->GetCountryFileName();
 
-    center = feature::GetCenter(*ft);
-    m_ranker.GetBestMatchName(*ft, name);
+    center = feature::GetCenter(ft);
+    m_ranker.GetBestMatchName(ft, name);
 
     // Insert exact address (street and house number) instead of empty result name.
     if (!m_isViewportMode && name.empty())
     {
       ReverseGeocoder::Address addr;
-      if (GetExactAddress(*ft, center, addr))
+      if (GetExactAddress(ft, center, addr))
       {
         unique_ptr<FeatureType> streetFeature;
 
@@ -498,8 +588,6 @@ private:
         }
       }
     }
-
-    return ft;
   }
 
   void InitRankingInfo(FeatureType & ft, m2::PointD const & center, PreRankerResult const & res, RankingInfo & info)
@@ -668,7 +756,7 @@ private:
   Geocoder::Params const & m_params;
   bool m_isViewportMode;
 
-  unique_ptr<FeaturesLoaderGuard> m_loader;
+  shared_ptr<FeaturesLoaderGuard> m_loader;
 };
 
 Ranker::Ranker(DataSource const & dataSource, CitiesBoundariesTable const & boundariesTable,
@@ -772,6 +860,8 @@ void Ranker::UpdateResults(bool lastUpdate)
   if (!lastUpdate)
     BailIfCancelled();
 
+  ScopedStageTimer timer(*m_stageTimings, SearchStage::Ranker);
+
   MakeRankerResults();
   RemoveDuplicatingLinear(m_tentativeResults);
   if (m_tentativeResults.empty())
@@ -885,11 +975,11 @@ void Ranker::MakeRankerResults()
   LOG(LDEBUG, ("PreRankerResults number =", m_preRankerResults.size()));
 
   RankerResultMaker maker(*this, m_dataSource, m_infoGetter, m_reverseGeocoder, m_geocoderParams);
-  for (auto const & r : m_preRankerResults)
+  auto const addResult = [&](PreRankerResult const & r)
   {
     auto p = maker(r);
     if (!p)
-      continue;
+      return;
 
     ASSERT(m_geocoderParams.m_mode != Mode::Viewport || m_geocoderParams.m_pivot.IsPointInside(p->GetCenter()), (r));
 
@@ -897,6 +987,82 @@ void Ranker::MakeRankerResults()
     m_tentativeResults.push_back(std::move(*p));
   };
 
+  if (m_params.m_viewportSearch)
+  {
+    // All candidates are made into results in the viewport mode, so their features are loaded
+    // in batches mwm by mwm, in the order of offsets. Results keep the order of candidates.
+    vector<PreRankerResult const *> sorted;
+    sorted.reserve(m_preRankerResults.size());
+    for (auto const & r : m_preRankerResults)
+      sorted.push_back(&r);
+    sort(sorted.begin(), sorted.end(), [](PreRankerResult const * lhs, PreRankerResult const * rhs)
+    {
+      return lhs->GetId() < rhs->GetId();
+    });
+
+    vector<optional<RankerResult>> results(m_preRankerResults.size());
+    vector<PreRankerResult const *> batch;
+    for (auto it = sorted.begin(); it != sorted.end();)
+    {
+      auto const & mwmId = (*it)->GetId().m_mwmId;
+      batch.clear();
+      for (; it != sorted.end() && (*it)->GetId().m_mwmId == mwmId; ++it)
+        batch.push_back(*it);
+
+      maker(batch, [&](size_t i, RankerResult && res)
+      {
+        results[batch[i] - m_preRankerResults.data()] = std::move(res);
+      });
+    }
+
+    for (auto & r : results)
+    {
+      if (!r)
+        continue;
+
+      ASSERT(m_geocoderParams.m_mode != Mode::Viewport ||
+             m_geocoderParams.m_pivot.IsPointInside(r->GetCenter()), ());
+      m_tentativeResults.push_back(std::move(*r));
+    }
+  }
+  else
+  {
+    // Only the best |m_limit| results are emitted in the everywhere mode, so there is no need
+    // to load features of candidates that can't beat them. Candidates are processed in order of
+    // decreasing upper bound of their rank until the bound drops below the rank of the worst
+    // result that may still be emitted.
+    size_t const emitted = m_emitter.GetResults().GetCount();
+    size_t const needed = (m_params.m_limit > emitted ? m_params.m_limit - emitted : 0) +
+                          kPruningReserveResults;
+
+    vector<pair<double, size_t>> bounds;
+    bounds.reserve(m_preRankerResults.size());
+    for (size_t i = 0; i < m_preRankerResults.size(); ++i)
+    {
+      bounds.emplace_back(RankingInfo::GetLinearModelRankUpperBound(
+                              m_preRankerResults[i].GetInfo(), m_params.m_categorialRequest),
+                          i);
+    }
+    stable_sort(bounds.begin(), bounds.end(), base::LessBy(&pair<double, size_t>::first));
+    reverse(bounds.begin(), bounds.end());
+
+    BestRanksTracker tracker(needed);
+    for (auto const & r : m_tentativeResults)
+      tracker.Add(r);
+
+    size_t i = 0;
+    for (; i < bounds.size() && !tracker.IsDominated(bounds[i].first); ++i)
+    {
+      size_t const prevSize = m_tentativeResults.size();
+      addResult(m_preRankerResults[bounds[i].second]);
+      if (m_tentativeResults.size() != prevSize)
+        tracker.Add(m_tentativeResults.back());
+    }
+
+    if (i < bounds.size())
+      LOG(LDEBUG, ("Pruned", bounds.size() - i, "of", bounds.size(), "PreRankerResults by rank upper bound."));
+  }
+
   m_preRankerResults.clear();
 }
 
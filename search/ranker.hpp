@@ -96,6 +96,9 @@ public:
 
   void LoadCountriesTree();
 
+  // Makes ranker add its duration to |timings|, must be called before the search.
+  void SetStageTimings(StageTimings & timings) { m_stageTimings = &timings; }
+
 private:
   friend class RankerResultMaker;
 
@@ -125,5 +128,7 @@ private:
 
   std::vector<PreRankerResult> m_preRankerResults;
   std::vector<RankerResult> m_tentativeResults;
+
+  StageTimings * m_stageTimings = nullptr;
 };
 }  // namespace search
@@ -1,5 +1,6 @@
 #include "search/ranking_info.hpp"
 
+#include "search/pre_ranking_info.hpp"
 #include "search/utils.hpp"
 
 #include "indexer/classificator.hpp"
@@ -8,7 +9,9 @@
 #include "base/assert.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <limits>
 #include <sstream>
 
@@ -423,6 +426,58 @@ double RankingInfo::GetLinearModelRank(bool viewportMode /* = false */) const
   return result;
 }
 
+// static
+double RankingInfo::GetLinearModelRankUpperBound(PreRankingInfo const & info, bool categorialRequest)
+{
+  // Max error of the distance estimated by the pre-ranker (centers table coding, etc).
+  double constexpr kDistanceSlackM = 1000.0;
+
+  // The distance may be reset to the distance to the matched city by the ranker.
+  double distanceToPivot = 0.0;
+  if (info.m_centerLoaded &&
+      (categorialRequest || Model::IsLocalityType(info.m_type) || !info.m_cityId.IsValid()))
+  {
+    distanceToPivot = TransformDistance(max(0.0, info.m_distanceToPivot - kDistanceSlackM));
+  }
+
+  // See NormalizeRank in ranker.cpp: small ranks are zeroed, cities may be boosted.
+  double constexpr kMaxRankBoost = 1.8;
+  double rank = 0.0;
+  if (info.m_rank > 70)
+  {
+    rank = static_cast<double>(info.m_rank) / numeric_limits<uint8_t>::max();
+    if (info.m_type == Model::TYPE_CITY)
+      rank *= kMaxRankBoost;
+  }
+  double const popularity = static_cast<double>(info.m_popularity) / numeric_limits<uint8_t>::max();
+
+  if (categorialRequest)
+  {
+    return kCategoriesDistanceToPivot * distanceToPivot + kCategoriesRank * rank +
+           kCategoriesPopularity * popularity + kHasName;
+  }
+
+  double result = kDistanceToPivot * distanceToPivot + kRank * rank;
+  if (Model::IsLocalityType(info.m_type))
+    result += kPopularity * popularity;
+
+  ASSERT(info.m_type < Model::TYPE_COUNT, ());
+  // GetTypeScore() may only lower the type score.
+  result += kType[info.m_type];
+
+  if (Model::IsPoi(info.m_type))
+    result += *max_element(begin(kPoiType), end(kPoiType));
+  else if (info.m_type == Model::TYPE_STREET)
+    result += *max_element(begin(kStreetType), end(kStreetType));
+
+  if (info.m_allTokensUsed)
+    result += kAllTokensUsed;
+
+  // Zero errors, all characters matched, no common tokens and alt names penalties.
+  result += *max_element(begin(kNameScore), end(kNameScore)) + kMatchedFraction;
+  return result;
+}
+
 // We build LevensteinDFA based on feature tokens to match query.
 // Feature tokens can be longer than query tokens that's why every query token can be
 // matched to feature token with maximal supported errors number.
@@ -14,6 +14,8 @@ namespace feature { class TypesHolder; }
 
 namespace search
 {
+struct PreRankingInfo;
+
 /// @note The order is important here (less is better)
 enum class PoiType : uint8_t
 {
@@ -88,6 +90,10 @@ struct RankingInfo : public StoredRankingInfo
 
   static double GetLinearRankViewportThreshold();
 
+  /// @return Upper bound of GetLinearModelRank() (not in the viewport mode) for a result,
+  /// given only the info known before the result's feature is loaded.
+  static double GetLinearModelRankUpperBound(PreRankingInfo const & info, bool categorialRequest);
+
   double GetErrorsMadePerToken() const;
 
   NameScore GetNameScore() const;
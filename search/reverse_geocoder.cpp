@@ -30,8 +30,6 @@ using namespace std;
 namespace
 {
 int constexpr kQueryScale = scales::GetUpperScale();
-/// Max number of tries (nearest houses with housenumber) to check when getting point address.
-size_t constexpr kMaxNumTriesToApproxAddress = 10;
 
 using AppendStreet = function<void(FeatureType & ft)>;
 using FillStreets =
@@ -65,7 +63,12 @@ ReverseGeocoder::Building FromFeatureImpl(FeatureType & ft, std::string const &
   return { ft.GetID(), distMeters, hn, feature::GetCenter(ft) };
 }
 
-std::string const & GetHouseNumber(FeatureType & ft)
+}  // namespace
+
+ReverseGeocoder::ReverseGeocoder(DataSource const & dataSource) : m_dataSource(dataSource) {}
+
+// static
+std::string const & ReverseGeocoder::GetHouseNumber(FeatureType & ft)
 {
   std::string const & hn = ft.GetHouseNumber();
   if (hn.empty() && ftypes::IsAddressInterpolChecker::Instance()(ft))
@@ -73,10 +76,6 @@ std::string const & GetHouseNumber(FeatureType & ft)
   return hn;
 }
 
-}  // namespace
-
-ReverseGeocoder::ReverseGeocoder(DataSource const & dataSource) : m_dataSource(dataSource) {}
-
 template <class ObjT, class FilterT>
 vector<ObjT> GetNearbyObjects(search::MwmContext & context, m2::PointD const & center,
                               double radiusM, FilterT && filter)
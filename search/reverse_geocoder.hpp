@@ -50,6 +50,8 @@ class ReverseGeocoder
 public:
   /// All "Nearby" functions work in this lookup radius.
   static int constexpr kLookupRadiusM = 500;
+  /// Max number of tries (nearest houses with housenumber) to check when getting point address.
+  static size_t constexpr kMaxNumTriesToApproxAddress = 10;
 
   explicit ReverseGeocoder(DataSource const & dataSource);
 
@@ -127,6 +129,9 @@ public:
   static std::vector<Place> GetNearbyPlaces(
       search::MwmContext & context, m2::PointD const & center, double radiusM);
 
+  /// @return House number of |ft| or the ref of an address interpolation line.
+  static std::string const & GetHouseNumber(FeatureType & ft);
+
   /// @return feature street name.
   /// Returns empty string when there is no street the feature belongs to.
   std::string GetFeatureStreetName(FeatureType & ft) const;
@@ -9,6 +9,7 @@
 #include "search/ranker.hpp"
 #include "search/search_tests_support/helpers.hpp"
 #include "search/search_tests_support/test_search_engine.hpp"
+#include "search/stage_timings.hpp"
 #include "search/suggest.hpp"
 
 #include "indexer/categories_holder.hpp"
@@ -122,7 +123,11 @@ UNIT_CLASS_TEST(PreRankerTest, Smoke)
   TestRanker ranker(m_dataSource, m_engine.GetCountryInfoGetter(), boundariesTable, keywordsScorer,
                     emitter, m_suggests, villagesCache, m_cancellable, pois.size(), results);
 
+  StageTimings timings;
+  ranker.SetStageTimings(timings);
+
   PreRanker preRanker(m_dataSource, ranker);
+  preRanker.SetStageTimings(timings);
   PreRanker::Params params;
   params.m_viewport = kViewport;
   params.m_accuratePivotCenter = kPivot;
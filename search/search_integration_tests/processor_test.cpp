@@ -16,6 +16,8 @@
 #include "search/token_range.hpp"
 #include "search/token_slice.hpp"
 
+#include "storage/country_info_getter.hpp"
+
 #include "indexer/feature_impl.hpp"
 
 #include "geometry/mercator.hpp"
@@ -3667,4 +3669,78 @@ UNIT_CLASS_TEST(ProcessorTest, NonSearchable_Categories)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, SharedDecodedCenters)
+{
+  string const countryName = "Wonderland";
+  TestCountry wonderlandCountry({10, 10}, countryName, "en");
+  TestCity losAlamosCity({10, 10}, "Los Alamos", "en", 100 /* rank */);
+
+  TestStreet feynmanStreet({{9.999, 9.999}, {10, 10}, {10.001, 10.001}}, "Feynman street", "en");
+  TestStreet bohrStreet({{9.999, 10.001}, {10, 10}, {10.001, 9.999}}, "Bohr street", "en");
+  TestStreet farBohrStreet({{10.1, 10.1}, {10.101, 10.101}}, "Bohr street", "en");
+
+  TestBuilding feynmanHouse({10, 10}, "Feynman house", "1", feynmanStreet.GetName("en"), "en");
+  TestBuilding bohrHouse({10.0005, 10.0005}, "Bohr house", "2", bohrStreet.GetName("en"), "en");
+  TestBuilding farBohrHouse({10.1, 10.1}, "", "2", farBohrStreet.GetName("en"), "en");
+  TestPOI lantern({10.0005, 10.0006}, "lantern", "en");
+
+  BuildWorld([&](TestMwmBuilder & builder)
+  {
+    builder.Add(wonderlandCountry);
+    builder.Add(losAlamosCity);
+  });
+  auto const wonderlandId = BuildCountry(countryName, [&](TestMwmBuilder & builder)
+  {
+    builder.Add(losAlamosCity);
+    builder.Add(feynmanStreet);
+    builder.Add(bohrStreet);
+    builder.Add(farBohrStreet);
+    builder.Add(feynmanHouse);
+    builder.Add(bohrHouse);
+    builder.Add(farBohrHouse);
+    builder.Add(lantern);
+  });
+
+  Engine::Params params;
+  params.m_shareDecodedCenters = true;
+  TestSearchEngine sharedEngine(m_dataSource, params, true /* mockCountryInfo */);
+  auto & infoGetter =
+      dynamic_cast<storage::CountryInfoGetterForTesting &>(sharedEngine.GetCountryInfoGetter());
+  infoGetter.AddCountry(storage::CountryDef(countryName, wonderlandId.GetInfo()->m_bordersRect));
+  sharedEngine.LoadCitiesBoundaries();
+
+  // Both engines must return the same results in the same order.
+  auto const check = [&](string const & query, Mode mode, m2::RectD const & viewport) {
+    TestSearchRequest request(m_engine, query, "en", mode, viewport);
+    request.Run();
+    TestSearchRequest sharedRequest(sharedEngine, query, "en", mode, viewport);
+    sharedRequest.Run();
+
+    auto const & results = request.Results();
+    auto const & sharedResults = sharedRequest.Results();
+    TEST(!results.empty(), (query));
+    TEST_EQUAL(results.size(), sharedResults.size(), (query, results, sharedResults));
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      TEST_EQUAL(results[i].GetResultType(), sharedResults[i].GetResultType(), (query, i));
+      TEST_EQUAL(results[i].GetString(), sharedResults[i].GetString(), (query, i));
+      if (results[i].GetResultType() == Result::Type::Feature)
+        TEST_EQUAL(results[i].GetFeatureID(), sharedResults[i].GetFeatureID(), (query, i));
+    }
+  };
+
+  m2::RectD const nearViewport(9.99, 9.99, 10.01, 10.01);
+  m2::RectD const farViewport(-1, -1, 1, 1);
+  for (auto const & query : {"Feynman street 1", "Bohr street 2", "lantern Bohr street",
+                             "Los Alamos Feynman street", "Feynman"})
+  {
+    check(query, Mode::Everywhere, nearViewport);
+    check(query, Mode::Everywhere, farViewport);
+    check(query, Mode::Viewport, nearViewport);
+  }
+
+  auto const usage = sharedEngine.GetEngine().GetDecodedCentersMemoryUsage();
+  TEST(!usage.empty(), ());
+  TEST(m_engine.GetEngine().GetDecodedCentersMemoryUsage().empty(), ());
+}
 } // namespace processor_test
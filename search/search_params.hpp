@@ -17,6 +17,7 @@
 namespace search
 {
 class Results;
+class StageTimings;
 class Tracer;
 
 struct SearchParams
@@ -33,6 +34,7 @@ struct SearchParams
 
   using OnStarted = std::function<void()>;
   using OnResults = std::function<void(Results const &)>;
+  using OnStageTimings = std::function<void(StageTimings const &)>;
 
   bool IsEqualCommon(SearchParams const & rhs) const;
 
@@ -59,6 +61,10 @@ struct SearchParams
   // the search may decide against duplicating calls but no guarantees are given.
   OnResults m_onResults;
 
+  // Called with durations of search stages before the last call of
+  // |m_onResults|. Not called for cancelled and bookmarks requests.
+  OnStageTimings m_onStageTimings;
+
   std::string m_query;
   std::string m_inputLocale;
 
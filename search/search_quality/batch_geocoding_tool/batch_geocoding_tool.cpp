@@ -0,0 +1,210 @@
+#include "search/search_quality/helpers.hpp"
+
+#include "search/search_tests_support/test_search_engine.hpp"
+
+#include "search/batch_search.hpp"
+#include "search/result.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_source.hpp"
+
+#include "platform/platform_tests_support/helpers.hpp"
+
+#include "geometry/latlon.hpp"
+#include "geometry/mercator.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+using namespace search::search_quality;
+using namespace search::tests_support;
+using namespace search;
+using namespace std;
+
+DEFINE_string(data_path, "", "Path to data directory (resources dir)");
+DEFINE_string(locale, "en", "Locale of all the search queries");
+DEFINE_int32(num_threads, 1, "Number of search engine threads");
+DEFINE_string(mwm_list_path, "",
+              "Path to a file containing the names of available mwms, one per line");
+DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
+DEFINE_string(viewport, "", "Default viewport for queries without coordinates "
+                            "(default, moscow, london, zurich)");
+DEFINE_string(input, "", "Path to the file with queries, one per line. A line is either "
+                         "<query> or <lat>;<lon>;<query>, where (lat, lon) is used as "
+                         "the center of the viewport (default: stdin)");
+DEFINE_string(output, "", "Path to the CSV file the results will be written to (default: stdout). "
+                          "Fields with ';' or '\"' are quoted with '\"'");
+DEFINE_int32(chunk_size, 100000, "Max number of rows kept in memory at once");
+DEFINE_int32(group_size, 64, "Max number of queries processed by one engine task");
+DEFINE_double(viewport_size_m, 5000, "Size of the viewport built around query coordinates");
+
+double constexpr kGroupCellSizeMercator = 0.5;
+
+// Parses |line| in the format described for the --input flag. |text| is set to
+// the query text as it is given in |line|.
+BatchSearch::Query ParseQuery(string const & line, m2::RectD const & defaultViewport,
+                              string & text)
+{
+  vector<string> parts;
+  strings::Tokenize(line, ";", [&parts](string_view s) { parts.emplace_back(s); });
+
+  m2::RectD viewport = defaultViewport;
+  text = line;
+  double lat, lon;
+  if (parts.size() >= 3 && strings::to_double(parts[0], lat) && strings::to_double(parts[1], lon))
+  {
+    auto const pos = line.find(';', line.find(';') + 1);
+    viewport = mercator::RectByCenterLatLonAndSizeInMeters(lat, lon, FLAGS_viewport_size_m);
+    text = line.substr(pos + 1);
+  }
+
+  // The trailing space makes the last token of the query complete, not a prefix.
+  return BatchSearch::Query(text + " ", viewport);
+}
+
+string ToCSVRow(size_t row, string const & query, Results const & results)
+{
+  ostringstream os;
+  os << fixed << setprecision(7);
+  os << row << ';' << ToCSVField(query) << ';';
+  if (results.GetCount() == 0)
+  {
+    os << ";;;;";
+    return os.str();
+  }
+
+  auto const & r = results[0];
+  os << ToCSVField(r.GetString()) << ';';
+  if (r.HasPoint())
+  {
+    auto const ll = mercator::ToLatLon(r.GetFeatureCenter());
+    os << ll.m_lat << ';' << ll.m_lon << ';';
+  }
+  else
+  {
+    os << ";;";
+  }
+
+  if (r.GetResultType() == Result::Type::Feature)
+    os << ToCSVField(r.GetFeatureID().GetMwmName()) << ';' << r.GetFeatureID().m_index;
+  else
+    os << ';';
+  return os.str();
+}
+
+int main(int argc, char * argv[])
+{
+  platform::tests_support::ChangeMaxNumberOfOpenFiles(kMaxOpenFiles);
+  CheckLocale();
+
+  gflags::SetUsageMessage("Batch geocoding of addresses.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  CHECK_GREATER(FLAGS_chunk_size, 0, ());
+  CHECK_GREATER(FLAGS_group_size, 0, ());
+
+  SetPlatformDirs(FLAGS_data_path, FLAGS_mwm_path);
+
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  InitDataSource(dataSource, FLAGS_mwm_list_path);
+
+  auto engine = InitSearchEngine(dataSource, FLAGS_locale, FLAGS_num_threads);
+  engine->InitAffiliations();
+
+  m2::RectD defaultViewport;
+  InitViewport(FLAGS_viewport, defaultViewport);
+
+  ios_base::sync_with_stdio(false);
+
+  ifstream fin;
+  if (!FLAGS_input.empty())
+  {
+    fin.open(FLAGS_input);
+    CHECK(fin.is_open(), ("Can't open", FLAGS_input));
+  }
+  istream & in = FLAGS_input.empty() ? cin : fin;
+
+  ofstream fout;
+  if (!FLAGS_output.empty())
+  {
+    fout.open(FLAGS_output);
+    CHECK(fout.is_open(), ("Can't open", FLAGS_output));
+  }
+  ostream & out = FLAGS_output.empty() ? cout : fout;
+  out << "Row;Query;Result;Lat;Lon;Mwm;FeatureIndex" << endl;
+
+  BatchSearch::Params params;
+  params.m_locale = FLAGS_locale;
+  params.m_cellSize = kGroupCellSizeMercator;
+  params.m_maxGroupSize = static_cast<size_t>(FLAGS_group_size);
+  BatchSearch batchSearch(engine->GetEngine(), params);
+
+  base::Timer timer;
+  size_t totalRows = 0;
+  size_t totalCancelled = 0;
+
+  auto const chunkSize = static_cast<size_t>(FLAGS_chunk_size);
+  vector<BatchSearch::Query> queries;
+  vector<string> texts;
+  vector<string> rows;
+  string line;
+  bool eof = false;
+  while (!eof)
+  {
+    queries.clear();
+    texts.clear();
+    while (queries.size() < chunkSize)
+    {
+      if (!getline(in, line))
+      {
+        eof = true;
+        break;
+      }
+      strings::Trim(line);
+      if (!line.empty())
+      {
+        texts.emplace_back();
+        queries.push_back(ParseQuery(line, defaultViewport, texts.back()));
+      }
+    }
+
+    if (queries.empty())
+      break;
+
+    // Each query writes only its own row, so no synchronization is needed here.
+    rows.assign(queries.size(), {});
+    auto const stats = batchSearch.Run(queries, [&](size_t i, Results const & results)
+    {
+      rows[i] = ToCSVRow(totalRows + i, texts[i], results);
+    });
+
+    for (auto const & row : rows)
+      out << row << '\n';
+    out.flush();
+
+    totalRows += queries.size();
+    totalCancelled += stats.m_numCancelled;
+    LOG(LINFO, ("Chunk done:", DebugPrint(stats)));
+  }
+
+  double const elapsed = timer.ElapsedSeconds();
+  cerr << fixed << setprecision(3);
+  cerr << "Rows processed: " << totalRows << endl;
+  cerr << "Rows cancelled by timeout: " << totalCancelled << endl;
+  cerr << "Elapsed time: " << elapsed << "s" << endl;
+  cerr << "Rows per second: " << (elapsed > 0 ? static_cast<double>(totalRows) / elapsed : 0.0)
+       << endl;
+  return 0;
+}
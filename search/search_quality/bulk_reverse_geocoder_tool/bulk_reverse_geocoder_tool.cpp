@@ -0,0 +1,158 @@
+#include "search/search_quality/helpers.hpp"
+
+#include "search/bulk_reverse_geocoder.hpp"
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_source.hpp"
+
+#include "platform/platform_tests_support/helpers.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+using namespace search::search_quality;
+using namespace search;
+using namespace std;
+
+DEFINE_string(data_path, "", "Path to data directory (resources dir)");
+DEFINE_string(mwm_list_path, "",
+              "Path to a file containing the names of available mwms, one per line");
+DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
+DEFINE_string(input, "", "Path to the file with points, one <lat>;<lon> pair per line "
+                         "(default: stdin)");
+DEFINE_string(output, "", "Path to the CSV file the addresses will be written to "
+                          "(default: stdout). Fields with ';' or '\"' are quoted with '\"'");
+DEFINE_int32(num_threads, 1, "Number of threads");
+DEFINE_int32(chunk_size, 1000000, "Max number of points kept in memory at once");
+DEFINE_int32(batch_size, 256, "Max number of points sharing loaded geometry");
+DEFINE_double(batch_span_m, 2000, "Max size of the bounding box of a batch, in meters");
+DEFINE_double(max_distance_m, ReverseGeocoder::kLookupRadiusM,
+              "Max distance from a point to its address, in meters");
+
+int main(int argc, char * argv[])
+{
+  platform::tests_support::ChangeMaxNumberOfOpenFiles(kMaxOpenFiles);
+
+  gflags::SetUsageMessage("Bulk reverse geocoding of points.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  CHECK_GREATER(FLAGS_num_threads, 0, ());
+  CHECK_GREATER(FLAGS_chunk_size, 0, ());
+  CHECK_GREATER(FLAGS_batch_size, 0, ());
+
+  SetPlatformDirs(FLAGS_data_path, FLAGS_mwm_path);
+
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  InitDataSource(dataSource, FLAGS_mwm_list_path);
+
+  ios_base::sync_with_stdio(false);
+
+  ifstream fin;
+  if (!FLAGS_input.empty())
+  {
+    fin.open(FLAGS_input);
+    CHECK(fin.is_open(), ("Can't open", FLAGS_input));
+  }
+  istream & in = FLAGS_input.empty() ? cin : fin;
+
+  ofstream fout;
+  if (!FLAGS_output.empty())
+  {
+    fout.open(FLAGS_output);
+    CHECK(fout.is_open(), ("Can't open", FLAGS_output));
+  }
+  ostream & out = FLAGS_output.empty() ? cout : fout;
+  out << fixed << setprecision(2);
+  out << "Row;Street;House;Distance" << endl;
+
+  BulkReverseGeocoder::Params params;
+  params.m_numThreads = static_cast<size_t>(FLAGS_num_threads);
+  params.m_maxBatchSize = static_cast<size_t>(FLAGS_batch_size);
+  params.m_maxBatchSpanM = FLAGS_batch_span_m;
+  params.m_maxDistanceM = FLAGS_max_distance_m;
+  BulkReverseGeocoder geocoder(dataSource, params);
+
+  BulkReverseGeocoder::Stats total;
+  size_t row = 0;
+  size_t malformed = 0;
+
+  auto const chunkSize = static_cast<size_t>(FLAGS_chunk_size);
+  vector<m2::PointD> points;
+  vector<size_t> rows;
+  vector<ReverseGeocoder::Address> addresses;
+  string line;
+  bool eof = false;
+  while (!eof)
+  {
+    points.clear();
+    rows.clear();
+    while (points.size() < chunkSize)
+    {
+      if (!getline(in, line))
+      {
+        eof = true;
+        break;
+      }
+
+      auto const parts = strings::Tokenize<string>(line, ";, \t");
+      double lat, lon;
+      if (parts.size() != 2 || !strings::to_double(parts[0], lat) ||
+          !strings::to_double(parts[1], lon))
+      {
+        LOG(LWARNING, ("Malformed line", row, ":", line));
+        ++malformed;
+        ++row;
+        continue;
+      }
+
+      points.push_back(mercator::FromLatLon(lat, lon));
+      rows.push_back(row++);
+    }
+
+    if (points.empty())
+      continue;
+
+    auto const stats = geocoder.GetNearbyAddresses(points, addresses);
+    LOG(LINFO, ("Chunk done:", DebugPrint(stats)));
+
+    total.m_numPoints += stats.m_numPoints;
+    total.m_numBatches += stats.m_numBatches;
+    total.m_numFeatureReads += stats.m_numFeatureReads;
+    total.m_numAddressesFound += stats.m_numAddressesFound;
+    total.m_elapsedSeconds += stats.m_elapsedSeconds;
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      auto const & addr = addresses[i];
+      out << rows[i] << ';';
+      if (addr.IsValid())
+      {
+        out << ToCSVField(addr.GetStreetName()) << ';' << ToCSVField(addr.GetHouseNumber()) << ';'
+            << addr.GetDistance();
+      }
+      else
+      {
+        out << ";;";
+      }
+      out << '\n';
+    }
+    out.flush();
+  }
+
+  cerr << "Malformed lines: " << malformed << endl;
+  cerr << DebugPrint(total) << endl;
+  return 0;
+}
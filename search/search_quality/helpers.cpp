@@ -89,6 +89,22 @@ void ReadStringsFromFile(string const & path, vector<string> & result)
   }
 }
 
+string ToCSVField(string const & field)
+{
+  if (field.find_first_of(";\"\r\n") == string::npos)
+    return field;
+
+  string result = "\"";
+  for (char const c : field)
+  {
+    if (c == '"')
+      result += '"';
+    result += c;
+  }
+  result += '"';
+  return result;
+}
+
 void SetPlatformDirs(string const & dataPath, string const & mwmPath)
 {
   Platform & platform = GetPlatform();
@@ -150,11 +166,12 @@ void InitDataSource(FrozenDataSource & dataSource, string const & mwmListPath)
 }
 
 unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
-    DataSource & dataSource, string const & locale, size_t numThreads)
+    DataSource & dataSource, string const & locale, size_t numThreads, bool shareDecodedCenters)
 {
   search::Engine::Params params;
   params.m_locale = locale;
   params.m_numThreads = base::checked_cast<size_t>(numThreads);
+  params.m_shareDecodedCenters = shareDecodedCenters;
 
   return make_unique<search::tests_support::TestSearchEngine>(dataSource, params);
 }
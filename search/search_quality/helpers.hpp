@@ -22,6 +22,10 @@ void CheckLocale();
 
 void ReadStringsFromFile(std::string const & path, std::vector<std::string> & result);
 
+// Quotes |field| for a ';'-separated CSV file if it contains the separator,
+// quotes or line breaks.
+std::string ToCSVField(std::string const & field);
+
 void SetPlatformDirs(std::string const & dataPath, std::string const & mwmPath);
 
 void InitViewport(std::string viewportName, m2::RectD & viewport);
@@ -29,6 +33,7 @@ void InitViewport(std::string viewportName, m2::RectD & viewport);
 void InitDataSource(FrozenDataSource & dataSource, std::string const & mwmListPath);
 
 std::unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
-    DataSource & dataSource, std::string const & locale, size_t numThreads);
+    DataSource & dataSource, std::string const & locale, size_t numThreads,
+    bool shareDecodedCenters = false);
 }  // namespace search_quality
 }  // namespace search
@@ -0,0 +1,20 @@
+#include "testing/testing.hpp"
+
+#include "search/search_quality/helpers.hpp"
+
+#include <string>
+
+namespace helpers_tests
+{
+using namespace search::search_quality;
+using namespace std;
+
+UNIT_TEST(ToCSVField)
+{
+  TEST_EQUAL(ToCSVField(""), "", ());
+  TEST_EQUAL(ToCSVField("Main street"), "Main street", ());
+  TEST_EQUAL(ToCSVField("1;2"), "\"1;2\"", ());
+  TEST_EQUAL(ToCSVField("\"Red\" square"), "\"\"\"Red\"\" square\"", ());
+  TEST_EQUAL(ToCSVField("line\nbreak"), "\"line\nbreak\"", ());
+}
+}  // namespace helpers_tests
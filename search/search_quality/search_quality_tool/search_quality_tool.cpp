@@ -6,6 +6,7 @@
 #include "search/ranking_info.hpp"
 #include "search/result.hpp"
 #include "search/search_params.hpp"
+#include "search/stage_timings.hpp"
 
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_source.hpp"
@@ -50,6 +51,8 @@ using namespace std;
 DEFINE_string(data_path, "", "Path to data directory (resources dir)");
 DEFINE_string(locale, "en", "Locale of all the search queries");
 DEFINE_int32(num_threads, 1, "Number of search engine threads");
+DEFINE_bool(share_decoded_centers, false,
+            "Decode centers tables once and share them between search engine threads");
 DEFINE_string(mwm_list_path, "",
               "Path to a file containing the names of available mwms, one per line");
 DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
@@ -58,6 +61,8 @@ DEFINE_int32(top, 1, "Number of top results to show for every query");
 DEFINE_string(viewport, "", "Viewport to use when searching (default, moscow, london, zurich)");
 DEFINE_string(check_completeness, "", "Path to the file with completeness data");
 DEFINE_string(ranking_csv_file, "", "File ranking info will be exported to");
+DEFINE_string(stage_timings_csv_file, "",
+              "File per-query durations of search stages (in ms) will be exported to");
 
 string const kDefaultQueriesPathSuffix =
     "/../search/search_quality/search_quality_tool/queries.txt";
@@ -289,8 +294,23 @@ void CheckCompleteness(string const & path, DataSource & dataSource, TestSearchE
        << expectedResultsTop1Percentage << "%)." << endl;
 }
 
+void PrintStageTimingsCSVHeader(ostream & os)
+{
+  os << "Query";
+  for (size_t i = 0; i < kNumSearchStages; ++i)
+    os << "," << DebugPrint(static_cast<SearchStage>(i));
+}
+
+void StageTimingsToCSV(size_t query, StageTimings const & timings, ostream & os)
+{
+  os << query;
+  for (size_t i = 0; i < kNumSearchStages; ++i)
+    os << "," << timings.Get(static_cast<SearchStage>(i)) * 1000.0;
+}
+
 void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string queriesPath,
-                 string const & locale, string const & rankingCSVFile, size_t top)
+                 string const & locale, string const & rankingCSVFile,
+                 string const & stageTimingsCSVFile, size_t top)
 {
   vector<string> queries;
   {
@@ -324,6 +344,26 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
     csv << endl;
   }
 
+  ofstream timingsCSV;
+  bool dumpTimingsCSV = false;
+  if (!stageTimingsCSVFile.empty())
+  {
+    timingsCSV.open(stageTimingsCSVFile);
+    if (!timingsCSV.is_open())
+    {
+      LOG(LERROR, ("Can't open file for CSV dump:", stageTimingsCSVFile));
+    }
+    else
+    {
+      dumpTimingsCSV = true;
+      timingsCSV << fixed << setprecision(3);
+      PrintStageTimingsCSVHeader(timingsCSV);
+      timingsCSV << endl;
+    }
+  }
+
+  engine.GetEngine().ResetStageLatencies();
+
   vector<double> responseTimes(queries.size());
   for (size_t i = 0; i < queries.size(); ++i)
   {
@@ -340,6 +380,12 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
         csv << endl;
       }
     }
+
+    if (dumpTimingsCSV)
+    {
+      StageTimingsToCSV(i, requests[i]->GetStageTimings(), timingsCSV);
+      timingsCSV << endl;
+    }
   }
 
   double averageTime;
@@ -353,6 +399,10 @@ void RunRequests(TestSearchEngine & engine, m2::RectD const & viewport, string q
   cout << "Maximum response time: " << maxTime << "s" << endl;
   cout << "Average response time: " << averageTime << "s"
        << " (std. dev. " << stdDevTime << "s)" << endl;
+  cout << DebugPrint(engine.GetEngine().GetStageLatencies()) << endl;
+
+  for (auto const & usage : engine.GetEngine().GetDecodedCentersMemoryUsage())
+    cout << "Decoded centers of " << usage.first << ": " << usage.second << " bytes" << endl;
 }
 
 int main(int argc, char * argv[])
@@ -370,7 +420,8 @@ int main(int argc, char * argv[])
   FrozenDataSource dataSource;
   InitDataSource(dataSource, FLAGS_mwm_list_path);
 
-  auto engine = InitSearchEngine(dataSource, FLAGS_locale, FLAGS_num_threads);
+  auto engine = InitSearchEngine(dataSource, FLAGS_locale, FLAGS_num_threads,
+                                 FLAGS_share_decoded_centers);
   engine->InitAffiliations();
 
   m2::RectD viewport;
@@ -385,6 +436,6 @@ int main(int argc, char * argv[])
   }
 
   RunRequests(*engine, viewport, FLAGS_queries_path, FLAGS_locale, FLAGS_ranking_csv_file,
-              static_cast<size_t>(FLAGS_top));
+              FLAGS_stage_timings_csv_file, static_cast<size_t>(FLAGS_top));
   return 0;
 }
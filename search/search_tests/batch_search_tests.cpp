@@ -0,0 +1,48 @@
+#include "testing/testing.hpp"
+
+#include "search/batch_search.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace batch_search_tests
+{
+using namespace search;
+using namespace std;
+
+using Query = BatchSearch::Query;
+
+m2::RectD MakeViewport(double x, double y)
+{
+  return m2::RectD(x - 0.01, y - 0.01, x + 0.01, y + 0.01);
+}
+
+UNIT_TEST(BatchSearch_MakeGroups_Smoke)
+{
+  TEST(BatchSearch::MakeGroups({}, 1.0 /* cellSize */, 10 /* maxGroupSize */).empty(), ());
+
+  vector<Query> const queries = {
+      Query("a", MakeViewport(0.5, 0.5)),  Query("b", MakeViewport(10.5, 10.5)),
+      Query("c", MakeViewport(0.2, 0.7)),  Query("d", MakeViewport(10.1, 10.9)),
+      Query("e", MakeViewport(-0.5, 0.5)),
+  };
+
+  vector<vector<size_t>> const expected = {{4}, {0, 2}, {1, 3}};
+  TEST_EQUAL(BatchSearch::MakeGroups(queries, 1.0 /* cellSize */, 10 /* maxGroupSize */), expected,
+             ());
+}
+
+UNIT_TEST(BatchSearch_MakeGroups_MaxGroupSize)
+{
+  vector<Query> queries;
+  for (size_t i = 0; i < 7; ++i)
+    queries.emplace_back(to_string(i), MakeViewport(0.5, 0.5));
+
+  vector<vector<size_t>> const expected = {{0, 1, 2}, {3, 4, 5}, {6}};
+  TEST_EQUAL(BatchSearch::MakeGroups(queries, 1.0 /* cellSize */, 3 /* maxGroupSize */), expected,
+             ());
+}
+}  // namespace batch_search_tests
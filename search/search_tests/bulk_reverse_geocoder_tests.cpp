@@ -0,0 +1,63 @@
+#include "testing/testing.hpp"
+
+#include "search/bulk_reverse_geocoder.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/point2d.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bulk_reverse_geocoder_tests
+{
+using namespace search;
+using namespace std;
+
+UNIT_TEST(BulkReverseGeocoder_OrderByHilbertCurve)
+{
+  // Two clusters of points far from each other, interleaved in the input.
+  vector<m2::PointD> const points = {
+      mercator::FromLatLon(53.90, 27.55), mercator::FromLatLon(-33.86, 151.20),
+      mercator::FromLatLon(53.91, 27.56), mercator::FromLatLon(-33.87, 151.21),
+      mercator::FromLatLon(53.90, 27.56),
+  };
+
+  auto const order = BulkReverseGeocoder::OrderByHilbertCurve(points);
+  TEST_EQUAL(order.size(), points.size(), ());
+
+  auto sorted = order;
+  sort(sorted.begin(), sorted.end());
+  TEST_EQUAL(sorted, vector<size_t>({0, 1, 2, 3, 4}), ());
+
+  // Points of the same cluster are adjacent in the order.
+  auto const isMinsk = [](size_t i) { return i % 2 == 0; };
+  size_t switches = 0;
+  for (size_t i = 1; i < order.size(); ++i)
+  {
+    if (isMinsk(order[i]) != isMinsk(order[i - 1]))
+      ++switches;
+  }
+  TEST_EQUAL(switches, 1, (order));
+}
+
+UNIT_TEST(BulkReverseGeocoder_MakeBatches)
+{
+  vector<m2::PointD> points;
+  for (size_t i = 0; i < 5; ++i)
+    points.push_back(mercator::FromLatLon(53.9, 27.55 + 0.0001 * i));
+  points.push_back(mercator::FromLatLon(54.9, 27.55));
+
+  vector<size_t> const order = {0, 1, 2, 3, 4, 5};
+
+  using Batches = vector<pair<size_t, size_t>>;
+  TEST_EQUAL(BulkReverseGeocoder::MakeBatches(points, order, 2 /* maxBatchSize */, 1000 /* maxSpanM */),
+             Batches({{0, 2}, {2, 4}, {4, 5}, {5, 6}}), ());
+  TEST_EQUAL(BulkReverseGeocoder::MakeBatches(points, order, 10 /* maxBatchSize */, 1000 /* maxSpanM */),
+             Batches({{0, 5}, {5, 6}}), ());
+  TEST_EQUAL(BulkReverseGeocoder::MakeBatches(points, order, 10 /* maxBatchSize */, 1e6 /* maxSpanM */),
+             Batches({{0, 6}}), ());
+  TEST(BulkReverseGeocoder::MakeBatches({}, {}, 10 /* maxBatchSize */, 1000 /* maxSpanM */).empty(), ());
+}
+}  // namespace bulk_reverse_geocoder_tests
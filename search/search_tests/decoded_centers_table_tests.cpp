@@ -0,0 +1,73 @@
+#include "testing/testing.hpp"
+
+#include "search/decoded_centers_table.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace decoded_centers_table_tests
+{
+using namespace search;
+using namespace std;
+
+UNIT_TEST(DecodedCentersTable_Get)
+{
+  vector<pair<uint32_t, m2::PointD>> const centers = {
+      {0, m2::PointD(1.0, 2.0)}, {3, m2::PointD(-10.5, 20.25)}, {5, m2::PointD(179.0, -179.0)}};
+  auto const table = DecodedCentersTable::Build(centers);
+  TEST(table, ());
+  TEST_EQUAL(table->Count(), centers.size(), ());
+
+  for (auto const & c : centers)
+  {
+    m2::PointD center;
+    TEST(table->Get(c.first, center), (c.first));
+    TEST(center.EqualDxDy(c.second, 1e-6), (center, c.second));
+  }
+
+  m2::PointD center;
+  TEST(!table->Get(1, center), ());
+  TEST(!table->Get(4, center), ());
+  TEST(!table->Get(100, center), ());
+}
+
+UNIT_TEST(DecodedCentersTable_Rect)
+{
+  // Features on a 10x10 grid with a step of 1, every seventh one has no center.
+  vector<pair<uint32_t, m2::PointD>> centers;
+  for (uint32_t id = 0; id < 100; ++id)
+  {
+    if (id % 7 != 0)
+      centers.emplace_back(id, m2::PointD(id % 10, id / 10));
+  }
+  auto const table = DecodedCentersTable::Build(centers);
+
+  m2::RectD const rect(1.5, 1.5, 3.5, 7.5);
+  vector<uint32_t> expected;
+  for (auto const & c : centers)
+  {
+    if (rect.IsPointInside(c.second))
+      expected.push_back(c.first);
+  }
+
+  vector<uint32_t> ids;
+  for (uint32_t id = 0; id < 110; ++id)
+    ids.push_back(id);
+  vector<bool> inside(ids.size(), false);
+  table->MarkInsideRect(ids, rect, inside);
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    bool const isExpected = find(expected.begin(), expected.end(), ids[i]) != expected.end();
+    TEST_EQUAL(inside[i], isExpected, (ids[i]));
+  }
+
+  inside.assign(ids.size(), false);
+  table->MarkInsideRect(ids, m2::RectD(), inside);
+  TEST(find(inside.begin(), inside.end(), true) == inside.end(), ());
+}
+}  // namespace decoded_centers_table_tests
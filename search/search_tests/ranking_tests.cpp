@@ -1,6 +1,7 @@
 #include "testing/testing.hpp"
 
 #include "search/pre_ranker.hpp"
+#include "search/pre_ranking_info.hpp"
 #include "search/query_params.hpp"
 #include "search/ranking_utils.hpp"
 #include "search/ranking_info.hpp"
@@ -13,6 +14,7 @@
 #include "base/string_utils.hpp"
 
 #include <cstdint>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -247,6 +249,162 @@ UNIT_TEST(RankingInfo_PrefixVsFull)
   }
 }
 
+namespace
+{
+// Info of a registered mwm, so ids of its features are valid.
+class RegisteredMwmInfo : public MwmInfo
+{
+public:
+  RegisteredMwmInfo() { SetStatus(STATUS_REGISTERED); }
+};
+
+// Makes a ranking info which the ranker may compute for a feature with |preInfo|,
+// see Ranker's InitRankingInfo and NormalizeRank.
+RankingInfo MakeRankingInfo(PreRankingInfo const & preInfo, bool categorialRequest, mt19937 & rng)
+{
+  auto const randomBool = [&rng]() { return uniform_int_distribution<int>(0, 1)(rng) == 1; };
+  auto const randomReal = [&rng](double min, double max)
+  {
+    return uniform_real_distribution<double>(min, max)(rng);
+  };
+
+  RankingInfo info;
+  info.m_type = preInfo.m_type;
+  info.m_tokenRanges = preInfo.m_tokenRanges;
+  info.m_allTokensUsed = preInfo.m_allTokensUsed;
+  info.m_exactMatch = preInfo.m_exactMatch;
+  info.m_categorialRequest = categorialRequest;
+  info.m_popularity = preInfo.m_popularity;
+
+  // The pre-ranker's distance may differ from the real one by the centers table coding error,
+  // and the ranker may use the distance to the matched city instead.
+  if (preInfo.m_centerLoaded &&
+      (categorialRequest || Model::IsLocalityType(preInfo.m_type) || !preInfo.m_cityId.IsValid()))
+  {
+    info.m_distanceToPivot = randomReal(max(0.0, preInfo.m_distanceToPivot - 1000.0),
+                                        preInfo.m_distanceToPivot + 1000.0);
+  }
+  else
+  {
+    info.m_distanceToPivot = randomReal(0.0, 2 * RankingInfo::kMaxDistMeters);
+  }
+
+  uint16_t rank = preInfo.m_rank;
+  if (rank <= 70)
+  {
+    rank = 0;
+  }
+  else
+  {
+    if (!preInfo.m_allTokensUsed)
+      rank /= 5.0;
+    switch (preInfo.m_type)
+    {
+    case Model::TYPE_VILLAGE: rank /= 2.5; break;
+    case Model::TYPE_CITY:
+    {
+      double const factors[] = {1.8, 1.7, 1 / 1.5};
+      rank *= factors[uniform_int_distribution<size_t>(0, size(factors) - 1)(rng)];
+      break;
+    }
+    case Model::TYPE_STATE: rank /= 1.5; break;
+    default: break;
+    }
+  }
+  info.m_rank = rank;
+
+  if (Model::IsPoi(info.m_type))
+  {
+    info.m_classifType.poi = static_cast<PoiType>(
+        uniform_int_distribution<int>(0, base::E2I(PoiType::Count) - 1)(rng));
+  }
+  else if (info.m_type == Model::TYPE_STREET)
+  {
+    info.m_classifType.street = static_cast<StreetType>(
+        uniform_int_distribution<int>(0, base::Underlying(StreetType::Count) - 1)(rng));
+  }
+
+  info.m_numTokens = uniform_int_distribution<uint16_t>(1, 5)(rng);
+  info.m_nameScore = static_cast<NameScore>(
+      uniform_int_distribution<int>(0, base::E2I(NameScore::COUNT) - 1)(rng));
+  info.m_errorsMade = randomBool() ? ErrorsMade(uniform_int_distribution<uint16_t>(0, 3)(rng))
+                                   : ErrorsMade();
+  info.m_matchedFraction = randomReal(0.0, 1.0);
+  info.m_commonTokensFactor = uniform_int_distribution<int16_t>(0, 3)(rng);
+  info.m_isAltOrOldName = randomBool();
+  info.m_pureCats = randomBool();
+  info.m_falseCats = randomBool();
+  info.m_hasName = randomBool();
+  return info;
+}
+}  // namespace
+
+UNIT_TEST(RankingInfo_UpperBound)
+{
+  RankingInfo info;
+  info.m_nameScore = NameScore::FULL_MATCH;
+  info.m_errorsMade = ErrorsMade(0);
+  info.m_numTokens = 1;
+  info.m_matchedFraction = 1;
+  info.m_allTokensUsed = true;
+  info.m_exactMatch = true;
+  info.m_distanceToPivot = 5000;
+  info.m_rank = 100;
+  info.m_popularity = 10;
+
+  for (auto const type : {Model::TYPE_SUBPOI, Model::TYPE_STREET, Model::TYPE_CITY})
+  {
+    auto actual = info;
+    actual.m_type = type;
+    actual.m_tokenRanges[type] = TokenRange(0, 1);
+    if (type == Model::TYPE_SUBPOI)
+      actual.m_classifType.poi = PoiType::Eat;
+
+    PreRankingInfo preInfo(type, TokenRange(0, 1));
+    preInfo.m_distanceToPivot = actual.m_distanceToPivot;
+    preInfo.m_centerLoaded = true;
+    preInfo.m_rank = actual.m_rank;
+    preInfo.m_popularity = actual.m_popularity;
+
+    TEST_LESS_OR_EQUAL(actual.GetLinearModelRank(),
+                       RankingInfo::GetLinearModelRankUpperBound(preInfo, false /* categorialRequest */),
+                       (actual, preInfo));
+
+    // A candidate which is much farther away from the pivot can't be better.
+    preInfo.m_distanceToPivot = 1e6;
+    TEST_LESS(RankingInfo::GetLinearModelRankUpperBound(preInfo, false /* categorialRequest */),
+              actual.GetLinearModelRank(), (actual, preInfo));
+  }
+
+  MwmSet::MwmId const mwmId(make_shared<RegisteredMwmInfo>());
+  mt19937 rng(0);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    auto const type = static_cast<Model::Type>(
+        uniform_int_distribution<int>(0, Model::TYPE_COUNT - 1)(rng));
+    PreRankingInfo preInfo(type, TokenRange(0, 1));
+    preInfo.m_distanceToPivot =
+        uniform_real_distribution<double>(0.0, 2 * RankingInfo::kMaxDistMeters)(rng);
+    preInfo.m_centerLoaded = uniform_int_distribution<int>(0, 1)(rng) == 1;
+    preInfo.m_allTokensUsed = uniform_int_distribution<int>(0, 1)(rng) == 1;
+    preInfo.m_exactMatch = uniform_int_distribution<int>(0, 1)(rng) == 1;
+    preInfo.m_rank = uniform_int_distribution<int>(0, 255)(rng);
+    preInfo.m_popularity = uniform_int_distribution<int>(0, 255)(rng);
+    if (uniform_int_distribution<int>(0, 1)(rng) == 1)
+      preInfo.m_cityId = FeatureID(mwmId, 0);
+
+    for (bool const categorialRequest : {false, true})
+    {
+      auto const bound = RankingInfo::GetLinearModelRankUpperBound(preInfo, categorialRequest);
+      for (size_t j = 0; j < 10; ++j)
+      {
+        auto const info = MakeRankingInfo(preInfo, categorialRequest, rng);
+        TEST_GREATER_OR_EQUAL(bound, info.GetLinearModelRank(), (info, preInfo));
+      }
+    }
+  }
+}
+
 namespace
 {
 class MwmIdWrapper
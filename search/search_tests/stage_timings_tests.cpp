@@ -0,0 +1,74 @@
+#include "testing/testing.hpp"
+
+#include "search/stage_timings.hpp"
+
+#include <cstdint>
+
+namespace stage_timings_tests
+{
+using namespace search;
+using namespace std;
+
+UNIT_TEST(LatencyHistogram_Smoke)
+{
+  LatencyHistogram histogram;
+  TEST_EQUAL(histogram.GetCount(), 0, ());
+  TEST_EQUAL(histogram.GetPercentile(50), 0, ());
+
+  for (uint64_t i = 1; i <= 10; ++i)
+    histogram.Add(i);
+
+  // Small values are stored exactly.
+  TEST_EQUAL(histogram.GetCount(), 10, ());
+  TEST_EQUAL(histogram.GetMax(), 10, ());
+  TEST_ALMOST_EQUAL_ABS(histogram.GetMean(), 5.5, 1e-9, ());
+  TEST_EQUAL(histogram.GetPercentile(0), 1, ());
+  TEST_EQUAL(histogram.GetPercentile(50), 5, ());
+  TEST_EQUAL(histogram.GetPercentile(90), 9, ());
+  TEST_EQUAL(histogram.GetPercentile(100), 10, ());
+}
+
+UNIT_TEST(LatencyHistogram_RelativeError)
+{
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 100000; ++i)
+    histogram.Add(i);
+
+  for (double const percentile : {10.0, 50.0, 90.0, 99.0, 99.9})
+  {
+    auto const expected = static_cast<double>(percentile * 1000);
+    auto const actual = static_cast<double>(histogram.GetPercentile(percentile));
+    TEST_GREATER_OR_EQUAL(actual, expected, (percentile));
+    TEST_LESS_OR_EQUAL(actual, expected * (1.0 + 1.0 / 16), (percentile));
+  }
+  TEST_EQUAL(histogram.GetPercentile(100), 100000, ());
+
+  LatencyHistogram other;
+  other.Add(uint64_t{1} << 40);
+  histogram.Merge(other);
+  TEST_EQUAL(histogram.GetCount(), 100001, ());
+  TEST_EQUAL(histogram.GetMax(), uint64_t{1} << 40, ());
+  TEST_EQUAL(histogram.GetPercentile(100), uint64_t{1} << 40, ());
+}
+
+UNIT_TEST(StageLatencies_Smoke)
+{
+  StageTimings timings;
+  timings.Add(SearchStage::Retrieval, 0.001);
+  timings.Add(SearchStage::Retrieval, 0.002);
+  timings.Add(SearchStage::Total, 0.010);
+  TEST_ALMOST_EQUAL_ABS(timings.Get(SearchStage::Retrieval), 0.003, 1e-9, ());
+
+  StageLatencies latencies;
+  latencies.Add(timings);
+  latencies.Add(timings);
+
+  TEST_EQUAL(latencies.Get(SearchStage::Retrieval).GetCount(), 2, ());
+  TEST_EQUAL(latencies.Get(SearchStage::Retrieval).GetMax(), 3000, ());
+  TEST_EQUAL(latencies.Get(SearchStage::Ranker).GetMax(), 0, ());
+  TEST_EQUAL(latencies.Get(SearchStage::Total).GetPercentile(50), 10000, ());
+
+  timings.Clear();
+  TEST_EQUAL(timings.Get(SearchStage::Retrieval), 0.0, ());
+}
+}  // namespace stage_timings_tests
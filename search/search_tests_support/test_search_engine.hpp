@@ -31,6 +31,8 @@ public:
 
   storage::CountryInfoGetter & GetCountryInfoGetter() { return *m_infoGetter; }
 
+  Engine & GetEngine() { return m_engine; }
+
 private:
   storage::Affiliations m_affiliations;
   std::unique_ptr<storage::CountryInfoGetter> m_infoGetter;
@@ -72,6 +72,13 @@ vector<search::Result> const & TestSearchRequest::Results() const
   return m_results;
 }
 
+StageTimings const & TestSearchRequest::GetStageTimings() const
+{
+  lock_guard<mutex> lock(m_mu);
+  CHECK(m_done, ("This function may be called only when request is processed."));
+  return m_stageTimings;
+}
+
 void TestSearchRequest::Start()
 {
   m_engine.Search(m_params);
@@ -87,6 +94,11 @@ void TestSearchRequest::SetUpCallbacks()
 {
   m_params.m_onStarted = bind(&TestSearchRequest::OnStarted, this);
   m_params.m_onResults = bind(&TestSearchRequest::OnResults, this, placeholders::_1);
+  m_params.m_onStageTimings = [this](StageTimings const & timings)
+  {
+    lock_guard<mutex> lock(m_mu);
+    m_stageTimings = timings;
+  };
 }
 
 void TestSearchRequest::SetUpResultParams()
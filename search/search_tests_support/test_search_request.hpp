@@ -4,6 +4,7 @@
 
 #include "search/result.hpp"
 #include "search/search_params.hpp"
+#include "search/stage_timings.hpp"
 
 #include "base/timer.hpp"
 
@@ -44,6 +45,8 @@ public:
   using TimeDurationT = base::Timer::DurationT;
   TimeDurationT ResponseTime() const;
   std::vector<search::Result> const & Results() const;
+  // Durations of search stages, zero if the request was cancelled.
+  StageTimings const & GetStageTimings() const;
 
 protected:
   TestSearchRequest(TestSearchEngine & engine, std::string const & query,
@@ -64,6 +67,7 @@ protected:
   mutable std::mutex m_mu;
 
   std::vector<search::Result> m_results;
+  StageTimings m_stageTimings;
   bool m_done = false;
 
   base::Timer m_timer;
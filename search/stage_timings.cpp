@@ -0,0 +1,150 @@
+#include "search/stage_timings.hpp"
+
+#include "base/assert.hpp"
+#include "base/bits.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace search
+{
+using namespace std;
+
+string DebugPrint(SearchStage stage)
+{
+  switch (stage)
+  {
+  case SearchStage::Retrieval: return "Retrieval";
+  case SearchStage::Localities: return "Localities";
+  case SearchStage::PathFinder: return "PathFinder";
+  case SearchStage::PreRanker: return "PreRanker";
+  case SearchStage::Ranker: return "Ranker";
+  case SearchStage::Total: return "Total";
+  case SearchStage::Count: return "Count";
+  }
+  return "Unknown";
+}
+
+string DebugPrint(StageTimings const & timings)
+{
+  ostringstream os;
+  os << fixed << setprecision(3) << "StageTimings [";
+  for (size_t i = 0; i < kNumSearchStages; ++i)
+  {
+    auto const stage = static_cast<SearchStage>(i);
+    if (i != 0)
+      os << ", ";
+    os << DebugPrint(stage) << ": " << timings.Get(stage) * 1000.0 << "ms";
+  }
+  os << "]";
+  return os.str();
+}
+
+// LatencyHistogram --------------------------------------------------------------------------------
+void LatencyHistogram::Add(uint64_t micros)
+{
+  ++m_counts[GetBucket(micros)];
+  ++m_count;
+  m_max = max(m_max, micros);
+  m_sum += static_cast<double>(micros);
+}
+
+void LatencyHistogram::Merge(LatencyHistogram const & rhs)
+{
+  for (size_t i = 0; i < kNumBuckets; ++i)
+    m_counts[i] += rhs.m_counts[i];
+  m_count += rhs.m_count;
+  m_max = max(m_max, rhs.m_max);
+  m_sum += rhs.m_sum;
+}
+
+double LatencyHistogram::GetMean() const
+{
+  return m_count == 0 ? 0.0 : m_sum / static_cast<double>(m_count);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const
+{
+  ASSERT_GREATER_OR_EQUAL(percentile, 0.0, ());
+  ASSERT_LESS_OR_EQUAL(percentile, 100.0, ());
+
+  if (m_count == 0)
+    return 0;
+
+  auto const rank = max(uint64_t{1}, static_cast<uint64_t>(ceil(percentile / 100.0 * m_count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i)
+  {
+    seen += m_counts[i];
+    if (seen >= rank)
+      return min(GetBucketUpperBound(i), m_max);
+  }
+  return m_max;
+}
+
+// static
+size_t LatencyHistogram::GetBucket(uint64_t value)
+{
+  if (value < kNumSubBuckets)
+    return static_cast<size_t>(value);
+
+  auto const shift = bits::FloorLog(value) - kSubBucketBits;
+  auto const subBucket = (value >> shift) - kNumSubBuckets;
+  return static_cast<size_t>(kNumSubBuckets + shift * kNumSubBuckets + subBucket);
+}
+
+// static
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t bucket)
+{
+  if (bucket < kNumSubBuckets)
+    return bucket;
+
+  auto const shift = (bucket - kNumSubBuckets) / kNumSubBuckets;
+  auto const subBucket = (bucket - kNumSubBuckets) % kNumSubBuckets;
+  auto const lower = (kNumSubBuckets + subBucket) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+string DebugPrint(LatencyHistogram const & histogram)
+{
+  ostringstream os;
+  os << "LatencyHistogram [ count: " << histogram.GetCount() << ", mean: " << fixed
+     << setprecision(1) << histogram.GetMean() << "us"
+     << ", p50: " << histogram.GetPercentile(50) << "us"
+     << ", p90: " << histogram.GetPercentile(90) << "us"
+     << ", p99: " << histogram.GetPercentile(99) << "us"
+     << ", max: " << histogram.GetMax() << "us ]";
+  return os.str();
+}
+
+// StageLatencies ----------------------------------------------------------------------------------
+void StageLatencies::Add(StageTimings const & timings)
+{
+  for (size_t i = 0; i < kNumSearchStages; ++i)
+  {
+    auto const seconds = timings.Get(static_cast<SearchStage>(i));
+    m_histograms[i].Add(static_cast<uint64_t>(llround(seconds * 1e6)));
+  }
+}
+
+void StageLatencies::Merge(StageLatencies const & rhs)
+{
+  for (size_t i = 0; i < kNumSearchStages; ++i)
+    m_histograms[i].Merge(rhs.m_histograms[i]);
+}
+
+string DebugPrint(StageLatencies const & latencies)
+{
+  ostringstream os;
+  os << "StageLatencies [" << endl;
+  for (size_t i = 0; i < kNumSearchStages; ++i)
+  {
+    auto const stage = static_cast<SearchStage>(i);
+    os << "  " << DebugPrint(stage) << ": " << DebugPrint(latencies.Get(stage)) << endl;
+  }
+  os << "]";
+  return os.str();
+}
+}  // namespace search
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "base/stl_helpers.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace search
+{
+// Stages of a search query whose duration is measured separately.
+// Stages don't overlap, so the time of a query which is not covered by
+// any stage is spent elsewhere, mostly in the geocoder's matching code.
+enum class SearchStage
+{
+  // Retrieval of features matching query tokens from the search index.
+  Retrieval,
+  // Matching of countries, states, cities and villages.
+  Localities,
+  // Intersection of features layers by FeaturesLayerPathFinder.
+  PathFinder,
+  PreRanker,
+  Ranker,
+  // The whole query, from the start till the last update of results.
+  Total,
+  Count
+};
+
+size_t constexpr kNumSearchStages = base::E2I(SearchStage::Count);
+
+std::string DebugPrint(SearchStage stage);
+
+// Time spent by a single search query in each stage.
+class StageTimings
+{
+public:
+  void Add(SearchStage stage, double seconds) { m_seconds[base::E2I(stage)] += seconds; }
+  double Get(SearchStage stage) const { return m_seconds[base::E2I(stage)]; }
+  void Clear() { m_seconds.fill(0.0); }
+
+private:
+  std::array<double, kNumSearchStages> m_seconds = {};
+};
+
+std::string DebugPrint(StageTimings const & timings);
+
+// Adds the time from construction to destruction to the |stage| of |timings|.
+class ScopedStageTimer
+{
+public:
+  ScopedStageTimer(StageTimings & timings, SearchStage stage) : m_timings(timings), m_stage(stage)
+  {
+  }
+
+  ~ScopedStageTimer()
+  {
+    m_timings.Add(m_stage, std::chrono::duration<double>(Clock::now() - m_start).count());
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  StageTimings & m_timings;
+  SearchStage m_stage;
+  Clock::time_point m_start = Clock::now();
+};
+
+// Histogram of latencies with a bounded relative error, in the spirit of
+// HdrHistogram. Values are grouped by powers of two, and each group is
+// split into kNumSubBuckets linear sub-buckets, so the relative error of
+// percentiles is at most 1 / kNumSubBuckets with a fixed memory footprint.
+class LatencyHistogram
+{
+public:
+  void Add(uint64_t micros);
+  void Merge(LatencyHistogram const & rhs);
+
+  uint64_t GetCount() const { return m_count; }
+  uint64_t GetMax() const { return m_max; }
+  double GetMean() const;
+
+  // Returns the value not exceeded by |percentile| percents of values,
+  // |percentile| is in [0, 100].
+  uint64_t GetPercentile(double percentile) const;
+
+private:
+  static uint8_t constexpr kSubBucketBits = 4;
+  static uint64_t constexpr kNumSubBuckets = uint64_t{1} << kSubBucketBits;
+  static size_t constexpr kNumBuckets = (64 - kSubBucketBits + 1) * kNumSubBuckets;
+
+  static size_t GetBucket(uint64_t value);
+  static uint64_t GetBucketUpperBound(size_t bucket);
+
+  std::array<uint64_t, kNumBuckets> m_counts = {};
+  uint64_t m_count = 0;
+  uint64_t m_max = 0;
+  double m_sum = 0.0;
+};
+
+std::string DebugPrint(LatencyHistogram const & histogram);
+
+// Per-stage latency histograms of a set of search queries.
+class StageLatencies
+{
+public:
+  void Add(StageTimings const & timings);
+  void Merge(StageLatencies const & rhs);
+
+  LatencyHistogram const & Get(SearchStage stage) const { return m_histograms[base::E2I(stage)]; }
+
+private:
+  std::array<LatencyHistogram, kNumSearchStages> m_histograms;
+};
+
+std::string DebugPrint(StageLatencies const & latencies);
+}  // namespace search